@@ -22,10 +22,12 @@ device \
 drivers \
 source \
 source/action \
+source/boot \
 source/execute \
 source/flash \
 source/gpio \
 source/pit \
+source/slot \
 source/spi \
 source/uart \
 startup \
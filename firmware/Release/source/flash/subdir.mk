@@ -5,15 +5,18 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
 ../source/flash/check_flash.c \
-../source/flash/flash_init.c 
+../source/flash/flash_init.c \
+../source/flash/flash_store.c 
 
 C_DEPS += \
 ./source/flash/check_flash.d \
-./source/flash/flash_init.d 
+./source/flash/flash_init.d \
+./source/flash/flash_store.d 
 
 OBJS += \
 ./source/flash/check_flash.o \
-./source/flash/flash_init.o 
+./source/flash/flash_init.o \
+./source/flash/flash_store.o 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -28,7 +31,7 @@ source/flash/%.o: ../source/flash/%.c source/flash/subdir.mk
 clean: clean-source-2f-flash
 
 clean-source-2f-flash:
-	-$(RM) ./source/flash/check_flash.d ./source/flash/check_flash.o ./source/flash/flash_init.d ./source/flash/flash_init.o
+	-$(RM) ./source/flash/check_flash.d ./source/flash/check_flash.o ./source/flash/flash_init.d ./source/flash/flash_init.o ./source/flash/flash_store.d ./source/flash/flash_store.o
 
 .PHONY: clean-source-2f-flash
 
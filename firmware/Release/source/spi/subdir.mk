@@ -4,12 +4,15 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../source/spi/spi_dma.c \
 ../source/spi/spi_init.c 
 
 C_DEPS += \
+./source/spi/spi_dma.d \
 ./source/spi/spi_init.d 
 
 OBJS += \
+./source/spi/spi_dma.o \
 ./source/spi/spi_init.o 
 
 
@@ -25,7 +28,7 @@ source/spi/%.o: ../source/spi/%.c source/spi/subdir.mk
 clean: clean-source-2f-spi
 
 clean-source-2f-spi:
-	-$(RM) ./source/spi/spi_init.d ./source/spi/spi_init.o
+	-$(RM) ./source/spi/spi_dma.d ./source/spi/spi_dma.o ./source/spi/spi_init.d ./source/spi/spi_init.o
 
 .PHONY: clean-source-2f-spi
 
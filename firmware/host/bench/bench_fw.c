@@ -0,0 +1,360 @@
+/*
+ * bench_fw.c
+ *
+ *  Firmware sıcak yollarının host benchmark’ı: build_packet(), frame_begin()/
+ *  frame_end(), crc16_block(), proto_rx_poll() ve parse_actions()
+ *  firmware/source’tan değiştirilmeden derlenir (make bench → build/bench_fw).
+ *
+ *  - Veri setleri sabittir (xorshift32, tohum 0x5EED); qt_app/bench/
+ *    bench_hotpaths.cpp aynı üreteçle byte-byte aynı akışı/grafı kurar, iki
+ *    tarafın sonuçları aynı girdiye karşılık gelir.
+ *  - proto_rx_poll, akışı rxRing’e (≤ UART_RX_RING_SZ-1 boş yer kadar) yazıp
+ *    DMA DADDR’ı ilerleterek beslenir; sim iş parçacıkları çalışmaz.
+ *  - Her ölçüm en az --min-ms sürecek kadar tekrarlanır; --json çıktısı
+ *    commit’ler arası karşılaştırma içindir (alanlar qt_app tarafıyla aynı).
+ *
+ *  Kullanım: build/bench_fw [--json FILE|-] [--min-ms N] [--stream-mb N]
+ */
+
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim_mcu.h"
+#include "uart/uart.h"
+#include "uart/uart_proto.h"
+#include "action/action.h"
+
+/* uart_rx.c DMA0->TCD[0].DADDR’dan head okur; sim_core yerine yerel kopya */
+static DMA_Type s_dma;
+DMA_Type *sim_dma0(void) { return &s_dma; }
+
+/* ------------------------------ Veri setleri ------------------------------ */
+
+static uint32_t s_rng;
+
+static uint32_t rng_next(void)
+{
+    uint32_t x = s_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return s_rng = x;
+}
+
+typedef struct {
+    uint8_t *p;
+    size_t   n, cap;
+    size_t   frames;        /* Üretilen geçerli çerçeve */
+} t_buf;
+
+static void buf_reserve(t_buf *b, size_t extra)
+{
+    if (b->n + extra <= b->cap) return;
+    while (b->n + extra > b->cap) b->cap = b->cap ? b->cap * 2u : 4096u;
+    b->p = (uint8_t *)realloc(b->p, b->cap);
+    if (!b->p) { perror("realloc"); exit(1); }
+}
+
+static void stream_frame(t_buf *b, uint8_t msg, uint16_t len, int corrupt)
+{
+    uint8_t pl[MAX_PAYLOAD];
+    for (uint16_t i = 0; i < len; ++i) pl[i] = (uint8_t)rng_next();
+
+    buf_reserve(b, PROTO_CORE_SIZE + len);
+    size_t n = build_packet(msg, pl, len, b->p + b->n);
+    if (corrupt) b->p[b->n + 5] ^= 0x01u;
+    b->n += n;
+}
+
+/* %70 çerçeve (0..512 B), %20 gürültü (arada 0xAA), %10 bozuk CRC’li DATA */
+static void make_stream(t_buf *b, size_t bytes)
+{
+    s_rng = 0x5EEDu;
+    while (b->n < bytes) {
+        uint32_t pick = rng_next() % 10u;
+        if (pick < 7u) {
+            uint8_t  msg = (uint8_t)rng_next();
+            uint16_t len = (uint16_t)(rng_next() % (MAX_PAYLOAD + 1u));
+            stream_frame(b, msg, len, 0);
+            b->frames++;
+        } else if (pick < 9u) {
+            uint32_t len = 1u + rng_next() % 2047u;
+            buf_reserve(b, len);
+            for (uint32_t i = 0; i < len; ++i) {
+                uint32_t r = rng_next();
+                b->p[b->n++] = (r % 16u == 0u) ? SOF0 : (uint8_t)(r >> 8);
+            }
+        } else {
+            stream_frame(b, MSG_ID_CSPI_DATA, (uint16_t)(1u + rng_next() % MAX_PAYLOAD), 1);
+        }
+    }
+}
+
+static void put_u8(t_buf *b, uint8_t v)    { buf_reserve(b, 1u); b->p[b->n++] = v; }
+static void put_u16(t_buf *b, uint16_t v)  { put_u8(b, (uint8_t)(v >> 8)); put_u8(b, (uint8_t)v); }
+static void put_u32(t_buf *b, uint32_t v)  { put_u16(b, (uint16_t)(v >> 16)); put_u16(b, (uint16_t)v); }
+
+/*
+ * n düğümlü zincir: 0 START → 1; i → i+1 (ve i%8==0 ise i+3).
+ * Tipler sırayla DELAY / PIN_WRITE / PIN_TRIGGER (wire formatı action.c’deki gibi).
+ */
+static void make_actions(t_buf *b, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        uint8_t t[2], ct = 0;
+        if (i + 1 < n)                   t[ct++] = (uint8_t)(i + 1);
+        if (i && i % 8 == 0 && i + 3 < n) t[ct++] = (uint8_t)(i + 3);
+
+        if (i == 0) {
+            put_u8(b, TYPE_START); put_u8(b, 0);
+        } else if (i % 3 == 1) {
+            put_u8(b, TYPE_DELAY); put_u8(b, (uint8_t)i);
+            put_u32(b, (uint32_t)(i % 50)); put_u16(b, (uint16_t)((i * 7) % 1000));
+        } else if (i % 3 == 2) {
+            put_u8(b, TYPE_PIN_WRITE); put_u8(b, (uint8_t)i);
+            put_u8(b, (uint8_t)(i % 5)); put_u8(b, (uint8_t)(i % 32));
+            put_u8(b, 0); put_u8(b, 1); put_u8(b, 0);
+            put_u32(b, (uint32_t)(1 + i % 20)); put_u16(b, 0);
+        } else {
+            put_u8(b, TYPE_PIN_TRIGGER); put_u8(b, (uint8_t)i);
+            put_u8(b, (uint8_t)(i % 5)); put_u8(b, (uint8_t)(i % 32));
+            put_u8(b, 0xFF); put_u8(b, 1);
+            put_u32(b, 10u); put_u16(b, 0);
+        }
+        put_u8(b, ct);
+        for (uint8_t k = 0; k < ct; ++k) put_u8(b, t[k]);
+    }
+}
+
+/* ------------------------------- Ölçüm ------------------------------------ */
+
+typedef struct {
+    const char *name, *dataset;
+    uint64_t    iters;
+    double      ns_per_op;
+    uint64_t    bytes_per_op, items_per_op;
+} t_result;
+
+#define MAX_RESULTS 16
+
+static t_result s_res[MAX_RESULTS];
+static int      s_nres;
+static double   s_min_ms = 200.0;
+
+static inline uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Derleyicinin sonucu atmasını engeller */
+static volatile uint32_t s_sink;
+
+typedef uint64_t (*bench_fn)(void *ctx);   /* Dönüş: işlenen öğe (çerçeve/action) */
+
+/* Bir ısınma turu, sonra toplam süre --min-ms’i geçene kadar iki katına çıkan turlar */
+static void run(const char *name, const char *dataset, uint64_t bytes, bench_fn fn, void *ctx)
+{
+    uint64_t items = fn(ctx);
+    uint64_t iters = 0, batch = 1, total = 0;
+
+    while ((double)total / 1e6 < s_min_ms) {
+        uint64_t t0 = now_ns();
+        for (uint64_t i = 0; i < batch; ++i) s_sink += (uint32_t)fn(ctx);
+        total += now_ns() - t0;
+        iters += batch;
+        batch *= 2u;
+    }
+
+    if (s_nres < MAX_RESULTS)
+        s_res[s_nres++] = (t_result){ name, dataset, iters, (double)total / (double)iters, bytes, items };
+}
+
+static double mb_per_s(const t_result *r)
+{
+    return r->bytes_per_op ? (double)r->bytes_per_op / r->ns_per_op * 1e9 / 1048576.0 : 0.0;
+}
+
+static void print_table(FILE *f)
+{
+    fprintf(f, "%-16s %-14s %12s %14s %10s %10s\n",
+            "benchmark", "dataset", "iterations", "ns/op", "MB/s", "items/op");
+    for (int i = 0; i < s_nres; ++i) {
+        const t_result *r = &s_res[i];
+        fprintf(f, "%-16s %-14s %12llu %14.1f %10.1f %10llu\n",
+                r->name, r->dataset, (unsigned long long)r->iters, r->ns_per_op,
+                mb_per_s(r), (unsigned long long)r->items_per_op);
+    }
+}
+
+static void print_json(FILE *f)
+{
+    fprintf(f, "{\n  \"suite\": \"firmware\",\n  \"min_ms\": %.0f,\n  \"results\": [\n", s_min_ms);
+    for (int i = 0; i < s_nres; ++i) {
+        const t_result *r = &s_res[i];
+        fprintf(f, "    {\"name\": \"%s\", \"dataset\": \"%s\", \"iterations\": %llu, "
+                   "\"ns_per_op\": %.1f, \"bytes_per_op\": %llu, \"items_per_op\": %llu, "
+                   "\"mb_per_s\": %.2f}%s\n",
+                r->name, r->dataset, (unsigned long long)r->iters, r->ns_per_op,
+                (unsigned long long)r->bytes_per_op, (unsigned long long)r->items_per_op,
+                mb_per_s(r), (i + 1 < s_nres) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+/* ------------------------------ Ölçülenler -------------------------------- */
+
+typedef struct {
+    const uint8_t *pl;
+    uint16_t       len;
+    uint8_t        out[PROTO_CORE_SIZE + MAX_PAYLOAD];
+} t_pkt_ctx;
+
+static uint64_t bench_build_packet(void *ctx)
+{
+    t_pkt_ctx *c = (t_pkt_ctx *)ctx;
+    return build_packet(MSG_ID_CSPI_DATA, c->pl, c->len, c->out) ? 1u : 0u;
+}
+
+/* CSPI_STATS çerçevesi: kayıt doğrudan çerçeveye yazılır (Debug_Tool.c yolu) */
+static uint64_t bench_frame_inplace(void *ctx)
+{
+    t_pkt_ctx *c = (t_pkt_ctx *)ctx;
+    const t_proto_cspi_stats s = { .rounds = c->len, .words = 0x12345678u, .ring_size = 2048u };
+    uint8_t *p = proto_put_cspi_stats(frame_begin(c->out, MSG_ID_CSPI_STATS), &s);
+    return frame_end(c->out, p) ? 1u : 0u;
+}
+
+static uint64_t bench_crc16_block(void *ctx)
+{
+    const t_buf *b = (const t_buf *)ctx;
+    return crc16_block(0xFFFFu, b->p, b->n) ? 1u : 0u;
+}
+
+/* Akışı ring’e yaz (DMA gibi), dolunca parser’a boşalt; dönüş: çerçeve sayısı */
+static uint64_t bench_proto_rx_poll(void *ctx)
+{
+    const t_buf *b = (const t_buf *)ctx;
+    static uint8_t pl[MAX_PAYLOAD];
+    uint64_t frames = 0;
+    uint16_t head = 0;
+    uint8_t  msg;
+    uint16_t len;
+
+    proto_rx_reset();
+    s_dma.TCD[0].DADDR = (uint32_t)(uintptr_t)&rxRing[0];
+
+    for (size_t off = 0; off < b->n;) {
+        /* Parser ring’i her turda boşaltır: UART_RX_RING_SZ-1 byte yazılabilir */
+        size_t n = b->n - off;
+        if (n > UART_RX_RING_SZ - 1u) n = UART_RX_RING_SZ - 1u;
+        for (size_t k = 0; k < n; ++k) {
+            rxRing[head] = b->p[off + k];
+            head = (uint16_t)((head + 1u) & (UART_RX_RING_SZ - 1u));
+        }
+        off += n;
+        __atomic_store_n(&s_dma.TCD[0].DADDR, (uint32_t)(uintptr_t)&rxRing[head], __ATOMIC_RELEASE);
+
+        while (proto_rx_poll(&msg, pl, &len) == 1) frames++;
+    }
+    return frames;
+}
+
+static uint64_t bench_parse_actions(void *ctx)
+{
+    const t_buf *b = (const t_buf *)ctx;
+    t_action_set S;
+    int n = parse_actions(b->p, (uint16_t)b->n, &S);
+    free_actions(&S);
+    return n > 0 ? (uint64_t)n : 0u;
+}
+
+/* ---------------------------------------------------------------------------- */
+
+static void usage(FILE *f, const char *prog)
+{
+    fprintf(f,
+        "Usage: %s [--json FILE|-] [--min-ms N] [--stream-mb N]\n"
+        "Benchmarks firmware build_packet/crc16_block/proto_rx_poll/parse_actions on\n"
+        "fixed datasets (shared with qt_app bench_hotpaths).\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option opts[] = {
+        { "json",      required_argument, NULL, 'j' },
+        { "min-ms",    required_argument, NULL, 'm' },
+        { "stream-mb", required_argument, NULL, 's' },
+        { "help",      no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    const char *json = NULL;
+    long stream_mb = 8;
+    int c;
+
+    while ((c = getopt_long(argc, argv, "h", opts, NULL)) != -1) {
+        switch (c) {
+        case 'j': json      = optarg; break;
+        case 'm': s_min_ms  = strtod(optarg, NULL); break;
+        case 's': stream_mb = strtol(optarg, NULL, 10); break;
+        case 'h': usage(stdout, argv[0]); return 0;
+        default:  usage(stderr, argv[0]); return 2;
+        }
+    }
+    if (optind < argc || stream_mb < 1 || s_min_ms <= 0.0) {
+        usage(stderr, argv[0]);
+        return 2;
+    }
+
+    /* Veri setleri */
+    uint8_t pl512[MAX_PAYLOAD];
+    s_rng = 0x5EEDu;
+    for (size_t i = 0; i < sizeof(pl512); ++i) pl512[i] = (uint8_t)rng_next();
+
+    t_buf stream = {0}, small = {0}, act8 = {0}, act255 = {0};
+    make_stream(&stream, (size_t)stream_mb << 20);
+    s_rng = 0x5EEDu;
+    stream_frame(&small, MSG_ID_CSPI_DATA, 32u, 0);     /* Tek küçük çerçeve */
+    small.frames = 1;
+    make_actions(&act8, 8);
+    make_actions(&act255, 255);
+
+    char stream_name[32];
+    snprintf(stream_name, sizeof(stream_name), "stream-%ldMB", stream_mb);
+
+    t_pkt_ctx p32  = { pl512, 32u,          {0} };
+    t_pkt_ctx p512 = { pl512, MAX_PAYLOAD,  {0} };
+
+    run("build_packet",  "payload-32",  PROTO_CORE_SIZE + 32u,          bench_build_packet,  &p32);
+    run("build_packet",  "payload-512", PROTO_CORE_SIZE + MAX_PAYLOAD,  bench_build_packet,  &p512);
+    run("frame_inplace", "cspi-stats",  PROTO_CORE_SIZE + PROTO_CSPI_STATS_SIZE, bench_frame_inplace, &p32);
+    run("crc16_block",   "payload-512", MAX_PAYLOAD,                    bench_crc16_block,
+        &(t_buf){ pl512, MAX_PAYLOAD, MAX_PAYLOAD, 0 });
+    run("crc16_block",   stream_name,   stream.n,                       bench_crc16_block,   &stream);
+    run("proto_rx_poll", "frame-32",    small.n,                        bench_proto_rx_poll, &small);
+    run("proto_rx_poll", stream_name,   stream.n,                       bench_proto_rx_poll, &stream);
+    run("parse_actions", "actions-8",   act8.n,                         bench_parse_actions, &act8);
+    run("parse_actions", "actions-255", act255.n,                       bench_parse_actions, &act255);
+
+    fprintf(stderr, "%s: %zu bytes, %zu valid frames generated\n",
+            stream_name, stream.n, stream.frames);
+
+    if (!json) {
+        print_table(stdout);
+    } else if (!strcmp(json, "-")) {
+        print_json(stdout);
+    } else {
+        FILE *f = fopen(json, "w");
+        if (!f) { perror(json); return 1; }
+        print_json(f);
+        fclose(f);
+        print_table(stdout);
+    }
+
+    free(stream.p); free(small.p); free(act8.p); free(act255.p);
+    return 0;
+}
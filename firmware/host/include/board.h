@@ -0,0 +1,7 @@
+/* Host simülasyonu: SDK/CMSIS board.h yerine (bkz. sim_mcu.h). */
+#ifndef SIM_BOARD_H_
+#define SIM_BOARD_H_
+
+#include "sim_mcu.h"
+
+#endif /* SIM_BOARD_H_ */
@@ -0,0 +1,7 @@
+/* Host simülasyonu: SDK/CMSIS clock_config.h yerine (bkz. sim_mcu.h). */
+#ifndef SIM_CLOCK_CONFIG_H_
+#define SIM_CLOCK_CONFIG_H_
+
+#include "sim_mcu.h"
+
+#endif /* SIM_CLOCK_CONFIG_H_ */
@@ -0,0 +1,7 @@
+/* Host simülasyonu: SDK/CMSIS core_cm4.h yerine (bkz. sim_mcu.h). */
+#ifndef SIM_CORE_CM4_H_
+#define SIM_CORE_CM4_H_
+
+#include "sim_mcu.h"
+
+#endif /* SIM_CORE_CM4_H_ */
@@ -0,0 +1,7 @@
+/* Host simülasyonu: SDK/CMSIS fsl_dmamux.h yerine (bkz. sim_mcu.h). */
+#ifndef SIM_FSL_DMAMUX_H_
+#define SIM_FSL_DMAMUX_H_
+
+#include "sim_mcu.h"
+
+#endif /* SIM_FSL_DMAMUX_H_ */
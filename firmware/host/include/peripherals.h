@@ -0,0 +1,13 @@
+/* Host simülasyonu: ConfigTools peripherals.h yerine (bkz. sim_mcu.h). */
+#ifndef SIM_PERIPHERALS_H_
+#define SIM_PERIPHERALS_H_
+
+#include "sim_mcu.h"
+
+/* UART RX: kanal 0, rxRing üzerinde dairesel (DADDR = yazma konumu) */
+#define DMA_DMA_BASEADDR     DMA0
+#define DMA_DMAMUX_BASEADDR  DMAMUX
+#define DMA_CH0_DMA_REQUEST  kDmaRequestMux0UART0Rx
+#define DMA_CH0_DMA_CHANNEL  0
+
+#endif /* SIM_PERIPHERALS_H_ */
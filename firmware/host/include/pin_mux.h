@@ -0,0 +1,7 @@
+/* Host simülasyonu: SDK/CMSIS pin_mux.h yerine (bkz. sim_mcu.h). */
+#ifndef SIM_PIN_MUX_H_
+#define SIM_PIN_MUX_H_
+
+#include "sim_mcu.h"
+
+#endif /* SIM_PIN_MUX_H_ */
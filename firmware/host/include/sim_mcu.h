@@ -0,0 +1,280 @@
+/*
+ * sim_mcu.h
+ *
+ *  Host (Linux) simülasyonu için MK02F SDK/CMSIS yerine geçen tanımlar.
+ *
+ *  Amaç:
+ *  -----
+ *  - firmware/source altındaki modüllerin değiştirilmeden derlenmesi için
+ *    kullandıkları tip, sabit ve fonksiyonların asgari karşılığı.
+ *  - Çevre birimleri (UART/eDMA, PIT, DSPI, GPIO, Flash) firmware/host/sim
+ *    altında simüle edilir; buradaki fsl_*.h dosyaları yalnızca bu başlığı
+ *    içerir.
+ *  - Sabit değerleri SDK ile birebir değildir; yalnızca firmware’in
+ *    kullandığı anlamları taşır.
+ */
+
+#ifndef SIM_MCU_H_
+#define SIM_MCU_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* ------------------------------ Durum kodları ----------------------------- */
+
+typedef int32_t status_t;
+
+enum {
+    kStatus_Success         = 0,
+    kStatus_Fail            = 1,
+    kStatus_ReadOnly        = 2,
+    kStatus_OutOfRange      = 3,
+    kStatus_InvalidArgument = 4,
+    kStatus_Timeout         = 5,
+
+    kStatus_UART_TxIdle     = 1002,   /* UART grubu (10), TxIdle (2) */
+
+    kStatus_FLASH_AccessError     = 103,   /* Silinmemiş phrase’e programlama */
+    kStatus_FLASH_AlignmentError  = 106,
+    kStatus_FLASH_AddressError    = 107,
+    kStatus_FLASH_EraseKeyError   = 110,
+};
+
+/* ------------------------------ Çekirdek (CM4) ---------------------------- */
+
+/* DWT: CYCCNT her okumada monotonik saatten güncellenir; firmware’in yazdığı
+ * değer (ör. CYCCNT = 0) bir sonraki erişimde yeni taban olarak alınır. */
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+DWT_Type *sim_dwt(void);
+extern CoreDebug_Type sim_core_debug;
+
+#define DWT                         (sim_dwt())
+#define CoreDebug                   (&sim_core_debug)
+#define DWT_CTRL_CYCCNTENA_Msk      (1u << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1u << 24)
+
+extern uint32_t SystemCoreClock;
+
+typedef enum {
+    SPI0_IRQn = 26,
+    PIT0_IRQn = 48,
+} IRQn_Type;
+
+/* __NOP() ana döngünün boşta kaldığı nokta: bekleyen “kesmeler” burada işlenir */
+void sim_idle(void);
+
+#define __NOP()                 sim_idle()
+#define __DSB()                 __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __ISB()                 __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#define SDK_ISR_EXIT_BARRIER    __DSB()
+
+/* Reset: süreç kendini yeniden başlatır (pty ve flash dosyası korunur) */
+void NVIC_SystemReset(void) __attribute__((noreturn));
+
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t prio) { (void)irq; (void)prio; }
+static inline status_t EnableIRQ(IRQn_Type irq) { (void)irq; return kStatus_Success; }
+
+/* -------------------------------- Saatler --------------------------------- */
+
+typedef enum {
+    kCLOCK_CoreSysClk,
+    kCLOCK_BusClk,
+} clock_name_t;
+
+typedef enum {
+    kCLOCK_PortA, kCLOCK_PortB, kCLOCK_PortC, kCLOCK_PortD, kCLOCK_PortE,
+} clock_ip_name_t;
+
+#define SIM_BUS_CLOCK_HZ  35995648u
+
+static inline uint32_t CLOCK_GetFreq(clock_name_t n)
+{
+    return (n == kCLOCK_BusClk) ? SIM_BUS_CLOCK_HZ : SystemCoreClock;
+}
+
+static inline void CLOCK_EnableClock(clock_ip_name_t n) { (void)n; }
+
+/* ---------------------------------- eDMA ---------------------------------- */
+
+/* Yalnız UART RX kanalının DADDR’ı anlamlı: RX iş parçacığı her byte’tan sonra
+ * rxRing içindeki yazma adresini (alt 32 bit) buraya koyar. */
+typedef struct {
+    volatile uint32_t SADDR;
+    volatile uint32_t DADDR;
+} sim_dma_tcd_t;
+
+typedef struct {
+    sim_dma_tcd_t TCD[16];
+} DMA_Type;
+
+typedef struct { uint32_t dummy; } DMAMUX_Type;
+
+/* DMA0 erişimi aynı zamanda ana döngünün kesme noktasıdır (bkz. sim_service) */
+DMA_Type *sim_dma0(void);
+extern DMAMUX_Type sim_dmamux;
+
+#define DMA0    (sim_dma0())
+#define DMAMUX  (&sim_dmamux)
+
+typedef enum {
+    kDmaRequestMux0UART0Rx = 2,
+    kDmaRequestMux0UART0Tx = 3,
+    kDmaRequestMux0SPI0Rx  = 14,
+    kDmaRequestMux0SPI0Tx  = 15,
+} dma_request_source_t;
+
+typedef struct {
+    DMA_Type *base;
+    uint8_t   channel;
+} edma_handle_t;
+
+static inline void DMAMUX_SetSource(DMAMUX_Type *b, uint32_t ch, int32_t src) { (void)b; (void)ch; (void)src; }
+static inline void DMAMUX_EnableChannel(DMAMUX_Type *b, uint32_t ch)  { (void)b; (void)ch; }
+static inline void DMAMUX_DisableChannel(DMAMUX_Type *b, uint32_t ch) { (void)b; (void)ch; }
+
+static inline void EDMA_CreateHandle(edma_handle_t *h, DMA_Type *base, uint32_t ch)
+{
+    h->base    = base;
+    h->channel = (uint8_t)ch;
+}
+
+/* ---------------------------------- UART ---------------------------------- */
+
+typedef struct { uint32_t dummy; } UART_Type;
+extern UART_Type sim_uart0;
+#define UART0 (&sim_uart0)
+
+typedef struct {
+    uint32_t baudRate_Bps;
+    bool     enableTx;
+    bool     enableRx;
+} uart_config_t;
+
+typedef struct {
+    union {
+        uint8_t       *data;
+        const uint8_t *txData;
+    };
+    size_t dataSize;
+} uart_transfer_t;
+
+typedef struct _uart_edma_handle uart_edma_handle_t;
+
+typedef void (*uart_edma_transfer_callback_t)(UART_Type *base,
+                                              uart_edma_handle_t *handle,
+                                              status_t status,
+                                              void *userData);
+
+struct _uart_edma_handle {
+    uart_edma_transfer_callback_t callback;
+    void          *userData;
+    edma_handle_t *txEdmaHandle;
+    edma_handle_t *rxEdmaHandle;
+};
+
+void     UART_GetDefaultConfig(uart_config_t *cfg);
+status_t UART_Init(UART_Type *base, const uart_config_t *cfg, uint32_t srcClock_Hz);
+void     UART_EnableRxDMA(UART_Type *base, bool enable);
+void     UART_EnableTxDMA(UART_Type *base, bool enable);
+void     UART_TransferCreateHandleEDMA(UART_Type *base, uart_edma_handle_t *h,
+                                       uart_edma_transfer_callback_t cb, void *userData,
+                                       edma_handle_t *txEdma, edma_handle_t *rxEdma);
+/* Tamamlanma geri çağrısı hat süresi dolunca ana döngüde (kesme gibi) gelir */
+status_t UART_SendEDMA(UART_Type *base, uart_edma_handle_t *h, uart_transfer_t *xfer);
+
+/* ----------------------------------- PIT ---------------------------------- */
+
+typedef struct { uint32_t dummy; } PIT_Type;
+extern PIT_Type sim_pit;
+#define PIT (&sim_pit)
+
+typedef enum { kPIT_Chnl_0 = 0 } pit_chnl_t;
+enum { kPIT_TimerFlag = 1u, kPIT_TimerInterruptEnable = 1u };
+
+typedef struct { bool enableRunInDebug; } pit_config_t;
+
+static inline void PIT_GetDefaultConfig(pit_config_t *c) { c->enableRunInDebug = false; }
+static inline void PIT_Init(PIT_Type *b, const pit_config_t *c) { (void)b; (void)c; }
+static inline void PIT_EnableInterrupts(PIT_Type *b, pit_chnl_t ch, uint32_t m) { (void)b; (void)ch; (void)m; }
+static inline void PIT_ClearStatusFlags(PIT_Type *b, pit_chnl_t ch, uint32_t m) { (void)b; (void)ch; (void)m; }
+void PIT_SetTimerPeriod(PIT_Type *base, pit_chnl_t ch, uint32_t count);
+void PIT_StartTimer(PIT_Type *base, pit_chnl_t ch);
+void PIT_StopTimer(PIT_Type *base, pit_chnl_t ch);
+
+/* ---------------------------------- DSPI ---------------------------------- */
+
+typedef struct { uint32_t dummy; } SPI_Type;
+extern SPI_Type sim_spi0;
+#define SPI0 (&sim_spi0)
+
+#define kDSPI_RxFifoDrainRequestFlag             (1u << 17)
+#define kDSPI_TxFifoFillRequestFlag              (1u << 25)
+#define kDSPI_TxFifoUnderflowFlag                (1u << 27)
+#define kDSPI_AllStatusFlag                      0xFFFF0000u
+
+#define kDSPI_RxFifoDrainRequestInterruptEnable  (1u << 17)
+#define kDSPI_AllInterruptEnable                 0xFFFF0000u
+
+typedef enum { kDSPI_Ctar0 = 0 } dspi_ctar_selection_t;
+typedef enum { kDSPI_ClockPolarityActiveHigh = 0, kDSPI_ClockPolarityActiveLow } dspi_clock_polarity_t;
+typedef enum { kDSPI_ClockPhaseFirstEdge = 0, kDSPI_ClockPhaseSecondEdge } dspi_clock_phase_t;
+typedef enum { kDSPI_SckToSin0Clock = 0 } dspi_delay_type_t;
+
+typedef struct {
+    uint32_t              bitsPerFrame;
+    dspi_clock_polarity_t cpol;
+    dspi_clock_phase_t    cpha;
+} dspi_slave_ctar_config_t;
+
+typedef struct {
+    dspi_ctar_selection_t    whichCtar;
+    dspi_slave_ctar_config_t ctarConfig;
+    bool                     enableContinuousSCK;
+    bool                     enableRxFifoOverWrite;
+    bool                     enableModifiedTimingFormat;
+    dspi_delay_type_t        samplePoint;
+} dspi_slave_config_t;
+
+void     DSPI_SlaveInit(SPI_Type *base, const dspi_slave_config_t *cfg);
+void     DSPI_StartTransfer(SPI_Type *base);
+void     DSPI_StopTransfer(SPI_Type *base);
+void     DSPI_FlushFifo(SPI_Type *base, bool flushTx, bool flushRx);
+uint32_t DSPI_GetStatusFlags(SPI_Type *base);
+void     DSPI_ClearStatusFlags(SPI_Type *base, uint32_t mask);
+void     DSPI_EnableInterrupts(SPI_Type *base, uint32_t mask);
+void     DSPI_DisableInterrupts(SPI_Type *base, uint32_t mask);
+uint32_t DSPI_ReadData(SPI_Type *base);
+void     DSPI_SlaveWriteData(SPI_Type *base, uint32_t data);
+
+/* ---------------------------------- Flash --------------------------------- */
+
+#define FSL_FEATURE_FLASH_PFLASH_BLOCK_SECTOR_SIZE  2048u
+#define kFLASH_ApiEraseKey                          0x6B65666Bu   /* "kefk" */
+
+typedef struct {
+    uint32_t PFlashBlockBase;
+    uint32_t PFlashTotalSize;
+    uint32_t PFlashSectorSize;
+} flash_config_t;
+
+status_t FLASH_Init(flash_config_t *config);
+status_t FLASH_Erase(flash_config_t *config, uint32_t start, uint32_t lengthInBytes, uint32_t key);
+status_t FLASH_Program(flash_config_t *config, uint32_t start, uint8_t *src, uint32_t lengthInBytes);
+
+/* ---------------------------------- Board --------------------------------- */
+
+void BOARD_InitBootPins(void);
+void BOARD_InitBootClocks(void);
+void BOARD_InitBootPeripherals(void);
+
+#endif /* SIM_MCU_H_ */
@@ -0,0 +1,47 @@
+#!/bin/sh
+# Senaryo regresyonu: debugtool-cli, scenarios/*.json’u dt_sim üzerinde koşar.
+#
+#   scenarios/run.sh <debugtool-cli> [senaryo|dizin ...]
+#   make scenarios CLI=<debugtool-cli>
+#
+# Önce --analyze (port açmadan statik zamanlama), sonra geçici flash dosyası ve
+# sabit bir link ile dt_sim başlatılıp tüm senaryolar bir kez koşulur.
+# Sim girişleri: C6 her execute’ta girişe alındıktan 10 ms sonra HIGH
+# (trigger_external); C7 hiç sürülmez (trigger_timeout).
+# Çıkış kodu debugtool-cli’nin kodudur (0: hepsi geçti).
+
+set -u
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+SIM=${SIM:-$HERE/../build/dt_sim}
+CLI=${1:-}
+[ -n "$CLI" ] || { echo "usage: $0 <debugtool-cli> [scenario...]" >&2; exit 2; }
+shift
+[ $# -gt 0 ] || set -- "$HERE"
+
+[ -x "$SIM" ] || { echo "$SIM not built (make -C firmware/host)" >&2; exit 2; }
+
+"$CLI" --analyze "$@" || exit $?
+
+TMP=$(mktemp -d)
+LINK=$TMP/ttyDT
+PID=
+trap '[ -n "$PID" ] && kill $PID 2>/dev/null; rm -rf "$TMP"' EXIT
+trap 'exit 130' INT TERM
+
+"$SIM" --flash "$TMP/flash.bin" --link "$LINK" --drive C6=1@10 >"$TMP/sim.log" 2>&1 &
+PID=$!
+
+# Link sim pty’yi açınca oluşur
+i=0
+while [ ! -e "$LINK" ]; do
+    i=$((i + 1))
+    if [ $i -gt 50 ] || ! kill -0 $PID 2>/dev/null; then
+        echo "dt_sim did not come up:" >&2
+        cat "$TMP/sim.log" >&2
+        exit 2
+    fi
+    sleep 0.1
+done
+
+"$CLI" -p "$LINK" "$@"
@@ -0,0 +1,82 @@
+/*
+ * sim.h
+ *
+ *  Host simülasyonu: backend’ler arası ortak durum ve yardımcılar.
+ *
+ *  Kesme modeli:
+ *  -------------
+ *  - PIT kendi iş parçacığında PIT0_IRQHandler’ı çağırır (yalnız g_tick’e dokunur).
+ *  - UART TX tamamlanması ve SPI0_IRQHandler ise ana döngüde, firmware’in sık
+ *    geçtiği noktalarda (DMA0 erişimi, __NOP, GPIO) sim_service() ile teslim
+ *    edilir; böylece ISR’lar donanımdaki gibi ana kodla aynı çekirdekte,
+ *    onu “böler” şekilde çalışır ve firmware’de ek kilit gerekmez.
+ *  - UART RX/TX iş parçacıkları pty ile konuşur, hattı --baud hızında sürer.
+ */
+
+#ifndef SIM_SIM_H_
+#define SIM_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "sim_mcu.h"
+
+#define SIM_MAX_DRIVES  64   /* --drive ile verilebilecek azami giriş olayı */
+
+/* Giriş pini olayı: pin girişe alındıktan at_us sonra seviye = level */
+typedef struct {
+    uint8_t  port, pin, level;
+    uint64_t at_us;
+} t_sim_drive;
+
+/* Komut satırı ayarları (sim_main.c doldurur) */
+typedef struct {
+    const char *flash_path;     /* Flash yedek dosyası */
+    const char *link_path;      /* pty slave için sembolik bağ (NULL: yok) */
+    long        baud;           /* Hat hızı (-1: firmware’in UART_Init değeri, 0: sınırsız) */
+    bool        busy;           /* Boşta bekleme yerine dön (gecikme ölçümleri için) */
+    bool        trace_gpio;     /* Çıkış kenarlarını stderr’e yaz */
+
+    const char *spi_mosi_path;  /* Master’ın göndereceği kelimeler (NULL: sayaç) */
+    const char *spi_capture;    /* Slave’in MISO kelimeleri buraya yazılır */
+    double      spi_rate;       /* Kelime/s (0: slave yetiştiği kadar) */
+    uint64_t    spi_words;      /* Oturum başına kelime sınırı (0: sınırsız) */
+
+    t_sim_drive drives[SIM_MAX_DRIVES];
+    int         drive_count;
+} t_sim_opts;
+
+extern t_sim_opts g_sim;
+extern DMA_Type   sim_dma0_regs;   /* DMA0’ın kendisi (sim_service tetiklemeden) */
+
+void sim_core_init(void);
+
+/* Monotonik saat (ns), sürecin başlangıcına göre */
+uint64_t sim_now_ns(void);
+void     sim_sleep_until(uint64_t t_ns);
+
+/* Ana döngü kesme noktası: bekleyen UART/SPI olaylarını teslim eder.
+ * Dönüş: en az bir ISR/geri çağrı çalıştıysa true. */
+bool sim_service(void);
+
+/* Arka plan iş parçacıklarından ana döngüyü uyandır */
+void sim_notify(void);
+
+/* Backend’ler */
+void     sim_uart_attach(int pty_fd);
+bool     sim_uart_service(void);
+void     sim_uart_stats(FILE *f);
+
+void     sim_pit_start(void);
+void     sim_pit_stats(FILE *f);
+
+bool     sim_spi_service(void);
+uint64_t sim_spi_next_due_ns(void);   /* 0: bekleyen kelime yok */
+void     sim_spi_stats(FILE *f);
+
+int      sim_flash_map(const char *path);
+void     sim_flash_stats(FILE *f);
+
+void     sim_gpio_stats(FILE *f);
+
+#endif /* SIM_SIM_H_ */
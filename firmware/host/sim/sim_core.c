@@ -0,0 +1,148 @@
+/*
+ * sim_core.c
+ *
+ *  Çekirdek karşılıkları: saat, DWT döngü sayacı, kart init’i ve ana döngünün
+ *  kesme noktaları (sim_service / sim_idle).
+ */
+
+#include <pthread.h>
+#include <sys/prctl.h>
+#include <time.h>
+#include "sim.h"
+#include "peripherals.h"
+
+uint32_t       SystemCoreClock = 71991296u;   /* clock_config.h: BOARD_BOOTCLOCKRUN_CORE_CLOCK */
+CoreDebug_Type sim_core_debug;
+DMAMUX_Type    sim_dmamux;
+DMA_Type       sim_dma0_regs;
+
+static DWT_Type s_dwt;
+static uint32_t s_dwt_shown;    /* Son okumada CYCCNT’ye konan değer */
+static uint64_t s_dwt_base_ns;  /* CYCCNT = 0 anı */
+
+static pthread_mutex_t s_wake_mx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  s_wake_cv;
+static uint64_t        s_wake_seq, s_wake_seen;
+static int             s_in_service;
+
+#define SIM_IDLE_MAX_NS  1000000u   /* Olay yokken en uzun bekleme (DWT tabanlı periyotlar için) */
+#define SIM_SPIN_NS      200000u    /* Bundan yakın SPI kelimesi uyumadan beklenir */
+
+static uint64_t mono_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t s_t0_ns;       /* sim_now_ns() sıfırı (CLOCK_MONOTONIC) */
+
+uint64_t sim_now_ns(void)
+{
+    return mono_ns() - s_t0_ns;
+}
+
+/* sim_now_ns() zamanını clock_nanosleep/cond_timedwait için mutlak zamana çevir */
+static struct timespec sim_abs(uint64_t t_ns)
+{
+    uint64_t abs = s_t0_ns + t_ns;
+    struct timespec ts = { (time_t)(abs / 1000000000u), (long)(abs % 1000000000u) };
+    return ts;
+}
+
+/* Saat tabanı ve uyandırma koşulu; iş parçacıkları başlamadan çağrılır */
+void sim_core_init(void)
+{
+    s_t0_ns = mono_ns() - 1u;
+    prctl(PR_SET_TIMERSLACK, 1UL);   /* Ana iş parçacığı ve ondan doğanlar: hassas uyanma */
+
+    pthread_condattr_t a;
+    pthread_condattr_init(&a);
+    pthread_condattr_setclock(&a, CLOCK_MONOTONIC);
+    pthread_cond_init(&s_wake_cv, &a);
+    pthread_condattr_destroy(&a);
+}
+
+/* sim_now_ns() zaman çizgisinde mutlak bir ana kadar uyu */
+void sim_sleep_until(uint64_t t_ns)
+{
+    if (t_ns <= sim_now_ns()) return;
+
+    struct timespec ts = sim_abs(t_ns);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) { }
+}
+
+/* CYCCNT’yi saatten yeniden hesapla; firmware araya bir değer yazdıysa onu taban al */
+DWT_Type *sim_dwt(void)
+{
+    uint64_t now = sim_now_ns();
+    if (s_dwt.CYCCNT != s_dwt_shown)
+        s_dwt_base_ns = now - (uint64_t)s_dwt.CYCCNT * 1000000000u / SystemCoreClock;
+
+    uint64_t dt  = now - s_dwt_base_ns;
+    s_dwt_shown  = (uint32_t)((dt / 1000000000u) * SystemCoreClock +
+                              (dt % 1000000000u) * SystemCoreClock / 1000000000u);
+    s_dwt.CYCCNT = s_dwt_shown;
+    return &s_dwt;
+}
+
+DMA_Type *sim_dma0(void)
+{
+    sim_service();
+    return &sim_dma0_regs;
+}
+
+bool sim_service(void)
+{
+    if (s_in_service) return false;   /* ISR içinden tekrar girilmez */
+    s_in_service = 1;
+    bool did = sim_uart_service();
+    did |= sim_spi_service();
+    s_in_service = 0;
+    return did;
+}
+
+void sim_notify(void)
+{
+    pthread_mutex_lock(&s_wake_mx);
+    s_wake_seq++;
+    pthread_cond_signal(&s_wake_cv);
+    pthread_mutex_unlock(&s_wake_mx);
+}
+
+/*
+ * Ana döngü boşta: önce bekleyen olayları teslim et; hiçbiri yoksa RX/TX
+ * iş parçacığı uyandırana, sıradaki SPI kelimesinin zamanına ya da en fazla
+ * SIM_IDLE_MAX_NS’e kadar uyu. SPI kelimesi yakınsa ya da --busy ise dön.
+ */
+void sim_idle(void)
+{
+    if (sim_service() || g_sim.busy) return;
+
+    uint64_t now  = sim_now_ns();
+    uint64_t wake = now + SIM_IDLE_MAX_NS;
+    uint64_t due  = sim_spi_next_due_ns();
+    if (due) {
+        if (due <= now + SIM_SPIN_NS) return;   /* Uyanma gecikmesi kelime periyodunu aşar */
+        if (due < wake) wake = due;
+    }
+
+    struct timespec ts = sim_abs(wake);
+    pthread_mutex_lock(&s_wake_mx);
+    if (s_wake_seq == s_wake_seen)
+        pthread_cond_timedwait(&s_wake_cv, &s_wake_mx, &ts);
+    s_wake_seen = s_wake_seq;
+    pthread_mutex_unlock(&s_wake_mx);
+}
+
+/* ------------------------------ Kart init’i ------------------------------- */
+
+void BOARD_InitBootPins(void)   { }
+void BOARD_InitBootClocks(void) { }
+
+/* RX DMA kanalı rxRing başına kurulur (peripherals.c’deki TCD ile aynı) */
+void BOARD_InitBootPeripherals(void)
+{
+    extern volatile uint8_t rxRing[];
+    sim_dma0_regs.TCD[DMA_CH0_DMA_CHANNEL].DADDR = (uint32_t)(uintptr_t)&rxRing[0];
+}
@@ -0,0 +1,126 @@
+/*
+ * sim_flash.c
+ *
+ *  FTFA flash sürücüsü karşılığı; kullanıcı bölgesi bir dosyadır.
+ *
+ *  - Dosya USER_FLASH_BASE adresine salt-okunur eşlenir: firmware flash’ı
+ *    donanımdaki gibi doğrudan adresten okur (flash_store, check_flash, XIP
+ *    boot imajı); yanlışlıkla yazma bus fault yerine SIGSEGV olur.
+ *  - Yazma yalnız FLASH_Program/FLASH_Erase ile (pwrite), NOR kuralıyla:
+ *    silinmemiş (0xFF olmayan) phrase’e programlama kStatus_FLASH_AccessError.
+ *  - Süreler datasheet tipikleridir (phrase 130 µs, sektör 13 ms); DWT ile
+ *    ölçülen delta kazançları (saved_us) gerçekçi kalır.
+ *  - Dosya reset (NVIC_SystemReset) ve süreç yeniden başlatmaları arasında
+ *    kalıcıdır; boot kaydı testleri bu sayede host’ta yapılabilir.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "sim.h"
+#include "flash/flash.h"
+
+#define SIM_T_PHRASE_NS   130000u
+#define SIM_T_SECTOR_NS   13000000u
+
+static int      s_fd = -1;
+static uint64_t s_programs, s_erases, s_nor_errors;
+
+static inline bool in_region(uint32_t start, uint32_t len)
+{
+    return start >= USER_FLASH_BASE && len <= USER_FLASH_SIZE &&
+           start - USER_FLASH_BASE <= USER_FLASH_SIZE - len;
+}
+
+static void busy_for(uint64_t ns)
+{
+    sim_sleep_until(sim_now_ns() + ns);
+}
+
+/* Dosyayı aç (yoksa silinmiş olarak oluştur) ve sabit adrese eşle. Dönüş: 0 / -1 */
+int sim_flash_map(const char *path)
+{
+    s_fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (s_fd < 0) { perror(path); return -1; }
+
+    struct stat st;
+    if (fstat(s_fd, &st) != 0) { perror(path); return -1; }
+    if (st.st_size == 0) {
+        uint8_t blank[FLASH_SECTOR_SIZE];
+        memset(blank, 0xFF, sizeof(blank));
+        for (uint32_t off = 0; off < USER_FLASH_SIZE; off += sizeof(blank))
+            if (pwrite(s_fd, blank, sizeof(blank), off) != (ssize_t)sizeof(blank)) {
+                perror(path);
+                return -1;
+            }
+    } else if (st.st_size != (off_t)USER_FLASH_SIZE) {
+        fprintf(stderr, "%s: expected %u bytes, found %lld\n",
+                path, USER_FLASH_SIZE, (long long)st.st_size);
+        return -1;
+    }
+
+    void *want = (void *)(uintptr_t)USER_FLASH_BASE;
+    void *p = mmap(want, USER_FLASH_SIZE, PROT_READ, MAP_SHARED | MAP_FIXED_NOREPLACE, s_fd, 0);
+    if (p == MAP_FAILED || p != want) {
+        fprintf(stderr, "flash: cannot map %s at 0x%08x: %s\n", path, USER_FLASH_BASE,
+                p == MAP_FAILED ? strerror(errno) : "address taken");
+        return -1;
+    }
+    return 0;
+}
+
+void sim_flash_stats(FILE *f)
+{
+    fprintf(f, "flash: %llu phrases programmed, %llu sectors erased, %llu NOR violations\n",
+            (unsigned long long)s_programs, (unsigned long long)s_erases,
+            (unsigned long long)s_nor_errors);
+}
+
+/* ------------------------------- SDK yüzü --------------------------------- */
+
+status_t FLASH_Init(flash_config_t *config)
+{
+    config->PFlashBlockBase  = 0u;
+    config->PFlashTotalSize  = 0x20000u;     /* MK02FN128 */
+    config->PFlashSectorSize = FLASH_SECTOR_SIZE;
+    return s_fd >= 0 ? kStatus_Success : kStatus_Fail;
+}
+
+status_t FLASH_Erase(flash_config_t *config, uint32_t start, uint32_t lengthInBytes, uint32_t key)
+{
+    (void)config;
+    if (key != kFLASH_ApiEraseKey)                            return kStatus_FLASH_EraseKeyError;
+    if ((start | lengthInBytes) % FLASH_SECTOR_SIZE)          return kStatus_FLASH_AlignmentError;
+    if (!in_region(start, lengthInBytes) || s_fd < 0)         return kStatus_FLASH_AddressError;
+
+    uint8_t blank[FLASH_SECTOR_SIZE];
+    memset(blank, 0xFF, sizeof(blank));
+    for (uint32_t a = start; a < start + lengthInBytes; a += FLASH_SECTOR_SIZE) {
+        if (pwrite(s_fd, blank, sizeof(blank), a - USER_FLASH_BASE) != (ssize_t)sizeof(blank))
+            return kStatus_Fail;
+        busy_for(SIM_T_SECTOR_NS);
+        s_erases++;
+    }
+    return kStatus_Success;
+}
+
+status_t FLASH_Program(flash_config_t *config, uint32_t start, uint8_t *src, uint32_t lengthInBytes)
+{
+    (void)config;
+    if ((start | lengthInBytes) % FLASH_PHRASE_SIZE)          return kStatus_FLASH_AlignmentError;
+    if (!in_region(start, lengthInBytes) || s_fd < 0)         return kStatus_FLASH_AddressError;
+
+    for (uint32_t i = 0; i < lengthInBytes; i += FLASH_PHRASE_SIZE) {
+        const uint8_t *cur = (const uint8_t *)(uintptr_t)(start + i);
+        for (uint32_t k = 0; k < FLASH_PHRASE_SIZE; ++k)
+            if (cur[k] != 0xFF) { s_nor_errors++; return kStatus_FLASH_AccessError; }
+
+        if (pwrite(s_fd, src + i, FLASH_PHRASE_SIZE, start + i - USER_FLASH_BASE) != FLASH_PHRASE_SIZE)
+            return kStatus_Fail;
+        busy_for(SIM_T_PHRASE_NS);
+        s_programs++;
+    }
+    return kStatus_Success;
+}
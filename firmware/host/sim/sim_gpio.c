@@ -0,0 +1,104 @@
+/*
+ * sim_gpio.c
+ *
+ *  gpio/gpio_utils.c karşılığı: 5 port x 32 pinlik bir pin modeli.
+ *
+ *  - Çıkış pinleri yazılan seviyeyi tutar; okuma çıkışta sürülen seviyeyi,
+ *    girişte dış dünyanın seviyesini döndürür.
+ *  - Girişler varsayılan LOW’dur (gpio_set_input pull-down açar). --drive
+ *    olayları pin girişe alındığı andan (init_pins → her execute) itibaren
+ *    zamanlanır: “D3=1@5” → PTD3, girişe alındıktan 5 ms sonra HIGH.
+ *  - --trace-gpio: çıkış kenarları (seviye değişimleri) stderr’e yazılır.
+ */
+
+#include "sim.h"
+#include "gpio/gpio_utils.h"
+
+#define SIM_PORTS  5u
+
+typedef struct {
+    uint32_t dir;              /* 1: çıkış */
+    uint32_t out;              /* Çıkış latch’i */
+    uint64_t armed_ns[32];     /* Pinin girişe alındığı an (drive zaman tabanı) */
+} t_sim_port;
+
+static t_sim_port s_port[SIM_PORTS];
+static uint64_t   s_edges, s_reads;
+
+static const char s_port_name[SIM_PORTS] = { 'A', 'B', 'C', 'D', 'E' };
+
+static inline bool pin_ok(gpio_port_t port, uint8_t pin)
+{
+    return (unsigned)port < SIM_PORTS && pin < 32u;
+}
+
+/* Girişin dış seviyesi: zamanı gelmiş son --drive olayı (yoksa LOW) */
+static uint8_t input_level(gpio_port_t port, uint8_t pin)
+{
+    uint64_t armed = s_port[port].armed_ns[pin];
+    uint64_t now   = sim_now_ns();
+    uint64_t best  = 0;
+    uint8_t  lvl   = 0;
+
+    for (int i = 0; i < g_sim.drive_count; ++i) {
+        const t_sim_drive *d = &g_sim.drives[i];
+        if (d->port != (uint8_t)port || d->pin != pin) continue;
+        uint64_t at = armed + d->at_us * 1000u;
+        if (at <= now && at >= best) { best = at; lvl = d->level; }
+    }
+    return lvl;
+}
+
+static void drive(gpio_port_t port, uint8_t pin, uint8_t level)
+{
+    if (!pin_ok(port, pin)) return;
+    t_sim_port *P   = &s_port[port];
+    uint32_t    bit = 1u << pin;
+    uint32_t    old = P->out;
+
+    P->out = level ? (P->out | bit) : (P->out & ~bit);
+    if ((old ^ P->out) & bit) {
+        s_edges++;
+        if (g_sim.trace_gpio && (P->dir & bit))
+            fprintf(stderr, "[gpio] %10.3f ms PT%c%u=%u\n",
+                    (double)sim_now_ns() / 1e6, s_port_name[port], pin, level ? 1u : 0u);
+    }
+}
+
+void sim_gpio_stats(FILE *f)
+{
+    fprintf(f, "gpio: %llu output edges, %llu reads\n",
+            (unsigned long long)s_edges, (unsigned long long)s_reads);
+}
+
+/* ----------------------------- gpio_utils.h ------------------------------- */
+
+void gpio_enable_clock(gpio_port_t port)       { (void)port; }
+void gpio_set_mux(gpio_port_t port, uint8_t pin) { (void)port; (void)pin; }
+
+void gpio_set_output(gpio_port_t port, uint8_t pin)
+{
+    if (!pin_ok(port, pin)) return;
+    s_port[port].dir |= 1u << pin;
+}
+
+void gpio_set_input(gpio_port_t port, uint8_t pin)
+{
+    if (!pin_ok(port, pin)) return;
+    s_port[port].dir &= ~(1u << pin);
+    s_port[port].armed_ns[pin] = sim_now_ns();
+}
+
+void gpio_write_high(gpio_port_t port, uint8_t pin) { drive(port, pin, 1u); }
+void gpio_write_low(gpio_port_t port, uint8_t pin)  { drive(port, pin, 0u); }
+
+/* Pin seviyesini okur (0=LOW, 1=HIGH, 0xFF=hatalı port). */
+uint8_t gpio_read(gpio_port_t port, uint8_t pin)
+{
+    if ((unsigned)port >= SIM_PORTS) return 0xFF;
+    if (pin >= 32u) return 0;
+    s_reads++;
+    if (s_port[port].dir & (1u << pin))
+        return (uint8_t)((s_port[port].out >> pin) & 1u);
+    return input_level(port, pin);
+}
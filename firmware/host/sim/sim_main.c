@@ -0,0 +1,236 @@
+/*
+ * sim_main.c
+ *
+ *  Debug Tool host simülasyonu: firmware’in protokol yığını (uart/, action/,
+ *  execute/, slot/, flash/, boot/, spi/ ve Debug_Tool.c ana döngüsü) Linux’ta,
+ *  simüle edilmiş UART/GPIO/PIT/DSPI/flash üzerinde çalışır.
+ *
+ *  - Host tarafı bir pty’dir: Qt uygulaması ya da debugtool-cli slave ucuna
+ *    (ör. /dev/pts/N veya --link ile verilen sabit ad) bağlanır.
+ *  - Debug_Tool.c’nin main()’i firmware_main() olarak derlenir; burası önce
+ *    pty/flash/PIT’i hazırlar, sonra kontrolü ona verir.
+ *  - NVIC_SystemReset süreci yeniden başlatır (exec); pty ve flash dosyası
+ *    korunur, RAM durumu (slotlar, ring’ler) donanımdaki gibi sıfırlanır.
+ *  - SIGINT/SIGTERM: sayaçları stderr’e yazıp çıkar.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include "sim.h"
+
+#define SIM_ENV_PTY  "DT_SIM_PTY"   /* Reset sonrası devralınan "master,slave" fd’leri */
+
+int firmware_main(void);
+
+t_sim_opts g_sim = {
+    .flash_path = "dt_flash.bin",
+    .baud       = -1,
+};
+
+static char **s_argv;
+static int    s_pty_master = -1, s_pty_slave = -1;
+
+static void usage(FILE *f, const char *prog)
+{
+    fprintf(f,
+        "Usage: %s [options]\n"
+        "Runs the Debug Tool firmware on simulated peripherals behind a pty.\n"
+        "\n"
+        "  -f, --flash FILE        user flash backing file (default dt_flash.bin)\n"
+        "  -l, --link PATH         symlink PATH to the pty slave (e.g. /tmp/ttyDT0)\n"
+        "  -b, --baud N            line rate for both directions; 0 = unpaced\n"
+        "                          (default: the firmware's UART baud, 115200;\n"
+        "                          like the real DMA ring, fast hosts can overrun RX)\n"
+        "      --busy              spin instead of sleeping when idle\n"
+        "      --trace-gpio        log output pin edges to stderr\n"
+        "      --drive PIN=L@MS    input PIN (e.g. D3) goes to level L (0/1) MS ms\n"
+        "                          after the firmware configures it as input\n"
+        "      --spi-mosi FILE     words the SPI master sends (looped; default counter)\n"
+        "      --spi-capture FILE  append the slave's MISO words to FILE\n"
+        "      --spi-rate N        master clock in words/s (0 = as fast as the slave)\n"
+        "      --spi-words N       stop the master after N words per session\n"
+        "  -h, --help\n", prog);
+}
+
+/* “D3=1@5.5” → port D, pin 3, HIGH, 5500 µs */
+static int parse_drive(const char *s, t_sim_drive *d)
+{
+    char    p  = (char)(*s & ~0x20);
+    char   *e  = NULL;
+    if (p < 'A' || p > 'E') return -1;
+
+    long pin = strtol(s + 1, &e, 10);
+    if (e == s + 1 || pin < 0 || pin > 31 || *e != '=') return -1;
+    if (e[1] != '0' && e[1] != '1') return -1;
+
+    double ms = 0.0;
+    if (e[2] == '@') {
+        char *end = NULL;
+        ms = strtod(e + 3, &end);
+        if (end == e + 3 || *end || ms < 0) return -1;
+    } else if (e[2]) {
+        return -1;
+    }
+
+    d->port  = (uint8_t)(p - 'A');
+    d->pin   = (uint8_t)pin;
+    d->level = (uint8_t)(e[1] - '0');
+    d->at_us = (uint64_t)(ms * 1000.0 + 0.5);
+    return 0;
+}
+
+static int parse_args(int argc, char **argv)
+{
+    enum { O_BUSY = 256, O_TRACE, O_DRIVE, O_MOSI, O_CAP, O_RATE, O_WORDS };
+    static const struct option opts[] = {
+        { "flash",       required_argument, NULL, 'f'     },
+        { "link",        required_argument, NULL, 'l'     },
+        { "baud",        required_argument, NULL, 'b'     },
+        { "busy",        no_argument,       NULL, O_BUSY  },
+        { "trace-gpio",  no_argument,       NULL, O_TRACE },
+        { "drive",       required_argument, NULL, O_DRIVE },
+        { "spi-mosi",    required_argument, NULL, O_MOSI  },
+        { "spi-capture", required_argument, NULL, O_CAP   },
+        { "spi-rate",    required_argument, NULL, O_RATE  },
+        { "spi-words",   required_argument, NULL, O_WORDS },
+        { "help",        no_argument,       NULL, 'h'     },
+        { NULL, 0, NULL, 0 }
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "f:l:b:h", opts, NULL)) != -1) {
+        switch (c) {
+        case 'f':     g_sim.flash_path    = optarg; break;
+        case 'l':     g_sim.link_path     = optarg; break;
+        case 'b':     g_sim.baud          = strtol(optarg, NULL, 10); break;
+        case O_BUSY:  g_sim.busy          = true; break;
+        case O_TRACE: g_sim.trace_gpio    = true; break;
+        case O_MOSI:  g_sim.spi_mosi_path = optarg; break;
+        case O_CAP:   g_sim.spi_capture   = optarg; break;
+        case O_RATE:  g_sim.spi_rate      = strtod(optarg, NULL); break;
+        case O_WORDS: g_sim.spi_words     = strtoull(optarg, NULL, 10); break;
+        case O_DRIVE:
+            if (g_sim.drive_count >= SIM_MAX_DRIVES ||
+                parse_drive(optarg, &g_sim.drives[g_sim.drive_count]) != 0) {
+                fprintf(stderr, "bad --drive '%s' (expected e.g. D3=1@5)\n", optarg);
+                return -1;
+            }
+            g_sim.drive_count++;
+            break;
+        case 'h':
+            usage(stdout, argv[0]);
+            exit(0);
+        default:
+            usage(stderr, argv[0]);
+            return -1;
+        }
+    }
+    if (optind < argc || g_sim.baud < -1) {
+        usage(stderr, argv[0]);
+        return -1;
+    }
+    return 0;
+}
+
+/* pty’yi aç (ya da reset öncesinden devral). Slave ucu da açık tutulur:
+ * host bağlı değilken master okuması EIO yerine bekler. */
+static int pty_open(void)
+{
+    const char *env = getenv(SIM_ENV_PTY);
+    if (env && sscanf(env, "%d,%d", &s_pty_master, &s_pty_slave) == 2)
+        return 0;
+
+    s_pty_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (s_pty_master < 0 || grantpt(s_pty_master) != 0 || unlockpt(s_pty_master) != 0) {
+        perror("posix_openpt");
+        return -1;
+    }
+    s_pty_slave = open(ptsname(s_pty_master), O_RDWR | O_NOCTTY);
+    if (s_pty_slave < 0) { perror("pty slave"); return -1; }
+
+    struct termios t;
+    tcgetattr(s_pty_slave, &t);
+    cfmakeraw(&t);
+    tcsetattr(s_pty_slave, TCSANOW, &t);
+
+    if (g_sim.link_path) {
+        unlink(g_sim.link_path);
+        if (symlink(ptsname(s_pty_master), g_sim.link_path) != 0)
+            perror(g_sim.link_path);
+    }
+    return 0;
+}
+
+static void print_stats(FILE *f)
+{
+    fprintf(f, "--- sim stats (%.3f s) ---\n", (double)sim_now_ns() / 1e9);
+    sim_uart_stats(f);
+    sim_spi_stats(f);
+    sim_pit_stats(f);
+    sim_gpio_stats(f);
+    sim_flash_stats(f);
+}
+
+static void *signal_thread(void *arg)
+{
+    sigset_t *set = (sigset_t *)arg;
+    int sig = 0;
+    sigwait(set, &sig);
+    print_stats(stderr);
+    if (g_sim.link_path) unlink(g_sim.link_path);
+    _exit(0);
+    return NULL;
+}
+
+void NVIC_SystemReset(void)
+{
+    char env[32];
+    snprintf(env, sizeof(env), "%d,%d", s_pty_master, s_pty_slave);
+    setenv(SIM_ENV_PTY, env, 1);
+    fcntl(s_pty_master, F_SETFD, 0);
+    fcntl(s_pty_slave,  F_SETFD, 0);
+
+    fprintf(stderr, "[sim] NVIC_SystemReset\n");
+    print_stats(stderr);
+    execv("/proc/self/exe", s_argv);
+    perror("execv");
+    _exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    s_argv = argv;
+    if (parse_args(argc, argv) != 0) return 2;
+
+    sim_core_init();
+    if (pty_open() != 0) return 1;
+    if (sim_flash_map(g_sim.flash_path) != 0) return 1;
+
+    /* Sinyaller yalnız sinyal iş parçacığına gelsin (sim iş parçacıkları maskeyi miras alır) */
+    static sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGINT);
+    sigaddset(&set, SIGTERM);
+    sigaddset(&set, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    pthread_t st;
+    pthread_create(&st, NULL, signal_thread, &set);
+    pthread_detach(st);
+
+    printf("pty: %s\n", ptsname(s_pty_master));
+    if (g_sim.link_path) printf("link: %s\n", g_sim.link_path);
+    fflush(stdout);
+
+    sim_uart_attach(s_pty_master);
+    sim_pit_start();
+    return firmware_main();
+}
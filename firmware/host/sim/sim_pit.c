@@ -0,0 +1,98 @@
+/*
+ * sim_pit.c
+ *
+ *  PIT kanal 0 karşılığı: timer çalışırken bir iş parçacığı periyot başına
+ *  bir kez PIT0_IRQHandler() çağırır (firmware’in pit_init.c’si değişmeden).
+ *
+ *  - Tick sayısı başlangıç anından saate göre hesaplanır; uyanma gecikmesi
+ *    birikmez, geciken tick’ler toplu teslim edilir (g_tick hiç geri kalmaz).
+ *  - execute() ana iş parçacığında g_tick’i döner beklerken bu iş parçacığı
+ *    ayrı çekirdekte çalışır; donanımda kesmenin ana kodu bölmesine denk.
+ */
+
+#include <pthread.h>
+#include "sim.h"
+
+PIT_Type sim_pit;
+
+void PIT0_IRQHandler(void);
+
+static pthread_mutex_t s_mx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  s_cv = PTHREAD_COND_INITIALIZER;
+static bool            s_running;
+static uint64_t        s_gen;              /* Start/Stop sayacı (iş parçacığı eskiyi bırakır) */
+static uint64_t        s_period_ns = 10000u;
+static uint64_t        s_start_ns;
+static uint64_t        s_ticks;            /* Toplam teslim edilen tick */
+
+static void *pit_thread(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&s_mx);
+        while (!s_running) pthread_cond_wait(&s_cv, &s_mx);
+        uint64_t gen = s_gen, t0 = s_start_ns, per = s_period_ns;
+        pthread_mutex_unlock(&s_mx);
+
+        uint64_t done = 0;
+        for (;;) {
+            sim_sleep_until(t0 + (done + 1u) * per);
+            if (__atomic_load_n(&s_gen, __ATOMIC_ACQUIRE) != gen) break;
+
+            uint64_t due = (sim_now_ns() - t0) / per;
+            while (done < due) {
+                PIT0_IRQHandler();
+                done++;
+            }
+        }
+        __atomic_add_fetch(&s_ticks, done, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+void sim_pit_start(void)
+{
+    pthread_t t;
+    pthread_create(&t, NULL, pit_thread, NULL);
+    pthread_detach(t);
+}
+
+void sim_pit_stats(FILE *f)
+{
+    fprintf(f, "pit: %llu ticks of %llu us\n",
+            (unsigned long long)__atomic_load_n(&s_ticks, __ATOMIC_RELAXED),
+            (unsigned long long)(s_period_ns / 1000u));
+}
+
+/* ------------------------------- SDK yüzü --------------------------------- */
+
+/* count: bus clock cinsinden yükleme değeri (pit_init: 10 µs) */
+void PIT_SetTimerPeriod(PIT_Type *base, pit_chnl_t ch, uint32_t count)
+{
+    (void)base; (void)ch;
+    pthread_mutex_lock(&s_mx);
+    s_period_ns = count ? (uint64_t)count * 1000000000u / SIM_BUS_CLOCK_HZ : 10000u;
+    if (!s_period_ns) s_period_ns = 1u;
+    pthread_mutex_unlock(&s_mx);
+}
+
+/* Donanımdaki gibi: start sayacı baştan yükler */
+void PIT_StartTimer(PIT_Type *base, pit_chnl_t ch)
+{
+    (void)base; (void)ch;
+    pthread_mutex_lock(&s_mx);
+    __atomic_add_fetch(&s_gen, 1u, __ATOMIC_RELEASE);
+    s_start_ns = sim_now_ns();
+    s_running  = true;
+    pthread_cond_signal(&s_cv);
+    pthread_mutex_unlock(&s_mx);
+}
+
+void PIT_StopTimer(PIT_Type *base, pit_chnl_t ch)
+{
+    (void)base; (void)ch;
+    pthread_mutex_lock(&s_mx);
+    __atomic_add_fetch(&s_gen, 1u, __ATOMIC_RELEASE);
+    s_running = false;
+    pthread_mutex_unlock(&s_mx);
+}
@@ -0,0 +1,222 @@
+/*
+ * sim_spi.c
+ *
+ *  SPI0 (DSPI, slave) karşılığı ve betiklenebilir SPI master.
+ *
+ *  - Master, transfer başlamış ve RFDF kesmesi açıkken kelime saatler:
+ *    --spi-rate kelime/s hızında (0: slave’in ISR’ı yetiştiği kadar), 4
+ *    kelimelik RX FIFO’ya iter ve SPI0_IRQHandler()’ı ana döngüde çağırır.
+ *    Kesme kapalıyken (round arası) master bekler; yani el sıkışmalı bir
+ *    master gibidir, FIFO taşması/TX underflow simüle edilmez.
+ *  - MOSI: --spi-mosi dosyasındaki kelimeler (≤8 bit 1 byte, 9..16 bit 2 byte
+ *    LE; dosya sonunda başa döner) ya da 0,1,2… sayacı; her oturum baştan.
+ *  - MISO: slave’in DSPI_SlaveWriteData ile yazdığı her kelime aynı düzende
+ *    --spi-capture dosyasına eklenir (host’un gönderdiği DATA ile kıyaslanır).
+ *  - --spi-words: oturum başına master’ın saatleyeceği azami kelime.
+ *  - eDMA veri yolu (CSPI_FLAG_DMA) simüle edilmez: spi_dma.c 32-bit adres
+ *    aritmetiğine dayanır; cspi_dma_init oturumu IRQ yoluna düşürür.
+ */
+
+#include <stdlib.h>
+#include "sim.h"
+#include "action/action.h"
+#include "spi/spi.h"
+
+SPI_Type sim_spi0;
+
+void SPI0_IRQHandler(void);
+
+#define SIM_SPI_FIFO  4u
+
+static bool     s_started;
+static uint32_t s_rser;                  /* Açık kesme/DMA istekleri */
+static uint32_t s_bits = 8u;
+static uint32_t s_fifo[SIM_SPI_FIFO];
+static uint32_t s_fifo_n, s_fifo_rd;
+
+static uint64_t s_next_ns;               /* Sıradaki kelimenin zamanı (--spi-rate) */
+static uint64_t s_sess_words;            /* Bu oturumda saatlenen kelime */
+static bool     s_fresh;                 /* Oturum henüz kelime görmedi */
+static uint8_t *s_mosi;                  /* --spi-mosi içeriği */
+static size_t   s_mosi_len, s_mosi_pos;
+static bool     s_mosi_loaded;
+static uint32_t s_counter;
+static FILE    *s_cap;
+
+static uint64_t s_sessions, s_words, s_miso_words, s_irqs;
+
+static inline uint32_t word_bytes(void) { return s_bits > 8u ? 2u : 1u; }
+static inline uint32_t word_mask(void)  { return (s_bits >= 32u) ? 0xFFFFFFFFu : ((1u << s_bits) - 1u); }
+
+static void mosi_load(void)
+{
+    s_mosi_loaded = true;
+    if (!g_sim.spi_mosi_path) return;
+
+    FILE *f = fopen(g_sim.spi_mosi_path, "rb");
+    if (!f) { perror(g_sim.spi_mosi_path); return; }
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (n > 0 && (s_mosi = (uint8_t *)malloc((size_t)n)) != NULL)
+        s_mosi_len = fread(s_mosi, 1, (size_t)n, f);
+    fclose(f);
+}
+
+static uint32_t mosi_next(void)
+{
+    uint32_t wb = word_bytes();
+    if (s_mosi_len < wb) return (s_counter++) & word_mask();
+
+    if (s_mosi_pos + wb > s_mosi_len) s_mosi_pos = 0;
+    uint32_t w = s_mosi[s_mosi_pos];
+    if (wb == 2u) w |= (uint32_t)s_mosi[s_mosi_pos + 1u] << 8;
+    s_mosi_pos += wb;
+    return w & word_mask();
+}
+
+static inline bool master_active(void)
+{
+    return s_started && (s_rser & kDSPI_RxFifoDrainRequestInterruptEnable) &&
+           (!g_sim.spi_words || s_sess_words < g_sim.spi_words);
+}
+
+static inline void fifo_push(uint32_t w)
+{
+    s_fifo[(s_fifo_rd + s_fifo_n) % SIM_SPI_FIFO] = w;
+    s_fifo_n++;
+    if (s_fresh) { s_fresh = false; s_sessions++; }
+    s_sess_words++;
+    s_words++;
+}
+
+/* Zamanı gelen kelimeleri FIFO’ya koy, slave ISR’ını çağır */
+bool sim_spi_service(void)
+{
+    if (!master_active()) return false;
+
+    if (g_sim.spi_rate > 0) {
+        uint64_t per = (uint64_t)(1e9 / g_sim.spi_rate);
+        uint64_t now = sim_now_ns();
+        if (!per) per = 1u;
+        if (s_next_ns + SIM_SPI_FIFO * per < now) s_next_ns = now;   /* Duraklamadan sonra patlama yok */
+        while (s_fifo_n < SIM_SPI_FIFO && s_next_ns <= now && master_active()) {
+            fifo_push(mosi_next());
+            s_next_ns += per;
+        }
+    } else {
+        while (s_fifo_n < SIM_SPI_FIFO && master_active())
+            fifo_push(mosi_next());
+    }
+    if (!s_fifo_n) return false;
+
+    s_irqs++;
+    SPI0_IRQHandler();
+    return true;
+}
+
+uint64_t sim_spi_next_due_ns(void)
+{
+    if (!master_active()) return 0;
+    if (g_sim.spi_rate <= 0 || !s_next_ns) return 1u;
+    return s_next_ns;
+}
+
+void sim_spi_stats(FILE *f)
+{
+    if (s_cap) fflush(s_cap);
+    fprintf(f, "spi: %llu sessions, %llu MOSI words, %llu MISO words, %llu ISR calls\n",
+            (unsigned long long)s_sessions, (unsigned long long)s_words,
+            (unsigned long long)s_miso_words, (unsigned long long)s_irqs);
+}
+
+/* ------------------------------- SDK yüzü --------------------------------- */
+
+/* Yeni CSPI oturumu: kelime boyu alınır, master baştan başlar */
+void DSPI_SlaveInit(SPI_Type *base, const dspi_slave_config_t *cfg)
+{
+    (void)base;
+    s_bits       = cfg->ctarConfig.bitsPerFrame;
+    s_rser       = 0;
+    s_started    = false;
+    s_fifo_n     = s_fifo_rd = 0;
+    s_next_ns    = 0;
+    s_sess_words = 0;
+    s_mosi_pos   = 0;
+    s_counter    = 0;
+    s_fresh      = true;
+
+    if (!s_mosi_loaded) mosi_load();
+    if (!s_cap && g_sim.spi_capture) {
+        s_cap = fopen(g_sim.spi_capture, "wb");
+        if (!s_cap) perror(g_sim.spi_capture);
+    }
+}
+
+void DSPI_StartTransfer(SPI_Type *base) { (void)base; s_started = true; }
+void DSPI_StopTransfer(SPI_Type *base)  { (void)base; s_started = false; }
+
+void DSPI_FlushFifo(SPI_Type *base, bool flushTx, bool flushRx)
+{
+    (void)base; (void)flushTx;
+    if (flushRx) s_fifo_n = s_fifo_rd = 0;
+}
+
+uint32_t DSPI_GetStatusFlags(SPI_Type *base)
+{
+    (void)base;
+    return kDSPI_TxFifoFillRequestFlag | (s_fifo_n ? kDSPI_RxFifoDrainRequestFlag : 0u);
+}
+
+/* RFDF/TFFF FIFO durumundan türetilir; temizlemek bir şey değiştirmez */
+void DSPI_ClearStatusFlags(SPI_Type *base, uint32_t mask) { (void)base; (void)mask; }
+
+void DSPI_EnableInterrupts(SPI_Type *base, uint32_t mask)
+{
+    (void)base;
+    s_rser |= mask;
+}
+
+void DSPI_DisableInterrupts(SPI_Type *base, uint32_t mask)
+{
+    (void)base;
+    s_rser &= ~mask;
+}
+
+uint32_t DSPI_ReadData(SPI_Type *base)
+{
+    (void)base;
+    if (!s_fifo_n) return 0;
+    uint32_t w = s_fifo[s_fifo_rd];
+    s_fifo_rd = (s_fifo_rd + 1u) % SIM_SPI_FIFO;
+    s_fifo_n--;
+    return w;
+}
+
+void DSPI_SlaveWriteData(SPI_Type *base, uint32_t data)
+{
+    (void)base;
+    s_miso_words++;
+    if (!s_cap) return;
+    uint8_t b[2] = { (uint8_t)data, (uint8_t)(data >> 8) };
+    fwrite(b, 1, word_bytes(), s_cap);
+}
+
+/* ------------------------------ spi_dma.c --------------------------------- */
+
+/* eDMA istendi: oturumu IRQ yoluyla sürdür (round akışı ana döngüde aynı) */
+void cspi_dma_init(t_cspi_fields *C)
+{
+    fprintf(stderr, "[spi] eDMA path not simulated, session runs on the IRQ path\n");
+    C->use_dma = 0;
+    spi_init(C);
+}
+
+void cspi_dma_start_round(t_cspi_fields *C)
+{
+    (void)C;
+    DSPI_EnableInterrupts(SPIx, kDSPI_RxFifoDrainRequestInterruptEnable);
+    DSPI_StartTransfer(SPIx);
+}
+
+void cspi_dma_stop(void) { }
@@ -0,0 +1,210 @@
+/*
+ * sim_uart.c
+ *
+ *  UART0 + eDMA karşılığı; hat bir pty’dir.
+ *
+ *  - RX: iş parçacığı pty’den okur, her byte’ı hat süresi (10 bit / baud)
+ *    dolunca rxRing’e yazar ve DMA kanal 0’ın DADDR’ını ilerletir; firmware’in
+ *    uart_rx.c’si donanımdaki gibi DADDR’dan head’i okur. Ring taşması
+ *    donanımdaki gibi fark edilmez.
+ *  - TX: UART_SendEDMA() parçayı TX iş parçacığına verir; parça hat hızında
+ *    pty’ye yazılır, bitince tamamlanma geri çağrısı ana döngüde (sim_service)
+ *    çağrılır → uart_tx.c’nin uart_tx_on_done() akışı değişmeden çalışır.
+ *  - baud: --baud verilmezse firmware’in UART_Init’e verdiği değer; 0 ise
+ *    hat süresi yok (host tarafının tavan hızını ölçmek için).
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "sim.h"
+#include "peripherals.h"
+#include "uart/uart.h"
+
+UART_Type sim_uart0;
+
+static int                 s_fd = -1;
+static uint32_t            s_cfg_baud = UARTx_BAUDRATE;
+static uart_edma_handle_t *s_handle;
+
+static pthread_t       s_rx_thr, s_tx_thr;
+static bool            s_rx_on, s_tx_on;
+static pthread_mutex_t s_tx_mx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  s_tx_cv = PTHREAD_COND_INITIALIZER;
+static const uint8_t  *s_tx_data;   /* Hatta olan parça (NULL: boşta) */
+static size_t          s_tx_len;
+static int             s_tx_done;   /* Tamamlandı, geri çağrı bekliyor */
+
+static uint64_t s_rx_bytes, s_tx_bytes, s_tx_chunks, s_tx_lost;
+
+/* Bir byte’ın hat süresi (ns); 0: sınırsız */
+static uint64_t byte_ns(void)
+{
+    long baud = (g_sim.baud < 0) ? (long)s_cfg_baud : g_sim.baud;
+    return baud > 0 ? 10000000000ull / (uint64_t)baud : 0u;
+}
+
+/* ---------------------------------- RX ------------------------------------ */
+
+static void *rx_thread(void *arg)
+{
+    (void)arg;
+    uint8_t  buf[256];
+    uint16_t head = 0;
+    uint64_t line = 0;     /* Hattın serbest kalacağı an */
+
+    for (;;) {
+        ssize_t n = read(s_fd, buf, sizeof(buf));
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            usleep(10000);             /* Karşı uç yok (EIO): tekrar dene */
+            continue;
+        }
+
+        uint64_t bn  = byte_ns();
+        uint64_t now = sim_now_ns();
+        if (line < now) line = now;
+
+        for (ssize_t i = 0; i < n; ++i) {
+            if (bn) {
+                line += bn;            /* Byte stop bitiyle birlikte gelir */
+                sim_sleep_until(line);
+            }
+            rxRing[head] = buf[i];
+            head = (uint16_t)((head + 1u) & (UART_RX_RING_SZ - 1u));
+            __atomic_store_n(&sim_dma0_regs.TCD[DMA_CH0_DMA_CHANNEL].DADDR,
+                             (uint32_t)(uintptr_t)&rxRing[head], __ATOMIC_RELEASE);
+            if (bn) sim_notify();
+        }
+        __atomic_add_fetch(&s_rx_bytes, (uint64_t)n, __ATOMIC_RELAXED);
+        if (!bn) sim_notify();
+    }
+    return NULL;
+}
+
+/* ---------------------------------- TX ------------------------------------ */
+
+static void *tx_thread(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&s_tx_mx);
+        while (!s_tx_data) pthread_cond_wait(&s_tx_cv, &s_tx_mx);
+        const uint8_t *p   = s_tx_data;
+        size_t         len = s_tx_len;
+        pthread_mutex_unlock(&s_tx_mx);
+
+        /* Hat hızında: o ana kadar hattan çıkmış olması gereken byte’ları yaz */
+        uint64_t bn = byte_ns();
+        uint64_t t0 = sim_now_ns();
+        size_t   sent = 0;
+        while (sent < len) {
+            size_t n = len - sent;
+            if (bn) {
+                uint64_t due = (sim_now_ns() - t0) / bn;
+                if (due <= sent) {
+                    sim_sleep_until(t0 + (uint64_t)(sent + 1u) * bn);
+                    continue;
+                }
+                if (due - sent < n) n = (size_t)(due - sent);
+            }
+            ssize_t w = write(s_fd, p + sent, n);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                __atomic_add_fetch(&s_tx_lost, (uint64_t)(len - sent), __ATOMIC_RELAXED);
+                break;                 /* pty gitti: parça hattan düşmüş sayılır */
+            }
+            sent += (size_t)w;
+        }
+        __atomic_add_fetch(&s_tx_bytes, (uint64_t)sent, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&s_tx_chunks, 1u, __ATOMIC_RELAXED);
+
+        pthread_mutex_lock(&s_tx_mx);
+        s_tx_data = NULL;
+        pthread_mutex_unlock(&s_tx_mx);
+        __atomic_store_n(&s_tx_done, 1, __ATOMIC_RELEASE);
+        sim_notify();
+    }
+    return NULL;
+}
+
+/* Tamamlanan parçanın geri çağrısı (ana döngü, “kesme” bağlamı) */
+bool sim_uart_service(void)
+{
+    if (!__atomic_load_n(&s_tx_done, __ATOMIC_ACQUIRE)) return false;
+    __atomic_store_n(&s_tx_done, 0, __ATOMIC_RELAXED);
+    if (s_handle && s_handle->callback)
+        s_handle->callback(UART0, s_handle, kStatus_UART_TxIdle, s_handle->userData);
+    return true;
+}
+
+void sim_uart_attach(int pty_fd)
+{
+    s_fd = pty_fd;
+}
+
+void sim_uart_stats(FILE *f)
+{
+    fprintf(f, "uart: rx=%llu B tx=%llu B in %llu DMA chunks, lost=%llu B, line=%llu baud\n",
+            (unsigned long long)s_rx_bytes, (unsigned long long)s_tx_bytes,
+            (unsigned long long)s_tx_chunks, (unsigned long long)s_tx_lost,
+            (unsigned long long)(byte_ns() ? 10000000000ull / byte_ns() : 0u));
+}
+
+/* ------------------------------- SDK yüzü --------------------------------- */
+
+void UART_GetDefaultConfig(uart_config_t *cfg)
+{
+    cfg->baudRate_Bps = 115200u;
+    cfg->enableTx     = false;
+    cfg->enableRx     = false;
+}
+
+status_t UART_Init(UART_Type *base, const uart_config_t *cfg, uint32_t srcClock_Hz)
+{
+    (void)base; (void)srcClock_Hz;
+    s_cfg_baud = cfg->baudRate_Bps;
+    return kStatus_Success;
+}
+
+void UART_EnableTxDMA(UART_Type *base, bool enable) { (void)base; (void)enable; }
+
+/* RX DMA açılınca hat dinlenmeye başlar */
+void UART_EnableRxDMA(UART_Type *base, bool enable)
+{
+    (void)base;
+    if (enable && !s_rx_on && s_fd >= 0)
+        s_rx_on = pthread_create(&s_rx_thr, NULL, rx_thread, NULL) == 0;
+}
+
+void UART_TransferCreateHandleEDMA(UART_Type *base, uart_edma_handle_t *h,
+                                   uart_edma_transfer_callback_t cb, void *userData,
+                                   edma_handle_t *txEdma, edma_handle_t *rxEdma)
+{
+    (void)base;
+    h->callback     = cb;
+    h->userData     = userData;
+    h->txEdmaHandle = txEdma;
+    h->rxEdmaHandle = rxEdma;
+    s_handle        = h;
+
+    if (!s_tx_on && s_fd >= 0)
+        s_tx_on = pthread_create(&s_tx_thr, NULL, tx_thread, NULL) == 0;
+}
+
+status_t UART_SendEDMA(UART_Type *base, uart_edma_handle_t *h, uart_transfer_t *xfer)
+{
+    (void)base; (void)h;
+    if (!xfer || !xfer->data || !xfer->dataSize) return kStatus_InvalidArgument;
+
+    pthread_mutex_lock(&s_tx_mx);
+    if (s_tx_data) {                   /* SDK: önceki transfer sürüyor */
+        pthread_mutex_unlock(&s_tx_mx);
+        return kStatus_Fail;
+    }
+    s_tx_data = xfer->data;
+    s_tx_len  = xfer->dataSize;
+    pthread_cond_signal(&s_tx_cv);
+    pthread_mutex_unlock(&s_tx_mx);
+    return kStatus_Success;
+}
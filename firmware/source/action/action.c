@@ -8,19 +8,6 @@
 #include "action.h"
 #include "pit/pit.h"
 
-/* 16-bit big-endian oku (wire’dan kısa okuma yardımcı) */
-static inline uint16_t u16be(const uint8_t *p) {
-    return (uint16_t)((uint16_t)p[0] << 8) | (uint16_t)p[1];
-}
-
-/* 32-bit big-endian oku (wire’dan uzun okuma yardımcı) */
-static inline uint32_t u32be(const uint8_t *p) {
-    return ((uint32_t)p[0] << 24) |
-           ((uint32_t)p[1] << 16) |
-           ((uint32_t)p[2] << 8)  |
-           ((uint32_t)p[3]);
-}
-
 /* (ms,us) → PIT tick dönüştürme (en yakın tick’e yuvarlar, saturasyon var) */
 static inline uint32_t msus_to_ticks(uint32_t ms, uint16_t us)
 {
@@ -46,7 +33,7 @@ void free_actions(t_action_set *S)
 }
 
 /*
- * Wire format
+ * Wire format (kayıt başları: proto/proto_schema.h)
  * START:       [01][ID][TCOUNT][TIDS...]
  * DELAY:       [02][ID][MS:4BE][US:2BE][TCOUNT][TIDS...]
  * PIN_READ:    [03][ID][PORT][PIN][INIT][TARGET][FINAL][MS:4BE][US:2BE][TCOUNT][TIDS...]
@@ -56,66 +43,53 @@ void free_actions(t_action_set *S)
  * Dönüş kodları (<0): -1 arg, -10.. uzunluk, -21 tip, -30/31 alloc hatası.
  */
 
+/* Hedef listesini kopyalar; p TCOUNT’u gösterir, listenin sonunu döndürür */
+static const uint8_t *take_targets(const uint8_t *p, t_action_rec *a)
+{
+    uint8_t ct = *p++;
+    a->target_count = ct;
+    if (ct) {
+        a->targets = (uint8_t*)malloc((size_t)ct);
+        if (!a->targets) return NULL;
+        memcpy(a->targets, p, ct);
+    }
+    return p + ct;
+}
+
 /* İki geçişli parser: 1) doğrula&max ID bul, 2) ID indeksli diziye doldur */
 int parse_actions(const uint8_t *pl, uint16_t len, t_action_set *S)
 {
     if (!pl || !S) return -1;
     memset(S, 0, sizeof(*S));
 
-    uint16_t i = 0;
+    uint32_t i = 0;
     int max_id = -1;
 
     /* Geçiş-1: uzunluk kontrolü ve max ID tespiti (hafızayı doğru boyutlamak için) */
     while (i < len) {
         if (i + 2 > len) return -10;
-        uint8_t type = pl[i++];
-        uint8_t id   = pl[i++];
+        uint8_t type = pl[i];
+        uint8_t id   = pl[i + 1];
         if (id > max_id) max_id = id;
 
+        /* Kayıt başı (TYPE,ID dahil) + TCOUNT; tipe göre hata kodları */
+        uint32_t head;
+        int      e_head, e_tids;
         switch (type) {
-        case TYPE_START: {
-            if (i + 1 > len) return -12;
-            uint8_t ct = pl[i++];
-            if (i + ct > len) return -14;
-            i += ct;  /* target ID’leri atla */
-        } break;
-
-        case TYPE_DELAY: {
-            /* 4B ms + 2B us + 1B ct + ctB ids */
-            if (i + 4 + 2 + 1 > len) return -15;
-            i += 4;  /* ms */
-            i += 2;  /* us */
-            uint8_t ct = pl[i++];
-            if (i + ct > len) return -17;
-            i += ct;
-        } break;
-
+        case TYPE_START:       head = PROTO_START_SIZE;       e_head = -12; e_tids = -14; break;
+        case TYPE_DELAY:       head = PROTO_DELAY_SIZE;       e_head = -15; e_tids = -17; break;
         case TYPE_PIN_READ:
-        case TYPE_PIN_WRITE: {
-            /* 1+1+1+1+1 + 4 + 2 + 1 + ct */
-            if (i + 5 + 4 + 2 + 1 > len) return -18;
-            i += 5;  /* port,pin,init,target,final */
-            i += 4;  /* ms */
-            i += 2;  /* us */
-            uint8_t ct = pl[i++];
-            if (i + ct > len) return -20;
-            i += ct;
-        } break;
-
-        case TYPE_PIN_TRIGGER: {
-            /* 1+1+1+1 + 4 + 2 + 1 + ct */
-            if (i + 4 + 4 + 2 + 1 > len) return -22;
-            i += 4;  /* port,pin,init,target */
-            i += 4;  /* timeout_ms */
-            i += 2;  /* timeout_us */
-            uint8_t ct = pl[i++];
-            if (i + ct > len) return -23;
-            i += ct;
-        } break;
-
+        case TYPE_PIN_WRITE:   head = PROTO_PIN_WRITE_SIZE;   e_head = -18; e_tids = -20; break;
+        case TYPE_PIN_TRIGGER: head = PROTO_PIN_TRIGGER_SIZE; e_head = -22; e_tids = -23; break;
         default:
             return -21;  /* bilinmeyen tip */
         }
+
+        if (i + head + 1 > len) return e_head;
+        uint8_t ct = pl[i + head];
+        i += head + 1;
+        if (i + ct > len) return e_tids;
+        i += ct;  /* target ID’leri atla */
     }
 
     int N = (max_id >= 0) ? (max_id + 1) : 0;
@@ -126,97 +100,65 @@ int parse_actions(const uint8_t *pl, uint16_t len, t_action_set *S)
     S->count = N;
 
     /* Geçiş-2: kayıtları ID alanına göre doldur (hedef listesi varsa malloc) */
-    i = 0;
-    while (i < len) {
+    const uint8_t *p   = pl;
+    const uint8_t *end = pl + len;
+    while (p < end) {
         t_action_rec a; memset(&a, 0, sizeof(a));
-        a.type   = pl[i++];
-        a.id     = pl[i++];
+        a.type   = p[0];
+        a.id     = p[1];
         a.status = STATUS_IDLE;
         a.error  = ERROR_NONE;
 
         switch (a.type) {
         case TYPE_START: {
-            uint8_t ct = pl[i++];
-            a.target_count = ct;
-            if (ct) {
-                a.targets = (uint8_t*)malloc((size_t)ct);
-                if (!a.targets) { free_actions(S); return -31; }
-                for (uint8_t k=0; k<ct; k++) a.targets[k] = pl[i++];
-            }
+            t_proto_start r;
+            p = proto_get_start(p, &r);
         } break;
 
         case TYPE_DELAY: {
-            a.u.delay.duration_ms = u32be(&pl[i]); i += 4;
-            a.u.delay.duration_us = u16be(&pl[i]); i += 2;
-            a.u.delay.duration_ticks = msus_to_ticks(a.u.delay.duration_ms, a.u.delay.duration_us);
-
-            uint8_t ct = pl[i++];
-            a.target_count = ct;
-            if (ct) {
-                a.targets = (uint8_t*)malloc((size_t)ct);
-                if (!a.targets) { free_actions(S); return -31; }
-                for (uint8_t k=0; k<ct; k++) a.targets[k] = pl[i++];
-            }
+            t_proto_delay r;
+            p = proto_get_delay(p, &r);
+            a.u.delay.duration_ms    = r.ms;
+            a.u.delay.duration_us    = r.us;
+            a.u.delay.duration_ticks = msus_to_ticks(r.ms, r.us);
+        } break;
+
+        case TYPE_PIN_READ: {
+            t_proto_pin_read r;
+            p = proto_get_pin_read(p, &r);
+            a.u.pin_read.port           = r.port;
+            a.u.pin_read.pin            = r.pin;
+            a.u.pin_read.initial        = r.initial;
+            a.u.pin_read.target         = r.target;
+            a.u.pin_read.final          = r.final;
+            a.u.pin_read.duration_ms    = r.ms;
+            a.u.pin_read.duration_us    = r.us;
+            a.u.pin_read.duration_ticks = msus_to_ticks(r.ms, r.us);
         } break;
 
-        case TYPE_PIN_READ:
         case TYPE_PIN_WRITE: {
-            /* Ortak alanları topla, tipe göre union’a yerleştir (ticks önceden hesap) */
-            uint8_t port  = pl[i++], pin = pl[i++];
-            uint8_t init  = pl[i++], tgt = pl[i++], fin = pl[i++];
-            uint32_t dur_ms = u32be(&pl[i]); i += 4;
-            uint16_t dur_us = u16be(&pl[i]); i += 2;
-            uint8_t ct      = pl[i++];
-
-            if (a.type == TYPE_PIN_READ) {
-                a.u.pin_read.port    = port;
-                a.u.pin_read.pin     = pin;
-                a.u.pin_read.initial = init;
-                a.u.pin_read.target  = tgt;
-                a.u.pin_read.final   = fin;
-                a.u.pin_read.duration_ms    = dur_ms;
-                a.u.pin_read.duration_us    = dur_us;
-                a.u.pin_read.duration_ticks = msus_to_ticks(dur_ms, dur_us);
-            } else {
-                a.u.pin_write.port    = port;
-                a.u.pin_write.pin     = pin;
-                a.u.pin_write.initial = init;
-                a.u.pin_write.target  = tgt;
-                a.u.pin_write.final   = fin;
-                a.u.pin_write.duration_ms    = dur_ms;
-                a.u.pin_write.duration_us    = dur_us;
-                a.u.pin_write.duration_ticks = msus_to_ticks(dur_ms, dur_us);
-            }
-
-            a.target_count = ct;
-            if (ct) {
-                a.targets = (uint8_t*)malloc((size_t)ct);
-                if (!a.targets) { free_actions(S); return -31; }
-                for (uint8_t k=0; k<ct; k++) a.targets[k] = pl[i++];
-            }
+            t_proto_pin_write r;
+            p = proto_get_pin_write(p, &r);
+            a.u.pin_write.port           = r.port;
+            a.u.pin_write.pin            = r.pin;
+            a.u.pin_write.initial        = r.initial;
+            a.u.pin_write.target         = r.target;
+            a.u.pin_write.final          = r.final;
+            a.u.pin_write.duration_ms    = r.ms;
+            a.u.pin_write.duration_us    = r.us;
+            a.u.pin_write.duration_ticks = msus_to_ticks(r.ms, r.us);
         } break;
 
         case TYPE_PIN_TRIGGER: {
-            uint8_t port = pl[i++], pin = pl[i++];
-            uint8_t init = pl[i++], tgt = pl[i++];
-            uint32_t timeout_ms = u32be(&pl[i]); i += 4;
-            uint16_t timeout_us = u16be(&pl[i]); i += 2;
-            uint8_t ct          = pl[i++];
-
-            a.u.pin_trigger.port         = port;
-            a.u.pin_trigger.pin          = pin;
-            a.u.pin_trigger.initial      = init;
-            a.u.pin_trigger.target       = tgt;
-            a.u.pin_trigger.timeout_ms   = timeout_ms;
-            a.u.pin_trigger.timeout_us   = timeout_us;
-            a.u.pin_trigger.duration_ticks = msus_to_ticks(timeout_ms, timeout_us);
-
-            a.target_count = ct;
-            if (ct) {
-                a.targets = (uint8_t*)malloc((size_t)ct);
-                if (!a.targets) { free_actions(S); return -31; }
-                for (uint8_t k=0; k<ct; k++) a.targets[k] = pl[i++];
-            }
+            t_proto_pin_trigger r;
+            p = proto_get_pin_trigger(p, &r);
+            a.u.pin_trigger.port           = r.port;
+            a.u.pin_trigger.pin            = r.pin;
+            a.u.pin_trigger.initial        = r.initial;
+            a.u.pin_trigger.target         = r.target;
+            a.u.pin_trigger.timeout_ms     = r.timeout_ms;
+            a.u.pin_trigger.timeout_us     = r.timeout_us;
+            a.u.pin_trigger.duration_ticks = msus_to_ticks(r.timeout_ms, r.timeout_us);
         } break;
 
         default:
@@ -224,6 +166,9 @@ int parse_actions(const uint8_t *pl, uint16_t len, t_action_set *S)
             return -21;  /* ilk geçişte yakalanmalıydı */
         }
 
+        p = take_targets(p, &a);
+        if (!p) { free_actions(S); return -31; }
+
         /* ID’ye göre yerleştir (ilk geçişte N = max_id+1 boyutlandı) */
         S->actions[a.id] = a;
     }
@@ -235,29 +180,38 @@ int parse_actions(const uint8_t *pl, uint16_t len, t_action_set *S)
 int parse_cspi_begin(const uint8_t *pl, uint16_t len, t_cspi_fields *C)
 {
     if (!pl || !C) return -1;
-    if (len < 13)  return -2;
+    if (len < PROTO_CSPI_BEGIN_SIZE - 1) return -2;   /* flags opsiyonel */
+
+    /* Eski host’lar flags byte’ını yollamaz: eksik kısım 0 kabul edilir */
+    uint8_t raw[PROTO_CSPI_BEGIN_SIZE] = {0};
+    memcpy(raw, pl, (len < sizeof(raw)) ? len : sizeof(raw));
+    t_proto_cspi_begin r;
+    proto_get_cspi_begin(raw, &r);
 
     memset(C, 0, sizeof(*C));
 
-    C->mode          = pl[0];                /* SPI mode (0..3) */
-    C->word_size     = pl[1];                /* şu an 8 bit destekli */
-    C->rx_size       = u16be(&pl[2]);        /* Masterdan okunacak veri boyutu */
-    C->transfer_size = pl[4];                /* Mastera her roundda gönderilecek veri */
-    C->threshold_val = u32be(&pl[7]);        /* projeye özgü eşik/değer */
-    C->port          = pl[11];				 /* Uyarı için pin ve port */
-    C->pin           = pl[12];
+    C->mode          = r.mode;               /* SPI mode (0..3) */
+    C->word_size     = r.word_size;          /* 4..16 bit (DSPI çerçeve boyu) */
+    C->rx_size       = r.rx_size;            /* Masterdan okunacak veri boyutu */
+    C->transfer_size = r.transfer_size;      /* Mastera her roundda gönderilecek veri */
+    C->threshold_val = r.threshold;          /* projeye özgü eşik/değer */
+    C->port          = r.port;               /* Uyarı için pin ve port */
+    C->pin           = r.pin;
+    C->use_dma       = (r.flags & CSPI_FLAG_DMA) != 0; /* Opsiyonel flags byte’ı */
 
     /* Varsayılan çalışma ayarları (ring boyutu/low-watermark) */
     C->idle_fill   = 0x00;       /* TX ring boşsa gönderilecek dolgu byte’ı */
     C->tx_rb_size  = 2048;       /* TX ring kapasitesi (byte) */
     C->tx_low_wm   = 256;        /* refill için düşük eşik (ipucu) */
+    C->ring_min    = C->tx_rb_size;
 
     if (C->tx_low_wm == 0 || C->tx_low_wm >= C->tx_rb_size)
         C->tx_low_wm = (uint16_t)(C->tx_rb_size / 4);
 
     /* Basit doğrulamalar (bu uygulama kısıtları) */
     if (C->mode > 3)       return -3;  /* geçersiz SPI modu */
-    if (C->word_size != 8) return -4;  /* sadece 8-bit kelime desteklenir */
+    if (C->word_size < 4 || C->word_size > 16) return -4;  /* DSPI: 4..16 bit çerçeve */
+    C->word_bytes = (C->word_size > 8) ? 2 : 1;
 
     /* TX ring tahsisi ve indekslerin sıfırlanması */
     C->tx_rb = (uint8_t*)malloc(C->tx_rb_size);
@@ -265,9 +219,9 @@ int parse_cspi_begin(const uint8_t *pl, uint16_t len, t_cspi_fields *C)
     C->tx_rb_head = 0;
     C->tx_rb_tail = 0;
 
-    /* İsteğe bağlı RX yakalama tamponu */
+    /* İsteğe bağlı RX yakalama tamponu (round boyundan bağımsız, sabit çift tampon) */
     if (C->rx_size > 0) {
-        C->rx_data = (uint8_t*)malloc(C->rx_size);
+        C->rx_data = (uint8_t*)malloc(2u * CSPI_RX_HALF);
         if (!C->rx_data) {
             return -6;
         }
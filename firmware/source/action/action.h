@@ -7,26 +7,11 @@
 #define ACTION_H_
 
 #include <stdint.h>
+#include "proto/proto.h"   /* TYPE_*, LVL_*, CSPI_FLAG_DMA */
 
 #define MAX_ACTIONS   64   /* Tek sette desteklenen maksimum action sayısı */
 #define MAX_TARGETS   16   /* Bir action’ın referans verebileceği maksimum target sayısı */
 
-/* Action türleri (opkod benzeri) */
-enum {
-    TYPE_START       = 0x01, /* Senaryonun başlangıcı/ilk adımı işaretle */
-    TYPE_DELAY       = 0x02, /* Zaman gecikmesi (ms/us/ticks) */
-    TYPE_PIN_READ    = 0x03, /* GPIO pini oku ve (opsiyonel) seviyeyi doğrula */
-    TYPE_PIN_WRITE   = 0x04, /* GPIO pinini hedef seviyeye sür */
-    TYPE_PIN_TRIGGER = 0x05  /* Pin hedef seviyeye gelene kadar bekle (timeout’lu) */
-};
-
-/* GPIO için mantık seviyeleri */
-enum {
-    LVL_UNDEF = 0xFF, /* Başlangıçta bilinmiyor/kontrol etme */
-    LVL_LOW   = 0x00, /* Düşük seviye */
-    LVL_HIGH  = 0x01  /* Yüksek seviye */
-};
-
 /* Action yaşam döngüsü durumları */
 enum {
     STATUS_IDLE,     /* Henüz planlanmadı/beklemede */
@@ -92,23 +77,32 @@ typedef struct
 /*
  * CSPI (SPI slave) işlem demeti ayar/durumları (tek “round”u yönetir):
  * - TX ring: slave verisini besler, RX opsiyoneldir (log/validasyon için).
- * - transfer_size penceresi (1..N): round sonunda son N byte’ı 32-bit değere toplayıp threshold ile kıyaslar.
+ * - Kelime 4..16 bit: ring/RX’te ≤8 bit 1 byte, 9..16 bit 2 byte (LE) yer tutar.
+ * - transfer_size penceresi (1..N kelime): round sonunda 32 bite sığan son kelimeleri
+ *   (word_size bit kaydırarak) tek değere toplayıp threshold ile kıyaslar.
  * - Eşik sonucuna göre belirtilen GPIO çıkışı sürülür (ISR tarafında yorumlanır).
  */
 typedef struct
 {
     /* Sabit SPI konfigürasyonu */
     uint8_t   mode;             /* SPI modu (0..3), CPOL/CPHA */
-    uint8_t   word_size;        /* Çerçeve bit sayısı (bu sürüm 8 bit kullanır) */
+    uint8_t   word_size;        /* Çerçeve bit sayısı (4..16) */
+    uint8_t   word_bytes;       /* Kelime başına saklama byte’ı (1 veya 2) */
 
     /* Round bazlı karşılaştırma parametreleri */
-    uint8_t   transfer_size;    /* Round sonunda dikkate alınacak byte sayısı (maks 4’te kıstırılır) */
+    uint8_t   transfer_size;    /* Round başına kelime sayısı (eşik penceresi 32 bitte kıstırılır) */
     uint32_t  threshold_val;    /* 32-bit karşılaştırma eşiği */
 
-    /* Opsiyonel RX yakalama */
-    uint16_t  rx_size;          /* RX buffer boyu (0: kapalı) */
-    uint8_t  *rx_data;          /* RX buffer pointer’ı (sahiplik bu yapıda) */
-    volatile uint16_t rx_offset;/* ISR tarafından ilerletilen yazma ofseti */
+    /* Opsiyonel RX yakalama (çift tampon: ISR bir yarıyı doldururken diğeri host’a gider) */
+    uint16_t  rx_size;          /* Round başına yakalanacak kelime (0: kapalı) */
+    uint8_t  *rx_data;          /* 2 * CSPI_RX_HALF byte (sahiplik bu yapıda) */
+    volatile uint16_t rx_offset;/* Bu round’da yakalanan kelime */
+    volatile uint16_t rx_fill;  /* Aktif yarıdaki byte */
+    volatile uint8_t  rx_half;  /* ISR’ın yazdığı yarı (0/1) */
+    volatile uint16_t rx_ready[2]; /* Gönderilmeyi bekleyen byte (0: yarı boş) */
+    volatile uint32_t rx_dropped;  /* İki yarı da doluyken atılan kelime */
+    uint16_t  rx_seq;           /* Sonraki MSG_ID_CSPI_RX sıra numarası */
+    uint8_t   rx_tx_half;       /* Host’a sıradaki gönderilecek yarı */
 
     /* GPIO bildirim çıkışı (eşik sonucunda sürülür) */
     uint8_t   port, pin;        /* Bildirim için GPIO port/pin */
@@ -121,14 +115,29 @@ typedef struct
     volatile uint16_t tx_rb_tail;/* Tüketici indeksi (ISR) */
 
     /* Akış kontrolü / ilerleme metrikleri */
-    uint16_t  tx_low_wm;            /* Düşük su seviyesi (refill tetikleme eşiği) */
+    uint16_t  tx_low_wm;            /* Düşük su seviyesi (altında kredi periyodik tekrarlanır) */
     volatile uint8_t  bulk_active;   /* Host sürekli veri akıtıyor mu? */
     volatile uint8_t  bulk_finished; /* Host veri bitti sinyali verdi mi? */
-    volatile uint32_t tx_total_recv; /* Toplam kabul edilen TX byte (tanı) */
-
-    volatile uint16_t tx_sent_in_round; /* Mevcut round’da gönderilen byte sayısı */
+    volatile uint32_t tx_total_recv; /* Toplam kabul edilen TX byte (kredi LIMIT’inin tabanı) */
+    volatile uint32_t tx_starved;    /* Ring boşken idle_fill ile gönderilen kelime (host gecikti) */
+
+    volatile uint16_t tx_sent_in_round; /* Mevcut round’da gönderilen kelime sayısı */
+
+    /* eDMA veri yolu (flags & CSPI_FLAG_DMA) ve tanı sayaçları */
+    uint8_t   use_dma;                  /* 1: PUSHR/POPR eDMA ile beslenir, CPU yalnız round sonunda */
+    volatile uint32_t dma_rounds;       /* Tamamlanan DMA round sayısı */
+    volatile uint32_t tx_underflows;    /* DSPI TFUF görülen round sayısı */
+    volatile uint32_t max_sck_hz;       /* Underflow’suz ardışık round’larda ölçülen en yüksek bit hızı */
+
+    /* Oturum istatistikleri (MSG_ID_CSPI_STATS ile raporlanır) */
+    uint32_t  rounds;                   /* Tamamlanan round (ana döngü sayar) */
+    volatile uint32_t tx_words;         /* SPI’a kaydırılan toplam kelime (dolgu dahil) */
+    volatile uint32_t thr_hits;         /* Eşiği aşan round sayısı (GPIO high) */
+    volatile uint16_t ring_min;         /* Akış sürerken görülen en düşük ring doluluğu (byte) */
 } t_cspi_fields;
 
+#define CSPI_RX_HALF   510u   /* RX çift tampon yarısı: 255 adet 16-bit kelime; [SEQ:2]+yarı = MAX_PAYLOAD */
+
 /* Tek action kaydı (tipine göre union payload) */
 typedef struct
 {
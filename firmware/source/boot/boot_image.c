@@ -0,0 +1,261 @@
+/*
+ * boot_image.c
+ *  Boot imajı derleyici, yerinde doğrulayıcı ve XIP yürütücü (format: boot_image.h).
+ */
+
+#include <string.h>
+#include "boot_image.h"
+#include "pit/pit.h"
+#include "gpio/gpio_utils.h"
+#include "uart/uart_proto.h"
+
+extern volatile uint32_t g_tick;  /* Global PIT tick sayacı */
+
+static uint32_t s_first_edge_cyc;  /* İlk gerçek pin değişimindeki DWT değeri (0: yok) */
+
+/* Bitiş tick’i geçildi mi? (execute.c ile aynı signed fark) */
+static inline int tick_reached(uint32_t deadline)
+{
+    return (int)((int32_t)(g_tick - deadline) >= 0);
+}
+
+size_t boot_image_size(const t_action_set *S)
+{
+    size_t edges = 0;
+    for (int i = 0; i < S->count; ++i) edges += S->actions[i].target_count;
+    return sizeof(t_boot_hdr) + (size_t)S->count * sizeof(t_boot_node) + edges;
+}
+
+int boot_image_build(const t_action_set *S, uint8_t *out, size_t cap)
+{
+    if (!S || S->count <= 0 || S->count > MAX_ACTIONS) return -70;
+
+    size_t size = boot_image_size(S);
+    if (!out || size > cap || size > 0xFFFFu) return -71;
+
+    t_boot_hdr  *h     = (t_boot_hdr *)out;
+    t_boot_node *nodes = (t_boot_node *)(h + 1);
+    uint8_t     *edges = (uint8_t *)(nodes + S->count);
+    uint16_t     e     = 0;
+
+    memset(out, 0, size);
+
+    for (int i = 0; i < S->count; ++i) {
+        const t_action_rec *a = &S->actions[i];
+        t_boot_node        *n = &nodes[i];
+
+        if (a->type == 0 || a->id != (uint8_t)i) return -70;  // ID boşluğu: execute() bitiremez
+
+        n->type       = a->type;
+        n->edge_first = e;
+        n->edge_count = a->target_count;
+        for (uint8_t k = 0; k < a->target_count; ++k) {
+            if (a->targets[k] >= S->count) return -72;
+            edges[e++] = a->targets[k];
+        }
+
+        // Tipe göre süreyi ve pin alanlarını düz kayda çöz
+        switch (a->type) {
+        case TYPE_DELAY:
+            n->ticks = a->u.delay.duration_ticks;
+            break;
+        case TYPE_PIN_READ:
+            n->port = a->u.pin_read.port;        n->pin    = a->u.pin_read.pin;
+            n->initial = a->u.pin_read.initial;  n->target = a->u.pin_read.target;
+            n->final = a->u.pin_read.final;      n->ticks  = a->u.pin_read.duration_ticks;
+            break;
+        case TYPE_PIN_WRITE:
+            n->port = a->u.pin_write.port;       n->pin    = a->u.pin_write.pin;
+            n->initial = a->u.pin_write.initial; n->target = a->u.pin_write.target;
+            n->final = a->u.pin_write.final;     n->ticks  = a->u.pin_write.duration_ticks;
+            break;
+        case TYPE_PIN_TRIGGER:
+            n->port = a->u.pin_trigger.port;       n->pin    = a->u.pin_trigger.pin;
+            n->initial = a->u.pin_trigger.initial; n->target = a->u.pin_trigger.target;
+            n->final = LVL_UNDEF;                  n->ticks  = a->u.pin_trigger.duration_ticks;
+            break;
+        default:
+            break;
+        }
+    }
+
+    h->magic      = BOOT_IMG_MAGIC;
+    h->version    = BOOT_IMG_VERSION;
+    h->size       = (uint16_t)size;
+    h->node_count = (uint8_t)S->count;
+    h->edge_count = e;
+    h->crc        = crc16_block(0xFFFF, out + sizeof(t_boot_hdr), size - sizeof(t_boot_hdr));
+    return (int)size;
+}
+
+const t_boot_hdr *boot_image_check(const uint8_t *img, uint16_t len)
+{
+    if (!img || len < sizeof(t_boot_hdr) || ((uintptr_t)img & 3u)) return NULL;
+
+    const t_boot_hdr *h = (const t_boot_hdr *)img;
+    if (h->magic != BOOT_IMG_MAGIC || h->version != BOOT_IMG_VERSION) return NULL;
+    if (h->size != len || h->node_count == 0 || h->node_count > MAX_ACTIONS) return NULL;
+
+    size_t expect = sizeof(t_boot_hdr) + (size_t)h->node_count * sizeof(t_boot_node) + h->edge_count;
+    if (expect != len) return NULL;
+
+    if (crc16_block(0xFFFF, img + sizeof(t_boot_hdr), len - sizeof(t_boot_hdr)) != h->crc) return NULL;
+
+    // Kenar aralıkları ve hedefler imaj içinde mi? (yürütücü indeksleri kontrolsüz kullanır)
+    const t_boot_node *nodes = (const t_boot_node *)(h + 1);
+    const uint8_t     *edges = (const uint8_t *)(nodes + h->node_count);
+    for (uint8_t i = 0; i < h->node_count; ++i) {
+        if ((uint32_t)nodes[i].edge_first + nodes[i].edge_count > h->edge_count) return NULL;
+    }
+    for (uint16_t k = 0; k < h->edge_count; ++k) {
+        if (edges[k] >= h->node_count) return NULL;
+    }
+    return h;
+}
+
+/* İlk kenar zaman damgası: yalnızca gerçekten değişen bir seviyede alınır */
+static inline void boot_mark_edge(void)
+{
+    if (!s_first_edge_cyc) s_first_edge_cyc = DWT->CYCCNT;
+}
+
+/* lvl’i sür (UNDEF: dokunma); seviye değişiyorsa ilk kenarı işaretle */
+static void boot_drive(const t_boot_node *n, uint8_t lvl)
+{
+    if (lvl != LVL_HIGH && lvl != LVL_LOW) return;
+    uint8_t cur = gpio_read((gpio_port_t)n->port, n->pin);   // 0xFF: geçersiz port
+    if (cur <= 1u && cur != (lvl == LVL_HIGH)) boot_mark_edge();
+    if (lvl == LVL_HIGH) gpio_write_high((gpio_port_t)n->port, n->pin);
+    else                 gpio_write_low((gpio_port_t)n->port, n->pin);
+}
+
+/* init_pins() ile aynı kurulum, düz düğüm dizisi üzerinden */
+static void boot_init_pins(const t_boot_node *nodes, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; ++i) {
+        const t_boot_node *n = &nodes[i];
+        if (n->port > GPIO_PORT_E || n->pin >= 32) continue;
+
+        switch (n->type) {
+        case TYPE_PIN_READ:
+        case TYPE_PIN_TRIGGER:
+            gpio_enable_clock((gpio_port_t)n->port);
+            gpio_set_mux((gpio_port_t)n->port, n->pin);
+            gpio_set_input((gpio_port_t)n->port, n->pin);
+            break;
+
+        case TYPE_PIN_WRITE:
+            gpio_enable_clock((gpio_port_t)n->port);
+            gpio_set_mux((gpio_port_t)n->port, n->pin);
+            if (n->initial == LVL_HIGH) gpio_write_high((gpio_port_t)n->port, n->pin);
+            else                        gpio_write_low((gpio_port_t)n->port, n->pin);
+            gpio_set_output((gpio_port_t)n->port, n->pin);
+            boot_mark_edge();   // Pin sürülmeye başladı: başlangıç seviyesi ilk kenardır
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+/*
+ * execute() ile aynı durum makinesi; yalnızca durum ve deadline RAM’de,
+ * düğümler/kenarlar flash’tan okunur.
+ */
+int boot_image_run(const t_boot_hdr *img)
+{
+    const t_boot_node *nodes = (const t_boot_node *)(img + 1);
+    const uint8_t     *edges = (const uint8_t *)(nodes + img->node_count);
+    const uint8_t      count = img->node_count;
+
+    uint8_t  status[MAX_ACTIONS];
+    uint32_t deadline[MAX_ACTIONS];
+
+    boot_init_pins(nodes, count);
+
+    for (uint8_t i = 0; i < count; ++i)
+        status[i] = (nodes[i].type == TYPE_START) ? STATUS_PENDING : STATUS_IDLE;
+
+    uint16_t total_done = 0;
+    pit_start();
+    while (total_done < count) {
+
+        for (uint8_t i = 0; i < count; ++i) {
+            const t_boot_node *n = &nodes[i];
+            int done = 0;
+
+            if (status[i] == STATUS_PENDING) {
+                uint32_t now = g_tick;
+                status[i] = STATUS_RUNNING;
+
+                switch (n->type) {
+                case TYPE_START:
+                    done = 1;
+                    break;
+                case TYPE_DELAY:
+                case TYPE_PIN_TRIGGER:
+                    deadline[i] = now + n->ticks;
+                    break;
+                case TYPE_PIN_WRITE:
+                    boot_drive(n, n->target);
+                    deadline[i] = now + n->ticks;
+                    break;
+                default:
+                    status[i] = STATUS_ERROR;
+                    break;
+                }
+            }
+            if (!done && status[i] == STATUS_RUNNING) {
+                switch (n->type) {
+                case TYPE_DELAY:
+                    done = tick_reached(deadline[i]);
+                    break;
+                case TYPE_PIN_WRITE:
+                    if (tick_reached(deadline[i])) {
+                        boot_drive(n, n->final);
+                        done = 1;
+                    }
+                    break;
+                case TYPE_PIN_TRIGGER:
+                    if (gpio_read((gpio_port_t)n->port, n->pin) == n->target) done = 1;
+                    else if (tick_reached(deadline[i])) status[i] = STATUS_ERROR;
+                    break;
+                default:
+                    done = 1;
+                    break;
+                }
+            }
+
+            if (status[i] == STATUS_ERROR) {
+                pit_stop();
+                return -55;
+            }
+
+            if (done) {
+                // DONE: hedefleri kenar tablosundan PENDING’e al
+                status[i] = STATUS_DONE;
+                total_done++;
+                for (uint8_t k = 0; k < n->edge_count; ++k) {
+                    uint8_t t = edges[n->edge_first + k];
+                    if (status[t] == STATUS_IDLE) status[t] = STATUS_PENDING;
+                }
+            }
+        }
+    }
+    pit_stop();
+    return 0;
+}
+
+void boot_timer_start(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+    s_first_edge_cyc = 0;
+}
+
+uint32_t boot_first_edge_us(void)
+{
+    return s_first_edge_cyc / (SystemCoreClock / 1000000u);
+}
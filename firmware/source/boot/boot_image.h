@@ -0,0 +1,74 @@
+/*
+ * boot_image.h
+ *  Boot senaryoları için önceden derlenmiş, flash’tan yerinde (XIP) çalışan imaj.
+ *
+ *  WRITE_FLASH_BOOT sırasında action blob bir kez parse edilip bu formata
+ *  derlenir: süreler PIT tick’ine çözülmüş, graf ID indeksli düz dizi,
+ *  hedefler tek bir kenar tablosunda, CRC önceden hesaplanmış. Boot’ta imaj
+ *  RAM’e kopyalanmaz, parse/malloc yapılmaz; doğrulama + yürütme doğrudan
+ *  memory-mapped flash üzerindendir (yalnızca düğüm durumları RAM’de).
+ *
+ *  Düzen (native LE, 4 byte hizalı):
+ *    t_boot_hdr | t_boot_node[node_count] | uint8_t edges[edge_count]
+ *  crc: başlık sonrası tüm byte’lar üzerinden CRC16 (CCITT-FALSE).
+ */
+
+#ifndef BOOT_BOOT_IMAGE_H_
+#define BOOT_BOOT_IMAGE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "action/action.h"
+
+#define BOOT_IMG_MAGIC    0x474D4942u  /* "BIMG" (LE) */
+#define BOOT_IMG_VERSION  1u
+
+typedef struct
+{
+    uint32_t magic;       /* BOOT_IMG_MAGIC */
+    uint16_t version;     /* BOOT_IMG_VERSION */
+    uint16_t size;        /* Başlık dahil toplam byte */
+    uint16_t crc;         /* Başlık sonrası gövdenin CRC16’sı */
+    uint8_t  node_count;  /* Düğüm sayısı (düğüm indeksi = action ID) */
+    uint8_t  rsv0;
+    uint16_t edge_count;  /* Kenar tablosu uzunluğu */
+    uint16_t rsv1;
+} t_boot_hdr;
+
+typedef struct
+{
+    uint32_t ticks;       /* Çözülmüş süre / timeout (PIT tick) */
+    uint16_t edge_first;  /* edges[] içindeki ilk hedefin indeksi */
+    uint8_t  edge_count;  /* Hedef sayısı */
+    uint8_t  type;        /* TYPE_* */
+    uint8_t  port, pin;
+    uint8_t  initial, target, final;
+    uint8_t  rsv[3];
+} t_boot_node;
+
+/* Set’ten üretilecek imajın byte boyu. */
+size_t boot_image_size(const t_action_set *S);
+
+/*
+ * Parse edilmiş seti imaja derler.
+ * Dönüş: >0 imaj boyu, <0 hata (-70 boş/fazla/boşluklu ID, -71 tampon küçük, -72 geçersiz hedef).
+ */
+int boot_image_build(const t_action_set *S, uint8_t *out, size_t cap);
+
+/* Flash’taki imajı yerinde doğrular (magic/sürüm/boyut/CRC); geçersizse NULL. */
+const t_boot_hdr *boot_image_check(const uint8_t *img, uint16_t len);
+
+/* İmajı flash’tan yürütür. Dönüş: 0 başarı, -55 yürütme hatası (execute() ile aynı). */
+int boot_image_run(const t_boot_hdr *img);
+
+/* main() girişinde DWT döngü sayacını sıfırdan başlatır (reset → ilk kenar ölçümü). */
+void boot_timer_start(void);
+
+/*
+ * boot_timer_start’tan ilk gerçek pin değişimine kadar geçen süre (µs); kenar yoksa 0.
+ * Sayılan: boot_init_pins’te sürülmeye başlayan PIN_WRITE pini ya da seviyeyi
+ * değiştiren target/final yazması (UNDEF ve aynı seviyeye yazma sayılmaz).
+ */
+uint32_t boot_first_edge_us(void);
+
+#endif /* BOOT_BOOT_IMAGE_H_ */
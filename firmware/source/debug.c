@@ -152,6 +152,7 @@ void dump_cspi(const t_cspi_fields *C)
     uart0_print("  tx_rb_head=");     uart0_print_i32(C->tx_rb_head);
     uart0_print("  tx_rb_tail=");     uart0_print_i32(C->tx_rb_tail);
     uart0_print("\r\n");
+    uart0_print("  use_dma=");        uart0_print_i32(C->use_dma);      uart0_print("\r\n");
 
     uart0_print("-----------------------\r\n");
 }
@@ -1,29 +1,104 @@
 /*
- *  Amaç: Kullanıcı flash’ındaki çerçeveyi doğrula, geçerliyse aksiyonları çalıştır.
- *  Beklenen flash formatı (UART çerçevesiyle aynı):
+ *  Amaç: Kayıt deposundaki en son boot işaretli kaydı doğrula, geçerliyse aksiyonları çalıştır.
+ *  FS_FLAG_IMAGE’lı kayıtlar boot/boot_image.h formatındadır; diğerleri UART çerçevesiyle aynı:
  *    [0]=0xAA, [1]=0x55, [2]=MSG_ID, [3]=LEN_H, [4]=LEN_L, [5..]=PAYLOAD, [5+len]=CRC_H, [6+len]=CRC_L
  */
 
 #include "flash.h"
+#include "flash_store.h"
+#include "boot/boot_image.h"
 #include "uart/uart.h"
 #include "uart/uart_proto.h"
 #include "execute/execute.h"
 #include "pit/pit.h"
 #include "debug.h"
+#include <string.h>
+
+/*
+ * Depo öncesi firmware bölgenin başına tek bir UART çerçevesi yazıyordu;
+ * flash_store_init() bu sektörü depo sektörü olmadığı için siler.
+ * Silinmeden önce geçerli eski çerçeve buf’a kopyalanır.
+ * Dönüş: >0 kopyalanan çerçeve boyu, 0 eski çerçeve yok, -1 eski çerçeve bozuk.
+ */
+static int legacy_take(uint8_t *buf, uint32_t cap)
+{
+    const uint8_t *f = (const uint8_t *)USER_FLASH_BASE;
+    if (f[0] != SOF0 || f[1] != SOF1) return 0;           // Depo sektörü ya da boş
+
+    uint16_t len  = ((uint16_t)f[3] << 8) | f[4];
+    uint32_t size = (uint32_t)len + PROTO_CORE_SIZE;
+    if ((f[2] != MSG_ID_WRITE_FLASH && f[2] != MSG_ID_WRITE_FLASH_BOOT) ||
+        len > MAX_PAYLOAD || size > cap) return -1;
+
+    uint16_t crc = crc16_block(0xFFFF, f + 2, 3u + len);
+    if (crc != (((uint16_t)f[5 + len] << 8) | f[6 + len])) return -1;
+
+    memcpy(buf, f, size);
+    return (int)size;
+}
 
 /**
- * @brief Flash’teki çerçeveyi doğrular, boot işaretliyse parse edip çalıştırır.
- * @param flash_cache Okunan çerçeve için RAM tamponu (>= MAX_PAYLOAD + PROTO_CORE_SIZE).
- * @param length şimdilik kullanılmıyor.
+ * @brief Depo indeksini kurar, en son boot işaretli kaydı çalıştırır:
+ *        derlenmiş imajsa flash’tan yerinde, eski çerçeveyse kopyalayıp parse ederek.
+ * @param flash_cache Okunan çerçeve için RAM tamponu.
+ * @param length flash_cache boyutu (>= MAX_PAYLOAD + PROTO_CORE_SIZE).
  */
 void check_flash(uint8_t *flash_cache, uint32_t length)
 {
-    (void)length; // Şimdilik kullanılmıyor.
+    // Eski tek çerçeveli format: init silmeden önce al, KEY 0’a taşı
+    int legacy = legacy_take(flash_cache, length);
+
+    // Boot’ta bir kez: tüm sektörleri tara, KEY başına en son kaydı indeksle
+    int live = flash_store_init();
+
+    if (legacy > 0) {
+        uint8_t flags = (flash_cache[2] == MSG_ID_WRITE_FLASH_BOOT) ? FS_FLAG_BOOT : 0u;
+        int st = flash_store_write(0, flags, flash_cache, (uint16_t)legacy, NULL);
+        uart0_print((st < 0) ? "Legacy flash frame lost\r\n" : "Legacy flash frame moved to key 0\r\n");
+        if (st >= 0) live++;
+    } else if (legacy < 0) {
+        uart0_print("Legacy flash cleared (invalid frame)\r\n");
+    }
+    int key  = flash_store_latest(FS_FLAG_BOOT);
+
+    uint16_t rec_len   = 0;
+    uint8_t  rec_flags = 0;
+    const uint8_t *rec = (key >= 0) ? flash_store_get((uint8_t)key, &rec_len, &rec_flags) : NULL;
+
+    // Hızlı yol: derlenmiş imaj flash’tan yerinde doğrulanıp çalıştırılır (kopya/parse/malloc yok)
+    if (rec && (rec_flags & FS_FLAG_IMAGE)) {
+        const t_boot_hdr *img = boot_image_check(rec, rec_len);
+        int st = img ? boot_image_run(img) : 0;
+
+        uart0_print("Checking flash...\r\n");
+        if (!img) {
+            uart0_print("Flash boot image invalid\r\n");
+            return;
+        }
+        uart0_print((st == -55) ? "Execution Error!!\r\n" : "Execution from flash image completed\r\n");
+        uart0_print("Boot first edge us=");
+        uart0_print_i32((int32_t)boot_first_edge_us());
+        uart0_print("\r\n");
+        return;
+    }
 
     uart0_print("Checking flash...\r\n");  // Durum bilgisi
+    uart0_print("Flash records: ");
+    uart0_print_i32(live);
+    uart0_print("\r\n");
 
-    // Flash’tan desteklenen en büyük çerçeve boyutunu oku (offset 0’dan tek çerçeve varsayımı).
-    flash_read(0, flash_cache, MAX_PAYLOAD + PROTO_CORE_SIZE);
+    if (!rec) {
+        uart0_print(live ? "Flash contains records, but none marked as bootable\r\n"
+                         : "No valid data in flash\r\n");
+        return;
+    }
+
+    // Eski kayıtlar: UART çerçevesi → RAM’e kopyala, doğrula, parse et
+    if (rec_len < PROTO_CORE_SIZE || rec_len > length) {
+        uart0_print("Flash record has invalid length\r\n");
+        return;
+    }
+    memcpy(flash_cache, rec, rec_len);
 
     // Preambl 0xAA55 mi?
     if (flash_cache[0] == 0xAA && flash_cache[1] == 0x55)
@@ -33,6 +108,10 @@ void check_flash(uint8_t *flash_cache, uint32_t length)
         {
             // PAYLOAD uzunluğu (BE16)
             uint16_t len = ((uint16_t)flash_cache[3] << 8) | flash_cache[4];
+            if ((size_t)len + PROTO_CORE_SIZE > rec_len) {
+                uart0_print("Flash frame length mismatch\r\n");  // Kayıt çerçeveden kısa
+                return;
+            }
 
             // Çekirdek alan uzunluğu: ID(1) + LEN(2) + PAYLOAD(len)
             size_t core_len  = 1u + 2u + (size_t)len;
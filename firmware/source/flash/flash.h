@@ -11,6 +11,21 @@
 
 #define FLASH_PHRASE_SIZE 8u
 
+/* P-Flash silme birimi (MK02F: 2 KB); USER_FLASH bu boyutun katı olmalı. */
+#define FLASH_SECTOR_SIZE (FSL_FEATURE_FLASH_PFLASH_BLOCK_SECTOR_SIZE)
+
+/* Karşılaştırmalı (delta) programlama sonucu; çağrılar üzerine biriktirilir, çağıran sıfırlar. */
+typedef struct
+{
+    uint32_t phrases_total;    /* Aralıktaki phrase sayısı */
+    uint32_t phrases_written;  /* FLASH_Program’a giden phrase sayısı */
+    uint32_t phrases_skipped;  /* Zaten doğru içerikte olduğu için atlanan (boş phrase’ler hariç) */
+    uint32_t sectors_erased;   /* İçeriği değiştiği için silinen sektör */
+    uint32_t sectors_skipped;  /* Aralığı dolu olduğu halde silinmesi gerekmeyen sektör */
+    uint32_t elapsed_us;       /* Bu işlemde harcanan program/erase süresi */
+    uint32_t saved_us;         /* Düz sil+yaz’a göre tahmini kazanç (boş alana ekleme: 0) */
+} t_flash_delta;
+
 /* Kullanıcı flashındaki veriyi doğrula ve varsa çalıştır. */
 void check_flash(uint8_t *flash_cache, uint32_t length);
 
@@ -20,6 +35,20 @@ status_t flash_program(uint32_t offset, const void *data, uint32_t length);
 
 status_t flash_erase(void);
 
+/* offset’in bulunduğu tek sektörü siler (offset sektör hizalı olmalı). */
+status_t flash_erase_sector(uint32_t offset);
+
+/*
+ * Mevcut içeriği memory-map üzerinden okuyup yalnızca değişen phrase’leri yazar.
+ * Yalnızca 0→1 geçişi gereken (boş olmayan ve farklı) phrase içeren sektörler silinir;
+ * böyle bir sektörün aralık dışında kalan kısmı boş değilse hiçbir şey yazılmadan
+ * kStatus_OutOfRange döner. stats NULL olabilir.
+ */
+status_t flash_program_delta(uint32_t offset, const void *data, uint32_t length, t_flash_delta *stats);
+
+/* Hiç yazılmadan atlanan phrase’leri (ör. aynı içerikli kayıt) istatistiğe ekler. */
+void flash_delta_skip(t_flash_delta *stats, uint32_t phrases);
+
 status_t flash_read(uint32_t offset, void *dst, uint32_t length);
 
 #endif /* FLASH_FLASH_H_ */
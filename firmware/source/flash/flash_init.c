@@ -12,6 +12,14 @@
 /* NXP SDK flash sürücüsü konfigürasyon yapısı. */
 static flash_config_t s_flash;
 
+/* Datasheet tipik süreleri (µs): phrase = 2 x longword program, 2 KB sektör silme. */
+#define FLASH_T_PHRASE_US_TYP   130u
+#define FLASH_T_SECTOR_US_TYP   13000u
+
+/* Delta programlamada ölçülen son ortalamalar (kazanç tahmini için). */
+static uint32_t s_t_phrase_us = FLASH_T_PHRASE_US_TYP;
+static uint32_t s_t_sector_us = FLASH_T_SECTOR_US_TYP;
+
 
 status_t flash_init(void)
 {
@@ -26,9 +34,17 @@ status_t flash_erase(void)
     return st;
 }
 
+status_t flash_erase_sector(uint32_t offset)
+{
+    if (offset % FLASH_SECTOR_SIZE)    return kStatus_InvalidArgument;  // Sektör hizasız
+    if (offset >= USER_FLASH_SIZE)     return kStatus_OutOfRange;       // Bölge dışı erişim
+
+    return FLASH_Erase(&s_flash, USER_FLASH_BASE + offset, FLASH_SECTOR_SIZE, kFLASH_ApiEraseKey);
+}
+
 /**
  * @brief Flash’a veri yazar (gerekirse hizasız baş/sonu tamponlayarak).
- * @param offset USER_FLASH_BASE’ten uzaklık (henüz implemente edilmedi).
+ * @param offset USER_FLASH_BASE’ten uzaklık (phrase hizalı olmalı).
  * @param data   Kaynak RAM tamponu.
  * @param length Yazılacak byte sayısı.
  * @return Başarılıysa kStatus_Success, aksi halde hata kodu.
@@ -36,10 +52,12 @@ status_t flash_erase(void)
 status_t flash_program(uint32_t offset, const void *data, uint32_t length)
 {
     if (!data && length)                   return kStatus_InvalidArgument;   // Geçersiz argüman
-    if (length > USER_FLASH_SIZE) 		   return kStatus_OutOfRange;       // Bölge dışı erişim
+    if (offset % FLASH_PHRASE_SIZE)        return kStatus_InvalidArgument;   // Phrase hizasız
+    if (offset > USER_FLASH_SIZE ||
+        length > USER_FLASH_SIZE - offset) return kStatus_OutOfRange;       // Bölge dışı erişim
 
     const uint8_t *src = (const uint8_t*)data;
-    uint32_t addr = USER_FLASH_BASE;
+    uint32_t addr = USER_FLASH_BASE + offset;
 
     if (length == 0) return kStatus_Success;                                // Yazacak bir şey yok
 
@@ -65,6 +83,156 @@ status_t flash_program(uint32_t offset, const void *data, uint32_t length)
     return kStatus_Success;
 }
 
+/* DWT döngü sayacını (gerekirse) başlatır; süre ölçümü için. */
+static void flash_cyc_start(void)
+{
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+}
+
+static inline uint32_t flash_cyc_to_us(uint32_t cyc)
+{
+    return cyc / (SystemCoreClock / 1000000u);
+}
+
+/* data’nın pos’taki phrase’i; kuyruk 0xFF ile tamamlanır (flash_program ile aynı). */
+static void delta_phrase(uint8_t *np, const uint8_t *src, uint32_t pos, uint32_t length)
+{
+    uint32_t n = length - pos;
+    if (n > FLASH_PHRASE_SIZE) n = FLASH_PHRASE_SIZE;
+    memset(np, 0xFF, FLASH_PHRASE_SIZE);
+    memcpy(np, src + pos, n);
+}
+
+static bool delta_blank(const uint8_t *p, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; ++i) if (p[i] != 0xFF) return false;
+    return true;
+}
+
+/* Sektörde boş olmayan ve farklı (yani silmeden yazılamayan) phrase var mı? */
+static bool delta_needs_erase(uint32_t lo, uint32_t hi, uint32_t offset,
+                              const uint8_t *src, uint32_t length)
+{
+    uint8_t np[FLASH_PHRASE_SIZE];
+    for (uint32_t p = lo; p < hi; p += FLASH_PHRASE_SIZE) {
+        const uint8_t *cur = (const uint8_t *)(USER_FLASH_BASE + p);
+        delta_phrase(np, src, p - offset, length);
+        if (memcmp(cur, np, FLASH_PHRASE_SIZE) != 0 && !delta_blank(cur, FLASH_PHRASE_SIZE))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Karşılaştırmalı programlama: aynı phrase’ler atlanır, yalnızca gereken sektörler silinir.
+ * @param offset USER_FLASH_BASE’ten uzaklık (phrase hizalı olmalı).
+ * @param data   Kaynak RAM tamponu.
+ * @param length Yazılacak byte sayısı.
+ * @param stats  Sonuç istatistikleri (üzerine eklenir, NULL olabilir).
+ * @return Başarılıysa kStatus_Success, aksi halde hata kodu.
+ */
+status_t flash_program_delta(uint32_t offset, const void *data, uint32_t length, t_flash_delta *stats)
+{
+    if (!data && length)                   return kStatus_InvalidArgument;   // Geçersiz argüman
+    if (offset % FLASH_PHRASE_SIZE)        return kStatus_InvalidArgument;   // Phrase hizasız
+    if (offset > USER_FLASH_SIZE ||
+        length > USER_FLASH_SIZE - offset) return kStatus_OutOfRange;       // Bölge dışı erişim
+
+    if (length == 0) return kStatus_Success;                                // Yazacak bir şey yok
+
+    const uint8_t *src   = (const uint8_t*)data;
+    uint32_t       end   = offset + ((length + FLASH_PHRASE_SIZE - 1u) & ~(FLASH_PHRASE_SIZE - 1u));
+    uint32_t       first = offset - (offset % FLASH_SECTOR_SIZE);
+
+    if (end > USER_FLASH_SIZE) return kStatus_OutOfRange;                   // Dolgulu kuyruk taşıyor
+
+    /* 1) Hiçbir şey yazmadan: silinecek sektörlerin aralık dışı kısmı boş mu? */
+    for (uint32_t sec = first; sec < end; sec += FLASH_SECTOR_SIZE) {
+        uint32_t lo = (offset > sec) ? offset : sec;
+        uint32_t hi = (end < sec + FLASH_SECTOR_SIZE) ? end : sec + FLASH_SECTOR_SIZE;
+        if (!delta_needs_erase(lo, hi, offset, src, length)) continue;
+
+        if (!delta_blank((const uint8_t *)(USER_FLASH_BASE + sec), lo - sec) ||
+            !delta_blank((const uint8_t *)(USER_FLASH_BASE + hi), sec + FLASH_SECTOR_SIZE - hi))
+            return kStatus_OutOfRange;                                      // Korunması gereken veri var
+    }
+
+    /* 2) Sektör sektör: gerekiyorsa sil, yalnızca farklı phrase’leri yaz */
+    t_flash_delta d;
+    uint32_t cyc_prog = 0, cyc_erase = 0;
+    uint8_t  np[FLASH_PHRASE_SIZE];
+
+    memset(&d, 0, sizeof(d));
+    flash_cyc_start();
+
+    for (uint32_t sec = first; sec < end; sec += FLASH_SECTOR_SIZE) {
+        uint32_t lo = (offset > sec) ? offset : sec;
+        uint32_t hi = (end < sec + FLASH_SECTOR_SIZE) ? end : sec + FLASH_SECTOR_SIZE;
+        bool erase  = delta_needs_erase(lo, hi, offset, src, length);
+
+        if (erase) {
+            uint32_t t0 = DWT->CYCCNT;
+            status_t st = FLASH_Erase(&s_flash, USER_FLASH_BASE + sec, FLASH_SECTOR_SIZE, kFLASH_ApiEraseKey);
+            cyc_erase += DWT->CYCCNT - t0;
+            if (st != kStatus_Success) return st;
+            d.sectors_erased++;
+        } else if (!delta_blank((const uint8_t *)(USER_FLASH_BASE + lo), hi - lo)) {
+            d.sectors_skipped++;   // Düz yazıcı dolu aralığı silerdi; zaten boşsa kazanç yok
+        }
+
+        for (uint32_t p = lo; p < hi; p += FLASH_PHRASE_SIZE) {
+            const uint8_t *cur = (const uint8_t *)(USER_FLASH_BASE + p);
+            d.phrases_total++;
+            delta_phrase(np, src, p - offset, length);
+
+            // Silinmiş sektörde boş phrase, diğerlerinde aynı phrase yazılmaz.
+            // Kazanç yalnızca düz yazıcının programlayacağı (boş olmayan) phrase’ler için sayılır.
+            bool same = erase ? delta_blank(np, FLASH_PHRASE_SIZE)
+                              : (memcmp(cur, np, FLASH_PHRASE_SIZE) == 0);
+            if (same) {
+                if (!delta_blank(np, FLASH_PHRASE_SIZE)) d.phrases_skipped++;
+                continue;
+            }
+
+            uint32_t t0 = DWT->CYCCNT;
+            status_t st = FLASH_Program(&s_flash, USER_FLASH_BASE + p, np, FLASH_PHRASE_SIZE);
+            cyc_prog += DWT->CYCCNT - t0;
+            if (st != kStatus_Success) return st;
+            d.phrases_written++;
+        }
+    }
+
+    /* Ölçülen ortalamalar sonraki kazanç tahminlerinde kullanılır */
+    if (d.phrases_written) s_t_phrase_us = flash_cyc_to_us(cyc_prog)  / d.phrases_written;
+    if (d.sectors_erased)  s_t_sector_us = flash_cyc_to_us(cyc_erase) / d.sectors_erased;
+
+    d.elapsed_us = flash_cyc_to_us(cyc_prog + cyc_erase);
+    d.saved_us   = d.phrases_skipped * s_t_phrase_us + d.sectors_skipped * s_t_sector_us;
+
+    if (stats) {
+        stats->phrases_total   += d.phrases_total;
+        stats->phrases_written += d.phrases_written;
+        stats->phrases_skipped += d.phrases_skipped;
+        stats->sectors_erased  += d.sectors_erased;
+        stats->sectors_skipped += d.sectors_skipped;
+        stats->elapsed_us      += d.elapsed_us;
+        stats->saved_us        += d.saved_us;
+    }
+    return kStatus_Success;
+}
+
+void flash_delta_skip(t_flash_delta *stats, uint32_t phrases)
+{
+    if (!stats) return;
+    stats->phrases_total   += phrases;
+    stats->phrases_skipped += phrases;
+    stats->saved_us        += phrases * s_t_phrase_us;
+}
+
 /**
  * @brief Kullanıcı flash bölgesinden veri okur (basit memcpy).
  * @param offset USER_FLASH_BASE’ten uzaklık.
@@ -0,0 +1,283 @@
+/*
+ * flash_store.c
+ *  USER_FLASH üzerinde log yapılı kayıt deposu (format: flash_store.h).
+ */
+
+#include <string.h>
+#include "flash_store.h"
+#include "uart/uart_proto.h"
+
+#define FS_SECTOR_MAGIC   0x53465444u   /* "DTFS" (LE) */
+#define FS_REC_MAGIC      0x5Au
+
+/* Başlık + phrase’e yuvarlanmış veri */
+#define FS_REC_SIZE(len)  (FLASH_PHRASE_SIZE + \
+                           (((uint32_t)(len) + FLASH_PHRASE_SIZE - 1u) & ~(FLASH_PHRASE_SIZE - 1u)))
+
+/* İndeks girdisi: KEY’in en son geçerli kaydı */
+typedef struct
+{
+    uint32_t off;    /* Kayıt başlığının USER_FLASH içi ofseti */
+    uint32_t seq;    /* Kaydın bulunduğu sektörün SEQ’i (sıralama için) */
+    uint16_t len;    /* Veri uzunluğu */
+    uint8_t  flags;  /* FS_FLAG_* */
+    uint8_t  used;   /* Girdi dolu mu? */
+} t_fs_entry;
+
+static t_fs_entry s_idx[FS_MAX_KEYS];
+static uint32_t   s_sec_seq[FS_SECTOR_COUNT]; /* 0 → sektör boş */
+static uint32_t   s_seq_max;                  /* En büyük sektör SEQ’i */
+static uint16_t   s_head;                     /* Yazılan (en yeni) sektör */
+static uint32_t   s_head_off;                 /* Head içindeki ilk boş ofset */
+static uint8_t    s_head_valid;
+
+static inline const uint8_t *fs_ptr(uint32_t off)
+{
+    return (const uint8_t *)(USER_FLASH_BASE + off);
+}
+
+/* off/len phrase hizalı: boot taramasını kısaltmak için word word karşılaştır */
+static int fs_is_blank(uint32_t off, uint32_t len)
+{
+    const uint32_t *p = (const uint32_t *)fs_ptr(off);
+    for (uint32_t i = 0; i < len / 4u; ++i) if (p[i] != 0xFFFFFFFFu) return 0;
+    return 1;
+}
+
+static uint16_t fs_rec_crc(uint8_t key, uint8_t flags, uint16_t len, const uint8_t *data)
+{
+    uint16_t crc = 0xFFFF;
+    crc = crc16_step(crc, key);
+    crc = crc16_step(crc, flags);
+    crc = crc16_step(crc, (uint8_t)(len >> 8));
+    crc = crc16_step(crc, (uint8_t)len);
+    return crc16_block(crc, data, len);
+}
+
+/* a kaydı b’den sonra mı yazıldı? (önce sektör SEQ’i, sonra sektör içi sıra) */
+static int fs_newer(const t_fs_entry *a, const t_fs_entry *b)
+{
+    if (a->seq != b->seq) return a->seq > b->seq;
+    return a->off > b->off;
+}
+
+static void fs_reset(void)
+{
+    memset(s_idx, 0, sizeof(s_idx));
+    memset(s_sec_seq, 0, sizeof(s_sec_seq));
+    s_seq_max    = 0;
+    s_head       = 0;
+    s_head_off   = FLASH_SECTOR_SIZE;  /* İlk yazma yeni sektör açar */
+    s_head_valid = 0;
+}
+
+/*
+ * Sektördeki kayıtları sırayla indekse işler.
+ * Dönüş: sektör içi ilk boş ofset (bozuk başlıkta FLASH_SECTOR_SIZE → sektör dolu sayılır).
+ */
+static uint32_t fs_scan_sector(uint16_t sec)
+{
+    uint32_t base = (uint32_t)sec * FLASH_SECTOR_SIZE;
+    uint32_t off  = FLASH_PHRASE_SIZE;
+
+    while (off + FLASH_PHRASE_SIZE <= FLASH_SECTOR_SIZE) {
+        const uint8_t *h = fs_ptr(base + off);
+        if (fs_is_blank(base + off, FLASH_PHRASE_SIZE)) return off;           // Log sonu
+        if (h[0] != FS_REC_MAGIC || (uint8_t)(h[1] ^ h[3]) != 0xFFu) return FLASH_SECTOR_SIZE;
+
+        uint16_t len  = ((uint16_t)h[4] << 8) | h[5];
+        uint32_t size = FS_REC_SIZE(len);
+        if (off + size > FLASH_SECTOR_SIZE) return FLASH_SECTOR_SIZE;
+
+        uint16_t crc = ((uint16_t)h[6] << 8) | h[7];
+        if (h[1] < FS_MAX_KEYS && crc == fs_rec_crc(h[1], h[2], len, h + FLASH_PHRASE_SIZE)) {
+            t_fs_entry *e = &s_idx[h[1]];
+            e->off   = base + off;
+            e->seq   = s_sec_seq[sec];
+            e->len   = len;
+            e->flags = h[2];
+            e->used  = 1;
+        }
+        // CRC’si tutmayan (yarım yazılmış) kayıt atlanır, yeri boşa gider
+        off += size;
+    }
+    return FLASH_SECTOR_SIZE;
+}
+
+/* Kaydı (başlık dahil) head’in sonuna aynen kopyalar; kaynak flash olduğundan phrase phrase RAM’e alınır. */
+static int fs_copy_to_head(uint32_t src, uint32_t size)
+{
+    uint32_t dst = (uint32_t)s_head * FLASH_SECTOR_SIZE + s_head_off;
+    uint8_t  phrase[FLASH_PHRASE_SIZE];
+
+    s_head_off += size;   // Yarıda kalsa da yer tüketildi
+    for (uint32_t i = 0; i < size; i += FLASH_PHRASE_SIZE) {
+        memcpy(phrase, fs_ptr(src + i), FLASH_PHRASE_SIZE);
+        if (flash_program(dst + i, phrase, FLASH_PHRASE_SIZE) != kStatus_Success) return -63;
+    }
+    return 0;
+}
+
+/* Sektörün canlı kayıtlarını head’e taşıyıp sektörü siler. */
+static int fs_evacuate(uint16_t sec)
+{
+    for (uint8_t k = 0; k < FS_MAX_KEYS; ++k) {
+        t_fs_entry *e = &s_idx[k];
+        if (!e->used || e->off / FLASH_SECTOR_SIZE != sec) continue;
+
+        uint32_t size = FS_REC_SIZE(e->len);
+        if (s_head_off + size > FLASH_SECTOR_SIZE) return -62;
+
+        uint32_t dst = (uint32_t)s_head * FLASH_SECTOR_SIZE + s_head_off;
+        int st = fs_copy_to_head(e->off, size);
+        if (st < 0) return st;
+        e->off = dst;
+        e->seq = s_sec_seq[s_head];
+    }
+
+    if (flash_erase_sector((uint32_t)sec * FLASH_SECTOR_SIZE) != kStatus_Success) return -63;
+    s_sec_seq[sec] = 0;
+    return 0;
+}
+
+/*
+ * Head doldu: sıradaki (boş) sektörü aç, ardındaki en eski sektörü boşalt.
+ * Dönüş: silinen sektör sayısı (0/1) veya hata.
+ */
+static int fs_advance(void)
+{
+    uint16_t next = s_head_valid ? (uint16_t)((s_head + 1u) % FS_SECTOR_COUNT) : 0u;
+    if (s_sec_seq[next]) return -62;                 // Boş sektör kuralı bozulmuş
+
+    uint32_t hdr[2] = { FS_SECTOR_MAGIC, s_seq_max + 1u };
+    if (flash_program((uint32_t)next * FLASH_SECTOR_SIZE, hdr, sizeof(hdr)) != kStatus_Success)
+        return -63;
+
+    s_seq_max++;
+    s_sec_seq[next] = s_seq_max;
+    s_head          = next;
+    s_head_off      = FLASH_PHRASE_SIZE;
+    s_head_valid    = 1;
+
+    uint16_t victim = (uint16_t)((next + 1u) % FS_SECTOR_COUNT);
+    if (!s_sec_seq[victim]) return 0;
+
+    int st = fs_evacuate(victim);
+    return (st < 0) ? st : 1;
+}
+
+int flash_store_init(void)
+{
+    fs_reset();
+
+    // Sektör başlıklarını oku; ne geçerli ne boş olanları (yarım silme) temizle
+    for (uint16_t s = 0; s < FS_SECTOR_COUNT; ++s) {
+        uint32_t base = (uint32_t)s * FLASH_SECTOR_SIZE;
+        const uint32_t *hdr = (const uint32_t *)fs_ptr(base);
+
+        if (hdr[0] == FS_SECTOR_MAGIC && hdr[1] != 0u && hdr[1] != 0xFFFFFFFFu) {
+            s_sec_seq[s] = hdr[1];
+            if (hdr[1] > s_seq_max) s_seq_max = hdr[1];
+        } else if (!fs_is_blank(base, FLASH_SECTOR_SIZE)) {
+            flash_erase_sector(base);
+        }
+    }
+
+    // Sektörleri SEQ sırasıyla tara: sonra yazılan kayıt öncekini ezer
+    uint32_t prev = 0;
+    for (;;) {
+        int16_t  sec  = -1;
+        uint32_t best = 0xFFFFFFFFu;
+        for (uint16_t s = 0; s < FS_SECTOR_COUNT; ++s) {
+            if (s_sec_seq[s] > prev && s_sec_seq[s] < best) { best = s_sec_seq[s]; sec = (int16_t)s; }
+        }
+        if (sec < 0) break;
+
+        uint32_t end = fs_scan_sector((uint16_t)sec);
+        if (best == s_seq_max) {
+            s_head       = (uint16_t)sec;
+            s_head_off   = end;
+            s_head_valid = 1;
+        }
+        prev = best;
+    }
+
+    // Taşıma sırasında kesilmiş olabilir: head’in ardındaki sektör boş kalmalı
+    if (s_head_valid) {
+        uint16_t victim = (uint16_t)((s_head + 1u) % FS_SECTOR_COUNT);
+        if (s_sec_seq[victim]) fs_evacuate(victim);
+    }
+
+    int live = 0;
+    for (uint8_t k = 0; k < FS_MAX_KEYS; ++k) live += s_idx[k].used;
+    return live;
+}
+
+int flash_store_write(uint8_t key, uint8_t flags, const uint8_t *data, uint16_t len,
+                      t_flash_delta *stats)
+{
+    if (key >= FS_MAX_KEYS)                   return -60;
+    if ((!data && len) || len > FS_MAX_RECORD) return -61;
+
+    uint32_t size   = FS_REC_SIZE(len);
+    int      erased = 0;
+
+    // Canlı kayıt birebir aynıysa hiçbir şey yazma/silme
+    const t_fs_entry *cur = &s_idx[key];
+    if (cur->used && cur->len == len && cur->flags == flags &&
+        memcmp(fs_ptr(cur->off + FLASH_PHRASE_SIZE), data, len) == 0) {
+        flash_delta_skip(stats, size / FLASH_PHRASE_SIZE);
+        return 0;
+    }
+
+    if (s_head_off + size > FLASH_SECTOR_SIZE) {
+        erased = fs_advance();
+        if (erased < 0) return erased;
+        if (s_head_off + size > FLASH_SECTOR_SIZE) return -62;  // Taşınan kayıtlar head’i doldurdu
+    }
+
+    uint16_t crc = fs_rec_crc(key, flags, len, data);
+    uint8_t  hdr[FLASH_PHRASE_SIZE] = {
+        FS_REC_MAGIC, key, flags, (uint8_t)~key,
+        (uint8_t)(len >> 8), (uint8_t)len, (uint8_t)(crc >> 8), (uint8_t)crc
+    };
+
+    uint32_t off = (uint32_t)s_head * FLASH_SECTOR_SIZE + s_head_off;
+    s_head_off += size;   // Hata olsa da yer tüketildi; tarama CRC ile atlar
+
+    if (flash_program_delta(off, hdr, sizeof(hdr), stats) != kStatus_Success)               return -63;
+    if (flash_program_delta(off + FLASH_PHRASE_SIZE, data, len, stats) != kStatus_Success) return -63;
+
+    t_fs_entry *e = &s_idx[key];
+    e->off   = off;
+    e->seq   = s_sec_seq[s_head];
+    e->len   = len;
+    e->flags = flags;
+    e->used  = 1;
+    return erased;
+}
+
+const uint8_t *flash_store_get(uint8_t key, uint16_t *len, uint8_t *flags)
+{
+    if (key >= FS_MAX_KEYS || !s_idx[key].used) return NULL;
+    if (len)   *len   = s_idx[key].len;
+    if (flags) *flags = s_idx[key].flags;
+    return fs_ptr(s_idx[key].off + FLASH_PHRASE_SIZE);
+}
+
+int flash_store_latest(uint8_t flags_mask)
+{
+    int best = -1;
+    for (uint8_t k = 0; k < FS_MAX_KEYS; ++k) {
+        const t_fs_entry *e = &s_idx[k];
+        if (!e->used || !(e->flags & flags_mask)) continue;
+        if (best < 0 || fs_newer(e, &s_idx[best])) best = k;
+    }
+    return best;
+}
+
+status_t flash_store_format(void)
+{
+    fs_reset();
+    return flash_erase();
+}
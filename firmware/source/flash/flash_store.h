@@ -0,0 +1,55 @@
+/*
+ * flash_store.h
+ *  USER_FLASH üzerinde append-only (log yapılı) kayıt deposu.
+ *
+ *  Bölge FLASH_SECTOR_SIZE’lık sektörlere ayrılır ve halka olarak kullanılır:
+ *    Sektör başlığı (1 phrase): [MAGIC:4LE][SEQ:4LE]      (SEQ her yeni sektörde artar)
+ *    Kayıt başlığı  (1 phrase): [0x5A][KEY][FLAGS][~KEY][LEN:2BE][CRC:2BE]
+ *    Kayıt verisi            : LEN byte, phrase sınırına 0xFF ile tamamlanır
+ *  CRC16 (CCITT-FALSE) KEY, FLAGS, LEN ve veri üzerinden hesaplanır.
+ *
+ *  Aynı KEY’e yazmak eski kaydı silmez, yenisini ekler; boot’ta bir kez
+ *  taranarak “en son yazılan kazanır” indeksi kurulur. Head sektörünün
+ *  ardındaki sektör her zaman boş tutulur: head dolduğunda en eski sektörün
+ *  canlı kayıtları yeni head’e taşınır ve yalnızca o sektör silinir
+ *  (bir yazma en fazla bir sektör siler).
+ */
+
+#ifndef FLASH_FLASH_STORE_H_
+#define FLASH_FLASH_STORE_H_
+
+#include <stdint.h>
+#include "flash.h"
+#include "proto/proto.h"   /* FS_MAX_KEYS: host ile ortak anahtar sayısı */
+
+#define FS_SECTOR_COUNT   (USER_FLASH_SIZE / FLASH_SECTOR_SIZE)
+#define FS_MAX_RECORD     (FLASH_SECTOR_SIZE - 2u * FLASH_PHRASE_SIZE) /* Tek kaydın azami veri boyu */
+
+#define FS_FLAG_BOOT      0x01u  /* Kayıt boot’ta çalıştırılabilir */
+#define FS_FLAG_IMAGE     0x02u  /* Veri UART çerçevesi değil, derlenmiş boot imajı (boot/boot_image.h) */
+
+/*
+ * Bölgeyi tarar, indeksi kurar; yarım kalmış silme/taşıma işlerini tamamlar.
+ * Dönüş: canlı kayıt sayısı.
+ */
+int  flash_store_init(void);
+
+/*
+ * KEY altına yeni kayıt ekler (eski sürüm indeksten düşer). Canlı kayıt birebir
+ * aynıysa flash’a dokunmaz; kayıt delta modunda yazılır, sonuç stats’a eklenir.
+ * Dönüş: >=0 bu yazma için silinen sektör sayısı (0 veya 1),
+ *        <0 hata (-60 geçersiz key, -61 kayıt çok büyük, -62 depo dolu, -63 flash hatası).
+ */
+int  flash_store_write(uint8_t key, uint8_t flags, const uint8_t *data, uint16_t len,
+                       t_flash_delta *stats);
+
+/* KEY’in canlı kaydının flash’taki verisi (memory-mapped); yoksa NULL. */
+const uint8_t *flash_store_get(uint8_t key, uint16_t *len, uint8_t *flags);
+
+/* flags_mask bitlerinden birini taşıyan en son yazılmış kaydın KEY’i; yoksa -1. */
+int  flash_store_latest(uint8_t flags_mask);
+
+/* Tüm bölgeyi siler ve indeksi sıfırlar. */
+status_t flash_store_format(void);
+
+#endif /* FLASH_FLASH_STORE_H_ */
@@ -0,0 +1,86 @@
+/*
+ * proto.h
+ *
+ *  proto_schema.h’ın C genişletmesi (firmware tarafı).
+ *
+ *  - Sabitler, MSG_ID_*, TYPE_*, LVL_* enum olarak.
+ *  - Her kayıt için:
+ *      t_proto_<ad>              alanları wire sırasıyla tutan struct
+ *      PROTO_<AD>_SIZE           wire boyutu (alanların toplamı)
+ *      proto_put_<ad>(p, r)      r’yi p’ye yazar, kaydın sonunu döndürür
+ *      proto_get_<ad>(p, r)      p’den okur, kaydın sonunu döndürür
+ *    Fonksiyonlar düz byte yazma/okumadır (döngü/uzunluk kontrolü yok);
+ *    sınır kontrolü çağıranda, PROTO_<AD>_SIZE ile yapılır.
+ */
+
+#ifndef PROTO_PROTO_H_
+#define PROTO_PROTO_H_
+
+#include <stdint.h>
+#include "proto_schema.h"
+
+#define PROTO_ENUM_CONST(name, value)   name = (value),
+#define PROTO_ENUM_MSG(name, value)     MSG_ID_##name = (value),
+#define PROTO_ENUM_TYPE(name, value)    TYPE_##name = (value),
+#define PROTO_ENUM_LVL(name, value)     LVL_##name = (value),
+
+enum { PROTO_CONSTANTS(PROTO_ENUM_CONST) };
+enum { PROTO_MESSAGES(PROTO_ENUM_MSG) };
+enum { PROTO_ACTION_TYPES(PROTO_ENUM_TYPE) };
+enum { PROTO_LEVELS(PROTO_ENUM_LVL) };
+
+/* ---------------------------- Alan tipleri -------------------------------- */
+
+typedef uint8_t  proto_u8;
+typedef uint16_t proto_u16;
+typedef uint32_t proto_u32;
+
+#define PROTO_SIZE_u8   1
+#define PROTO_SIZE_u16  2
+#define PROTO_SIZE_u32  4
+
+static inline uint8_t *proto_put_u8(uint8_t *p, uint8_t v)
+{
+    p[0] = v;
+    return p + 1;
+}
+
+static inline uint8_t *proto_put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v >> 8); p[1] = (uint8_t)v;
+    return p + 2;
+}
+
+static inline uint8_t *proto_put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);  p[3] = (uint8_t)v;
+    return p + 4;
+}
+
+static inline uint8_t  proto_get_u8(const uint8_t *p)  { return p[0]; }
+static inline uint16_t proto_get_u16(const uint8_t *p) { return (uint16_t)(((uint16_t)p[0] << 8) | p[1]); }
+static inline uint32_t proto_get_u32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/* ------------------------------- Kayıtlar --------------------------------- */
+
+#define PROTO_F_MEMBER(t, n)    proto_##t n;
+#define PROTO_F_SIZE(t, n)      + PROTO_SIZE_##t
+#define PROTO_F_PUT(t, n)       p = proto_put_##t(p, r->n);
+#define PROTO_F_GET(t, n)       r->n = proto_get_##t(p); p += PROTO_SIZE_##t;
+
+#define PROTO_DEFINE_RECORD(lc, UC, Cpp, FIELDS, WIRE)                              \
+    typedef struct { FIELDS(PROTO_F_MEMBER) } t_proto_##lc;                         \
+    enum { PROTO_##UC##_SIZE = 0 FIELDS(PROTO_F_SIZE) };                            \
+    _Static_assert(PROTO_##UC##_SIZE == (WIRE), "proto_schema.h: " #lc " wire size"); \
+    static inline uint8_t *proto_put_##lc(uint8_t *p, const t_proto_##lc *r)        \
+    { FIELDS(PROTO_F_PUT) return p; }                                               \
+    static inline const uint8_t *proto_get_##lc(const uint8_t *p, t_proto_##lc *r)  \
+    { FIELDS(PROTO_F_GET) return p; }
+
+PROTO_RECORDS(PROTO_DEFINE_RECORD)
+
+#endif /* PROTO_PROTO_H_ */
@@ -0,0 +1,121 @@
+/*
+ * proto_schema.h
+ *
+ *  Debug Tool protokolünün tek kaynağı: sabitler, mesaj ID’leri, action
+ *  tipleri ve tüm sabit boyutlu kayıt düzenleri burada, X-macro listeleri
+ *  olarak tanımlıdır. Kod üretimi önişlemcide yapılır:
+ *
+ *    - firmware: proto/proto.h   → C enum’ları, t_proto_* struct’ları,
+ *                                  proto_put_* / proto_get_* (static inline)
+ *    - qt_app:   protocol.h      → constexpr sabitler, proto::* struct’ları,
+ *                                  constexpr proto::encode / proto::decode
+ *
+ *  Bu dosya yalnız liste içerir (include/tip yok); iki dil de aynı listeyi
+ *  genişletir, düzenler ayrışamaz. Çok byte’lı alanlar big-endian’dır.
+ *
+ *  Alan tipleri: u8, u16, u32. Her kaydın son argümanı wire boyutudur;
+ *  genişletmeler alanların toplamını buna karşı derleme anında doğrular
+ *  (cihazlardaki firmware ile uyumu bozacak bir değişiklik derlenmez).
+ */
+
+#ifndef PROTO_PROTO_SCHEMA_H_
+#define PROTO_PROTO_SCHEMA_H_
+
+/* ------------------------------- Sabitler --------------------------------- */
+/* X(AD, DEĞER) */
+#define PROTO_CONSTANTS(X)                                                      \
+    X(SOF0,             0xAA)   /* Çerçeve başı, 1. byte                   */   \
+    X(SOF1,             0x55)   /* Çerçeve başı, 2. byte                   */   \
+    X(MAX_PAYLOAD,      512)    /* Çerçeve başına azami payload (byte)     */   \
+    X(PROTO_CORE_SIZE,  7)      /* SOF(2) + MSG(1) + LEN(2) + CRC(2)       */   \
+    X(MAX_SLOTS,        4)      /* RAM’de tutulan action set slotu         */   \
+    X(SLOT_ID_ALL,      0xFF)   /* SLOT_DROP: tüm slotlar                  */   \
+    X(FS_MAX_KEYS,      16)     /* Flash deposundaki kayıt anahtarı        */   \
+    X(CSPI_FLAG_DMA,    0x01)   /* CSPI_BEGIN flags: eDMA veri yolu        */
+
+/* ------------------------------ Mesaj ID’leri ------------------------------ */
+/* X(AD, ID) → MSG_ID_AD */
+#define PROTO_MESSAGES(X)                                                       \
+    X(EXECUTE_ACTIONS,  0x10)   /* [BLOB] → parse et ve hemen çalıştır     */   \
+    X(SLOT_UPLOAD,      0x12)   /* [SLOT][BLOB] → parse et, slotta tut     */   \
+    X(SLOT_EXECUTE,     0x14)   /* [SLOT] → slottaki seti çalıştır         */   \
+    X(SLOT_LIST,        0x16)   /* Host: len=0; cihaz: [USED]{SLOT_INFO}   */   \
+    X(SLOT_DROP,        0x18)   /* [SLOT] → slotu boşalt (SLOT_ID_ALL)     */   \
+    X(CSPI_BEGIN,       0x50)   /* CSPI_BEGIN kaydı (flags opsiyonel)      */   \
+    X(CSPI_DATA,        0x52)   /* TX kelime akışı                         */   \
+    X(CSPI_END,         0x54)   /* Oturumu bitir (kalan işi tamamla)       */   \
+    X(CSPI_REQ,         0x59)   /* Cihaz → host: CSPI_CREDIT kaydı         */   \
+    X(CSPI_TERMINATE,   0x5B)   /* Oturumu hemen iptal et                  */   \
+    X(CSPI_RX,          0x5D)   /* Cihaz → host: [SEQ:2][kelimeler (LE)]   */   \
+    X(CSPI_STATS,       0x5F)   /* Cihaz → host: CSPI_STATS kaydı          */   \
+    X(WRITE_FLASH,      0x90)   /* [KEY][BLOB] → flash kaydı               */   \
+    X(WRITE_FLASH_BOOT, 0x91)   /* [KEY][BLOB] → flash kaydı (boot)        */   \
+    X(CLEAR_FLASH,      0xCC)   /* User flash bölgesini sil                */   \
+    X(RESET,            0xFF)   /* Yazılımsal reset                        */
+
+/* ------------------------------ Action tipleri ----------------------------- */
+/* X(AD, TAG) → TYPE_AD */
+#define PROTO_ACTION_TYPES(X)                                                   \
+    X(START,            0x01)                                                   \
+    X(DELAY,            0x02)                                                   \
+    X(PIN_READ,         0x03)                                                   \
+    X(PIN_WRITE,        0x04)                                                   \
+    X(PIN_TRIGGER,      0x05)
+
+/* Pin seviyeleri: X(AD, DEĞER) → LVL_AD */
+#define PROTO_LEVELS(X)                                                         \
+    X(LOW,              0x00)                                                   \
+    X(HIGH,             0x01)                                                   \
+    X(UNDEF,            0xFF)   /* Kontrol etme / belirtilmemiş            */
+
+/* ------------------------------ Kayıt alanları ----------------------------- */
+/* F(TİP, ALAN) sırası wire sırasıdır */
+
+/* Action kayıt başları; hepsinin ardından [TCOUNT][TIDS...] gelir */
+#define PROTO_FIELDS_START(F)                                                   \
+    F(u8,  type) F(u8,  id)
+
+#define PROTO_FIELDS_DELAY(F)                                                   \
+    F(u8,  type) F(u8,  id) F(u32, ms) F(u16, us)
+
+#define PROTO_FIELDS_PIN(F)                                                     \
+    F(u8,  type) F(u8,  id) F(u8,  port) F(u8,  pin)                            \
+    F(u8,  initial) F(u8,  target) F(u8,  final) F(u32, ms) F(u16, us)
+
+#define PROTO_FIELDS_PIN_TRIGGER(F)                                             \
+    F(u8,  type) F(u8,  id) F(u8,  port) F(u8,  pin)                            \
+    F(u8,  initial) F(u8,  target) F(u32, timeout_ms) F(u16, timeout_us)
+
+/* CSPI_BEGIN; son byte (flags) opsiyoneldir, eski host’lar 13 byte yollar */
+#define PROTO_FIELDS_CSPI_BEGIN(F)                                              \
+    F(u8,  mode) F(u8,  word_size) F(u16, rx_size) F(u8,  transfer_size)        \
+    F(u16, tx_len) F(u32, threshold) F(u8,  port) F(u8,  pin) F(u8,  flags)
+
+/* CSPI_REQ: LIMIT = oturum başından beri gönderilebilecek toplam DATA byte’ı */
+#define PROTO_FIELDS_CSPI_CREDIT(F)                                             \
+    F(u32, limit) F(u32, starved) F(u32, underflow)
+
+/* CSPI_STATS: sayaçlar oturum başından kümülatif; RING_MIN son rapordan beri */
+#define PROTO_FIELDS_CSPI_STATS(F)                                              \
+    F(u32, rounds) F(u32, words) F(u32, starved) F(u32, underflow)              \
+    F(u32, thr_hits) F(u32, rx_dropped) F(u32, rtt_us) F(u32, rtt_max_us)       \
+    F(u16, ring_min) F(u16, ring_size)
+
+/* SLOT_LIST cevabında slot başına kayıt */
+#define PROTO_FIELDS_SLOT_INFO(F)                                               \
+    F(u8,  slot) F(u8,  count) F(u16, len) F(u16, crc) F(u32, runs)
+
+/* --------------------------------- Kayıtlar -------------------------------- */
+/* X(c_adı, BÜYÜK_AD, CppAdı, ALANLAR, WIRE_BOYUTU) */
+#define PROTO_RECORDS(X)                                                        \
+    X(start,       START,       Start,       PROTO_FIELDS_START,        2)      \
+    X(delay,       DELAY,       Delay,       PROTO_FIELDS_DELAY,        8)      \
+    X(pin_read,    PIN_READ,    PinRead,     PROTO_FIELDS_PIN,         13)      \
+    X(pin_write,   PIN_WRITE,   PinWrite,    PROTO_FIELDS_PIN,         13)      \
+    X(pin_trigger, PIN_TRIGGER, PinTrigger,  PROTO_FIELDS_PIN_TRIGGER, 12)      \
+    X(cspi_begin,  CSPI_BEGIN,  CspiBegin,   PROTO_FIELDS_CSPI_BEGIN,  14)      \
+    X(cspi_credit, CSPI_CREDIT, CspiCredit,  PROTO_FIELDS_CSPI_CREDIT, 12)      \
+    X(cspi_stats,  CSPI_STATS,  CspiStats,   PROTO_FIELDS_CSPI_STATS,  36)      \
+    X(slot_info,   SLOT_INFO,   SlotInfo,    PROTO_FIELDS_SLOT_INFO,   10)
+
+#endif /* PROTO_PROTO_SCHEMA_H_ */
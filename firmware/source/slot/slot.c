@@ -0,0 +1,85 @@
+/*
+ * slot.c
+ *  Parse edilmiş action set’leri slot ID’leri altında RAM’de tutar.
+ */
+
+#include <string.h>
+#include "slot.h"
+#include "uart/uart_proto.h"
+
+static t_action_slot s_slots[MAX_SLOTS];
+
+/* Ham blob CRC16’sı (host ile aynı CCITT-FALSE, 0xFFFF başlangıç) */
+static uint16_t blob_crc16(const uint8_t *pl, uint16_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (uint16_t i = 0; i < len; ++i) crc = crc16_step(crc, pl[i]);
+    return crc;
+}
+
+int slot_store(uint8_t slot, const uint8_t *pl, uint16_t len)
+{
+    if (slot >= MAX_SLOTS) return -40;
+
+    /* Önce geçici sete parse et: hata olursa eski slot içeriği korunur */
+    t_action_set set;
+    int n = parse_actions(pl, len, &set);
+    if (n <= 0) return (n == 0) ? -10 : n;
+
+    t_action_slot *s = &s_slots[slot];
+    if (s->used) free_actions(&s->set);
+
+    s->set       = set;
+    s->blob_len  = len;
+    s->blob_crc  = blob_crc16(pl, len);
+    s->run_count = 0;
+    s->used      = 1;
+    return n;
+}
+
+t_action_set *slot_acquire(uint8_t slot)
+{
+    if (slot >= MAX_SLOTS || !s_slots[slot].used) return NULL;
+    s_slots[slot].run_count++;
+    return &s_slots[slot].set;
+}
+
+int slot_drop(uint8_t slot)
+{
+    if (slot == SLOT_ID_ALL) {
+        for (uint8_t i = 0; i < MAX_SLOTS; ++i) slot_drop(i);
+        return 0;
+    }
+    if (slot >= MAX_SLOTS) return -40;
+
+    t_action_slot *s = &s_slots[slot];
+    if (s->used) free_actions(&s->set);
+    memset(s, 0, sizeof(*s));
+    return 0;
+}
+
+size_t slot_list(uint8_t *out, size_t cap)
+{
+    if (!out || cap < 1) return 0;
+
+    size_t  i    = 1;
+    uint8_t used = 0;
+    for (uint8_t k = 0; k < MAX_SLOTS; ++k) {
+        const t_action_slot *s = &s_slots[k];
+        if (!s->used) continue;
+        if (i + PROTO_SLOT_INFO_SIZE > cap) break;
+
+        const t_proto_slot_info info = {
+            .slot  = k,
+            .count = (uint8_t)s->set.count,
+            .len   = s->blob_len,
+            .crc   = s->blob_crc,
+            .runs  = s->run_count,
+        };
+        proto_put_slot_info(out + i, &info);
+        i += PROTO_SLOT_INFO_SIZE;
+        used++;
+    }
+    out[0] = used;
+    return i;
+}
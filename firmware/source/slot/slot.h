@@ -0,0 +1,51 @@
+/*
+ * slot.h
+ *  RAM’de kalıcı (resident) action set slotları.
+ *
+ *  Host bir action blob’unu slot ID’si ile bir kez yükler; cihaz blob’u
+ *  parse edip slotta tutar. Sonraki çalıştırmalar yalnızca 1 byte’lık
+ *  “execute slot” çerçevesi ile tetiklenir (yeniden upload/parse/malloc yok).
+ */
+
+#ifndef SLOT_SLOT_H_
+#define SLOT_SLOT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "action/action.h"
+
+/*
+ * MAX_SLOTS, SLOT_ID_ALL ve LIST cevabındaki slot kaydı (t_proto_slot_info,
+ * PROTO_SLOT_INFO_SIZE) proto/proto_schema.h’ta tanımlıdır.
+ */
+
+/* Tek slot: parse edilmiş set + tanı bilgileri */
+typedef struct
+{
+    uint8_t      used;       /* Slot dolu mu? */
+    uint16_t     blob_len;   /* Yüklenen ham payload uzunluğu */
+    uint16_t     blob_crc;   /* Ham payload CRC16’sı (host tarafı doğrulama için) */
+    uint32_t     run_count;  /* Bu slot kaç kez çalıştırıldı */
+    t_action_set set;        /* Parse edilmiş action set (slot sahibi) */
+} t_action_slot;
+
+/*
+ * Blob’u parse edip slota yerleştirir. Slot doluysa eski set serbest bırakılır.
+ * Dönüş: >0 action sayısı, <0 hata (-40 geçersiz slot, diğerleri parse_actions kodları).
+ */
+int  slot_store(uint8_t slot, const uint8_t *pl, uint16_t len);
+
+/* Slot’taki set’i döndürür (boşsa/geçersizse NULL); run_count’u artırır. */
+t_action_set *slot_acquire(uint8_t slot);
+
+/* Slotu boşaltır (SLOT_ID_ALL → hepsi). Dönüş: 0 başarı, -40 geçersiz slot. */
+int  slot_drop(uint8_t slot);
+
+/*
+ * Dolu slotların özetini yazar:
+ *   [USED_COUNT]{[SLOT][COUNT][LEN:2BE][CRC:2BE][RUNS:4BE]}...
+ * Dönüş: out’a yazılan byte sayısı.
+ */
+size_t slot_list(uint8_t *out, size_t cap);
+
+#endif /* SLOT_SLOT_H_ */
@@ -6,9 +6,57 @@
 //Kullanılan spi arayüzü
 #define SPIx SPI0
 
+/* eDMA veri yolu (CSPI_FLAG_DMA): kanal 0/1 UART’ta */
+#define CSPI_DMA_BASEADDR     DMA0
+#define CSPI_DMAMUX_BASEADDR  DMAMUX
+#define CSPI_RX_DMA_CHANNEL   2U
+#define CSPI_TX_DMA_CHANNEL   3U
+#define CSPI_RX_DMA_REQUEST   kDmaRequestMux0SPI0Rx
+#define CSPI_TX_DMA_REQUEST   kDmaRequestMux0SPI0Tx
+#define CSPI_DMA_ROUND_MAX    256U   /* Tek DMA round’unun azami kelime sayısı */
+
 void spi_init(t_cspi_fields *C);
 
+/*
+ * Eşik penceresi: 32 bite sığan son k kelime (k = min(transfer_size, 32/word_size), en az 1).
+ * Dönüş: k*word_size bitlik maske; *k_out’a k yazılır.
+ */
+static inline uint32_t cspi_thr_mask(const volatile t_cspi_fields *C, uint8_t *k_out)
+{
+    uint8_t k = (uint8_t)(32u / C->word_size);
+    if (C->transfer_size && C->transfer_size < k) k = C->transfer_size;
+    if (k_out) *k_out = k;
+    uint32_t bits = (uint32_t)k * C->word_size;
+    return (bits >= 32u) ? 0xFFFFFFFFu : ((1u << bits) - 1u);
+}
+
 
 size_t cspi_tx_push(t_cspi_fields *C, const uint8_t *data, size_t len);
 
+/* RX çift tamponu: aktif yarıyı host’a devret, diğerine geç (ISR bağlamı). */
+static inline void cspi_rx_flip(volatile t_cspi_fields *C)
+{
+    if (!C->rx_fill) return;
+    C->rx_ready[C->rx_half] = C->rx_fill;
+    C->rx_half ^= 1u;
+    C->rx_fill  = 0;
+}
+
+/* Bir kelimeyi aktif yarıya yaz; yarı hâlâ gönderilmeyi bekliyorsa kelime düşer. */
+static inline void cspi_rx_put(volatile t_cspi_fields *C, uint32_t w)
+{
+    if (C->rx_ready[C->rx_half]) { C->rx_dropped++; return; }
+
+    uint8_t *dst = &C->rx_data[C->rx_half * CSPI_RX_HALF + C->rx_fill];
+    dst[0] = (uint8_t)w;
+    if (C->word_bytes == 2u) dst[1] = (uint8_t)(w >> 8);
+    C->rx_fill = (uint16_t)(C->rx_fill + C->word_bytes);
+    if (C->rx_fill >= CSPI_RX_HALF) cspi_rx_flip(C);
+}
+
+/* eDMA yolu: kanalları bağla (spi_init C->use_dma iken çağırır), round kur, durdur. */
+void cspi_dma_init(t_cspi_fields *C);
+void cspi_dma_start_round(t_cspi_fields *C);
+void cspi_dma_stop(void);
+
 #endif /* SPI_SPI_H_ */
@@ -0,0 +1,259 @@
+/*
+ * spi_dma.c
+ *
+ *  Amaç:
+ *  -----
+ *  - CSPI slave veri yolunun eDMA sürümü (CSPI_BEGIN flags & CSPI_FLAG_DMA).
+ *  - TX kanalı ring’den PUSHR’ı, RX kanalı POPR’dan RX çift tamponunun aktif
+ *    yarısını besler (round, yarının kalan yerine göre kısaltılır);
+ *    byte başına IRQ yoktur, CPU yalnızca round sonunda (RX major loop bitti)
+ *    devreye girer: ring tail ilerletme, eşik karşılaştırma, underflow/hız ölçümü.
+ *  - Round uzunluğu: transfer_size (>0 ise), yoksa kalan RX hedefi; en fazla
+ *    CSPI_DMA_ROUND_MAX kelime. RX hedefi bundan büyükse alt round’lar IRQ içinde
+ *    hemen yeniden kurulur.
+ *  - Kelime ≤8 bit ise 1, 9..16 bit ise 2 byte’lık eDMA transferi (ring/RX LE).
+ */
+
+#include <string.h>
+#include "action/action.h"
+#include "gpio/gpio_utils.h"
+#include "fsl_edma.h"
+#include "fsl_dmamux.h"
+#include "spi.h"
+
+extern volatile bool g_spi_done;  /* spi_init.c: round bitti bilgisi */
+
+/* --- Round durumu --- */
+
+static t_cspi_fields *s_cspi = NULL;
+static uint8_t   s_tx_bounce[CSPI_DMA_ROUND_MAX * 2u] __attribute__((aligned(2))); /* Ring sarması/eksik veri için TX kopyası */
+static uint16_t  s_rx_sink;                       /* Yakalama yoksa POPR buraya boşaltılır */
+static const uint8_t *s_tx_src;                   /* Bu round’un TX kaynağı (eşik için) */
+static uint16_t  s_round_len;                     /* Bu round’daki kelime sayısı */
+static uint16_t  s_tx_taken;                      /* Ring’den tüketilecek kelime sayısı */
+static uint8_t   s_rx_mode;                       /* 0: yakalama yok, 1: aktif yarıya, 2: düşür (iki yarı dolu) */
+static uint32_t  s_last_end_cyc;                  /* Önceki round sonunun DWT değeri (0: yok) */
+
+static inline uint16_t dma_rb_count(const t_cspi_fields *C)
+{
+    uint16_t h = C->tx_rb_head, t = C->tx_rb_tail;
+    return (h >= t) ? (uint16_t)(h - t) : (uint16_t)(C->tx_rb_size - (t - h));
+}
+
+/* Bu round’un kelime sayısı (0 olamaz). */
+static uint16_t dma_round_len(const t_cspi_fields *C)
+{
+    uint32_t n;
+    if (C->transfer_size > 0u)          n = C->transfer_size;
+    else if (C->rx_size > C->rx_offset) n = (uint32_t)(C->rx_size - C->rx_offset);
+    else                                n = CSPI_DMA_ROUND_MAX;
+
+    if (n > CSPI_DMA_ROUND_MAX) n = CSPI_DMA_ROUND_MAX;
+    return (uint16_t)n;
+}
+
+/* Tek kanal: kelime boyu (wb) minor loop, n iterasyon, major bitince istek otomatik kapanır (DREQ). */
+static void dma_arm(uint32_t ch, uint32_t src, int16_t soff, uint32_t dst, int16_t doff, uint16_t n, uint8_t wb)
+{
+    edma_transfer_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.srcAddr          = src;
+    cfg.destAddr         = dst;
+    cfg.srcTransferSize  = (wb == 2u) ? kEDMA_TransferSize2Bytes : kEDMA_TransferSize1Bytes;
+    cfg.destTransferSize = cfg.srcTransferSize;
+    cfg.srcOffset        = soff;
+    cfg.destOffset       = doff;
+    cfg.minorLoopBytes   = wb;
+    cfg.majorLoopCounts  = n;
+
+    EDMA_ResetChannel(CSPI_DMA_BASEADDR, ch);
+    EDMA_SetTransferConfig(CSPI_DMA_BASEADDR, ch, &cfg, NULL);
+}
+
+/* Round’u kurar ve iki kanalı da açar (ISR ve ana döngüden çağrılır). */
+static void dma_arm_round(t_cspi_fields *C)
+{
+    const uint8_t wb = C->word_bytes;
+    uint16_t n = dma_round_len(C);
+
+    /* RX: round aktif yarının kalan yerine sığmalı. Yalnız yakalamada round
+     * kısaltılır; eşikli round bölünmez, yarım blok erken devredilir. */
+    s_rx_mode = 0;
+    if (C->rx_data && C->rx_offset < C->rx_size) {
+        uint16_t room = (uint16_t)((CSPI_RX_HALF - C->rx_fill) / wb);
+        if (n > room) {
+            if (C->transfer_size == 0u) n = room;
+            else                        cspi_rx_flip(C);
+        }
+        s_rx_mode = C->rx_ready[C->rx_half] ? 2 : 1;
+    }
+    s_round_len = n;
+
+    /* TX: ring’de kesintisiz n kelime varsa doğrudan ring’den, yoksa bounce kopyası */
+    uint16_t level = C->bulk_active ? dma_rb_count(C) : 0u;
+    uint16_t avail = (uint16_t)(level / wb);
+    if (C->bulk_active && !C->bulk_finished && level < C->ring_min) C->ring_min = level;
+    uint16_t tail  = C->tx_rb_tail;
+    if (avail >= n && (uint32_t)tail + (uint32_t)n * wb <= C->tx_rb_size) {
+        s_tx_src = &C->tx_rb[tail];
+    } else {
+        uint16_t take  = (avail < n) ? avail : n;
+        uint16_t bytes = (uint16_t)(take * wb);
+        uint16_t first = (uint16_t)(C->tx_rb_size - tail);
+        if (first > bytes) first = bytes;
+        memcpy(s_tx_bounce, &C->tx_rb[tail], first);
+        memcpy(s_tx_bounce + first, C->tx_rb, (size_t)(bytes - first));
+        for (uint16_t i = take; i < n; ++i) {                 /* Underflow’da dolgu kelimesi */
+            s_tx_bounce[i * wb] = C->idle_fill;
+            if (wb == 2u) s_tx_bounce[i * wb + 1u] = 0u;
+        }
+        if (C->bulk_active && !C->bulk_finished) C->tx_starved += (uint32_t)(n - take);
+        s_tx_src = s_tx_bounce;
+        avail = take;
+    }
+    s_tx_taken = (avail < n) ? avail : n;
+
+    if (s_rx_mode == 1) {
+        dma_arm(CSPI_RX_DMA_CHANNEL, DSPI_GetRxRegisterAddress(SPIx), 0,
+                (uint32_t)&C->rx_data[C->rx_half * CSPI_RX_HALF + C->rx_fill], wb, n, wb);
+    } else {
+        dma_arm(CSPI_RX_DMA_CHANNEL, DSPI_GetRxRegisterAddress(SPIx), 0,
+                (uint32_t)&s_rx_sink, 0, n, wb);
+    }
+    dma_arm(CSPI_TX_DMA_CHANNEL, (uint32_t)s_tx_src, wb,
+            DSPI_SlaveGetTxRegisterAddress(SPIx), 0, n, wb);
+
+    EDMA_EnableChannelInterrupts(CSPI_DMA_BASEADDR, CSPI_RX_DMA_CHANNEL, kEDMA_MajorInterruptEnable);
+    EDMA_EnableChannelRequest(CSPI_DMA_BASEADDR, CSPI_RX_DMA_CHANNEL);
+    EDMA_EnableChannelRequest(CSPI_DMA_BASEADDR, CSPI_TX_DMA_CHANNEL);
+}
+
+/* --- Round sonu IRQ (RX kanalı major loop tamamlandı) --- */
+
+/**
+ * @brief DMA kanal 2 ISR (startup’taki WEAK tanımı ezer).
+ *
+ * - Ring tail’i round’da tüketilen kadar ilerletir, RX ofsetini günceller.
+ * - transfer_size doluysa son min(transfer_size,4) byte’ı eşikle kıyaslar.
+ * - TFUF görüldüyse underflow sayar; yoksa round periyodundan SCK hızını ölçer.
+ * - Round koşulu sağlanmadıysa sonraki alt round’u hemen kurar.
+ */
+void DMA2_IRQHandler(void)
+{
+    EDMA_ClearChannelStatusFlags(CSPI_DMA_BASEADDR, CSPI_RX_DMA_CHANNEL, kEDMA_InterruptFlag | kEDMA_DoneFlag);
+
+    t_cspi_fields *C = s_cspi;
+    if (!C) {
+        SDK_ISR_EXIT_BARRIER;
+        return;
+    }
+
+    const uint8_t wb = C->word_bytes;
+    uint16_t n   = s_round_len;
+    uint32_t now = DWT->CYCCNT;
+
+    /* TX: tüketilen ring kelimeleri */
+    if (s_tx_taken) C->tx_rb_tail = (uint16_t)((C->tx_rb_tail + (uint32_t)s_tx_taken * wb) % C->tx_rb_size);
+    C->tx_sent_in_round = (uint16_t)(C->tx_sent_in_round + n);
+    C->tx_words        += n;
+
+    /* RX: round hedefindeki kelimeler aktif yarıya sayılır (fazlası sonraki yazımla ezilir) */
+    if (s_rx_mode) {
+        uint16_t room = (uint16_t)(C->rx_size - C->rx_offset);
+        uint16_t got  = (n < room) ? n : room;
+        if (s_rx_mode == 1) {
+            C->rx_fill = (uint16_t)(C->rx_fill + got * wb);
+            if (C->rx_fill >= CSPI_RX_HALF) cspi_rx_flip(C);
+        } else {
+            C->rx_dropped += got;
+        }
+        C->rx_offset = (uint16_t)(C->rx_offset + got);
+    }
+
+    /* Underflow ve hız: TFUF yoksa round periyodu master’ın sürdürdüğü hızın alt sınırı */
+    C->dma_rounds++;
+    if (DSPI_GetStatusFlags(SPIx) & kDSPI_TxFifoUnderflowFlag) {
+        DSPI_ClearStatusFlags(SPIx, kDSPI_TxFifoUnderflowFlag);
+        C->tx_underflows++;
+    } else if (s_last_end_cyc) {
+        uint32_t dt = now - s_last_end_cyc;
+        if (dt) {
+            uint32_t hz = (uint32_t)(((uint64_t)n * C->word_size * SystemCoreClock) / dt);
+            if (hz > C->max_sck_hz) C->max_sck_hz = hz;
+        }
+    }
+    s_last_end_cyc = now;
+
+    bool tx_round_done = (C->transfer_size > 0u) && (C->tx_sent_in_round >= C->transfer_size);
+    bool rx_round_done = (C->rx_size > 0u) && (C->rx_offset >= C->rx_size);
+
+    if (tx_round_done) {
+        /* Round’un son k kelimesi (ilk gönderilen en yüksek) eşikle kıyaslanır; SPI0 ISR ile aynı kural */
+        uint8_t  k;
+        uint32_t mask  = cspi_thr_mask(C, &k);
+        uint32_t wmask = (1u << C->word_size) - 1u;
+        uint32_t val   = 0;
+        for (uint16_t i = (uint16_t)(n - k); i < n; ++i) {
+            uint32_t w = s_tx_src[i * wb];
+            if (wb == 2u) w |= (uint32_t)s_tx_src[i * wb + 1u] << 8;
+            val = (val << C->word_size) | (w & wmask);
+        }
+
+        if ((val & mask) > (C->threshold_val & mask)) {
+            gpio_write_high((gpio_port_t)C->port, C->pin);
+            C->thr_hits++;
+        } else {
+            gpio_write_low((gpio_port_t)C->port, C->pin);
+        }
+
+        C->tx_sent_in_round = 0;
+    }
+
+    if (tx_round_done || rx_round_done) {
+        if (C->rx_data) cspi_rx_flip(C);  /* Round sonu: yarım bloğu da gönder */
+        g_spi_done = true;
+    } else {
+        dma_arm_round(C);   /* Alt round: CPU müdahalesi olmadan devam */
+    }
+
+    SDK_ISR_EXIT_BARRIER;
+}
+
+/* --- Başlatma / round / durdurma --- */
+
+void cspi_dma_init(t_cspi_fields *C)
+{
+    s_cspi         = C;
+    s_last_end_cyc = 0;
+
+    /* Hız ölçümü için DWT döngü sayacı (boot_timer_start açık bırakır; yine de garanti et) */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+
+    DMAMUX_SetSource(CSPI_DMAMUX_BASEADDR, CSPI_RX_DMA_CHANNEL, CSPI_RX_DMA_REQUEST);
+    DMAMUX_EnableChannel(CSPI_DMAMUX_BASEADDR, CSPI_RX_DMA_CHANNEL);
+    DMAMUX_SetSource(CSPI_DMAMUX_BASEADDR, CSPI_TX_DMA_CHANNEL, CSPI_TX_DMA_REQUEST);
+    DMAMUX_EnableChannel(CSPI_DMAMUX_BASEADDR, CSPI_TX_DMA_CHANNEL);
+
+    /* RFDF/TFFF istekleri DMA’ya yönlenir; SPI0 IRQ kapalı kalır */
+    DSPI_DisableInterrupts(SPIx, kDSPI_AllInterruptEnable);
+    DSPI_EnableDMA(SPIx, kDSPI_TxDmaEnable | kDSPI_RxDmaEnable);
+    EnableIRQ(DMA2_IRQn);
+}
+
+void cspi_dma_start_round(t_cspi_fields *C)
+{
+    dma_arm_round(C);
+    DSPI_StartTransfer(SPIx);
+}
+
+void cspi_dma_stop(void)
+{
+    EDMA_DisableChannelRequest(CSPI_DMA_BASEADDR, CSPI_RX_DMA_CHANNEL);
+    EDMA_DisableChannelRequest(CSPI_DMA_BASEADDR, CSPI_TX_DMA_CHANNEL);
+    DSPI_DisableDMA(SPIx, kDSPI_TxDmaEnable | kDSPI_RxDmaEnable);
+    DMAMUX_DisableChannel(CSPI_DMAMUX_BASEADDR, CSPI_RX_DMA_CHANNEL);
+    DMAMUX_DisableChannel(CSPI_DMAMUX_BASEADDR, CSPI_TX_DMA_CHANNEL);
+    DisableIRQ(DMA2_IRQn);
+    s_cspi = NULL;
+}
@@ -9,7 +9,8 @@
  *  - CSPI transferleri için SPI slave başlatma ve IRQ işleyici (ISR) mantığı.
  *  - NXP DSPI sürücüsü kullanılır (Slave mod).
  *  - TX ring buffer'dan veri besleme, opsiyonel RX yakalama,
- *    ve gönderilen baytlardan basit bir "eşik karşılaştırma" ile GPIO sürme.
+ *    ve gönderilen kelimelerden basit bir "eşik karşılaştırma" ile GPIO sürme.
+ *  - Kelime 4..16 bit; ring ve RX tamponunda 1 (≤8 bit) veya 2 byte (LE).
  */
 
 #include "action/action.h"
@@ -18,10 +19,8 @@
 
 /* --- Global Durum --- */
 
-/* Eşik kontrolü için son gönderilen baytları toplayan kaydırmalı akümülatör. */
+/* Eşik kontrolü için son gönderilen kelimeleri toplayan kaydırmalı akümülatör. */
 static volatile uint32_t g_tx_acc  = 0;
-/* g_tx_acc içine kaç bayt yüklendi (0..4). */
-static volatile uint8_t  g_tx_cnt  = 0;
 /* Aktif CSPI konfigürasyonu (parse edilmiş alanlar + ring adresleri). */
 static volatile t_cspi_fields *g_cspi = NULL;
 /* Bir "round" bittiğinde (TX boyutu tamamlandı ya da RX hedefe ulaşıldı) set edilir. */
@@ -51,6 +50,12 @@ static inline uint16_t rb_free(uint16_t h, uint16_t t, uint16_t sz){
 size_t cspi_tx_push(t_cspi_fields *C, const uint8_t *data, size_t len)
 {
     size_t w = 0;
+
+    /* Ring yalnızca tam kelime kabul eder (head/tail kelime hizalı kalır). */
+    size_t room = rb_free(C->tx_rb_head, C->tx_rb_tail, C->tx_rb_size);
+    if (len > room) len = room;
+    len -= len % C->word_bytes;
+
     while (w < len) {
         uint16_t h=C->tx_rb_head, t=C->tx_rb_tail;
         uint16_t free = rb_free(h,t,C->tx_rb_size);
@@ -80,10 +85,10 @@ size_t cspi_tx_push(t_cspi_fields *C, const uint8_t *data, size_t len)
 /**
  * @brief SPI0 ISR.
  *
- * - RX FIFO boşaltma isteği geldikçe byte okur.
- * - TX için ring'de veri varsa onu, yoksa idle_fill gönderir.
- * - Gönderilen baytları eşik karşılaştırması için g_tx_acc içine biriktirir.
- * - "transfer_size" kadar byte gönderildiğinde round biter ve g_spi_done set edilir.
+ * - RX FIFO boşaltma isteği geldikçe kelime okur.
+ * - TX için ring'de tam kelime varsa onu, yoksa idle_fill gönderir.
+ * - Gönderilen kelimeleri eşik karşılaştırması için g_tx_acc içine biriktirir.
+ * - "transfer_size" kadar kelime gönderildiğinde round biter ve g_spi_done set edilir.
  */
 void SPI0_IRQHandler(void)
 {
@@ -94,19 +99,24 @@ void SPI0_IRQHandler(void)
         return;
     }
 
-    /* --- RX/TV besleme döngüsü --- */
+    const uint8_t  ws    = g_cspi->word_size;
+    const uint8_t  wb    = g_cspi->word_bytes;
+    const uint32_t wmask = (1u << ws) - 1u;
+    const uint32_t amask = cspi_thr_mask(g_cspi, NULL);  /* Eşik penceresi maskesi */
+
+    /* --- RX/TX besleme döngüsü (her RFDF bir kelime) --- */
     while (DSPI_GetStatusFlags(SPIx) & kDSPI_RxFifoDrainRequestFlag)
     {
         /* 1) RX: Master'dan gelen bir kelimeyi çek. */
-        uint32_t rxw = DSPI_ReadData(SPIx);
-        uint8_t  rxb = (uint8_t)rxw;
+        uint32_t rxw = DSPI_ReadData(SPIx) & wmask;
 
-        /* RX yakalama açıksa RAM'e koy. */
+        /* RX yakalama açıksa çift tamponun aktif yarısına koy (2 byte'lık kelimeler LE). */
         if (g_cspi->rx_data && (g_cspi->rx_offset < g_cspi->rx_size)) {
-            g_cspi->rx_data[g_cspi->rx_offset++] = rxb;
+            cspi_rx_put(g_cspi, rxw);
+            g_cspi->rx_offset++;
         }
 
-        /* 2) TX: Ring'de byte varsa onu, yoksa idle_fill kullan. */
+        /* 2) TX: Ring'de tam kelime varsa onu, yoksa idle_fill kullan. */
         uint32_t txw;
         bool have_tx = false;
 
@@ -117,32 +127,29 @@ void SPI0_IRQHandler(void)
                           ? (uint16_t)(head - tail)
                           : (uint16_t)(g_cspi->tx_rb_size - (tail - head));
 
-            if (cnt > 0u) {
+            if (cnt < g_cspi->ring_min && !g_cspi->bulk_finished) g_cspi->ring_min = cnt;
+
+            if (cnt >= wb) {
                 txw = g_cspi->tx_rb[tail];
-                g_cspi->tx_rb_tail = (uint16_t)((tail + 1u) % g_cspi->tx_rb_size);
+                if (wb == 2u) txw |= (uint32_t)g_cspi->tx_rb[tail + 1u] << 8;
+                g_cspi->tx_rb_tail = (uint16_t)((tail + wb) % g_cspi->tx_rb_size);
                 have_tx = true;
             }
         }
 
         if (!have_tx) {
-            txw = g_cspi->idle_fill;  /* Underflow'ta gönderilecek dolgu byte'ı. */
+            txw = g_cspi->idle_fill;  /* Underflow'ta gönderilecek dolgu kelimesi. */
+            if (g_cspi->bulk_active && !g_cspi->bulk_finished) g_cspi->tx_starved++;
         }
+        txw &= wmask;
 
-        /* 3) Eşik karşılaştırma için gönderilen baytı akümülatöre kaydırarak ekle. */
-        uint8_t n = g_cspi->transfer_size;   /* round uzunluğu (byte) */
-        if (n == 0) n = 1;
-        if (n > 4)  n = 4;                   /* 32-bit'e kadar destek. */
-
-        /* n baytlık pencere maskesi (1→0xFF, 2→0xFFFF, 3→0xFFFFFF, 4→0xFFFFFFFF). */
-        uint32_t mask = (n == 4) ? 0xFFFFFFFFu : ((1u << (8u * n)) - 1u);
-        uint8_t  txb  = (uint8_t)txw;
-
-        g_tx_acc = ((g_tx_acc << 8) | txb) & mask;
-        if (g_tx_cnt < n) g_tx_cnt++;
+        /* 3) Eşik karşılaştırma için gönderilen kelimeyi akümülatöre kaydırarak ekle. */
+        g_tx_acc = ((g_tx_acc << ws) | txw) & amask;
 
-        /* 4) Byte'ı DSPI TX'e yaz ve bayrakları temizle. */
+        /* 4) Kelimeyi DSPI TX'e yaz ve bayrakları temizle. */
         DSPI_SlaveWriteData(SPIx, txw);
         g_cspi->tx_sent_in_round++;
+        g_cspi->tx_words++;
         DSPI_ClearStatusFlags(SPIx, kDSPI_RxFifoDrainRequestFlag | kDSPI_TxFifoFillRequestFlag);
     }
 
@@ -153,28 +160,24 @@ void SPI0_IRQHandler(void)
                          (g_cspi->rx_offset >= g_cspi->rx_size);
 
     if (tx_round_done) {
-        /* Gönderilen n byte'lık pencereyi eşik ile kıyasla ve GPIO sür. */
-        uint8_t  n   = g_cspi->transfer_size;
-        if (n == 0) n = 1;
-        if (n > 4)  n = 4;
-        uint32_t mask = (n == 4) ? 0xFFFFFFFFu : ((1u << (8u * n)) - 1u);
-
-        uint32_t val = g_tx_acc & mask;              /* son n byte */
-        uint32_t ref = g_cspi->threshold_val & mask; /* eşik */
+        /* Gönderilen son k kelimelik pencereyi eşik ile kıyasla ve GPIO sür. */
+        uint32_t val = g_tx_acc & amask;              /* son k kelime */
+        uint32_t ref = g_cspi->threshold_val & amask; /* eşik */
 
         if (val > ref) {
             gpio_write_high((gpio_port_t)g_cspi->port, g_cspi->pin);
+            g_cspi->thr_hits++;
         } else {
             gpio_write_low((gpio_port_t)g_cspi->port, g_cspi->pin);
         }
 
         /* Sonraki round için sayaçları temizle. */
         g_tx_acc = 0;
-        g_tx_cnt = 0;
         g_cspi->tx_sent_in_round = 0;
     }
 
     if (tx_round_done || rx_round_done) {
+        if (g_cspi->rx_data) cspi_rx_flip(g_cspi);  /* Round sonu: yarım bloğu da gönder */
         g_spi_done = true;
         DSPI_DisableInterrupts(SPIx, kDSPI_RxFifoDrainRequestInterruptEnable);
     }
@@ -189,7 +192,8 @@ void SPI0_IRQHandler(void)
  *
  * - C->mode (CPOL/CPHA) ve C->word_size (bit/çerçeve) ayarlanır.
  * - Eşik sonucu için kullanılacak GPIO pin çıkışa alınır.
- * - RX FIFO drain IRQ etkinleştirilir ve transfer başlatılır.
+ * - RX FIFO drain IRQ etkinleştirilir ve transfer başlatılır
+ *   (C->use_dma ise bunun yerine eDMA kanalları bağlanır, bkz. spi_dma.c).
  */
 void spi_init(t_cspi_fields *C)
 {
@@ -216,6 +220,14 @@ void spi_init(t_cspi_fields *C)
     DSPI_StopTransfer(SPIx);
     DSPI_FlushFifo(SPIx, true, true);
     DSPI_ClearStatusFlags(SPIx, kDSPI_AllStatusFlag);
+
+    if (C->use_dma) {
+        /* eDMA yolu: byte başına IRQ yok, round’u cspi_dma_start_round kurar */
+        g_cspi = NULL;
+        cspi_dma_init(C);
+        return;
+    }
+
     DSPI_EnableInterrupts(SPIx, kDSPI_RxFifoDrainRequestInterruptEnable);
     DSPI_StartTransfer(SPIx);
     EnableIRQ(SPI0_IRQn);
@@ -20,8 +20,46 @@
  *      [N+1] CRC_L
  */
 
+#include <string.h>
 #include "uart_proto.h"
 
+#define FRAME_HDR  5u   /* SOF0 + SOF1 + MSG_ID + LEN_H + LEN_L */
+
+/**
+ * @brief Çerçeve başlığını out’a yazar, payload’ın yazılacağı yeri döndürür.
+ *
+ * LEN henüz bilinmez; frame_end() yazılan payload’a göre yamalar. Kayıtlar
+ * (proto_put_*) doğrudan dönen adrese yazılır, ara tampon gerekmez.
+ */
+uint8_t *frame_begin(uint8_t *out, uint8_t msgId)
+{
+    out[0] = SOF0;
+    out[1] = SOF1;
+    out[2] = msgId;
+    return out + FRAME_HDR;
+}
+
+/**
+ * @brief frame_begin() ile açılan çerçeveyi kapatır.
+ *
+ * @param out  frame_begin()’e verilen buffer.
+ * @param end  Payload’ın bittiği adres (son yazılan byte’tan sonrası).
+ *
+ * LEN’i yamalar, CRC16’yı MSG_ID + LEN + PAYLOAD üzerinden tek geçişte
+ * (tablo) hesaplayıp sona ekler. Dönüş: toplam paket uzunluğu.
+ */
+size_t frame_end(uint8_t *out, const uint8_t *end)
+{
+    const uint16_t len = (uint16_t)(end - (out + FRAME_HDR));
+    out[3] = (uint8_t)(len >> 8);
+    out[4] = (uint8_t)len;
+
+    const uint16_t crc = crc16_block(0xFFFF, out + 2, 3u + len);
+    out[FRAME_HDR + len]      = (uint8_t)(crc >> 8);
+    out[FRAME_HDR + len + 1u] = (uint8_t)crc;
+    return FRAME_HDR + len + 2u;
+}
+
 /**
  * @brief Verilen buffer içine protokol paketini kurar (çerçeve + CRC dahil).
  *
@@ -30,49 +68,16 @@
  * @param payload_len  Payload uzunluğu (bayt).
  * @param out          Çıkış buffer’ı (paketin tamamı buraya yazılır; yeterli büyük olmalı).
  *
+ * Payload zaten out+5’te ise (frame_begin() ile yazılmışsa) kopyalanmaz.
+ *
  * @return out içine yazılan toplam bayt sayısı (tam paket uzunluğu).
  */
 size_t build_packet(uint8_t msgId,
                     const uint8_t *payload, uint16_t payload_len,
                     uint8_t *out)
 {
-    size_t i = 0;
-
-    /* --- SOF: çerçeve başı imzası --- */
-    out[i++] = SOF0;   // 0xAA
-    out[i++] = SOF1;   // 0x55
-
-    const size_t core_start = i; // "çekirdek" alanların başladığı index (MSG_ID)
-
-    /* --- Çekirdek başlık: MSG_ID + LEN --- */
-    out[i++] = msgId;  // Mesaj ID
-
-    const uint8_t len_hi = (uint8_t)((payload_len >> 8) & 0xFF);
-    const uint8_t len_lo = (uint8_t)(payload_len & 0xFF);
-    out[i++] = len_hi; // Payload uzunluğu (üst byte)
-    out[i++] = len_lo; // Payload uzunluğu (alt byte)
-
-    /* --- Payload kopyası --- */
-    if (payload && payload_len > 0) {
-        for (uint16_t k = 0; k < payload_len; ++k) {
-            out[i++] = payload[k]; // Payload baytlarını araya koy
-        }
-    }
-
-    /* --- CRC16 hesabı (çekirdek alanlar üzerinden) --- */
-    // Not: CRC, MSG_ID + LEN_H + LEN_L + PAYLOAD sırasıyla hesaplanır.
-    uint16_t crc = 0xFFFF;
-    crc = crc16_step(crc, msgId);
-    crc = crc16_step(crc, len_hi);
-    crc = crc16_step(crc, len_lo);
-    for (uint16_t k = 0; k < payload_len; ++k) {
-        // Payload, core_start + 3 (MSG_ID + LEN_H + LEN_L) sonrasından başlar
-        crc = crc16_step(crc, out[core_start + 3 + k]);
-    }
-
-    /* --- CRC16 ekle (büyük endian) --- */
-    out[i++] = (uint8_t)((crc >> 8) & 0xFF); // CRC üst byte
-    out[i++] = (uint8_t)(crc & 0xFF);        // CRC alt byte
-
-    return i; // Toplam paket uzunluğu
+    uint8_t *p = frame_begin(out, msgId);
+    if (payload && payload_len > 0 && payload != p)
+        memcpy(p, payload, payload_len);
+    return frame_end(out, p + payload_len);
 }
@@ -28,6 +28,8 @@ void uart0_init(void);
 
 size_t uart0_write(const void *data, size_t len);
 
+size_t uart0_tx_free(void);
+
 void uart0_putc(char c);
 
 void uart0_print(const char *s);
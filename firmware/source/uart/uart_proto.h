@@ -16,6 +16,7 @@
  * Yardımcılar:
  *  - crc16_step()  : CRC güncelleme
  *  - build_packet(): Çerçeve paket inşa etme
+ *  - frame_begin()/frame_end(): Payload’ı çerçevenin içine doğrudan yazma
  *  - proto_rx_*()  : UART alıcı state machine yardımcıları
  */
 
@@ -24,35 +25,34 @@
 
 #include <stdint.h>
 
-/* Frame başlangıcı için sabit değerler (senkronizasyon için peş peşe gelir) */
-#define SOF0 0xAA
-#define SOF1 0x55
-
-/* Maksimum payload boyutu (byte cinsinden) */
-#define MAX_PAYLOAD 512
-
-/* Sabit çerçeve boyutu (SOF + MSG + LEN + CRC) */
-#define PROTO_CORE_SIZE (2u /*SOF*/ + 1u /*MSG*/ + 2u /*LEN*/ + 2u /*CRC*/)
-
-/* Mesaj ID’leri (uygulama seviyesinde anlam yüklenir) */
-#define MSG_ID_EXECUTE_ACTIONS  0x10  /* Action blob hemen çalıştır */
-
-#define MSG_ID_CSPI_BEGIN       0x50  /* SPI slave başlatma/config */
-#define MSG_ID_CSPI_DATA        0x52  /* SPI slave veri chunk */
-#define MSG_ID_CSPI_END         0x54  /* SPI oturumunu bitir */
-#define MSG_ID_CSPI_REQ         0x59  /* Cihaz host’tan daha fazla veri ister */
-#define MSG_ID_CSPI_TERMINATE   0x5B  /* SPI oturumunu iptal/abort */
-
-#define MSG_ID_WRITE_FLASH      0x90  /* Flash’a yaz (boot değil) */
-#define MSG_ID_WRITE_FLASH_BOOT 0x91  /* Flash’a yaz (bootable) */
+/*
+ * SOF0/SOF1, MAX_PAYLOAD, PROTO_CORE_SIZE, MSG_ID_* ve CSPI kredi/istatistik
+ * kayıt düzenleri (t_proto_cspi_credit, t_proto_cspi_stats) tek kaynaktan,
+ * proto/proto_schema.h’tan gelir; host aynı listeyi kullanır.
+ */
+#include "proto/proto.h"
 
-#define MSG_ID_RESET            0xFF  /* Yazılımsal reset isteği */
+/*
+ * CSPI kredi akışı: LIMIT, host’un oturum başından beri gönderebileceği toplam
+ * DATA byte’ıdır (kabul edilen + ring’deki boş yer). Host birden çok DATA
+ * çerçevesini LIMIT’e kadar uçuşta tutar; cihaz LIMIT en az CSPI_CREDIT_STEP
+ * ilerleyince yeni kredi yollar.
+ */
+#define CSPI_CREDIT_STEP        512u
 
-#define MSG_ID_CLEAR_FLASH      0xCC  /* User flash bölgesini sil */
+/*
+ * CSPI istatistik çerçevesi (PROTO_CSPI_STATS_SIZE) bu periyotla gider.
+ * RING_MIN: son rapordan beri görülen en düşük TX ring doluluğu (byte).
+ * RTT: kredi çerçevesinden sonraki ilk DATA’ya kadar geçen süre.
+ */
+#define CSPI_STATS_PERIOD_MS    250u
 
 /* CRC hesaplama adımı */
 uint16_t crc16_step(uint16_t crc, uint8_t byte);
 
+/* Blok CRC (tablo tabanlı, crc16_step ile aynı sonuç); boot/flash doğrulamaları için */
+uint16_t crc16_block(uint16_t crc, const uint8_t *p, size_t n);
+
 /* RX state machine reset fonksiyonu */
 void proto_rx_reset(void);
 
@@ -64,4 +64,12 @@ size_t build_packet(uint8_t msgId,
                     const uint8_t *payload, uint16_t payload_len,
                     uint8_t *out);
 
+/*
+ * Yerinde çerçeve: başlığı yaz, payload’ı dönen adrese doğrudan üret,
+ * frame_end() ile LEN + CRC’yi kapat (kopya yok). out en az
+ * PROTO_CORE_SIZE + payload byte olmalı.
+ */
+uint8_t *frame_begin(uint8_t *out, uint8_t msgId);
+size_t   frame_end(uint8_t *out, const uint8_t *end);
+
 #endif /* UART_PROTO_H_ */
@@ -126,6 +126,16 @@ size_t uart0_write(const void *data, size_t len)
     return wr;
 }
 
+/**
+ * @brief Free bytes in the TX ring (callers that must not split a frame
+ *        check this before enqueueing).
+ */
+size_t uart0_tx_free(void)
+{
+    uint16_t used = (uint16_t)((s_head - s_tail + UART_TX_RING_SZ) % UART_TX_RING_SZ);
+    return (size_t)(UART_TX_RING_SZ - 1u - used);
+}
+
 /* Convenience helpers */
 void uart0_putc(char c)           { (void)uart0_write(&c, 1); }
 void uart0_print(const char *s)   { (void)uart0_write(s, strlen(s)); }
@@ -28,7 +28,8 @@ enum class Kind   : std::int8_t { START, DELAY, PIN_READ, PIN_WRITE, PIN_TRIGGER
 /**
  * @brief Base action node for the editor / encoder.
  *
- * - id           : Unique, dense identifier used as array index on device.
+ * - id           : Unique, stable editor identifier (ActionSet never renumbers;
+ *                  the encoder maps it to the dense device index).
  * - kind         : Concrete type discriminator (mirrors union on device).
  * - runAfterMe   : List of action IDs that should start after this completes.
  *
@@ -164,12 +165,14 @@ public:
  *
  * Parameters:
  * - mode           : SPI mode (0..3).
- * - wordSize       : Bits per frame; device currently supports 8.
- * - readSize       : Number of bytes to capture from MISO (if any).
- * - transfer_size  : Bytes per "round" (1..4 used for threshold compare logic).
+ * - wordSize       : Bits per frame (4..16, native DSPI frame sizes).
+ * - readSize       : Number of words to capture from MOSI (if any).
+ * - transfer_size  : Words per "round"; the threshold window is the last
+ *                    words of the round that fit in 32 bits.
  * - port, pin      : GPIO used as an indicator/output (e.g., LED).
- * - threshold      : 32-bit compare value against last @transfer_size TX bytes.
- * - txData         : Streamed payload that will be fed to the device ring.
+ * - threshold      : 32-bit compare value against that TX word window.
+ * - txData         : Streamed words fed to the device ring (1 byte per word
+ *                    up to 8 bits, 2 bytes little-endian for 9..16 bits).
  *
  * Device mapping:
  * - Header sent via MSG_ID_CSPI_BEGIN.
@@ -185,6 +188,7 @@ public:
     int port{-1};
     int pin{-1};
     quint64 threshold{0};
+    bool useDma{false};   // CSPI_FLAG_DMA: eDMA data path on the device
     QByteArray txData;
 
     CSPIAction() { kind = Kind::CSPI; }
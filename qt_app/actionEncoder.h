@@ -2,117 +2,88 @@
 #define ACTIONENCODER_H
 
 #include "action.h"
+#include "actionset.h"
+#include "protocol.h"
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
+class FrameWriter;
+
 /*-----------------------------------------------------------------------------
- * Protocol constants (must match device firmware)
+ * Protocol constants
  *-----------------------------------------------------------------------------
- * SOF0/SOF1           : Start-of-frame bytes for UART framing (0xAA, 0x55).
- * MSG_ID_*            : Application message identifiers.
- * MAX_PAYLOAD_SIZE    : Maximum bytes of payload per packet (excluding SOF/CRC).
- * TYPE_*              : On-device action type tags used in the encoded blob.
+ * SOF0/SOF1, MSG_ID_*, TYPE_* and the record layouts come from protocol.h
+ * (generated from the firmware's proto_schema.h). The names below are the
+ * host-side spellings used across the UI; they are aliases, not copies.
  *---------------------------------------------------------------------------*/
 
-#define SOF0 0xAA
-#define SOF1 0x55
-
-#define MSG_ID_EXECUTE_ACTIONS  0x10   // Send & execute an actions blob immediately
-
-#define MSG_ID_CSPI_BEGIN       0x50   // Begin CSPI session (header)
-#define MSG_ID_CSPI_DATA        0x52   // Stream CSPI TX data (512B chunks typically)
-#define MSG_ID_CSPI_END         0x54   // Graceful CSPI end; finish remaining work
-#define MSG_ID_CSPI_REQ         0x59   // Device → host: please send next data chunk
-#define MSG_ID_CSPI_TERMINATE   0x5B   // Abort CSPI session immediately
-
-#define MSG_ID_WRITE_FLASH      0x90   // Store a frame in user flash (no auto-exec)
-#define MSG_ID_WRITE_FLASH_BOOT 0x91   // Store & mark as boot-executable frame
+inline constexpr int MAX_PAYLOAD_SIZE = MAX_PAYLOAD;     // Device-side parser limit
 
-#define MSG_ID_RESET            0xFF   // Device software reset
+inline constexpr int SLOT_COUNT       = MAX_SLOTS;       // Resident slots on device
+inline constexpr int SLOT_INFO_SIZE   = int(proto::SlotInfo::kSize);   // Per-slot record in a SLOT_LIST reply
 
-#define MSG_ID_CLEAR_FLASH      0xCC   // Erase user flash region
+inline constexpr int FLASH_KEY_COUNT  = FS_MAX_KEYS;     // Record keys in the device flash store
 
-#define MAX_PAYLOAD_SIZE        512    // Matches device-side parser limit
-
-// Device-side action type tags (wire format)
-static constexpr std::uint8_t TYPE_START       = 0x01;
-static constexpr std::uint8_t TYPE_DELAY       = 0x02;
-static constexpr std::uint8_t TYPE_PIN_READ    = 0x03;
-static constexpr std::uint8_t TYPE_PIN_WRITE   = 0x04;
-static constexpr std::uint8_t TYPE_PIN_TRIGGER = 0x05;
-
-/*-----------------------------------------------------------------------------
- * Small helpers for byte packing (big-endian where applicable)
- *---------------------------------------------------------------------------*/
+inline constexpr int CSPI_HEADER_SIZE = int(proto::CspiBegin::kSize);  // MSG_ID_CSPI_BEGIN payload (incl. flags)
+inline constexpr int CSPI_CREDIT_SIZE = int(proto::CspiCredit::kSize); // MSG_ID_CSPI_REQ credit payload
+inline constexpr int CSPI_CHUNK_SIZE  = 512;             // Bytes per MSG_ID_CSPI_DATA frame
+inline constexpr int CSPI_STATS_SIZE  = int(proto::CspiStats::kSize);  // MSG_ID_CSPI_STATS payload
 
 /**
- * @brief Convert Level enum to wire format (0=LOW, 1=HIGH, 0xFF=UNDEFINED).
+ * @brief Convert Level enum to wire format (LVL_LOW, LVL_HIGH, LVL_UNDEF).
  */
 std::uint8_t levelToU8(Level l);
 
-/**
- * @brief Append a single byte to an output buffer.
- */
-void appendU8(std::vector<std::uint8_t>& out, std::uint8_t v);
-
-/**
- * @brief Append a 16-bit unsigned integer in big-endian order.
- */
-void appendU16BE(std::vector<std::uint8_t>& out, std::uint16_t v);
-
-/**
- * @brief Append a 32-bit unsigned integer in big-endian order.
- */
-void appendU32BE(std::vector<std::uint8_t>& out, std::uint32_t v);
+/*-----------------------------------------------------------------------------
+ * Action-to-bytes packers (host → device wire format)
+ *-----------------------------------------------------------------------------
+ * - Each packer writes one record at @out and returns the end of it; the
+ *   caller provides recordSize(a) bytes (no per-byte growth, no checks).
+ * - recordEncodable() is the range check (id/pin/targets fit in a byte);
+ *   encodeActions() runs it once per action before sizing the blob.
+ *---------------------------------------------------------------------------*/
 
 /**
- * @brief Clamp an integer ID to 0..255 for wire encoding.
- *
- * The device expects dense 8-bit IDs; editor-side IDs are int.
+ * @brief Wire size of @a's record: fixed header + [TCOUNT] + target ids.
+ *        0 for kinds that are not part of the actions blob (CSPI).
  */
-std::uint8_t clampIdToU8(int id);
+std::size_t  recordSize(const Action& a);
 
 /**
- * @brief Append a target list: count byte followed by IDs.
- *
- * Layout: [count:1][id0:1][id1:1]...
+ * @brief True if @a's id, pin and targets fit the 8-bit wire fields.
  */
-void appendTargets(std::vector<std::uint8_t>& out, const std::vector<int>& ids);
-
-/*-----------------------------------------------------------------------------
- * Action-to-bytes packers (host → device wire format)
- * Each function appends a single action record into @out.
- *---------------------------------------------------------------------------*/
+bool         recordEncodable(const Action& a);
 
 /**
  * @brief Encode a StartAction as TYPE_START.
  * Layout: [TYPE][ID][TCOUNT][TIDS...]
  */
-void packStart   (std::vector<std::uint8_t>& out, const StartAction& a);
+std::uint8_t* packStart     (std::uint8_t* out, const StartAction& a);
 
 /**
  * @brief Encode a DelayAction as TYPE_DELAY.
  * Layout: [TYPE][ID][DUR_MS:4][DUR_US:2][TCOUNT][TIDS...]
  */
-void packDelay   (std::vector<std::uint8_t>& out, const DelayAction& a);
+std::uint8_t* packDelay     (std::uint8_t* out, const DelayAction& a);
 
 /**
  * @brief Encode a PinReadAction as TYPE_PIN_READ.
  * Layout: [TYPE][ID][PORT][PIN][INIT][TARGET][FINAL][MS:4][US:2][TCOUNT][TIDS...]
  */
-void packPinRead (std::vector<std::uint8_t>& out, const PinReadAction& a);
+std::uint8_t* packPinRead   (std::uint8_t* out, const PinReadAction& a);
 
 /**
  * @brief Encode a PinWriteAction as TYPE_PIN_WRITE.
  * Layout: [TYPE][ID][PORT][PIN][INIT][TARGET][FINAL][MS:4][US:2][TCOUNT][TIDS...]
  */
-void packPinWrite(std::vector<std::uint8_t>& out, const PinWriteAction& a);
+std::uint8_t* packPinWrite  (std::uint8_t* out, const PinWriteAction& a);
 
 /**
  * @brief Encode a PinTriggerAction as TYPE_PIN_TRIGGER.
  * Layout: [TYPE][ID][PORT][PIN][INIT][TARGET][TIMEOUT_MS:4][TIMEOUT_US:2][TCOUNT][TIDS...]
  */
-void packPinTrigger(std::vector<std::uint8_t>& out, const PinTriggerAction& a);
+std::uint8_t* packPinTrigger(std::uint8_t* out, const PinTriggerAction& a);
 
 /*-----------------------------------------------------------------------------
  * UART framing helpers (CRC + packet builder)
@@ -124,11 +95,20 @@ void packPinTrigger(std::vector<std::uint8_t>& out, const PinTriggerAction& a);
  */
 quint16     crc16_ccitt(const QByteArray &data);
 
+/**
+ * @brief Table-driven CRC-CCITT continuation over a raw range (same result as
+ *        crc16_ccitt when seeded with 0xFFFF). Used on hot framing paths.
+ */
+quint16     crc16_ccitt_update(quint16 crc, const char *p, qsizetype n);
+
 /**
  * @brief Build a framed UART packet: SOF, MSG, LEN, PAYLOAD, CRC.
  *
  * Frame:
  *  SOF0 SOF1  MSG  LEN_H LEN_L  [PAYLOAD...]  CRC_H CRC_L
+ *
+ * One allocation and one payload copy (via FrameWriter). Payloads that are
+ * encoded anyway should be written into a FrameWriter directly instead.
  */
 QByteArray  buildPacket(quint8 msgId, const QByteArray &payload);
 
@@ -137,22 +117,86 @@ QByteArray  buildPacket(quint8 msgId, const QByteArray &payload);
  *---------------------------------------------------------------------------*/
 
 /**
- * @brief Encode a set of Action* into the device "actions blob" (payload only).
+ * @brief One record of an encoded actions blob: where it sits and what it is.
+ */
+struct ActionRecord {
+    int          offset;   ///< Byte offset of the record's TYPE byte in the blob.
+    int          length;   ///< Record length in bytes (TYPE..last target id).
+    Kind         kind;     ///< Source action kind.
+    std::uint8_t id;       ///< Wire (device) ID of the record.
+};
+using ActionIndex = std::vector<ActionRecord>;
+
+/**
+ * @brief Actions blob plus its record index, produced in one pass.
+ *
+ * The index is what the monitor (per-record coloring), the flash/slot writers
+ * (size diagnostics) and dissectors use instead of re-encoding prefixes.
+ */
+struct EncodedActions {
+    std::vector<std::uint8_t> bytes;
+    ActionIndex               index;
+};
+
+/**
+ * @brief Encode a set of Action* into the device "actions blob" and record
+ *        each action's offset/length/kind on the way (single pass).
  *
+ * - Records are emitted in @actions order; CSPI actions produce no record.
+ * - The blob is sized once and written in place; if any action does not fit
+ *   the wire fields (recordEncodable()), bytes and index come back empty.
  * - The caller is responsible for wrapping with a MSG_ID_EXECUTE_ACTIONS packet.
  * - Actions must have unique IDs and consistent runAfterMe references.
  */
+EncodedActions encodeActions(const std::vector<Action*>& actions);
+
+/**
+ * @brief Encode a whole ActionSet in wire order (ascending id).
+ *        Shared by MainWindow and the headless runner so both send the
+ *        same bytes for the same graph.
+ *
+ * ActionSet ids are stable and may have gaps; here the k-th record gets
+ * device id k (0..N-1, START = 0) and target lists are remapped to match,
+ * since the firmware indexes its node table by id. Fails (empty) with more
+ * than 256 records or a target that has no record.
+ */
+EncodedActions encodeActionSet(const ActionSet& set);
+
+/**
+ * @brief Number of leading records of @index that end within @capacity bytes.
+ */
+int recordsFitting(const ActionIndex& index, int capacity);
+
+/**
+ * @brief Blob only; same bytes as encodeActions(actions).bytes.
+ */
 std::vector<std::uint8_t> encodeActionPayload(const std::vector<Action*>& actions);
 
 /**
- * @brief Encode CSPI header + separate TX data payload.
+ * @brief Encode @actions straight into the payload of @w (after whatever the
+ *        caller already wrote, e.g. a slot/key byte).
+ *
+ * - Same bytes and order as encodeActions(); the payload grows once by the
+ *   exact blob size and records are packed in place.
+ * - @index (optional) gets offsets relative to the blob start.
+ * - false (nothing written) if an action does not fit the wire fields.
+ */
+bool encodeActionsInto(FrameWriter& w, const std::vector<Action*>& actions, ActionIndex* index);
+
+/**
+ * @brief encodeActionsInto() in wire order with dense device ids, like
+ *        encodeActionSet().
+ */
+bool encodeActionSetInto(FrameWriter& w, const ActionSet& set, ActionIndex* index);
+
+/**
+ * @brief Encode the MSG_ID_CSPI_BEGIN payload (proto::CspiBegin).
  *
- * Return value:
- *  - For header: call encodeCSPIPayload(CSPIAction) and take the first 13 bytes
- *    as the MSG_ID_CSPI_BEGIN payload (mode, wordSize, readSize, transfer_size,
- *    threshold (BE32), port, pin). The remaining bytes (if any) are ignored here.
- *  - Actual stream data (a.txData) should be sent in 512B chunks with MSG_ID_CSPI_DATA.
+ * Layout: mode, wordSize, readSize, transfer_size, txLen (saturated at
+ * 0xFFFF), threshold (BE32), port, pin, flags. The TX stream (a.txData) is
+ * not copied here; it goes to the device in CSPI_CHUNK_SIZE pieces with
+ * MSG_ID_CSPI_DATA.
  */
-std::vector<std::uint8_t> encodeCSPIPayload(const CSPIAction& a);
+QByteArray encodeCSPIHeader(const CSPIAction& a);
 
 #endif // ACTIONENCODER_H
@@ -1,11 +1,26 @@
 #ifndef ACTIONSET_H
 #define ACTIONSET_H
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 #include <unordered_map>
 #include "action.h"
 
+/*------------------------------------------------------------------------------
+ * ActionSet: editor-side action graph
+ *------------------------------------------------------------------------------
+ *   - IDs are stable: assigned once by add() (monotonic, START = 0) and never
+ *     renumbered or reused, so removals leave gaps. The dense 0..N-1 device
+ *     IDs the firmware indexes by are assigned by the encoder at send time
+ *     (encodeActionSet()).
+ *   - Nodes are kept in ascending ID order (the UI list order); lookups are a
+ *     binary search.
+ *   - Edges are stored both ways: children in Action::runAfterMe, parents in
+ *     a maintained reverse index. Change edges only through this class
+ *     (add/edit/remove/link/unlink) so the two stay in sync; every operation
+ *     is then O(log n + degree) instead of a scan over all nodes.
+ *----------------------------------------------------------------------------*/
 class ActionSet {
 public:
     /**
@@ -29,8 +44,9 @@ public:
      * @brief Add a node and connect it after the given parents.
      *
      * Behavior:
-     *   - Takes ownership of @p node.
-     *   - Inserts into `nodes_` and updates `id2idx_`.
+     *   - Takes ownership of @p node and assigns it the next ID; its
+     *     runAfterMe is reset (children are linked with link()).
+     *   - Appends to `nodes_` (IDs are monotonic, so the order is kept).
      *   - For each parent in @p parentIds, appends this node's id to
      *     parent.runAfterMe (if not already present).
      *
@@ -47,7 +63,8 @@ public:
      *   - If @p id exists, the old node is replaced by @p replacement
      *     (ownership transferred).
      *   - Rebuilds parent links according to @p newParentIds (removes old
-     *     parent→child edges to this id, adds the new ones).
+     *     parent→child edges to this id via the parent index, adds the new
+     *     ones). Children are kept.
      *
      * @param id             Target node ID to replace.
      * @param replacement    New Action with the SAME id field (or will be set).
@@ -60,11 +77,13 @@ public:
      * @brief Remove a node by ID. Optionally relink its children to Start.
      *
      * Behavior:
-     *   - Erases node from `nodes_` and `id2idx_`.
+     *   - Erases node from `nodes_` and the parent index; other IDs are
+     *     unchanged.
      *   - Removes all edges from its parents to this node.
-     *   - Removes all edges from this node to its children.
-     *   - If @p relinkToStartIfOrphan is true, children that become orphaned
-     *     will be linked from a StartAction (id=0), if present.
+     *   - Removes all edges from this node to its children; each former
+     *     parent is linked to each former child instead.
+     *   - If @p relinkToStartIfOrphan is true and the node had no parents,
+     *     its children are linked from START (id=0).
      *
      * @param id                       Node to remove.
      * @param relinkToStartIfOrphan    If true, ensure children remain reachable.
@@ -75,24 +94,25 @@ public:
     /**
      * @brief Create a parent → child edge.
      *
-     * Adds `childId` to parent.runAfterMe if not already present.
-     * Returns false if either node is missing.
+     * Adds `childId` to parent.runAfterMe (and `parentId` to the child's
+     * parent list) if not already present.
+     * Returns false if either node is missing or parentId == childId.
      */
     bool link(int parentId, int childId);
 
     /**
      * @brief Remove a parent → child edge.
      *
-     * Erases `childId` from parent.runAfterMe if present.
-     * Returns false if either node is missing.
+     * Erases `childId` from parent.runAfterMe (and the reverse entry) if
+     * present. Returns false if the parent is missing.
      */
     bool unlink(int parentId, int childId);
 
     /**
      * @brief Get all parents of a node (IDs).
      *
-     * Scans the graph and returns any node whose `runAfterMe` contains @p id.
-     * Complexity: O(n).
+     * Returns a copy of the maintained parent list of @p id (link order).
+     * Complexity: O(log n + in-degree).
      */
     std::vector<int> parentsOf(int id) const;
 
@@ -110,27 +130,26 @@ public:
     const std::vector<std::unique_ptr<Action>>& nodes() const { return nodes_; }
 
     /**
-     * @brief Largest ID currently present (useful for UI ID allocation).
+     * @brief Last ID handed out by add(); IDs are never reused, so this is
+     *        >= every ID present (not a node count).
      */
     int lastId() const { return lastId_; }
 
 private:
-    /* Storage of owned nodes; index positions are transient and can change
-       after removals. Use `id2idx_` for lookups. */
+    /* Storage of owned nodes in ascending ID order (add() appends the next
+       ID, remove() erases in place). Positions shift after removals. */
     std::vector<std::unique_ptr<Action>> nodes_;
 
-    /* ID → index mapping into `nodes_`. */
-    std::unordered_map<int, size_t> id2idx_;
+    /* Reverse edges: child ID → parent IDs (mirror of every runAfterMe). */
+    std::unordered_map<int, std::vector<int>> parents_;
 
-    /* Tracks the maximum assigned ID to keep UI generation monotonic. */
+    /* Last assigned ID; only grows. */
     int lastId_{0};
 
     /**
-     * @brief Rebuild `id2idx_` from `nodes_`.
-     *
-     * Call after operations that may reorder `nodes_` (e.g., erase/compact).
+     * @brief Position of @p id in `nodes_` (binary search), or -1.
      */
-    void indexRebuild_();
+    std::ptrdiff_t indexOf_(int id) const;
 
     /**
      * @brief Utility: check if vector contains an id.
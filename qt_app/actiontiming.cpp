@@ -0,0 +1,490 @@
+#include "actiontiming.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+
+/*
+ * Static timing analysis over ActionSet.
+ * --------------------------------------
+ * Everything runs on dense indices 0..n-1 in ActionSet::nodes() order (which
+ * is ascending id), over CSR adjacency built once:
+ *   1) Tarjan SCC            → topological order, cycles
+ *   2) Dijkstra ×2           → earliest / latest start windows, critical path
+ *   3) Dominators (CHK)      → "always before" test for the pin checks
+ *   4) Per-pin sweeps        → overlapping writes, trigger vs. its source
+ */
+
+namespace {
+
+using i64 = std::int64_t;
+
+constexpr i64 kInf = std::numeric_limits<i64>::max();
+
+/* msus_to_ticks() in firmware action.c, converted back to µs. */
+i64 deviceUs(std::uint32_t ms, std::uint32_t us)
+{
+    const std::uint64_t ticks = std::uint64_t(ms) * (1000u / DEVICE_TICK_US)
+                              + (us + DEVICE_TICK_US / 2) / DEVICE_TICK_US;
+    return i64(std::min<std::uint64_t>(ticks, 0xFFFFFFFFu)) * DEVICE_TICK_US;
+}
+
+/* Pin actions share port/pin; key for grouping (port and pin fit a byte). */
+int pinKey(int port, int pin) { return (port << 8) | (pin & 0xFF); }
+
+struct Graph {
+    std::vector<int> off, adj;     // children: adj[off[v] .. off[v+1])
+    std::vector<int> poff, padj;   // parents, same layout
+
+    int  n() const { return int(off.size()) - 1; }
+};
+
+Graph buildGraph(const ActionSet& set)
+{
+    const auto& nodes = set.nodes();
+    const int n = int(nodes.size());
+    auto indexOf = [&nodes](int id) {
+        const auto it = std::lower_bound(nodes.begin(), nodes.end(), id,
+                                         [](const std::unique_ptr<Action>& a, int v) { return a->id < v; });
+        return (it != nodes.end() && (*it)->id == id) ? int(it - nodes.begin()) : -1;
+    };
+
+    Graph g;
+    g.off.assign(size_t(n) + 1, 0);
+    for (int v = 0; v < n; ++v) {
+        for (int cid : nodes[size_t(v)]->runAfterMe) {
+            const int c = indexOf(cid);
+            if (c >= 0) g.adj.push_back(c);
+        }
+        g.off[size_t(v) + 1] = int(g.adj.size());
+    }
+
+    // Parents by counting sort over the child lists
+    g.poff.assign(size_t(n) + 1, 0);
+    for (int c : g.adj) ++g.poff[size_t(c) + 1];
+    for (int v = 0; v < n; ++v) g.poff[size_t(v) + 1] += g.poff[size_t(v)];
+    g.padj.resize(g.adj.size());
+    std::vector<int> fill(g.poff.begin(), g.poff.end() - 1);
+    for (int v = 0; v < n; ++v)
+        for (int e = g.off[size_t(v)]; e < g.off[size_t(v) + 1]; ++e)
+            g.padj[size_t(fill[size_t(g.adj[size_t(e)])]++)] = v;
+    return g;
+}
+
+/*
+ * Iterative Tarjan. SCCs come out in reverse topological order; reversed and
+ * concatenated they give a topological order of the condensation (= of the
+ * graph if it is acyclic). Returns the SCCs in topological order.
+ */
+std::vector<std::vector<int>> stronglyConnected(const Graph& g)
+{
+    const int n = g.n();
+    std::vector<int> index(size_t(n), -1), low(size_t(n), 0);
+    std::vector<char> onStack(size_t(n), 0);
+    std::vector<int> sccStack;
+    std::vector<std::pair<int, int>> call;   // (node, next edge)
+    std::vector<std::vector<int>> sccs;
+    int counter = 0;
+
+    for (int root = 0; root < n; ++root) {
+        if (index[size_t(root)] >= 0) continue;
+        call.push_back({root, g.off[size_t(root)]});
+        index[size_t(root)] = low[size_t(root)] = counter++;
+        sccStack.push_back(root); onStack[size_t(root)] = 1;
+
+        while (!call.empty()) {
+            auto& [v, e] = call.back();
+            if (e < g.off[size_t(v) + 1]) {
+                const int w = g.adj[size_t(e++)];
+                if (index[size_t(w)] < 0) {
+                    index[size_t(w)] = low[size_t(w)] = counter++;
+                    sccStack.push_back(w); onStack[size_t(w)] = 1;
+                    call.push_back({w, g.off[size_t(w)]});
+                } else if (onStack[size_t(w)]) {
+                    low[size_t(v)] = std::min(low[size_t(v)], index[size_t(w)]);
+                }
+                continue;
+            }
+            const int done = v;
+            call.pop_back();
+            if (!call.empty())
+                low[size_t(call.back().first)] = std::min(low[size_t(call.back().first)], low[size_t(done)]);
+            if (low[size_t(done)] == index[size_t(done)]) {
+                std::vector<int> scc;
+                int w;
+                do {
+                    w = sccStack.back(); sccStack.pop_back();
+                    onStack[size_t(w)] = 0;
+                    scc.push_back(w);
+                } while (w != done);
+                sccs.push_back(std::move(scc));
+            }
+        }
+    }
+    std::reverse(sccs.begin(), sccs.end());
+    return sccs;
+}
+
+/*
+ * Start times from START (index 0): start(c) = min over parents p of
+ * start(p) + dur(p). Non-negative weights, so Dijkstra is exact even on
+ * cycles. @via gets the parent that set each start (-1 for START/unreached).
+ */
+std::vector<i64> startTimes(const Graph& g, const std::vector<i64>& dur, std::vector<int>* via)
+{
+    const int n = g.n();
+    std::vector<i64> dist(size_t(n), kInf);
+    if (via) via->assign(size_t(n), -1);
+    if (n == 0) return dist;
+
+    using Item = std::pair<i64, int>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> pq;
+    dist[0] = 0;
+    pq.push({0, 0});
+    while (!pq.empty()) {
+        const auto [d, v] = pq.top();
+        pq.pop();
+        if (d != dist[size_t(v)]) continue;
+        const i64 fin = d + dur[size_t(v)];
+        for (int e = g.off[size_t(v)]; e < g.off[size_t(v) + 1]; ++e) {
+            const int c = g.adj[size_t(e)];
+            if (fin < dist[size_t(c)]) {
+                dist[size_t(c)] = fin;
+                if (via) (*via)[size_t(c)] = v;
+                pq.push({fin, c});
+            }
+        }
+    }
+    return dist;
+}
+
+/*
+ * Dominator tree of the nodes reachable from START (Cooper, Harvey, Kennedy:
+ * "A Simple, Fast Dominance Algorithm"), flattened to DFS intervals so that
+ * dominates(a, b) is O(1). a dominates b ⇒ every path to b passes a ⇒ b can
+ * only start after a has finished.
+ */
+class Dominators {
+public:
+    Dominators(const Graph& g, const std::vector<char>& reached)
+    {
+        const int n = g.n();
+        tin_.assign(size_t(n), -1);
+        tout_.assign(size_t(n), -1);
+        if (n == 0) return;
+
+        // Reverse postorder from START
+        std::vector<int> post, rpoNum(size_t(n), -1);
+        std::vector<char> seen(size_t(n), 0);
+        std::vector<std::pair<int, int>> st{{0, g.off[0]}};
+        seen[0] = 1;
+        while (!st.empty()) {
+            auto& [v, e] = st.back();
+            if (e < g.off[size_t(v) + 1]) {
+                const int w = g.adj[size_t(e++)];
+                if (!seen[size_t(w)]) { seen[size_t(w)] = 1; st.push_back({w, g.off[size_t(w)]}); }
+                continue;
+            }
+            post.push_back(v);
+            st.pop_back();
+        }
+        std::vector<int> rpo(post.rbegin(), post.rend());
+        for (size_t i = 0; i < rpo.size(); ++i) rpoNum[size_t(rpo[i])] = int(i);
+
+        std::vector<int> idom(size_t(n), -1);
+        idom[0] = 0;
+        auto intersect = [&](int a, int b) {
+            while (a != b) {
+                while (rpoNum[size_t(a)] > rpoNum[size_t(b)]) a = idom[size_t(a)];
+                while (rpoNum[size_t(b)] > rpoNum[size_t(a)]) b = idom[size_t(b)];
+            }
+            return a;
+        };
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (size_t i = 1; i < rpo.size(); ++i) {
+                const int v = rpo[i];
+                int nd = -1;
+                for (int e = g.poff[size_t(v)]; e < g.poff[size_t(v) + 1]; ++e) {
+                    const int p = g.padj[size_t(e)];
+                    if (!reached[size_t(p)] || idom[size_t(p)] < 0) continue;
+                    nd = (nd < 0) ? p : intersect(p, nd);
+                }
+                if (nd != idom[size_t(v)]) { idom[size_t(v)] = nd; changed = true; }
+            }
+        }
+
+        // Tree children, then one DFS for the intervals
+        std::vector<int> coff(size_t(n) + 1, 0), cadj;
+        for (int v : rpo) if (v != 0) ++coff[size_t(idom[size_t(v)]) + 1];
+        for (int v = 0; v < n; ++v) coff[size_t(v) + 1] += coff[size_t(v)];
+        cadj.resize(size_t(coff[size_t(n)]));
+        std::vector<int> fill(coff.begin(), coff.end() - 1);
+        for (int v : rpo) if (v != 0) cadj[size_t(fill[size_t(idom[size_t(v)])]++)] = v;
+
+        int t = 0;
+        std::vector<std::pair<int, int>> dst{{0, coff[0]}};
+        tin_[0] = t++;
+        while (!dst.empty()) {
+            auto& [v, e] = dst.back();
+            if (e < coff[size_t(v) + 1]) {
+                const int c = cadj[size_t(e++)];
+                tin_[size_t(c)] = t++;
+                dst.push_back({c, coff[size_t(c)]});
+                continue;
+            }
+            tout_[size_t(v)] = t++;
+            dst.pop_back();
+        }
+    }
+
+    bool dominates(int a, int b) const
+    {
+        return tin_[size_t(a)] >= 0 && tin_[size_t(b)] >= 0
+            && tin_[size_t(a)] <= tin_[size_t(b)] && tout_[size_t(b)] <= tout_[size_t(a)];
+    }
+
+private:
+    std::vector<int> tin_, tout_;
+};
+
+bool drives(Level l) { return l == Level::LOW || l == Level::HIGH; }
+
+} // namespace
+
+bool TimingReport::hasErrors() const
+{
+    return !issues.empty() && issues.front().severity == TimingIssue::Severity::Error;
+}
+
+const NodeTiming* TimingReport::find(int id) const
+{
+    const auto it = std::lower_bound(nodes.begin(), nodes.end(), id,
+                                     [](const NodeTiming& t, int v) { return t.id < v; });
+    return (it != nodes.end() && it->id == id) ? &*it : nullptr;
+}
+
+TimingReport analyzeTiming(const ActionSet& set)
+{
+    using Issue = TimingIssue;
+    TimingReport rep;
+    const auto& nodes = set.nodes();
+    const int n = int(nodes.size());
+    if (n == 0) return rep;
+
+    const Graph g = buildGraph(set);
+    auto idOf = [&nodes](int v) { return nodes[size_t(v)]->id; };
+
+    // Duration range per action
+    std::vector<i64> dmin(size_t(n), 0), dmax(size_t(n), 0);
+    for (int v = 0; v < n; ++v) {
+        const Action* a = nodes[size_t(v)].get();
+        switch (a->kind) {
+        case Kind::DELAY: {
+            const auto* d = static_cast<const DelayAction*>(a);
+            dmin[size_t(v)] = dmax[size_t(v)] = deviceUs(d->durationMs, d->durationUs);
+        } break;
+        case Kind::PIN_WRITE: {
+            const auto* w = static_cast<const PinWriteAction*>(a);
+            dmin[size_t(v)] = dmax[size_t(v)] = deviceUs(w->durationMs, w->durationUs);
+        } break;
+        case Kind::PIN_TRIGGER: {
+            // Fires on the level (≥ 0) or errors at the timeout: a successful
+            // run waits strictly less than the timeout
+            const auto* t = static_cast<const PinTriggerAction*>(a);
+            dmax[size_t(v)] = std::max<i64>(0, deviceUs(t->timeoutMs, t->timeoutUs) - DEVICE_TICK_US);
+        } break;
+        default:
+            break;   // START, PIN_READ (rejected), CSPI (not in the blob)
+        }
+    }
+
+    // 1) Order and cycles
+    for (const auto& scc : stronglyConnected(g)) {
+        for (int v : scc) rep.order.push_back(idOf(v));
+        if (scc.size() > 1) {
+            Issue is{Issue::Kind::Cycle, Issue::Severity::Warning, {}};
+            for (int v : scc) is.ids.push_back(idOf(v));
+            std::sort(is.ids.begin(), is.ids.end());
+            rep.issues.push_back(std::move(is));
+        }
+    }
+
+    // 2) Start windows
+    std::vector<int> via;
+    const std::vector<i64> es = startTimes(g, dmin, nullptr);
+    const std::vector<i64> ls = startTimes(g, dmax, &via);
+
+    std::vector<char> reached(size_t(n), 0);
+    rep.nodes.resize(size_t(n));
+    Issue unreachable{Issue::Kind::Unreachable, Issue::Severity::Error, {}};
+    Issue pinRead{Issue::Kind::PinRead, Issue::Severity::Error, {}};
+    int last = 0;
+    for (int v = 0; v < n; ++v) {
+        NodeTiming& t = rep.nodes[size_t(v)];
+        t.id            = idOf(v);
+        t.minDurationUs = dmin[size_t(v)];
+        t.maxDurationUs = dmax[size_t(v)];
+        if (es[size_t(v)] == kInf) {
+            unreachable.ids.push_back(t.id);
+            continue;
+        }
+        reached[size_t(v)] = 1;
+        t.earliestStartUs = es[size_t(v)];
+        t.latestStartUs   = ls[size_t(v)];
+        rep.makespanMinUs = std::max(rep.makespanMinUs, t.earliestFinishUs());
+        if (t.latestFinishUs() > rep.nodes[size_t(last)].latestFinishUs()) last = v;
+        if (nodes[size_t(v)]->kind == Kind::PIN_READ) pinRead.ids.push_back(t.id);
+    }
+    rep.makespanMaxUs = rep.nodes[size_t(last)].latestFinishUs();
+    for (int v = last; v >= 0; v = via[size_t(v)]) rep.criticalPath.push_back(idOf(v));
+    std::reverse(rep.criticalPath.begin(), rep.criticalPath.end());
+    if (!unreachable.ids.empty()) rep.issues.push_back(std::move(unreachable));
+    if (!pinRead.ids.empty())     rep.issues.push_back(std::move(pinRead));
+
+    // 3) + 4) Pin checks on reached actions
+    const Dominators dom(g, reached);
+    std::unordered_map<int, std::vector<int>> writesByPin, triggersByPin;
+    for (int v = 0; v < n; ++v) {
+        if (!reached[size_t(v)]) continue;
+        const Action* a = nodes[size_t(v)].get();
+        if (a->kind == Kind::PIN_WRITE) {
+            const auto* w = static_cast<const PinWriteAction*>(a);
+            writesByPin[pinKey(w->port, w->pin)].push_back(v);
+        } else if (a->kind == Kind::PIN_TRIGGER) {
+            const auto* t = static_cast<const PinTriggerAction*>(a);
+            triggersByPin[pinKey(t->port, t->pin)].push_back(v);
+        }
+    }
+
+    // Writes: active over [earliest start, latest finish); sweep by start
+    for (auto& [key, ws] : writesByPin) {
+        std::sort(ws.begin(), ws.end(), [&es](int a, int b) { return es[size_t(a)] < es[size_t(b)]; });
+        std::vector<char> hit(ws.size(), 0);
+        for (size_t i = 0; i < ws.size(); ++i) {
+            const NodeTiming& a = rep.nodes[size_t(ws[i])];
+            for (size_t j = i + 1; j < ws.size() && es[size_t(ws[j])] < a.latestFinishUs(); ++j) {
+                if (dom.dominates(ws[i], ws[j]) || dom.dominates(ws[j], ws[i])) continue;
+                hit[i] = hit[j] = 1;
+            }
+        }
+        Issue is{Issue::Kind::PinConflict, Issue::Severity::Warning, {}, key >> 8, key & 0xFF};
+        for (size_t i = 0; i < ws.size(); ++i)
+            if (hit[i]) is.ids.push_back(idOf(ws[i]));
+        if (is.ids.empty()) continue;
+        std::sort(is.ids.begin(), is.ids.end());
+        rep.issues.push_back(std::move(is));
+    }
+
+    // Triggers: when can an in-graph write first/last drive the awaited level?
+    for (const auto& [key, ts] : triggersByPin) {
+        const auto wit = writesByPin.find(key);
+        if (wit == writesByPin.end()) continue;   // external signal
+        const std::vector<int>& ws = wit->second;
+
+        for (int t : ts) {
+            const auto* trig = static_cast<const PinTriggerAction*>(nodes[size_t(t)].get());
+            if (!drives(trig->target)) continue;
+
+            bool preset = false;
+            i64 srcEarliest = kInf, srcLatest = kInf;
+            int src = -1;
+            for (int w : ws) {
+                const auto* wr = static_cast<const PinWriteAction*>(nodes[size_t(w)].get());
+                if (wr->initial == trig->target) { preset = true; break; }
+                if (dom.dominates(t, w)) continue;   // only runs after the trigger
+                const NodeTiming& wt = rep.nodes[size_t(w)];
+                i64 e = kInf, l = kInf;
+                if (wr->target == trig->target)     { e = wt.earliestStartUs;    l = wt.latestStartUs; }
+                else if (wr->final == trig->target) { e = wt.earliestFinishUs(); l = wt.latestFinishUs(); }
+                if (e < srcEarliest) { srcEarliest = e; src = w; }
+                srcLatest = std::min(srcLatest, l);
+            }
+            if (preset) continue;
+
+            const NodeTiming& tt = rep.nodes[size_t(t)];
+            const i64 timeout = deviceUs(trig->timeoutMs, trig->timeoutUs);
+            Issue is{Issue::Kind::TriggerTimeout, Issue::Severity::Error, {idOf(t)}, key >> 8, key & 0xFF};
+            if (srcEarliest > tt.latestStartUs + timeout) {
+                if (src >= 0) is.ids.push_back(idOf(src));
+            } else if (srcLatest > tt.earliestStartUs + timeout) {
+                is.kind     = Issue::Kind::TriggerRace;
+                is.severity = Issue::Severity::Warning;
+                is.ids.push_back(idOf(src));
+            } else {
+                continue;
+            }
+            rep.issues.push_back(std::move(is));
+        }
+    }
+
+    std::stable_sort(rep.issues.begin(), rep.issues.end(), [](const Issue& a, const Issue& b) {
+        return a.severity == Issue::Severity::Error && b.severity != Issue::Severity::Error;
+    });
+    return rep;
+}
+
+/* ------------------------------- Text ----------------------------------- */
+
+static QString idList(const std::vector<int>& ids)
+{
+    QString s;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (i) s += ',';
+        s += QString::number(ids[i]);
+    }
+    return s;
+}
+
+static QString pinName(int port, int pin)
+{
+    const QString p = (port >= 0 && port < 26) ? QString(QChar('A' + port)) : QString("?");
+    return QString("port %1 pin %2").arg(p).arg(pin);
+}
+
+static QString msText(std::int64_t us)
+{
+    return QString::number(double(us) / 1000.0, 'f', 3) + "ms";
+}
+
+QString timingIssueText(const TimingIssue& is)
+{
+    using K = TimingIssue::Kind;
+    const QString sev = is.severity == TimingIssue::Severity::Error ? "error" : "warning";
+    switch (is.kind) {
+    case K::Unreachable:
+        return QString("%1: never started (no path from START), device waits forever: ID %2")
+            .arg(sev, idList(is.ids));
+    case K::PinRead:
+        return QString("%1: PIN_READ is not executed by the device (run stops with an error): ID %2")
+            .arg(sev, idList(is.ids));
+    case K::TriggerTimeout:
+        return is.ids.size() > 1
+            ? QString("%1: trigger ID %2 on %3 times out before write ID %4 can drive its level")
+                  .arg(sev).arg(is.ids[0]).arg(pinName(is.port, is.pin)).arg(is.ids[1])
+            : QString("%1: trigger ID %2 on %3: no write drives its level before the timeout")
+                  .arg(sev).arg(is.ids[0]).arg(pinName(is.port, is.pin));
+    case K::TriggerRace:
+        return QString("%1: trigger ID %2 on %3 may time out before write ID %4 drives its level")
+            .arg(sev).arg(is.ids[0]).arg(pinName(is.port, is.pin)).arg(is.ids[1]);
+    case K::Cycle:
+        return QString("%1: cycle (back edges never fire): ID %2").arg(sev, idList(is.ids));
+    case K::PinConflict:
+        return QString("%1: writes to %2 may overlap: ID %3")
+            .arg(sev, pinName(is.port, is.pin), idList(is.ids));
+    }
+    return sev;
+}
+
+QString timingSummary(const TimingReport& r)
+{
+    int errors = 0;
+    for (const TimingIssue& is : r.issues) errors += is.severity == TimingIssue::Severity::Error;
+    return QString("makespan %1..%2, critical path %3 actions, %4 error(s), %5 warning(s)")
+        .arg(msText(r.makespanMinUs), msText(r.makespanMaxUs))
+        .arg(r.criticalPath.size())
+        .arg(errors)
+        .arg(int(r.issues.size()) - errors);
+}
@@ -0,0 +1,118 @@
+/*
+ * bench_frameparser
+ * -----------------
+ * Feeds several MB of mixed device frames, line noise and corrupted frames
+ * through FrameParser in random-sized chunks (as readyRead() delivers them)
+ * and compares it with the previous remove(0, …) based parser.
+ *
+ * Build: cmake -DDEBUGTOOL_BENCH=ON … && ./bench_frameparser [MB]
+ */
+#include "../frameparser.h"
+#include "../actionEncoder.h"
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+/* Previous SerialMonitor::parseProtoFrames() algorithm, kept for comparison. */
+struct LegacyParser {
+    QByteArray buf;
+    quint64    frames{0};
+
+    void feed(const QByteArray &chunk)
+    {
+        buf += chunk;
+        for (;;) {
+            int sof = buf.indexOf(char(SOF0));
+            if (sof < 0) { buf.clear(); return; }
+            if (sof + 1 >= buf.size()) return;
+            if (quint8(buf[sof + 1]) != SOF1) { buf.remove(0, sof + 1); continue; }
+            if (buf.size() < sof + 7) return;
+
+            const quint16 len = quint16((quint8(buf[sof + 3]) << 8) | quint8(buf[sof + 4]));
+            const int frameLen = 7 + len;
+            if (buf.size() < sof + frameLen) return;
+
+            const quint16 rx = quint16((quint8(buf[sof + frameLen - 2]) << 8) | quint8(buf[sof + frameLen - 1]));
+            if (crc16_ccitt_update(0xFFFF, buf.constData() + sof + 2, 3 + len) == rx) {
+                ++frames;
+                buf.remove(sof, frameLen);
+            } else {
+                buf.remove(0, sof + 1);
+            }
+        }
+    }
+};
+
+QByteArray makeFrame(QRandomGenerator &rng, quint8 msg, int len)
+{
+    QByteArray f(7 + len, Qt::Uninitialized);
+    char *p = f.data();
+    p[0] = char(SOF0); p[1] = char(SOF1); p[2] = char(msg);
+    p[3] = char(len >> 8); p[4] = char(len & 0xFF);
+    for (int i = 0; i < len; ++i) p[5 + i] = char(rng.bounded(256));
+    const quint16 crc = crc16_ccitt_update(0xFFFF, p + 2, 3 + len);
+    p[5 + len] = char(crc >> 8); p[6 + len] = char(crc & 0xFF);
+    return f;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int mb = (argc > 1) ? std::max(1, atoi(argv[1])) : 8;
+    QRandomGenerator rng(0x5EED);
+
+    // Stream: 70% frames (0..512 B), 20% noise bursts (with stray 0xAA), 10% corrupted frames
+    QByteArray stream;
+    stream.reserve(qsizetype(mb) << 20);
+    quint64 expected = 0;
+    while (stream.size() < (qsizetype(mb) << 20)) {
+        const int pick = int(rng.bounded(10));
+        if (pick < 7) {
+            stream += makeFrame(rng, quint8(rng.bounded(256)), int(rng.bounded(513)));
+            ++expected;
+        } else if (pick < 9) {
+            QByteArray noise(int(rng.bounded(1, 2048)), Qt::Uninitialized);
+            for (char &c : noise) c = (rng.bounded(16) == 0) ? char(SOF0) : char(rng.bounded(256));
+            stream += noise;
+        } else {
+            QByteArray bad = makeFrame(rng, 0x52, int(rng.bounded(1, 513)));
+            bad[5] = char(bad[5] ^ 0x01);
+            stream += bad;
+        }
+    }
+
+    // Random chunking like readyRead() (1..4096 B)
+    std::vector<QByteArray> chunks;
+    for (qsizetype off = 0; off < stream.size();) {
+        const qsizetype n = std::min<qsizetype>(rng.bounded(1, 4097), stream.size() - off);
+        chunks.push_back(stream.mid(off, n));
+        off += n;
+    }
+
+    QElapsedTimer t;
+
+    FrameParser fp;
+    quint64 frames = 0;
+    t.start();
+    for (const QByteArray &c : chunks)
+        fp.feed(c, [&frames](quint8, const char *, quint16) { ++frames; });
+    const double fpMs = t.nsecsElapsed() / 1e6;
+
+    LegacyParser lp;
+    t.start();
+    for (const QByteArray &c : chunks) lp.feed(c);
+    const double lpMs = t.nsecsElapsed() / 1e6;
+
+    const double mbs = stream.size() / 1048576.0;
+    std::printf("input        %.1f MB in %zu chunks, %llu valid frames generated\n",
+                mbs, chunks.size(), (unsigned long long)expected);
+    std::printf("FrameParser  %8.1f ms  %8.1f MB/s  frames=%llu\n",
+                fpMs, mbs / (fpMs / 1000.0), (unsigned long long)frames);
+    std::printf("legacy       %8.1f ms  %8.1f MB/s  frames=%llu\n",
+                lpMs, mbs / (lpMs / 1000.0), (unsigned long long)lp.frames);
+    return (frames >= expected) ? 0 : 1;
+}
@@ -0,0 +1,465 @@
+/*
+ * bench_hotpaths
+ * --------------
+ * Host-side hot paths on fixed datasets, with JSON output for comparing
+ * commits:
+ *
+ *   crc16_ccitt, buildPacket          framing (512 B payload, multi-MB stream)
+ *   encodeActionPayload               8- and 255-action graphs
+ *   actionsFrame / actionsFrameCopy   same graphs framed in place (FrameWriter)
+ *                                     vs. blob → QByteArray → buildPacket
+ *   encodeCSPIHeader                  BEGIN header (TX data is not copied)
+ *   actionSetAdd / Edit / AddRemove   editor graph ops on a 10k-node set
+ *                                     (AddRemove − Add = cost of removes)
+ *   analyzeTiming                     static timing analysis, same graph
+ *   parseProtoFrames                  FrameParser + SerialMonitor's dispatch
+ *   parseHexString / decodeHexText    CSPI editor text vs. importer scanner
+ *
+ * Datasets are generated from xorshift32 (seed 0x5EED) exactly like
+ * firmware/host/bench/bench_fw.c, so the stream and the action graphs are
+ * byte-identical on both sides and the two JSON reports line up by
+ * (name, dataset).
+ *
+ * Build: cmake -DDEBUGTOOL_BENCH=ON … && ./bench_hotpaths [--json FILE|-]
+ *        [--min-ms N] [--stream-mb N]
+ */
+#include "../actionEncoder.h"
+#include "../actionset.h"
+#include "../actiontiming.h"
+#include "../cspihex.h"
+#include "../cspiimporter.h"
+#include "../frameparser.h"
+#include "../framewriter.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+namespace {
+
+/* ------------------------------- Datasets -------------------------------- */
+
+struct Rng {
+    quint32 s{0x5EED};
+    quint32 next()
+    {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        return s;
+    }
+};
+
+QByteArray randomBytes(Rng &rng, int n)
+{
+    QByteArray b(n, Qt::Uninitialized);
+    for (char &c : b) c = char(quint8(rng.next()));
+    return b;
+}
+
+/* 70% frames (0..512 B), 20% noise (with stray 0xAA), 10% DATA with bad CRC */
+QByteArray makeStream(qsizetype bytes, quint64 *validFrames)
+{
+    Rng rng;
+    QByteArray s;
+    s.reserve(bytes + 4096);
+    quint64 frames = 0;
+    while (s.size() < bytes) {
+        const quint32 pick = rng.next() % 10u;
+        if (pick < 7u) {
+            const quint8 msg = quint8(rng.next());
+            const int    len = int(rng.next() % (MAX_PAYLOAD_SIZE + 1u));
+            s += buildPacket(msg, randomBytes(rng, len));
+            ++frames;
+        } else if (pick < 9u) {
+            const quint32 len = 1u + rng.next() % 2047u;
+            for (quint32 i = 0; i < len; ++i) {
+                const quint32 r = rng.next();
+                s += char((r % 16u == 0u) ? SOF0 : quint8(r >> 8));
+            }
+        } else {
+            const int at  = int(s.size());
+            const int len = int(1u + rng.next() % MAX_PAYLOAD_SIZE);
+            s += buildPacket(MSG_ID_CSPI_DATA, randomBytes(rng, len));
+            s[at + 5] = char(s[at + 5] ^ 0x01);
+        }
+    }
+    if (validFrames) *validFrames = frames;
+    return s;
+}
+
+/* readyRead()-like chunk boundaries (1..4096 B) over @total bytes */
+std::vector<qsizetype> makeChunks(qsizetype total)
+{
+    Rng rng;
+    std::vector<qsizetype> ends;
+    for (qsizetype off = 0; off < total;) {
+        off = std::min<qsizetype>(off + 1 + rng.next() % 4096u, total);
+        ends.push_back(off);
+    }
+    return ends;
+}
+
+/* Node i of the generated graphs: START at 0, then kinds cycle
+ * DELAY / PIN_WRITE / PIN_TRIGGER. */
+std::unique_ptr<Action> makeNode(int i)
+{
+    if (i == 0)
+        return std::make_unique<StartAction>();
+    if (i % 3 == 1) {
+        auto d = std::make_unique<DelayAction>();
+        d->durationMs = uint32_t(i % 50);
+        d->durationUs = uint16_t((i * 7) % 1000);
+        return d;
+    }
+    if (i % 3 == 2) {
+        auto w = std::make_unique<PinWriteAction>();
+        w->port = i % 5; w->pin = i % 32;
+        w->initial = Level::LOW; w->target = Level::HIGH; w->final = Level::LOW;
+        w->durationMs = uint32_t(1 + i % 20);
+        return w;
+    }
+    auto t = std::make_unique<PinTriggerAction>();
+    t->port = i % 5; t->pin = i % 32;
+    t->target = Level::HIGH;
+    t->timeoutMs = 10;
+    return t;
+}
+
+/*
+ * n-node chain: 0 START → 1; i → i+1 (and i+3 when i%8 == 0).
+ * Same graph as bench_fw.c.
+ */
+std::vector<std::unique_ptr<Action>> makeActions(int n)
+{
+    std::vector<std::unique_ptr<Action>> v;
+    for (int i = 0; i < n; ++i) {
+        std::unique_ptr<Action> a = makeNode(i);
+        a->id = i;
+        if (i + 1 < n)                      a->runAfterMe.push_back(i + 1);
+        if (i && i % 8 == 0 && i + 3 < n)   a->runAfterMe.push_back(i + 3);
+        v.push_back(std::move(a));
+    }
+    return v;
+}
+
+/*
+ * Editor graph of n nodes built the way the UI does (ActionSet::add()):
+ * node i gets 1..3 parents among the previous 64 IDs, so the graph is wide
+ * and the parent lists are not trivial.
+ */
+std::vector<std::vector<int>> makeParents(int n)
+{
+    Rng rng;
+    std::vector<std::vector<int>> parents(size_t(n));
+    for (int i = 1; i < n; ++i) {
+        const int k = 1 + int(rng.next() % 3u);
+        for (int j = 0; j < k; ++j)
+            parents[size_t(i)].push_back(std::max(0, i - 1 - int(rng.next() % 64u)));
+    }
+    return parents;
+}
+
+void buildSet(ActionSet &set, const std::vector<std::vector<int>> &parents)
+{
+    for (int i = 1; i < int(parents.size()); ++i)
+        set.add(makeNode(i), parents[size_t(i)]);
+}
+
+/* @lines rounds of 8 x 8-bit words, editor grammar ("AA BB …;") */
+QByteArray makeHexText(int lines)
+{
+    Rng rng;
+    static const char hex[] = "0123456789ABCDEF";
+    QByteArray t;
+    t.reserve(qsizetype(lines) * 25);
+    for (int l = 0; l < lines; ++l) {
+        for (int w = 0; w < 8; ++w) {
+            const quint8 b = quint8(rng.next());
+            if (w) t += ' ';
+            t += hex[b >> 4];
+            t += hex[b & 0x0F];
+        }
+        t += ";\n";
+    }
+    return t;
+}
+
+/* ------------------------------- Harness --------------------------------- */
+
+struct Result {
+    QString name, dataset;
+    quint64 iterations;
+    double  nsPerOp;
+    quint64 bytesPerOp, itemsPerOp;
+
+    double mbPerSec() const { return bytesPerOp ? bytesPerOp / nsPerOp * 1e9 / 1048576.0 : 0.0; }
+};
+
+class Bench
+{
+public:
+    explicit Bench(double minMs) : m_minMs(minMs) {}
+
+    /* @fn returns the items it processed (frames, actions, …); one warm-up
+     * call, then doubling batches until --min-ms has elapsed. */
+    void run(const QString &name, const QString &dataset, quint64 bytes,
+             const std::function<quint64()> &fn)
+    {
+        const quint64 items = fn();
+        quint64 iters = 0, batch = 1;
+        qint64  total = 0;
+        QElapsedTimer t;
+        while (total / 1e6 < m_minMs) {
+            t.start();
+            for (quint64 i = 0; i < batch; ++i) m_sink += fn();
+            total += t.nsecsElapsed();
+            iters += batch;
+            batch *= 2;
+        }
+        m_results.push_back({name, dataset, iters, double(total) / double(iters), bytes, items});
+    }
+
+    void printTable(FILE *f) const
+    {
+        std::fprintf(f, "%-20s %-14s %12s %14s %10s %10s\n",
+                     "benchmark", "dataset", "iterations", "ns/op", "MB/s", "items/op");
+        for (const Result &r : m_results)
+            std::fprintf(f, "%-20s %-14s %12llu %14.1f %10.1f %10llu\n",
+                         qPrintable(r.name), qPrintable(r.dataset),
+                         (unsigned long long)r.iterations, r.nsPerOp, r.mbPerSec(),
+                         (unsigned long long)r.itemsPerOp);
+    }
+
+    /* Same fields as bench_fw --json */
+    QByteArray json() const
+    {
+        QJsonArray results;
+        for (const Result &r : m_results) {
+            results.append(QJsonObject{
+                {"name",         r.name},
+                {"dataset",      r.dataset},
+                {"iterations",   qint64(r.iterations)},
+                {"ns_per_op",    r.nsPerOp},
+                {"bytes_per_op", qint64(r.bytesPerOp)},
+                {"items_per_op", qint64(r.itemsPerOp)},
+                {"mb_per_s",     r.mbPerSec()},
+            });
+        }
+        const QJsonObject root{
+            {"suite",   "qt_app"},
+            {"min_ms",  m_minMs},
+            {"results", results},
+        };
+        return QJsonDocument(root).toJson(QJsonDocument::Indented);
+    }
+
+private:
+    double              m_minMs;
+    std::vector<Result> m_results;
+    volatile quint64    m_sink{0};
+};
+
+volatile quint64 g_dispatchSink = 0;
+
+/* SerialMonitor::parseProtoFrames() dispatch with the signal arguments built
+ * but not emitted (the widget needs a QApplication and a link). */
+quint64 parseProtoFrames(FrameParser &fp, const QByteArray &stream,
+                         const std::vector<qsizetype> &chunkEnds)
+{
+    quint64 frames = 0, sink = 0;
+    auto onFrame = [&frames, &sink](quint8 msg, const char *plPtr, quint16 len) {
+        ++frames;
+        if (msg == MSG_ID_CSPI_REQ && len >= CSPI_CREDIT_SIZE) {
+            sink += proto::read<proto::CspiCredit>(reinterpret_cast<const quint8 *>(plPtr)).limit;
+        } else if (msg == MSG_ID_CSPI_RX && len >= 2) {
+            sink += QByteArray(plPtr + 2, len - 2).size();
+        } else if ((msg == MSG_ID_CSPI_STATS && len >= CSPI_STATS_SIZE)
+                   || (msg == MSG_ID_SLOT_LIST && len >= 1)) {
+            sink += QByteArray(plPtr, len).size();
+        }
+    };
+
+    fp.reset();
+    qsizetype off = 0;
+    for (qsizetype end : chunkEnds) {
+        fp.feed(stream.constData() + off, end - off, onFrame);
+        off = end;
+    }
+    g_dispatchSink = g_dispatchSink + sink;
+    return frames;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("bench_hotpaths");
+
+    QCommandLineParser cli;
+    cli.setApplicationDescription("Benchmark protocol, encoder and parser hot paths on fixed datasets.");
+    cli.addHelpOption();
+    const QCommandLineOption jsonOpt("json", "Write JSON results to FILE ('-' for stdout).", "file");
+    const QCommandLineOption minOpt("min-ms", "Minimum measured time per benchmark (default 200).", "ms", "200");
+    const QCommandLineOption mbOpt("stream-mb", "Size of the frame stream dataset (default 8).", "MB", "8");
+    cli.addOptions({jsonOpt, minOpt, mbOpt});
+    cli.process(app);
+
+    bool ok1 = false, ok2 = false;
+    const double minMs    = cli.value(minOpt).toDouble(&ok1);
+    const int    streamMb = cli.value(mbOpt).toInt(&ok2);
+    if (!ok1 || !ok2 || minMs <= 0 || streamMb < 1) {
+        std::fputs(qPrintable(cli.helpText()), stderr);
+        return 2;
+    }
+
+    // Datasets
+    Rng rng;
+    const QByteArray pl512 = randomBytes(rng, MAX_PAYLOAD_SIZE);
+    const QByteArray pl32  = pl512.left(32);
+
+    quint64 validFrames = 0;
+    const QByteArray stream = makeStream(qsizetype(streamMb) << 20, &validFrames);
+    const std::vector<qsizetype> chunks = makeChunks(stream.size());
+    const QString streamName = QString("stream-%1MB").arg(streamMb);
+
+    rng = Rng{};
+    const QByteArray small = buildPacket(MSG_ID_CSPI_DATA, randomBytes(rng, 32));
+    const std::vector<qsizetype> smallChunks{small.size()};
+
+    const auto own8   = makeActions(8);
+    const auto own255 = makeActions(255);
+    std::vector<Action *> act8, act255;
+    for (const auto &a : own8)   act8.push_back(a.get());
+    for (const auto &a : own255) act255.push_back(a.get());
+
+    const int  graphN = 10000;
+    const auto graphParents = makeParents(graphN);
+    std::vector<int> removeOrder;
+    for (int i = 1; i < graphN; ++i) removeOrder.push_back(i);
+    rng = Rng{};
+    for (size_t i = removeOrder.size(); i > 1; --i)
+        std::swap(removeOrder[i - 1], removeOrder[rng.next() % i]);
+
+    CSPIAction cspiLarge;
+    cspiLarge.mode = 0; cspiLarge.wordSize = 8; cspiLarge.readSize = 0;
+    cspiLarge.transfer_size = 8; cspiLarge.port = 0; cspiLarge.pin = 0;
+    rng = Rng{};
+    cspiLarge.txData = randomBytes(rng, 1 << 20);
+
+    const QByteArray hexSmall = makeHexText(16);
+    const QByteArray hexLarge = makeHexText(65536);
+    const QString    hexSmallStr = QString::fromLatin1(hexSmall);
+    const QString    hexLargeStr = QString::fromLatin1(hexLarge);
+
+    // Measurements
+    Bench b(minMs);
+
+    b.run("crc16_ccitt", "payload-512", pl512.size(), [&] { return quint64(crc16_ccitt(pl512) != 0); });
+    b.run("crc16_ccitt", streamName, stream.size(), [&] { return quint64(crc16_ccitt(stream) != 0); });
+
+    b.run("buildPacket", "payload-32", 7 + pl32.size(),
+          [&] { return quint64(buildPacket(MSG_ID_CSPI_DATA, pl32).size() != 0); });
+    b.run("buildPacket", "payload-512", 7 + pl512.size(),
+          [&] { return quint64(buildPacket(MSG_ID_CSPI_DATA, pl512).size() != 0); });
+
+    b.run("encodeActionPayload", "actions-8", encodeActionPayload(act8).size(),
+          [&] { return quint64(encodeActionPayload(act8).empty() ? 0 : act8.size()); });
+    b.run("encodeActionPayload", "actions-255", encodeActionPayload(act255).size(),
+          [&] { return quint64(encodeActionPayload(act255).empty() ? 0 : act255.size()); });
+
+    // MainWindow::buildActionsFrame() vs. the copying path it replaced
+    auto actionsFrame = [](const std::vector<Action *> &acts) {
+        FrameWriter w(MSG_ID_EXECUTE_ACTIONS, MAX_PAYLOAD_SIZE);
+        ActionIndex index;
+        encodeActionsInto(w, acts, &index);
+        return w.finish();
+    };
+    auto actionsFrameCopy = [](const std::vector<Action *> &acts) {
+        const auto blob = encodeActionPayload(acts);
+        return buildPacket(MSG_ID_EXECUTE_ACTIONS,
+                           QByteArray(reinterpret_cast<const char *>(blob.data()), qsizetype(blob.size())));
+    };
+    for (const auto *set : {&act8, &act255}) {
+        const QString ds = QString("actions-%1").arg(set->size());
+        const qsizetype frameLen = actionsFrame(*set).size();
+        b.run("actionsFrame", ds, frameLen,
+              [&] { return quint64(actionsFrame(*set).isEmpty() ? 0 : set->size()); });
+        b.run("actionsFrameCopy", ds, frameLen,
+              [&] { return quint64(actionsFrameCopy(*set).isEmpty() ? 0 : set->size()); });
+    }
+
+    b.run("encodeCSPIHeader", "tx-1MB", CSPI_HEADER_SIZE,
+          [&] { return quint64(encodeCSPIHeader(cspiLarge).size() != 0); });
+
+    // ActionSet edits (UI add/edit/delete handlers) on a 10k-node graph
+    const QString graphName = QString("graph-%1k").arg(graphN / 1000);
+    b.run("actionSetAdd", graphName, 0, [&] {
+        ActionSet set;
+        buildSet(set, graphParents);
+        return quint64(set.nodes().size());
+    });
+    {
+        ActionSet set;
+        buildSet(set, graphParents);
+        b.run("actionSetEdit", graphName, 0, [&] {
+            // Same kind, same parents: what an edit dialog round trip does
+            for (int id = 1; id < graphN; ++id)
+                set.edit(id, makeNode(id), set.parentsOf(id));
+            return quint64(graphN - 1);
+        });
+        b.run("analyzeTiming", graphName, 0, [&] { return quint64(analyzeTiming(set).nodes.size()); });
+    }
+    b.run("actionSetAddRemove", graphName, 0, [&] {
+        ActionSet set;
+        buildSet(set, graphParents);
+        for (int id : removeOrder) set.remove(id);
+        return quint64(removeOrder.size());
+    });
+
+    FrameParser fp;
+    b.run("parseProtoFrames", "frame-32", small.size(), [&] { return parseProtoFrames(fp, small, smallChunks); });
+    b.run("parseProtoFrames", streamName, stream.size(), [&] { return parseProtoFrames(fp, stream, chunks); });
+
+    struct HexSet { const char *name; const QByteArray *text; const QString *str; };
+    for (const HexSet &h : {HexSet{"lines-16", &hexSmall, &hexSmallStr},
+                            HexSet{"lines-65536", &hexLarge, &hexLargeStr}}) {
+        b.run("parseHexString", h.name, h.text->size(), [&h] {
+            bool ok = false;
+            return quint64(parseHexString(*h.str, 8, 8, &ok).size() / 8);
+        });
+        b.run("decodeHexText", h.name, h.text->size(), [&h] {
+            QByteArray out;
+            qint64 lines = 0;
+            CspiImporter::decodeHexText(h.text->constData(), h.text->size(), 8, 8, out, &lines);
+            return quint64(lines);
+        });
+    }
+
+    std::fprintf(stderr, "%s: %lld bytes in %zu chunks, %llu valid frames generated\n",
+                 qPrintable(streamName), (long long)stream.size(), chunks.size(),
+                 (unsigned long long)validFrames);
+
+    if (!cli.isSet(jsonOpt)) {
+        b.printTable(stdout);
+    } else if (cli.value(jsonOpt) == "-") {
+        const QByteArray json = b.json();
+        std::fwrite(json.constData(), 1, size_t(json.size()), stdout);
+    } else {
+        QFile f(cli.value(jsonOpt));
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate) || f.write(b.json()) < 0) {
+            std::fprintf(stderr, "%s: %s\n", qPrintable(f.fileName()), qPrintable(f.errorString()));
+            return 1;
+        }
+        b.printTable(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,216 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutex>
+#include <QSerialPortInfo>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include "scenario.h"
+#include "runner.h"
+
+/*
+ * debugtool-cli
+ * -------------
+ * Unattended scenario runner: same ActionSet, encoder and framing code as the
+ * GUI, no widgets. Every --port gets its own worker thread running the whole
+ * batch; per-run lines are printed as they finish, a per-port summary at the
+ * end.
+ *
+ * --analyze prints the static timing report of every scenario (makespan
+ * window, critical path, issues; see actiontiming.h) and exits without
+ * opening a port. Before a normal run, scenarios whose worst-case makespan
+ * exceeds their run timeout are reported on stderr, and the batch is refused
+ * (nothing sent) if a scenario has timing errors it does not expect: any
+ * error when it expects "completed", an unreachable action (the device would
+ * never answer) otherwise. --force sends such scenarios anyway.
+ *
+ * Exit code: 0 = every run on every port passed (--analyze: no timing
+ *                errors in scenarios that expect "completed"),
+ *            1 = a run failed or a port could not be opened (--analyze:
+ *                such a timing error was found),
+ *            2 = usage or scenario error (nothing was sent).
+ */
+
+namespace {
+
+enum ExitCode { kPass = 0, kFail = 1, kUsage = 2 };
+
+/* Scenario arguments: files, or directories (their *.json, by name). */
+QStringList expandScenarios(const QStringList &args)
+{
+    QStringList files;
+    for (const QString &a : args) {
+        const QFileInfo fi(a);
+        if (fi.isDir()) {
+            for (const QFileInfo &e : QDir(a).entryInfoList({"*.json"}, QDir::Files, QDir::Name))
+                files << e.filePath();
+        } else {
+            files << a;
+        }
+    }
+    return files;
+}
+
+/* --analyze output for one scenario; false if it has timing errors. */
+bool printTiming(QTextStream &out, const Scenario &s)
+{
+    const TimingReport &t = s.timing;
+    out << s.name << ": " << timingSummary(t) << Qt::endl;
+
+    QStringList path;
+    for (int id : t.criticalPath) path << QString::number(id);
+    out << "  critical path: " << path.join(" > ") << Qt::endl;
+    for (const TimingIssue &is : t.issues)
+        out << "  " << timingIssueText(is) << Qt::endl;
+    return !t.hasErrors();
+}
+
+/* Would sending @s be pointless or hang the device? (see the header comment) */
+bool timingBlocks(const Scenario &s)
+{
+    for (const TimingIssue &is : s.timing.issues) {
+        if (is.severity != TimingIssue::Severity::Error) break;   // errors come first
+        if (!s.expectError || is.kind == TimingIssue::Kind::Unreachable) return true;
+    }
+    return false;
+}
+
+QString summary(const PortReport &rep)
+{
+    if (!rep.openError.isEmpty())
+        return QString("%1  FAIL  not opened (%2)").arg(rep.port, rep.openError);
+
+    int passed = 0, acks = 0, dones = 0;
+    double ackSum = 0, ackMax = 0, doneSum = 0, doneMax = 0;
+    for (const RunResult &r : rep.runs) {
+        passed += r.pass;
+        if (r.ackMs >= 0)  { acks++;  ackSum  += r.ackMs;  ackMax  = std::max(ackMax, r.ackMs); }
+        if (r.doneMs >= 0) { dones++; doneSum += r.doneMs; doneMax = std::max(doneMax, r.doneMs); }
+    }
+    const double secs = rep.elapsedMs / 1000.0;
+    const double bps  = secs > 0 ? (rep.txBytes + rep.rxBytes) / secs : 0.0;
+
+    return QString("%1  %2  start %3  runs %4  pass %5  fail %6  %7 s  tx %8 B  rx %9 B  %10 B/s  "
+                   "ack avg/max %11/%12 ms  done avg/max %13/%14 ms")
+        .arg(rep.port, QString(rep.pass() ? "PASS" : "FAIL"),
+             QDateTime::fromMSecsSinceEpoch(rep.startWallMs).toString(Qt::ISODateWithMs))
+        .arg(rep.runs.size()).arg(passed).arg(int(rep.runs.size()) - passed)
+        .arg(secs, 0, 'f', 2).arg(rep.txBytes).arg(rep.rxBytes).arg(bps, 0, 'f', 0)
+        .arg(acks ? ackSum / acks : 0.0, 0, 'f', 1).arg(ackMax, 0, 'f', 1)
+        .arg(dones ? doneSum / dones : 0.0, 0, 'f', 1).arg(doneMax, 0, 'f', 1);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("debugtool-cli");
+
+    QCommandLineParser cli;
+    cli.setApplicationDescription("Run action-graph scenarios on Debug Tool devices without the GUI.");
+    cli.addHelpOption();
+    const QCommandLineOption portOpt({"p", "port"}, "Serial port (repeat for parallel devices).", "name");
+    const QCommandLineOption baudOpt({"b", "baud"}, "Baud rate (default 115200).", "rate", "115200");
+    const QCommandLineOption repOpt({"n", "repeat"}, "Run the batch N times per port (default 1).", "N", "1");
+    const QCommandLineOption toOpt({"t", "timeout"}, "Per-run timeout in ms (default 10000).", "ms", "10000");
+    const QCommandLineOption listOpt("list-ports", "List serial ports and exit.");
+    const QCommandLineOption anaOpt("analyze", "Print each scenario's static timing report and exit.");
+    const QCommandLineOption forceOpt("force", "Send scenarios even if their timing analysis has errors.");
+    cli.addOptions({portOpt, baudOpt, repOpt, toOpt, listOpt, anaOpt, forceOpt});
+    cli.addPositionalArgument("scenarios", "Scenario JSON files or directories.", "<scenario>...");
+    cli.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if (cli.isSet(listOpt)) {
+        for (const QSerialPortInfo &p : QSerialPortInfo::availablePorts())
+            out << p.portName() << "  " << p.description() << Qt::endl;
+        return kPass;
+    }
+
+    const QStringList ports = cli.values(portOpt);
+    bool ok1 = false, ok2 = false, ok3 = false;
+    const int baud    = cli.value(baudOpt).toInt(&ok1);
+    const int repeat  = cli.value(repOpt).toInt(&ok2);
+    const int timeout = cli.value(toOpt).toInt(&ok3);
+    const bool analyze = cli.isSet(anaOpt);
+    if ((ports.isEmpty() && !analyze) || cli.positionalArguments().isEmpty()
+        || !ok1 || !ok2 || !ok3 || baud <= 0 || repeat <= 0 || timeout <= 0) {
+        err << cli.helpText();
+        return kUsage;
+    }
+
+    // Everything is loaded and encoded before any port is touched
+    std::vector<Scenario> scenarios;
+    for (const QString &path : expandScenarios(cli.positionalArguments())) {
+        Scenario s;
+        QString error;
+        if (!loadScenario(path, s, &error)) {
+            err << error << Qt::endl;
+            return kUsage;
+        }
+        scenarios.push_back(std::move(s));
+    }
+    if (scenarios.empty()) {
+        err << "No scenario files found" << Qt::endl;
+        return kUsage;
+    }
+
+    if (analyze) {
+        bool clean = true;
+        for (const Scenario &s : scenarios)
+            clean = (printTiming(out, s) || s.expectError) && clean;
+        return clean ? kPass : kFail;
+    }
+
+    bool blocked = false;
+    for (const Scenario &s : scenarios) {
+        const int runTimeout = s.timeoutMs > 0 ? s.timeoutMs : timeout;
+        if (s.timing.makespanMaxUs > qint64(runTimeout) * 1000)
+            err << "warning: " << s.name << ": worst-case makespan "
+                << s.timing.makespanMaxUs / 1000 << " ms exceeds the " << runTimeout
+                << " ms run timeout" << Qt::endl;
+        if (!timingBlocks(s)) continue;
+        blocked = true;
+        for (const TimingIssue &is : s.timing.issues)
+            if (is.severity == TimingIssue::Severity::Error)
+                err << s.name << ": " << timingIssueText(is) << Qt::endl;
+    }
+    if (blocked && !cli.isSet(forceOpt)) {
+        err << "Timing errors, nothing sent (--force to send anyway)" << Qt::endl;
+        return kUsage;
+    }
+
+    QMutex outLock;
+    auto log = [&](const QString &line) {
+        QMutexLocker lock(&outLock);
+        out << line << Qt::endl;
+    };
+
+    // One blocking runner per port, each on its own thread
+    std::vector<PortReport> reports(size_t(ports.size()));
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (qsizetype i = 0; i < ports.size(); ++i) {
+        threads.emplace_back(QThread::create([&, i] {
+            PortRunner runner(ports[i], baud, scenarios, repeat, timeout, log);
+            reports[size_t(i)] = runner.run();
+        }));
+        threads.back()->start();
+    }
+    for (auto &t : threads) t->wait();
+
+    bool allPass = true;
+    out << Qt::endl;
+    for (const PortReport &rep : reports) {
+        out << summary(rep) << Qt::endl;
+        allPass = allPass && rep.pass();
+    }
+    return allPass ? kPass : kFail;
+}
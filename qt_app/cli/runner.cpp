@@ -0,0 +1,148 @@
+#include "runner.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QSerialPort>
+
+namespace {
+
+constexpr int       kDrainMs   = 20;     // quiet time that counts as "no stale output"
+constexpr qsizetype kMaxLine   = 4096;   // binary noise without '\n' is dropped past this
+
+double msSince(const QElapsedTimer &t) { return double(t.nsecsElapsed()) / 1e6; }
+
+QString fmtMs(double ms) { return ms < 0 ? QString("-") : QString::number(ms, 'f', 1); }
+
+} // namespace
+
+bool PortReport::pass() const
+{
+    if (!openError.isEmpty() || runs.empty()) return false;
+    for (const RunResult &r : runs)
+        if (!r.pass) return false;
+    return true;
+}
+
+PortRunner::PortRunner(const QString &port, qint32 baud, const std::vector<Scenario> &scenarios,
+                       int repeat, int timeoutMs, Log log)
+    : m_port(port), m_baud(baud), m_scenarios(scenarios),
+      m_repeat(repeat), m_timeoutMs(timeoutMs), m_log(std::move(log))
+{
+}
+
+PortReport PortRunner::run()
+{
+    PortReport rep;
+    rep.port        = m_port;
+    rep.startWallMs = QDateTime::currentMSecsSinceEpoch();
+
+    QElapsedTimer wall;
+    wall.start();
+
+    QSerialPort port;
+    port.setPortName(m_port);
+    port.setBaudRate(m_baud);
+    port.setDataBits(QSerialPort::Data8);
+    port.setParity(QSerialPort::NoParity);
+    port.setStopBits(QSerialPort::OneStop);
+    port.setFlowControl(QSerialPort::NoFlowControl);
+    if (!port.open(QIODevice::ReadWrite)) {
+        rep.openError = port.errorString();
+        m_log(QString("%1  open failed: %2").arg(m_port, rep.openError));
+        return rep;
+    }
+
+    for (int i = 1; i <= m_repeat; ++i) {
+        for (const Scenario &s : m_scenarios) {
+            RunResult r = runOne(port, s, i);
+            rep.txBytes += r.txBytes;
+            rep.rxBytes += r.rxBytes;
+            m_log(QString("%1  %2 #%3  %4  %5  start %6  tx %7 ms  ack %8 ms  done %9 ms  %10/%11 B")
+                      .arg(m_port, r.scenario).arg(r.iteration)
+                      .arg(QString(r.pass ? "PASS" : "FAIL"), r.outcome,
+                           QDateTime::fromMSecsSinceEpoch(r.startWallMs).toString("HH:mm:ss.zzz"),
+                           fmtMs(r.txMs), fmtMs(r.ackMs), fmtMs(r.doneMs))
+                      .arg(r.txBytes).arg(r.rxBytes));
+            rep.runs.push_back(std::move(r));
+
+            if (port.error() == QSerialPort::ResourceError) {   // unplugged: nothing left to run
+                m_log(QString("%1  port lost: %2").arg(m_port, port.errorString()));
+                rep.elapsedMs = wall.elapsed();
+                return rep;
+            }
+        }
+    }
+
+    port.close();
+    rep.elapsedMs = wall.elapsed();
+    return rep;
+}
+
+RunResult PortRunner::runOne(QSerialPort &port, const Scenario &s, int iteration)
+{
+    RunResult r;
+    r.scenario  = s.name;
+    r.iteration = iteration;
+    const int timeoutMs = s.timeoutMs > 0 ? s.timeoutMs : m_timeoutMs;
+
+    // Leftover lines from an earlier run must not be read as this run's status
+    port.clear(QSerialPort::Input);
+    while (port.waitForReadyRead(kDrainMs))
+        port.readAll();
+
+    QElapsedTimer t;
+    t.start();
+    r.startWallMs = QDateTime::currentMSecsSinceEpoch();
+
+    const qint64 n = port.write(s.frame);
+    if (n != s.frame.size()) {
+        r.outcome = QString("write failed: %1").arg(port.errorString());
+        return r;
+    }
+    while (port.bytesToWrite() > 0) {
+        const qint64 left = timeoutMs - t.elapsed();
+        if (left <= 0 || !port.waitForBytesWritten(int(left))) {
+            r.outcome = QString("write timeout: %1").arg(port.errorString());
+            return r;
+        }
+    }
+    r.txMs    = msSince(t);
+    r.txBytes = n;
+
+    QByteArray buf;
+    bool execError = false;
+    while (r.doneMs < 0) {
+        const qint64 left = timeoutMs - t.elapsed();
+        if (left <= 0 || !port.waitForReadyRead(int(left))) {
+            r.outcome = port.error() == QSerialPort::ResourceError ? port.errorString()
+                                                                     : QString("timeout");
+            return r;
+        }
+        const QByteArray chunk = port.readAll();
+        const double ms = msSince(t);
+        r.rxBytes += chunk.size();
+        buf += chunk;
+
+        qsizetype nl;
+        while (r.doneMs < 0 && (nl = buf.indexOf('\n')) >= 0) {
+            const QByteArray line = buf.left(nl).trimmed();
+            buf.remove(0, nl + 1);
+
+            if (line.startsWith("Executing")) {
+                r.ackMs = ms;
+            } else if (line.startsWith("Execution Error")) {
+                execError = true;
+            } else if (line.startsWith("Execution completed")) {
+                r.doneMs  = ms;
+                r.outcome = execError ? "execution error" : "completed";
+            } else if (line.startsWith("Parse error")) {
+                r.doneMs  = ms;
+                r.outcome = QString::fromLatin1(line).toLower();
+                return r;                                   // never a pass
+            }
+        }
+        if (buf.size() > kMaxLine) buf.clear();
+    }
+
+    r.pass = (execError == s.expectError);
+    return r;
+}
@@ -0,0 +1,80 @@
+#ifndef RUNNER_H
+#define RUNNER_H
+
+#include <QString>
+#include <functional>
+#include <vector>
+#include "scenario.h"
+
+class QSerialPort;
+
+/** Outcome of one scenario execution on one port. */
+struct RunResult {
+    QString scenario;
+    int     iteration{0};
+    bool    pass{false};
+    QString outcome;          ///< "completed", "execution error", "parse error N", "timeout", ...
+    qint64  startWallMs{0};   ///< Epoch ms when the frame write started.
+    double  txMs{0};          ///< Write start → frame handed to the driver.
+    double  ackMs{-1};        ///< Write start → "Executing..." (-1 = not seen).
+    double  doneMs{-1};       ///< Write start → final status line (-1 = timeout).
+    qint64  txBytes{0};
+    qint64  rxBytes{0};
+};
+
+/** Everything one port did during a batch. */
+struct PortReport {
+    QString port;
+    QString openError;        ///< Non-empty: the port never opened, no runs.
+    qint64  startWallMs{0};
+    qint64  elapsedMs{0};
+    qint64  txBytes{0};
+    qint64  rxBytes{0};
+    std::vector<RunResult> runs;
+
+    bool pass() const;
+};
+
+/*------------------------------------------------------------------------------
+ * PortRunner
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - Runs a scenario batch against one device with the blocking QSerialPort
+ *     API, so it needs no event loop and can own a plain worker thread.
+ *     Several PortRunners on several threads drive several devices at once.
+ *
+ * Per run
+ *   - Stale input is drained, the MSG_ID_EXECUTE_ACTIONS frame is written and
+ *     the device's status lines are read until a final one arrives:
+ *       "Executing..."        → ack latency
+ *       "Execution Error!!"   → remembered; the run ends at "completed"
+ *       "Execution completed" → done latency, pass if the expectation matches
+ *       "Parse error N"       → done, always a failure
+ *   - No final line within the timeout fails the run; the batch continues.
+ *
+ * Threading
+ *   - run() creates, uses and destroys its QSerialPort on the calling thread.
+ *   - @log is called from that thread; the caller serializes output.
+ *----------------------------------------------------------------------------*/
+class PortRunner
+{
+public:
+    using Log = std::function<void(const QString &line)>;
+
+    PortRunner(const QString &port, qint32 baud, const std::vector<Scenario> &scenarios,
+               int repeat, int timeoutMs, Log log);
+
+    PortReport run();
+
+private:
+    RunResult runOne(QSerialPort &port, const Scenario &s, int iteration);
+
+    QString                       m_port;
+    qint32                        m_baud;
+    const std::vector<Scenario>  &m_scenarios;
+    int                           m_repeat;
+    int                           m_timeoutMs;
+    Log                           m_log;
+};
+
+#endif // RUNNER_H
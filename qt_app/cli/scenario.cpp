@@ -0,0 +1,170 @@
+#include "scenario.h"
+#include "../actionset.h"
+#include "../actionEncoder.h"
+#include "../framewriter.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+bool fail(QString *error, const QString &msg)
+{
+    if (error) *error = msg;
+    return false;
+}
+
+/* Report IDs → file ids (START stays 0) so messages match the JSON. */
+void relabel(TimingReport &r, const std::unordered_map<int, int> &setToFile)
+{
+    auto map = [&setToFile](int &id) {
+        const auto it = setToFile.find(id);
+        if (it != setToFile.end()) id = it->second;
+    };
+    for (NodeTiming &t : r.nodes) map(t.id);
+    for (int &id : r.order) map(id);
+    for (int &id : r.criticalPath) map(id);
+    for (TimingIssue &is : r.issues)
+        for (int &id : is.ids) map(id);
+    std::sort(r.nodes.begin(), r.nodes.end(),
+              [](const NodeTiming &a, const NodeTiming &b) { return a.id < b.id; });
+}
+
+/* "low" / "high" / missing → Level; anything else is rejected. */
+bool toLevel(const QJsonObject &o, const char *key, Level &out)
+{
+    const QString s = o.value(QLatin1String(key)).toString().toLower();
+    if (s.isEmpty())      out = Level::UNDEFINED;
+    else if (s == "low")  out = Level::LOW;
+    else if (s == "high") out = Level::HIGH;
+    else return false;
+    return true;
+}
+
+/* "A".."E" or the numeric port index used by the action window. */
+bool toPort(const QJsonValue &v, int &out)
+{
+    if (v.isDouble()) { out = v.toInt(-1); return out >= 0 && out <= 4; }
+    const QString s = v.toString().toUpper();
+    if (s.size() != 1 || s[0] < 'A' || s[0] > 'E') return false;
+    out = s[0].unicode() - 'A';
+    return true;
+}
+
+template <typename T>
+bool pinFields(const QJsonObject &o, T &a)
+{
+    a.pin = o.value("pin").toInt(-1);
+    return toPort(o.value("port"), a.port) && a.pin >= 0 && a.pin <= 31
+        && toLevel(o, "initial", a.initial) && toLevel(o, "target", a.target);
+}
+
+std::unique_ptr<Action> makeAction(const QJsonObject &o)
+{
+    const QString kind = o.value("kind").toString().toLower();
+    const auto ms = quint32(o.value("ms").toDouble());
+    const auto us = quint16(o.value("us").toInt());
+
+    if (kind == "delay") {
+        auto d = std::make_unique<DelayAction>();
+        d->durationMs = ms;
+        d->durationUs = us;
+        return d;
+    }
+    if (kind == "pin_read") {
+        auto r = std::make_unique<PinReadAction>();
+        if (!pinFields(o, *r) || !toLevel(o, "final", r->final)) return nullptr;
+        r->durationMs = ms;
+        r->durationUs = us;
+        return r;
+    }
+    if (kind == "pin_write") {
+        auto w = std::make_unique<PinWriteAction>();
+        if (!pinFields(o, *w) || !toLevel(o, "final", w->final)) return nullptr;
+        w->durationMs = ms;
+        w->durationUs = us;
+        return w;
+    }
+    if (kind == "pin_trigger") {
+        auto t = std::make_unique<PinTriggerAction>();
+        if (!pinFields(o, *t)) return nullptr;
+        t->timeoutMs = quint32(o.value("timeout_ms").toDouble());
+        t->timeoutUs = quint16(o.value("timeout_us").toInt());
+        return t;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+bool loadScenario(const QString &path, Scenario &out, QString *error)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly))
+        return fail(error, QString("%1: %2").arg(path, f.errorString()));
+
+    QJsonParseError jerr;
+    const QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &jerr);
+    if (!doc.isObject())
+        return fail(error, QString("%1: %2 at offset %3").arg(path, jerr.errorString()).arg(jerr.offset));
+    const QJsonObject root = doc.object();
+
+    const QString expect = root.value("expect").toString("completed").toLower();
+    if (expect != "completed" && expect != "error")
+        return fail(error, QString("%1: expect must be \"completed\" or \"error\"").arg(path));
+
+    // Same construction path as the editor: ActionSet::add() in list order
+    ActionSet set;
+    std::unordered_map<int, int> fileToSet{{0, 0}};
+    const QJsonArray list = root.value("actions").toArray();
+    if (list.isEmpty())
+        return fail(error, QString("%1: no actions").arg(path));
+
+    for (qsizetype i = 0; i < list.size(); ++i) {
+        const QJsonObject o = list.at(i).toObject();
+        const int fileId = o.value("id").toInt(int(i) + 1);
+        if (fileId <= 0 || fileToSet.count(fileId))
+            return fail(error, QString("%1: action #%2: duplicate or invalid id %3").arg(path).arg(i).arg(fileId));
+
+        std::vector<int> parents;
+        for (const QJsonValue &p : o.value("after").toArray()) {
+            const auto it = fileToSet.find(p.toInt(-1));
+            if (it == fileToSet.end())
+                return fail(error, QString("%1: action %2: unknown parent %3 (parents must come first)")
+                                       .arg(path).arg(fileId).arg(p.toInt(-1)));
+            parents.push_back(it->second);
+        }
+
+        auto a = makeAction(o);
+        if (!a)
+            return fail(error, QString("%1: action %2: bad kind/port/pin/level").arg(path).arg(fileId));
+        fileToSet[fileId] = set.add(std::move(a), parents);
+    }
+
+    // Encoded straight into the EXECUTE_ACTIONS frame
+    FrameWriter w(MSG_ID_EXECUTE_ACTIONS, MAX_PAYLOAD_SIZE);
+    ActionIndex index;
+    if (!encodeActionSetInto(w, set, &index))
+        return fail(error, QString("%1: graph does not fit the wire format (max 256 actions, pins 0..255)").arg(path));
+    if (w.payloadSize() > MAX_PAYLOAD_SIZE)
+        return fail(error, QString("%1: encoded graph is %2 bytes (max %3, %4 of %5 records fit)")
+                               .arg(path).arg(w.payloadSize()).arg(MAX_PAYLOAD_SIZE)
+                               .arg(recordsFitting(index, MAX_PAYLOAD_SIZE)).arg(index.size()));
+
+    out.path        = path;
+    out.name        = root.value("name").toString(QFileInfo(path).completeBaseName());
+    out.frame       = w.finish();
+    out.actions     = int(index.size());
+    out.expectError = (expect == "error");
+    out.timeoutMs   = root.value("timeout_ms").toInt(0);
+
+    std::unordered_map<int, int> setToFile;
+    for (const auto &[fileId, setId] : fileToSet) setToFile[setId] = fileId;
+    out.timing = analyzeTiming(set);
+    relabel(out.timing, setToFile);
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <QByteArray>
+#include <QString>
+#include "../actiontiming.h"
+
+/*------------------------------------------------------------------------------
+ * Scenario
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - One unattended test case for the headless runner: an action graph,
+ *     already encoded and framed as MSG_ID_EXECUTE_ACTIONS, plus the outcome
+ *     the device is expected to report.
+ *
+ * File format (JSON)
+ *   {
+ *     "name":       "blink",            // optional, defaults to the file name
+ *     "expect":     "completed",        // or "error" (device reports -55)
+ *     "timeout_ms": 5000,               // optional, overrides --timeout
+ *     "actions": [
+ *       { "id": 1, "kind": "pin_write", "port": "B", "pin": 21,
+ *         "initial": "low", "target": "high", "final": "low", "ms": 100 },
+ *       { "id": 2, "kind": "delay", "after": [1], "ms": 50, "us": 500 },
+ *       { "id": 3, "kind": "pin_trigger", "after": [2], "port": "C", "pin": 6,
+ *         "target": "high", "timeout_ms": 200 }
+ *     ]
+ *   }
+ *   - kind: delay | pin_read | pin_write | pin_trigger (CSPI is not batchable).
+ *   - after: parent ids from this file (0 = START); empty/missing = START.
+ *     Parents must appear earlier in the list, as in the editor.
+ *   - port: "A".."E" or the GUI's port index; levels: low | high (omitted =
+ *     undefined).
+ *   - File ids are labels only; nodes get dense ids in list order exactly
+ *     like ActionSet::add() in the GUI, so the bytes are identical. The
+ *     timing report is relabeled back to file ids.
+ *----------------------------------------------------------------------------*/
+struct Scenario {
+    QString    name;
+    QString    path;
+    QByteArray frame;              ///< Framed MSG_ID_EXECUTE_ACTIONS packet.
+    int        actions{0};         ///< Encoded records (START included).
+    bool       expectError{false}; ///< Pass only if the device reports an execution error.
+    int        timeoutMs{0};       ///< 0 = runner default.
+    TimingReport timing;           ///< Static timing analysis; IDs are the file's ids.
+};
+
+/**
+ * @brief Parse, build and encode the scenario at @path.
+ * @return false with @error set (file, JSON or graph problem).
+ */
+bool loadScenario(const QString &path, Scenario &out, QString *error);
+
+#endif // SCENARIO_H
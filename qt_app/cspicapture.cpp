@@ -0,0 +1,47 @@
+#include "cspicapture.h"
+#include <QDateTime>
+#include <QDir>
+
+bool CspiCapture::open(const QString &dir)
+{
+    close();
+
+    const QString name = QString("cspi_rx_%1.bin")
+                             .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    m_file.setFileName(QDir(dir).filePath(name));
+
+    m_haveSeq = false;
+    m_nextSeq = 0;
+    m_blocks  = m_lost = 0;
+    m_bytes   = 0;
+
+    return m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+void CspiCapture::close()
+{
+    if (m_file.isOpen()) m_file.close();
+}
+
+/*
+ * Record header + data go through QFile's buffer; the OS write happens in
+ * large batches, so a block per UART frame costs no syscall of its own.
+ */
+void CspiCapture::append(quint16 seq, const QByteArray &data)
+{
+    if (!m_file.isOpen()) return;
+
+    if (m_haveSeq && seq != m_nextSeq)
+        m_lost += quint16(seq - m_nextSeq);   // wrap-safe gap
+    m_haveSeq = true;
+    m_nextSeq = quint16(seq + 1);
+
+    const quint16 len = quint16(data.size());
+    const char hdr[4] = { char(seq >> 8), char(seq & 0xFF),
+                          char(len >> 8), char(len & 0xFF) };
+    m_file.write(hdr, sizeof(hdr));
+    m_file.write(data);
+
+    m_blocks++;
+    m_bytes += len;
+}
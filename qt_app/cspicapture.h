@@ -0,0 +1,58 @@
+#ifndef CSPICAPTURE_H
+#define CSPICAPTURE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+/*------------------------------------------------------------------------------
+ * CspiCapture
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - Appends device MSG_ID_CSPI_RX blocks to a binary capture file instead
+ *     of rendering them as hex text.
+ *
+ * File format
+ *   - Sequence of records: [SEQ:2 BE][LEN:2 BE][LEN bytes of RX words]
+ *     (16-bit words are stored little-endian, exactly as the device sent them).
+ *
+ * Loss accounting
+ *   - The device numbers blocks with a wrapping 16-bit SEQ; a gap means frames
+ *     were lost on the wire (bad CRC / serial overrun) and is counted in lost().
+ *   - Words the device could not buffer are reported by its own drop counter.
+ *----------------------------------------------------------------------------*/
+class CspiCapture
+{
+public:
+    /**
+     * @brief Open a new capture file `cspi_rx_<timestamp>.bin` under @dir.
+     * @return false if the file could not be created.
+     */
+    bool open(const QString &dir);
+
+    /**
+     * @brief Flush and close the current file (no-op if none is open).
+     */
+    void close();
+
+    /**
+     * @brief Append one device block; updates the SEQ gap counter.
+     */
+    void append(quint16 seq, const QByteArray &data);
+
+    bool    isOpen() const { return m_file.isOpen(); }
+    QString path()   const { return m_file.fileName(); }
+    quint32 blocks() const { return m_blocks; }
+    quint32 lost()   const { return m_lost; }
+    quint64 bytes()  const { return m_bytes; }
+
+private:
+    QFile   m_file;
+    bool    m_haveSeq{false};
+    quint16 m_nextSeq{0};
+    quint32 m_blocks{0};
+    quint32 m_lost{0};
+    quint64 m_bytes{0};
+};
+
+#endif // CSPICAPTURE_H
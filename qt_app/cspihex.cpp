@@ -0,0 +1,81 @@
+#include "cspihex.h"
+#include <QRegularExpression>
+#include <QStringList>
+
+/*
+ * parseWordToken
+ * --------------
+ * Parses one hex word token for a `wordBits`-wide frame: 1..ceil(bits/4)
+ * hex digits, value must fit in `wordBits` (e.g. 12-bit: "0" .. "FFF").
+ */
+bool parseWordToken(const QString& tok, int wordBits, quint32* out)
+{
+    const int maxDigits = (wordBits + 3) / 4;
+    if (tok.isEmpty() || tok.size() > maxDigits) return false;
+    bool ok = false;
+    const uint v = tok.toUInt(&ok, 16);
+    if (!ok || v > ((1u << wordBits) - 1u)) return false;
+    if (out) *out = v;
+    return true;
+}
+
+/*
+ * parseHexString
+ * --------------
+ * Converts a multi-line hex-text into the device TX word stream according to
+ * a fixed transfer size (words) per line.
+ *
+ * Expected input format:
+ *   - Each non-empty line must end with a semicolon ';'.
+ *   - Between the line start and the semicolon there must be exactly
+ *     `transferSize` hex word tokens separated by whitespace.
+ *   - Example for transferSize = 3, 8-bit:  "AA BB CC;"
+ *             for transferSize = 2, 12-bit: "7FF 800;"
+ *
+ * Output encoding (matches the device ring): 4..8-bit words take one byte,
+ * 9..16-bit words two bytes little-endian.
+ *
+ * Validation:
+ *   - Missing semicolon, wrong token count, non-hex or too-wide tokens => failure.
+ *
+ * @param s             Source string (possibly multi-line).
+ * @param transferSize  Number of words expected per line.
+ * @param wordBits      SPI frame size in bits (4..16).
+ * @param ok            Out flag set true on success, false on any parse error.
+ *
+ * @return Concatenated words of all valid lines (empty on error).
+ */
+QByteArray parseHexString(const QString& s, int transferSize, int wordBits, bool* ok) {
+    if (ok) *ok = false;
+
+    QByteArray out;
+    QStringList lines = s.split(QRegularExpression("[\r\n]"), Qt::SkipEmptyParts);
+
+    for (int ln = 0; ln < lines.size(); ++ln) {
+        QString line = lines[ln].trimmed();
+        if (line.isEmpty()) continue;
+
+        // Every data line must terminate with ';'
+        if (!line.endsWith(';')) {
+            return {};
+        }
+        line.chop(1); // remove trailing ';'
+
+        // Split into whitespace-separated tokens
+        QStringList tokens = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+        if (tokens.size() != transferSize) {
+            return {};
+        }
+
+        // Parse each token as one word and store it in device order
+        for (const QString& tok : tokens) {
+            quint32 v = 0;
+            if (!parseWordToken(tok, wordBits, &v)) return {};
+            out.append(char(v & 0xFF));
+            if (wordBits > 8) out.append(char((v >> 8) & 0xFF));
+        }
+    }
+
+    if (ok) *ok = true;
+    return out;
+}
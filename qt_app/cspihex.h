@@ -0,0 +1,30 @@
+#ifndef CSPIHEX_H
+#define CSPIHEX_H
+
+#include <QByteArray>
+#include <QString>
+
+/*------------------------------------------------------------------------------
+ * CSPI TX hex text (editor grammar)
+ *------------------------------------------------------------------------------
+ *   - One round per line: `transferSize` whitespace-separated hex words,
+ *     terminated by ';' (e.g. "AA BB CC;", 12-bit: "7FF 800;").
+ *   - Output is the device word stream: 4..8-bit words one byte, 9..16-bit
+ *     words two bytes little-endian.
+ *   - Large files go through CspiImporter::decodeHexText (same grammar,
+ *     table-driven); these QString versions serve the editor text.
+ *----------------------------------------------------------------------------*/
+
+/**
+ * @brief Parse one hex word token for a @wordBits-wide frame.
+ * @return false if the token is empty, too long, not hex or too wide.
+ */
+bool       parseWordToken(const QString& tok, int wordBits, quint32* out);
+
+/**
+ * @brief Convert multi-line editor text into the device TX word stream.
+ * @return Concatenated words of all lines; empty with *ok=false on any error.
+ */
+QByteArray parseHexString(const QString& s, int transferSize, int wordBits, bool* ok);
+
+#endif // CSPIHEX_H
@@ -0,0 +1,194 @@
+#include "cspiimporter.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <array>
+
+namespace {
+
+/* Hex digit → value, 0xFF for anything else. */
+constexpr std::array<quint8, 256> makeHexTable()
+{
+    std::array<quint8, 256> t{};
+    for (auto &v : t) v = 0xFF;
+    for (int c = '0'; c <= '9'; ++c) t[c] = quint8(c - '0');
+    for (int c = 'a'; c <= 'f'; ++c) t[c] = quint8(c - 'a' + 10);
+    for (int c = 'A'; c <= 'F'; ++c) t[c] = quint8(c - 'A' + 10);
+    return t;
+}
+constexpr std::array<quint8, 256> kHex = makeHexTable();
+
+inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v'; }
+
+/* Render up to kPreviewLines rounds of the decoded stream in editor syntax. */
+QString makePreview(const QByteArray &data, int transferSize, int wordBits)
+{
+    const int wb     = (wordBits > 8) ? 2 : 1;
+    const int digits = (wordBits + 3) / 4;
+    const qsizetype roundBytes = qsizetype(transferSize) * wb;
+    if (roundBytes <= 0) return {};
+
+    QString out;
+    const auto *p = reinterpret_cast<const quint8*>(data.constData());
+    for (qsizetype off = 0, ln = 0;
+         off + roundBytes <= data.size() && ln < CspiImporter::kPreviewLines;
+         off += roundBytes, ++ln) {
+        for (int k = 0; k < transferSize; ++k) {
+            quint32 w = p[off + k * wb];
+            if (wb == 2) w |= quint32(p[off + k * wb + 1]) << 8;
+            if (k) out += ' ';
+            out += QString("%1").arg(w, digits, 16, QChar('0')).toUpper();
+        }
+        out += ";\n";
+    }
+    return out;
+}
+
+} // namespace
+
+CspiImporter::CspiImporter(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<CspiImporter::Result>();
+}
+
+CspiImporter::~CspiImporter()
+{
+    cancel();
+}
+
+/*
+ * Single pass over the mapped text: tokens are accumulated digit by digit
+ * through a lookup table and written out as soon as they end. Grammar and
+ * limits match the editor parser (1..ceil(bits/4) digits, value < 2^bits,
+ * exactly transferSize words, ';' last on the line, blank lines skipped).
+ */
+QString CspiImporter::decodeHexText(const char *p, qint64 n, int transferSize, int wordBits,
+                                    QByteArray &out, qint64 *lines,
+                                    const std::atomic_bool *stop)
+{
+    const int     maxDigits = (wordBits + 3) / 4;
+    const quint32 maxVal    = (1u << wordBits) - 1u;
+    const bool    wide      = wordBits > 8;
+
+    out.clear();
+    out.reserve(qsizetype(n / (maxDigits + 1) + 1) * (wide ? 2 : 1));
+
+    qint64 lineNo = 1, dataLines = 0;
+    qint64 i = 0;
+    while (i < n) {
+        if (stop && (lineNo & 0xFFF) == 0 && stop->load(std::memory_order_relaxed))
+            return QStringLiteral("cancelled");
+
+        int  words  = 0;
+        bool sawSemi = false, any = false;
+
+        for (; i < n && p[i] != '\n'; ++i) {
+            const char c = p[i];
+            if (isBlank(c)) continue;
+            if (sawSemi) return QString("line %1: text after ';'").arg(lineNo);
+            any = true;
+            if (c == ';') { sawSemi = true; continue; }
+
+            quint32 v = 0;
+            int     d = 0;
+            for (; i < n; ++i, ++d) {
+                const quint8 h = kHex[quint8(p[i])];
+                if (h == 0xFF) break;
+                v = (v << 4) | h;
+                if (d >= maxDigits) return QString("line %1: word too wide").arg(lineNo);
+            }
+            if (d == 0 || (i < n && !isBlank(p[i]) && p[i] != ';' && p[i] != '\n'))
+                return QString("line %1: invalid hex word").arg(lineNo);
+            if (v > maxVal)
+                return QString("line %1: word exceeds %2 bits").arg(lineNo).arg(wordBits);
+            if (++words > transferSize)
+                return QString("line %1: more than %2 words").arg(lineNo).arg(transferSize);
+
+            out.append(char(v & 0xFF));
+            if (wide) out.append(char((v >> 8) & 0xFF));
+            --i;                          // loop increment lands on the delimiter
+        }
+
+        if (any) {
+            if (!sawSemi)               return QString("line %1: missing ';'").arg(lineNo);
+            if (words != transferSize)  return QString("line %1: expected %2 words").arg(lineNo).arg(transferSize);
+            ++dataLines;
+        }
+        ++i;                              // skip '\n'
+        ++lineNo;
+    }
+
+    if (lines) *lines = dataLines;
+    return {};
+}
+
+CspiImporter::Result CspiImporter::run(const QString &path, int transferSize, int wordBits,
+                                       const std::atomic_bool &stop)
+{
+    Result r;
+    r.path         = path;
+    r.transferSize = transferSize;
+    r.wordBits     = wordBits;
+
+    QElapsedTimer clock;
+    clock.start();
+
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        r.error = f.errorString();
+        return r;
+    }
+    r.fileSize = f.size();
+
+    // map() fails for empty files and some special files; fall back to read
+    QByteArray fallback;
+    const char *src = nullptr;
+    if (r.fileSize > 0) {
+        if (uchar *m = f.map(0, r.fileSize)) src = reinterpret_cast<const char*>(m);
+        else { fallback = f.readAll(); src = fallback.constData(); }
+    }
+
+    const bool binary = QFileInfo(path).suffix().compare("bin", Qt::CaseInsensitive) == 0;
+    const int  wb     = (wordBits > 8) ? 2 : 1;
+
+    if (binary) {
+        if (r.fileSize % wb) {
+            r.error = QString("binary length %1 is not a multiple of %2-byte words")
+                          .arg(r.fileSize).arg(wb);
+            return r;
+        }
+        r.data  = QByteArray(src, qsizetype(r.fileSize));
+        r.lines = (transferSize > 0) ? r.fileSize / (qint64(transferSize) * wb) : 0;
+    } else {
+        r.error = decodeHexText(src, r.fileSize, transferSize, wordBits, r.data, &r.lines, &stop);
+        if (!r.error.isEmpty()) r.data.clear();
+    }
+
+    if (r.error.isEmpty()) {
+        r.data.squeeze();
+        r.preview = makePreview(r.data, transferSize, wordBits);
+    }
+    r.elapsedMs = clock.elapsed();
+    return r;                             // QFile unmaps on destruction
+}
+
+void CspiImporter::start(const QString &path, int transferSize, int wordBits)
+{
+    cancel();
+    m_stop = false;
+    m_thread = QThread::create([this, path, transferSize, wordBits] {
+        Result r = run(path, transferSize, wordBits, m_stop);
+        if (!m_stop) emit finished(r);
+    });
+    m_thread->start();
+}
+
+void CspiImporter::cancel()
+{
+    if (!m_thread) return;
+    m_stop = true;
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+}
@@ -0,0 +1,89 @@
+#ifndef CSPIIMPORTER_H
+#define CSPIIMPORTER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QThread>
+#include <atomic>
+
+/*------------------------------------------------------------------------------
+ * CspiImporter
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - Loads large CSPI TX pattern files without going through the editor:
+ *     the file is memory-mapped and decoded straight into the device word
+ *     stream on a worker thread; the UI only receives the finished bytes and
+ *     a short preview.
+ *
+ * Formats
+ *   - Hex text (default): same grammar as the editor, one line per round,
+ *     `transferSize` whitespace-separated hex words terminated by ';'.
+ *     Decoded with a table-driven scanner (no QString / regex per line).
+ *   - Raw binary (*.bin): bytes are already in device order (4..8-bit words
+ *     one byte, 9..16-bit words two bytes LE); only the length is checked.
+ *
+ * Threading
+ *   - start()/cancel() are called from the owner's thread.
+ *   - finished() is emitted from the worker; connect it queued.
+ *----------------------------------------------------------------------------*/
+class CspiImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** Decoded pattern and what it was decoded with. */
+    struct Result {
+        QString    path;        ///< Source file (matches the start() call).
+        QByteArray data;        ///< Device word stream (empty on error).
+        QString    preview;     ///< First kPreviewLines rounds re-rendered as hex text.
+        QString    error;       ///< Non-empty on failure (with line number for text).
+        qint64     fileSize{0}; ///< Source file size in bytes.
+        qint64     lines{0};    ///< Rounds decoded (data lines / binary rounds).
+        qint64     elapsedMs{0};///< Map + decode time on the worker.
+        int        transferSize{0};
+        int        wordBits{0};
+    };
+
+    static constexpr int kPreviewLines = 64;   ///< Rounds shown in the editor.
+
+    explicit CspiImporter(QObject *parent = nullptr);
+    ~CspiImporter();
+
+    /**
+     * @brief Decode @path on a worker for the given round layout.
+     *        A running import is cancelled first.
+     */
+    void start(const QString &path, int transferSize, int wordBits);
+
+    /**
+     * @brief Cancel and join a running import (no finished() is emitted for it).
+     *        Also reaps the worker after finished() was delivered.
+     */
+    void cancel();
+
+    bool isRunning() const { return m_thread != nullptr; }
+
+    /**
+     * @brief Decode hex text in @p [0, n) into @out. Used by the worker; exposed
+     *        so the same scanner serves the editor path.
+     * @return Empty on success, otherwise an error with its 1-based line number.
+     */
+    static QString decodeHexText(const char *p, qint64 n, int transferSize, int wordBits,
+                                 QByteArray &out, qint64 *lines = nullptr,
+                                 const std::atomic_bool *stop = nullptr);
+
+signals:
+    void finished(const CspiImporter::Result &result);
+
+private:
+    static Result run(const QString &path, int transferSize, int wordBits,
+                      const std::atomic_bool &stop);
+
+    QThread          *m_thread{nullptr};
+    std::atomic_bool  m_stop{false};
+};
+
+Q_DECLARE_METATYPE(CspiImporter::Result)
+
+#endif // CSPIIMPORTER_H
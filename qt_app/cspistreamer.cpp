@@ -0,0 +1,140 @@
+#include "cspistreamer.h"
+#include "actionEncoder.h"
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+
+CspiStreamer::CspiStreamer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+CspiStreamer::~CspiStreamer()
+{
+    stop();
+}
+
+/*
+ * Frame one DATA packet whose payload continues the cyclic source at `pos`.
+ * The payload is filled in contiguous runs (memcpy up to the wrap point)
+ * instead of byte-by-byte modulo, and the CRC uses the table variant.
+ */
+QByteArray CspiStreamer::buildFrame(qsizetype &pos) const
+{
+    constexpr int kLen = CSPI_CHUNK_SIZE;
+    QByteArray pkt(2 + 3 + kLen + 2, Qt::Uninitialized);
+    char *p = pkt.data();
+
+    p[0] = char(SOF0);
+    p[1] = char(SOF1);
+    p[2] = char(MSG_ID_CSPI_DATA);
+    p[3] = char((kLen >> 8) & 0xFF);
+    p[4] = char(kLen & 0xFF);
+
+    char *dst = p + 5;
+    const qsizetype n = m_src.size();
+    if (n == 0) {
+        std::memset(dst, 0, kLen);
+    } else {
+        int filled = 0;
+        while (filled < kLen) {
+            const qsizetype run = std::min<qsizetype>(kLen - filled, n - pos);
+            std::memcpy(dst + filled, m_src.constData() + pos, size_t(run));
+            filled += int(run);
+            pos = (pos + run) % n;
+        }
+    }
+
+    const quint16 crc = crc16_ccitt_update(0xFFFF, p + 2, 3 + kLen);
+    p[5 + kLen]     = char((crc >> 8) & 0xFF);
+    p[5 + kLen + 1] = char(crc & 0xFF);
+    return pkt;
+}
+
+/*
+ * Start a new stream.
+ *
+ * - Short repeat periods are framed right here into m_cycle (one-time cost,
+ *   no worker needed).
+ * - Longer sources get a worker thread that keeps the pool topped up.
+ */
+void CspiStreamer::start(const QByteArray &source)
+{
+    stop();
+
+    m_src      = source;
+    m_cyclePos = 0;
+    m_cycle.clear();
+
+    const qsizetype n = std::max<qsizetype>(m_src.size(), 1);
+    const qsizetype period = std::lcm(n, qsizetype(CSPI_CHUNK_SIZE)) / CSPI_CHUNK_SIZE;
+
+    if (period <= kMaxCached) {
+        qsizetype pos = 0;
+        m_cycle.reserve(size_t(period));
+        for (qsizetype i = 0; i < period; ++i) m_cycle.push_back(buildFrame(pos));
+        return;
+    }
+
+    {
+        QMutexLocker lk(&m_lock);
+        m_running = true;
+    }
+    m_thread = QThread::create([this] { run(); });
+    m_thread->start();
+}
+
+void CspiStreamer::stop()
+{
+    if (m_thread) {
+        {
+            QMutexLocker lk(&m_lock);
+            m_running = false;
+            m_space.wakeAll();
+        }
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+    QMutexLocker lk(&m_lock);
+    m_ready.clear();
+    m_cycle.clear();
+}
+
+QByteArray CspiStreamer::take()
+{
+    if (!m_cycle.empty()) {
+        const QByteArray &f = m_cycle[m_cyclePos];   // implicitly shared, no copy
+        m_cyclePos = (m_cyclePos + 1) % m_cycle.size();
+        return f;
+    }
+
+    QMutexLocker lk(&m_lock);
+    if (m_ready.empty()) return QByteArray();
+    QByteArray f = std::move(m_ready.front());
+    m_ready.pop_front();
+    m_space.wakeOne();
+    return f;
+}
+
+/*
+ * Worker: frame outside the lock, publish under it, sleep while the pool is full.
+ */
+void CspiStreamer::run()
+{
+    qsizetype pos = 0;
+    for (;;) {
+        QByteArray f = buildFrame(pos);
+
+        QMutexLocker lk(&m_lock);
+        while (m_running && int(m_ready.size()) >= kPoolDepth)
+            m_space.wait(&m_lock);
+        if (!m_running) return;
+
+        const bool wasEmpty = m_ready.empty();
+        m_ready.push_back(std::move(f));
+        lk.unlock();
+
+        if (wasEmpty) emit framesReady();
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef CSPISTREAMER_H
+#define CSPISTREAMER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <deque>
+#include <vector>
+
+/*------------------------------------------------------------------------------
+ * CspiStreamer
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - Produces ready-to-write MSG_ID_CSPI_DATA frames (SOF + header + 512-byte
+ *     chunk + CRC) on a worker thread, so answering a device credit is just
+ *     popping finished frames.
+ *
+ * Pool
+ *   - The TX source is streamed cyclically, so the chunk sequence repeats
+ *     every lcm(len, 512) / 512 frames. If that period fits in kMaxCached
+ *     frames, every frame is built once and replayed forever (no per-chunk
+ *     work at all after the first pass).
+ *   - Otherwise the worker keeps kPoolDepth frames ahead of the consumer,
+ *     filling chunks with run-length memcpy from the source and a table CRC.
+ *
+ * Threading
+ *   - start()/stop()/take() are called from the owner's thread.
+ *   - framesReady() is emitted from the worker when the pool goes from empty
+ *     to non-empty; connect it queued to resume sending.
+ *----------------------------------------------------------------------------*/
+class CspiStreamer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kPoolDepth = 32;   ///< Frames kept ahead in streaming mode.
+    static constexpr int kMaxCached = 256;  ///< Max repeat period built once and replayed.
+
+    explicit CspiStreamer(QObject *parent = nullptr);
+    ~CspiStreamer();
+
+    /**
+     * @brief Start producing frames cycling over @source (zero-filled if empty).
+     *        Restarts from the beginning if already running.
+     */
+    void start(const QByteArray &source);
+
+    /**
+     * @brief Stop the worker and drop all pending frames.
+     */
+    void stop();
+
+    /**
+     * @brief Pop the next framed DATA packet; empty if none is ready yet.
+     *        Never blocks.
+     */
+    QByteArray take();
+
+signals:
+    /**
+     * @brief The pool was empty and now has frames again.
+     */
+    void framesReady();
+
+private:
+    void run();                               ///< Worker loop.
+    QByteArray buildFrame(qsizetype &pos) const; ///< Frame the chunk starting at @pos.
+
+    QByteArray m_src;                         ///< Cycled TX source (read-only while running).
+
+    mutable QMutex         m_lock;
+    QWaitCondition         m_space;           ///< Consumer took a frame / stop requested.
+    std::deque<QByteArray> m_ready;           ///< Streaming mode: frames ahead of the consumer.
+    std::vector<QByteArray> m_cycle;          ///< Cached mode: one full repeat period.
+    size_t                 m_cyclePos{0};     ///< Next frame index in m_cycle.
+    bool                   m_running{false};
+    QThread               *m_thread{nullptr};
+};
+
+#endif // CSPISTREAMER_H
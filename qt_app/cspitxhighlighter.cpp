@@ -0,0 +1,95 @@
+#include "cspitxhighlighter.h"
+#include "cspiimporter.h"
+#include <QPointer>
+#include <QTextBlockUserData>
+
+/* Per-block classification; removes itself from the totals when its block dies. */
+class CspiTxBlockData : public QTextBlockUserData
+{
+public:
+    explicit CspiTxBlockData(CspiTxHighlighter *h) : owner(h) {}
+    ~CspiTxBlockData() override
+    {
+        if (owner) owner->adjust(cls, CspiTxHighlighter::Invalid);
+    }
+
+    QPointer<CspiTxHighlighter> owner;
+    int cls{CspiTxHighlighter::Invalid};
+};
+
+CspiTxHighlighter::CspiTxHighlighter(QTextDocument *doc)
+    : QSyntaxHighlighter(doc)
+{
+    m_overFmt.setForeground(QColor("#e74c3c"));
+}
+
+void CspiTxHighlighter::setParams(int transferSize, int wordBits, quint64 thr)
+{
+    if (transferSize == m_tsize && wordBits == m_wbits && thr == m_thr) return;
+    m_tsize = transferSize;
+    m_wbits = wordBits;
+    m_thr   = thr;
+    rehighlight();
+}
+
+/*
+ * One line through the importer's scanner (same grammar as Set), then the
+ * device threshold window over the decoded words.
+ */
+CspiTxHighlighter::LineClass CspiTxHighlighter::classify(const QString &text) const
+{
+    if (m_tsize <= 0 || !text.contains(';')) return Invalid;
+
+    const QByteArray line = text.toLatin1();
+    QByteArray words;
+    qint64 lines = 0;
+    if (!CspiImporter::decodeHexText(line.constData(), line.size(), m_tsize, m_wbits, words, &lines).isEmpty()
+        || lines != 1)
+        return Invalid;
+
+    const int wb       = (m_wbits > 8) ? 2 : 1;
+    const int winWords = qMax(1, qMin(m_tsize, 32 / m_wbits));
+    const quint64 winMask = (quint64(1) << (winWords * m_wbits)) - 1;
+    const auto *p = reinterpret_cast<const quint8*>(words.constData());
+
+    quint64 val = 0;
+    for (int k = m_tsize - winWords; k < m_tsize; ++k) {
+        quint32 w = p[k * wb];
+        if (wb == 2) w |= quint32(p[k * wb + 1]) << 8;
+        val = (val << m_wbits) | w;
+    }
+    return (val > (m_thr & winMask)) ? Over : Valid;
+}
+
+void CspiTxHighlighter::highlightBlock(const QString &text)
+{
+    auto *data = static_cast<CspiTxBlockData*>(currentBlockUserData());
+    if (!data) {
+        data = new CspiTxBlockData(this);
+        setCurrentBlockUserData(data);       // document owns it
+    }
+
+    const LineClass cls = classify(text);
+    if (cls != data->cls) {
+        adjust(data->cls, cls);
+        data->cls = cls;
+    }
+    if (cls == Over) setFormat(0, int(text.size()), m_overFmt);
+}
+
+void CspiTxHighlighter::adjust(int oldClass, int newClass)
+{
+    m_total += (newClass != Invalid) - (oldClass != Invalid);
+    m_over  += (newClass == Over)    - (oldClass == Over);
+    scheduleCounts();
+}
+
+void CspiTxHighlighter::scheduleCounts()
+{
+    if (m_countsPending) return;
+    m_countsPending = true;
+    QMetaObject::invokeMethod(this, [this] {
+        m_countsPending = false;
+        emit countsChanged(m_total, m_over);
+    }, Qt::QueuedConnection);
+}
@@ -0,0 +1,68 @@
+#ifndef CSPITXHIGHLIGHTER_H
+#define CSPITXHIGHLIGHTER_H
+
+#include <QSyntaxHighlighter>
+#include <QTextCharFormat>
+
+/*------------------------------------------------------------------------------
+ * CspiTxHighlighter
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - Colors CSPI TX editor lines whose threshold window exceeds the threshold
+ *     (same rule as the device: last words that fit in 32 bits, first word
+ *     most significant).
+ *
+ * Incremental model
+ *   - QSyntaxHighlighter only re-runs highlightBlock() for blocks touched by
+ *     an edit, so a keystroke costs one line regardless of document size.
+ *   - Each block remembers its classification in user data; the valid/over
+ *     totals are adjusted by the difference when a block is re-evaluated and
+ *     when a block is deleted (user data destructor).
+ *   - setParams() re-highlights the whole document only when the transfer
+ *     size, word size or threshold actually changed.
+ *
+ * Signals
+ *   - countsChanged() is coalesced: at most one per event-loop pass.
+ *----------------------------------------------------------------------------*/
+class CspiTxHighlighter : public QSyntaxHighlighter
+{
+    Q_OBJECT
+
+public:
+    explicit CspiTxHighlighter(QTextDocument *doc);
+
+    /**
+     * @brief Set the round layout and threshold; re-highlights on change.
+     * @param thr Threshold (use UINT64 max for "never over", e.g. invalid input).
+     */
+    void setParams(int transferSize, int wordBits, quint64 thr);
+
+    int total() const { return m_total; }   ///< Valid data lines.
+    int over()  const { return m_over; }    ///< Valid lines above the threshold.
+
+signals:
+    void countsChanged(int total, int over);
+
+protected:
+    void highlightBlock(const QString &text) override;
+
+private:
+    friend class CspiTxBlockData;
+
+    /** Line class: not a data line, valid, valid and over the threshold. */
+    enum LineClass { Invalid = 0, Valid = 1, Over = 2 };
+
+    LineClass classify(const QString &text) const;
+    void adjust(int oldClass, int newClass);   ///< Update totals for one block.
+    void scheduleCounts();
+
+    int     m_tsize{0};
+    int     m_wbits{8};
+    quint64 m_thr{0};
+    int     m_total{0};
+    int     m_over{0};
+    bool    m_countsPending{false};
+    QTextCharFormat m_overFmt;
+};
+
+#endif // CSPITXHIGHLIGHTER_H
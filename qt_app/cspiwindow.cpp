@@ -1,5 +1,6 @@
 #include "cspiwindow.h"
 #include "ui_cspiwindow.h"
+#include "cspitxhighlighter.h"
 
 CSPIWindow::CSPIWindow(QWidget *parent)
     : QWidget(parent)
@@ -7,12 +8,25 @@ CSPIWindow::CSPIWindow(QWidget *parent)
 {
     ui->setupUi(this);
 
+    // Plain text + per-line highlighter (only edited lines are re-evaluated)
+    ui->textEdit_tx_data->setAcceptRichText(false);
+    m_txHighlighter = new CspiTxHighlighter(ui->textEdit_tx_data->document());
+    connect(m_txHighlighter, &CspiTxHighlighter::countsChanged, this,
+            [this](int total, int over) {
+                ui->label_th_vals->setText(QString("%1/%2").arg(total).arg(over));
+            });
+    updateTxHighlight();
+
     connect(ui->lineEdit_threshold, &QLineEdit::textChanged,
             this, &CSPIWindow::updateTxHighlight);
-    connect(ui->textEdit_tx_data, &QTextEdit::textChanged,
-            this, &CSPIWindow::updateTxHighlight);
     connect(ui->spinBox_transfer_size,   &QSpinBox::valueChanged,
             this, &CSPIWindow::updateTxHighlight);
+    connect(ui->comboBox_word, &QComboBox::currentIndexChanged,
+            this, &CSPIWindow::updateTxHighlight);
+
+    // Import worker result comes back on the GUI thread
+    connect(&m_importer, &CspiImporter::finished,
+            this, &CSPIWindow::onImportFinished, Qt::QueuedConnection);
 }
 
 CSPIWindow::~CSPIWindow()
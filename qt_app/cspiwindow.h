@@ -2,6 +2,10 @@
 #define CSPIWINDOW_H
 
 #include <QWidget>
+#include <QElapsedTimer>
+#include "cspiimporter.h"
+
+class CspiTxHighlighter;
 
 namespace Ui {
 class CSPIWindow;
@@ -17,6 +21,10 @@ class CSPIWindow;
  *     a compact binary payload, and emits it to the application when requested.
  *   - Provides controls to clear/import data, stop an ongoing session, or
  *     terminate it abruptly.
+ *   - Imports large TX pattern files (hex text or raw binary) on a worker;
+ *     the decoded bytes bypass the editor, which only shows a preview.
+ *   - Shows live session statistics (rates, starvation, ring health) from the
+ *     device's periodic MSG_ID_CSPI_STATS frames.
  *----------------------------------------------------------------------------*/
 class CSPIWindow : public QWidget
 {
@@ -33,12 +41,19 @@ public:
      */
     ~CSPIWindow();
 
+    /**
+     * @brief Update the stats panel from a MSG_ID_CSPI_STATS payload.
+     *        Rates are derived from the previous report's counters.
+     */
+    void showStats(const QByteArray& payload);
+
 signals:
     /**
-     * @brief Emitted when the user finalizes the CSPI header + TX data.
-     *        The payload format is application-defined (consumer parses it).
+     * @brief Emitted when the user finalizes a CSPI session.
+     * @param header MSG_ID_CSPI_BEGIN payload (encodeCSPIHeader()).
+     * @param txData Device word stream to cycle through DATA frames.
      */
-    void payloadReady(const QByteArray& payload);
+    void payloadReady(const QByteArray& header, const QByteArray& txData);
 
     /**
      * @brief Emitted when the user requests a graceful stop of the CSPI stream.
@@ -54,7 +69,7 @@ signals:
 
 private slots:
     /**
-     * @brief Build payload from current UI state and emit @ref payloadReady.
+     * @brief Build the session from current UI state and emit @ref payloadReady.
      */
     void on_setButton_clicked();
 
@@ -79,13 +94,39 @@ private slots:
      */
     void on_terminateButton_clicked();
 
+    /**
+     * @brief Take over a finished import: keep the bytes, show the preview.
+     */
+    void onImportFinished(const CspiImporter::Result& result);
+
 private:
     /* Generated form instance (owned). */
     Ui::CSPIWindow *ui{nullptr};
 
+    /* TX editor line highlighter (owned by the editor's document). */
+    CspiTxHighlighter *m_txHighlighter{nullptr};
+
+    /* File import (bytes kept out of the editor). */
+    CspiImporter  m_importer;
+    QString       m_importPath;       ///< File of the pending/active import.
+    QByteArray    m_importedTx;       ///< Decoded TX stream; used by Set instead of the editor.
+    int           m_importTsize{0};   ///< Transfer size the import was decoded with.
+    int           m_importBits{0};    ///< Word size the import was decoded with.
+
+    /**
+     * @brief Drop the imported pattern and make the editor editable again.
+     */
+    void clearImport();
+
+    /* Previous stats report (rate computation). */
+    QElapsedTimer m_statsClock;
+    quint32       m_lastRounds{0};
+    quint32       m_lastWords{0};
+    quint32       m_lastStarved{0};
+
     /**
-     * @brief Update any visual indicators related to TX data (e.g., byte count,
-     *        preview highlight, validity badges).
+     * @brief Push transfer size / word size / threshold to the TX highlighter
+     *        (full re-highlight only when one of them changed).
      */
     void updateTxHighlight();
 };
@@ -0,0 +1,49 @@
+#include "frameparser.h"
+#include "actionEncoder.h"
+#include <cstring>
+
+void FrameParser::feed(const char *data, qsizetype n, const Handler &onFrame)
+{
+    // Compact only when the consumed prefix dominates the buffer
+    if (m_rd >= kCompactBytes && m_rd * 2 >= m_buf.size()) {
+        m_buf.remove(0, m_rd);
+        m_rd = 0;
+    }
+    if (m_rd == m_buf.size()) { m_buf.resize(0); m_rd = 0; } // nothing pending: keep capacity
+    m_buf.append(data, n);
+
+    const char     *base = m_buf.constData();
+    const qsizetype size = m_buf.size();
+
+    while (m_rd < size) {
+        // Next SOF0
+        const void *hit = std::memchr(base + m_rd, SOF0, size_t(size - m_rd));
+        if (!hit) { m_rd = size; return; }               // all noise
+        const qsizetype sof = static_cast<const char*>(hit) - base;
+        m_rd = sof;
+
+        if (sof + 1 >= size) return;                     // wait for SOF1
+        if (quint8(base[sof + 1]) != SOF1) { m_rd = sof + 1; continue; }
+
+        // Minimum frame: SOF(2) + msg(1) + len(2) + crc(2) = 7 bytes
+        if (size - sof < 7) return;
+
+        const quint8  msg = quint8(base[sof + 2]);
+        const quint16 len = quint16((quint8(base[sof + 3]) << 8) | quint8(base[sof + 4]));
+        if (len > kMaxPayload) { m_rd = sof + 1; continue; }
+
+        const qsizetype frameLen = 7 + len;
+        if (size - sof < frameLen) return;               // incomplete -> wait
+
+        const quint16 rxCrc = quint16((quint8(base[sof + frameLen - 2]) << 8)
+                                      | quint8(base[sof + frameLen - 1]));
+        if (crc16_ccitt_update(0xFFFF, base + sof + 2, 3 + len) != rxCrc) {
+            ++m_crcErrors;
+            m_rd = sof + 1;                              // resync after this 0xAA
+            continue;
+        }
+
+        m_rd = sof + frameLen;                           // consume before the callback
+        onFrame(msg, base + sof + 5, len);
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef FRAMEPARSER_H
+#define FRAMEPARSER_H
+
+#include <QByteArray>
+#include <functional>
+
+/*------------------------------------------------------------------------------
+ * FrameParser
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - Incremental parser for device frames: AA 55 | MSG | LEN(2 BE) |
+ *     PAYLOAD | CRC16-CCITT-FALSE(2 BE) over MSG..PAYLOAD.
+ *
+ * Buffering
+ *   - Incoming chunks are appended to one buffer and scanned from a read
+ *     offset; consumed frames and noise only advance the offset, nothing is
+ *     erased from the front per frame.
+ *   - The consumed prefix is dropped (one memmove of the unparsed tail) only
+ *     when it outgrows kCompactBytes and half the buffer, so compaction is
+ *     amortized O(1) per byte.
+ *   - SOF search uses memchr; CRC is the table variant.
+ *
+ * Resync
+ *   - Bad CRC or an implausible LEN (> kMaxPayload) skips just that 0xAA, so
+ *     a fake header inside noise cannot stall parsing while waiting for a
+ *     64 KiB "frame".
+ *
+ * Threading
+ *   - No internal locking; feed() from one thread.
+ *----------------------------------------------------------------------------*/
+class FrameParser
+{
+public:
+    static constexpr int kMaxPayload   = 1024;      ///< Device MAX_PAYLOAD is 512; margin for growth.
+    static constexpr int kCompactBytes = 64 * 1024; ///< Consumed prefix size that triggers compaction.
+
+    /** Called for each valid frame; @payload points into the parser buffer,
+     *  preceded by the 5 header bytes and followed by the 2 CRC bytes. */
+    using Handler = std::function<void(quint8 msg, const char *payload, quint16 len)>;
+
+    /**
+     * @brief Append @n bytes and dispatch every complete valid frame.
+     */
+    void feed(const char *data, qsizetype n, const Handler &onFrame);
+    void feed(const QByteArray &chunk, const Handler &onFrame) { feed(chunk.constData(), chunk.size(), onFrame); }
+
+    /**
+     * @brief Drop buffered bytes (e.g. on port change).
+     */
+    void reset() { m_buf.clear(); m_rd = 0; }
+
+    qsizetype pending() const { return m_buf.size() - m_rd; }  ///< Unparsed bytes.
+    quint64   crcErrors() const { return m_crcErrors; }        ///< Frames rejected by CRC.
+
+private:
+    QByteArray m_buf;
+    qsizetype  m_rd{0};          ///< First unparsed byte in m_buf.
+    quint64    m_crcErrors{0};
+};
+
+#endif // FRAMEPARSER_H
@@ -0,0 +1,41 @@
+#include "framewriter.h"
+#include "actionEncoder.h"
+#include <cstring>
+
+FrameWriter::FrameWriter(quint8 msgId, qsizetype payloadHint)
+{
+    m_buf.reserve(kHeaderSize + payloadHint + kCrcSize);
+    m_buf.resize(kHeaderSize);
+    char *p = m_buf.data();
+    p[0] = char(SOF0);
+    p[1] = char(SOF1);
+    p[2] = char(msgId);
+    p[3] = p[4] = 0;                        // LEN, patched by finish()
+}
+
+/* resize() keeps the reserved capacity, so within the hint this is a size bump. */
+std::uint8_t* FrameWriter::grow(qsizetype n)
+{
+    const qsizetype at = m_buf.size();
+    m_buf.resize(at + n);
+    return reinterpret_cast<std::uint8_t*>(m_buf.data()) + at;
+}
+
+void FrameWriter::append(const char* p, qsizetype n)
+{
+    if (n > 0) std::memcpy(grow(n), p, size_t(n));
+}
+
+QByteArray FrameWriter::finish()
+{
+    const quint16 len = quint16(payloadSize());
+    char *p = m_buf.data();
+    p[3] = char((len >> 8) & 0xFF);
+    p[4] = char(len & 0xFF);
+
+    const quint16 crc = crc16_ccitt_update(0xFFFF, p + 2, 3 + len);
+    std::uint8_t *c = grow(kCrcSize);
+    c[0] = std::uint8_t(crc >> 8);
+    c[1] = std::uint8_t(crc);
+    return std::move(m_buf);
+}
@@ -0,0 +1,61 @@
+#ifndef FRAMEWRITER_H
+#define FRAMEWRITER_H
+
+#include <QByteArray>
+#include <cstdint>
+
+/*------------------------------------------------------------------------------
+ * FrameWriter
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - Builds one device frame (AA 55 | MSG | LEN(2 BE) | PAYLOAD | CRC16) in
+ *     a single buffer: the header is written up front, the payload is encoded
+ *     straight after it, LEN and CRC are filled in by finish().
+ *
+ * Allocation
+ *   - The constructor reserves header + @payloadHint + CRC once. With a hint
+ *     that covers the payload (MAX_PAYLOAD_SIZE always does) the frame is
+ *     built without any further allocation or copy.
+ *
+ * CRC
+ *   - The CRC covers LEN, which is only known when the payload is complete,
+ *     so finish() runs the table CRC once over the in-place MSG..PAYLOAD
+ *     range (still cache-hot) instead of per write.
+ *
+ * Usage
+ *   FrameWriter w(MSG_ID_SLOT_UPLOAD, MAX_PAYLOAD_SIZE);
+ *   w.put(slot);
+ *   encodeActionSetInto(w, set, &index);
+ *   link.send(w.finish());
+ *----------------------------------------------------------------------------*/
+class FrameWriter
+{
+public:
+    static constexpr int kHeaderSize = 5;   ///< SOF0 SOF1 MSG LEN_H LEN_L
+    static constexpr int kCrcSize    = 2;
+
+    explicit FrameWriter(quint8 msgId, qsizetype payloadHint = 0);
+
+    /**
+     * @brief Extend the payload by @n bytes and return where to write them.
+     *        The bytes are uninitialized; the pointer is valid until the next grow().
+     */
+    std::uint8_t* grow(qsizetype n);
+
+    void put(quint8 v) { *grow(1) = v; }
+    void append(const char* p, qsizetype n);
+    void append(const QByteArray& b) { append(b.constData(), b.size()); }
+
+    qsizetype payloadSize() const { return m_buf.size() - kHeaderSize; }
+
+    /**
+     * @brief Patch LEN, append the CRC and hand over the finished frame.
+     *        The writer is empty afterwards.
+     */
+    QByteArray finish();
+
+private:
+    QByteArray m_buf;
+};
+
+#endif // FRAMEWRITER_H
@@ -3,5 +3,6 @@
 
 void CSPIWindow::on_clrButton_clicked()
 {
+    clearImport();
     ui->textEdit_tx_data->clear();
 }
@@ -1,8 +1,7 @@
 #include "../../cspiwindow.h"
 #include "../../ui_cspiwindow.h"
 #include <QFileDialog>
-#include <QFile>
-#include <QTextStream>
+#include <QFileInfo>
 #include <QMessageBox>
 
 /*
@@ -11,44 +10,93 @@
  * Slot for handling the "Import" button click in the CSPIWindow UI.
  *
  * Behavior:
- *   1. Opens a file dialog allowing the user to select a *.txt file (or any file).
+ *   1. Opens a file dialog for a hex-text pattern (*.txt) or raw binary (*.bin).
  *   2. If the user cancels, the function simply returns without action.
- *   3. Attempts to open the selected file in read-only text mode.
- *      - If opening fails, shows a QMessageBox warning with the error string.
- *   4. If successful, reads the entire file into a QString.
- *   5. Populates the UI's tx_data text editor with the imported content.
+ *   3. Hands the file to CspiImporter, which memory-maps and decodes it on a
+ *      worker for the current transfer/word size. The editor is locked and
+ *      shows progress; the UI stays responsive for multi-megabyte files.
+ *   4. onImportFinished() takes the result.
  */
 void CSPIWindow::on_importButton_clicked()
 {
     // Step 1: Prompt user to select a file
     QString fileName = QFileDialog::getOpenFileName(
         this,
-        tr("Import Data from TXT"),
+        tr("Import TX Pattern"),
         "",
-        tr("Text Files (*.txt);;All Files (*)")
+        tr("Hex Text (*.txt);;Raw Binary (*.bin);;All Files (*)")
         );
 
     // Step 2: If no file was chosen, abort
     if (fileName.isEmpty())
         return;
 
-    // Step 3: Open the chosen file in read-only text mode
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        // Error handling: show message box with cause
-        QMessageBox::warning(
-            this,
-            tr("Error"),
-            tr("Cannot open file: %1").arg(file.errorString())
-            );
+    // Step 3: Decode on the worker with the layout currently selected
+    clearImport();
+    m_importPath = fileName;
+    const int wbits = ui->comboBox_word->currentIndex() + 4;   // 4..16 bit (see set.cpp)
+    m_importer.start(fileName, ui->spinBox_transfer_size->value(), wbits);
+
+    const QSignalBlocker blocker(ui->textEdit_tx_data);
+    ui->textEdit_tx_data->clear();
+    ui->textEdit_tx_data->setReadOnly(true);
+    ui->textEdit_tx_data->setPlaceholderText(
+        tr("Importing %1 ...").arg(QFileInfo(fileName).fileName()));
+}
+
+/*
+ * onImportFinished
+ * ----------------
+ * - Errors: warn with the decoder's message (includes the line number for
+ *   hex text) and unlock the editor.
+ * - Success: keep the decoded bytes for Set, show the first rounds as a
+ *   read-only preview and report size / rounds / load time.
+ * - Results of an import that was superseded by a newer one are ignored.
+ */
+void CSPIWindow::onImportFinished(const CspiImporter::Result& r)
+{
+    if (r.path != m_importPath) return;
+    m_importer.cancel();                      // worker is done; join it
+
+    if (!r.error.isEmpty()) {
+        clearImport();
+        QMessageBox::warning(this, tr("Error"),
+                             tr("Cannot import %1: %2").arg(QFileInfo(r.path).fileName(), r.error));
         return;
     }
 
-    // Step 4: Read entire content of file
-    QTextStream in(&file);
-    QString content = in.readAll();
-    file.close();
+    m_importedTx  = r.data;
+    m_importTsize = r.transferSize;
+    m_importBits  = r.wordBits;
+
+    {
+        const QSignalBlocker blocker(ui->textEdit_tx_data);
+        ui->textEdit_tx_data->setPlainText(r.preview);   // highlighter colors the preview
+    }
+
+    const QString info = tr("%1: %2 MB, %3 rounds, %4 ms")
+                             .arg(QFileInfo(r.path).fileName())
+                             .arg(r.fileSize / 1048576.0, 0, 'f', 1)
+                             .arg(r.lines)
+                             .arg(r.elapsedMs);
+    ui->textEdit_tx_data->setToolTip(info + tr("\nPreview only; Clear to edit again."));
+    ui->label_stats->setText(info);
+}
+
+/*
+ * clearImport
+ * -----------
+ * Forget the imported pattern (cancelling a running import) and return the
+ * editor to normal text entry.
+ */
+void CSPIWindow::clearImport()
+{
+    m_importer.cancel();
+    m_importPath.clear();
+    m_importedTx.clear();
+    m_importTsize = m_importBits = 0;
 
-    // Step 5: Set text content into the designated UI text editor
-    ui->textEdit_tx_data->setPlainText(content);
+    ui->textEdit_tx_data->setReadOnly(false);
+    ui->textEdit_tx_data->setToolTip(QString());
+    ui->textEdit_tx_data->setPlaceholderText(QString());
 }
@@ -0,0 +1,61 @@
+#include "../../cspiwindow.h"
+#include "../../ui_cspiwindow.h"
+#include "../../actionEncoder.h"
+#include <algorithm>
+
+/*
+ * Render a MSG_ID_CSPI_STATS payload.
+ *
+ * Layout (proto::CspiStats; device → host, all BE, counters cumulative since BEGIN):
+ *   [ROUNDS:4][WORDS:4][STARVED:4][UNDERFLOW:4][THR_HITS:4][RX_DROPPED:4]
+ *   [RTT_US:4][RTT_MAX_US:4][RING_MIN:2][RING_SIZE:2]
+ *
+ * - Rates are deltas against the previous report over host elapsed time;
+ *   the baseline resets when a session is started from this window (or a
+ *   counter goes backwards).
+ * - The ring bar shows the lowest TX ring fill seen since the last report;
+ *   a bar near zero means the host is barely keeping up.
+ */
+void CSPIWindow::showStats(const QByteArray& payload)
+{
+    if (payload.size() < CSPI_STATS_SIZE) return;
+
+    const auto s = proto::read<proto::CspiStats>(reinterpret_cast<const quint8*>(payload.constData()));
+    const quint32 rounds    = s.rounds;
+    const quint32 words     = s.words;
+    const quint32 starved   = s.starved;
+    const quint32 underflow = s.underflow;
+    const quint32 thrHits   = s.thr_hits;
+    const quint32 rxDropped = s.rx_dropped;
+    const quint32 rttUs     = s.rtt_us;
+    const quint32 rttMaxUs  = s.rtt_max_us;
+    const int     ringMin   = s.ring_min;
+    const int     ringSize  = s.ring_size;
+
+    if (!m_statsClock.isValid() || rounds < m_lastRounds || words < m_lastWords) {
+        m_lastRounds = m_lastWords = m_lastStarved = 0;
+        m_statsClock.start();
+    }
+    const double dt = std::max<qint64>(m_statsClock.restart(), 1) / 1000.0;
+    const double wordsPerS   = (words   - m_lastWords)   / dt;
+    const double roundsPerS  = (rounds  - m_lastRounds)  / dt;
+    const double starvedPerS = (starved - m_lastStarved) / dt;
+    m_lastRounds  = rounds;
+    m_lastWords   = words;
+    m_lastStarved = starved;
+
+    ui->progressBar_ring->setMaximum(std::max(ringSize, 1));
+    ui->progressBar_ring->setValue(std::min(ringMin, ringSize));
+
+    ui->label_stats->setText(
+        QString("words/s  %1\nrounds/s %2  thr %3\nstarved  %4 (%5/s)\nunderfl  %6  rxdrop %7\nrtt us   %8 (max %9)")
+            .arg(wordsPerS, 0, 'f', 0)
+            .arg(roundsPerS, 0, 'f', 0)
+            .arg(thrHits)
+            .arg(starved)
+            .arg(starvedPerS, 0, 'f', 0)
+            .arg(underflow)
+            .arg(rxDropped)
+            .arg(rttUs)
+            .arg(rttMaxUs));
+}
@@ -6,14 +6,14 @@
  * MainWindow::on_addActionButton_clicked
  * --------------------------------------
  * Opens the "Add Action" dialog, collects the newly created action along with
- * its dependencies, translates dependency *indices in the current UI list*
- * into canonical *action IDs*, and inserts the new node into the ActionSet.
+ * its dependencies (the action IDs shown in the list), drops IDs that do not
+ * exist, and inserts the new node into the ActionSet.
  *
  * Flow:
  *   1) Show AddActionWindow and bail if the user cancels.
  *   2) Take ownership of the freshly created Action (raw pointer -> unique_ptr).
- *   3) Map dialog-reported dependency indices (rows in the current list view)
- *      to the corresponding persistent action IDs held by ActionSet.
+ *   3) Keep the dialog-reported dependency IDs that exist in ActionSet.
+ *      IDs are stable and not row numbers (removals leave gaps).
  *   4) Add the new node with its dependency edges into ActionSet.
  *   5) Refresh the list UI.
  */
@@ -27,18 +27,15 @@ void MainWindow::on_addActionButton_clicked()
     std::unique_ptr<Action> node(dlg.createdAction());
     if (!node) return;
 
-    // 3) Convert dependency *indices* (rows in the current list widget)
-    //    into stable *IDs* from the ActionSet's backing store.
-    const auto& nodes   = actionSet.nodes();
-    const auto  depsIdx = dlg.dependencies();
+    // 3) Dependencies are the "ID:n" values shown in the list; IDs are
+    //    stable (not rows), so only existence has to be checked.
+    const auto depsIn = dlg.dependencies();
     std::vector<int> depsId;
-    depsId.reserve(depsIdx.size());
+    depsId.reserve(depsIn.size());
 
-    for (int idx : depsIdx) {
-        // Validate index against current nodes vector; ignore out-of-range
-        if (idx >= 0 && idx < static_cast<int>(nodes.size())) {
-            depsId.push_back(nodes[idx]->id); // map list row -> action ID
-        }
+    for (int id : depsIn) {
+        // Ignore IDs that are not (or no longer) in the set
+        if (actionSet.find(id)) depsId.push_back(id);
     }
 
     // 4) Insert the new node into the graph with its parent links
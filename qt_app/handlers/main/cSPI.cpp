@@ -16,8 +16,8 @@
  *    focuses it.
  *
  * Signal wiring:
- *  - CSPIWindow::payloadReady(QByteArray)  -> MainWindow::onCspiPayloadReady
- *      Emitted when user prepares a valid CSPI header/payload; the main window
+ *  - CSPIWindow::payloadReady(header, txData) -> MainWindow::onCspiPayloadReady
+ *      Emitted when user prepares a valid CSPI header/TX data; the main window
  *      forwards it over the serial link.
  *  - CSPIWindow::stopRequested()           -> MainWindow::onSPIStopRequested
  *      Requests a graceful stop of the ongoing bulk SPI transfer.
@@ -5,19 +5,19 @@
  * MainWindow::on_connButton_clicked
  * ---------------------------------
  * Toggle serial connection:
- *  - When disconnected: open port using UI-selected name and standard UART
- *    parameters, update UI state, and attach the SerialMonitor.
- *  - When connected: detach monitor, close port, and reset UI state.
+ *  - When disconnected: ask the transport to open the UI-selected port; the
+ *    result arrives in onLinkOpened() (the port is opened on the I/O thread).
+ *  - When connected: detach monitor, close the transport, and reset UI state.
  *
  * Behavior details:
- *  - Port parameters:
+ *  - Port parameters (applied by SerialTransport):
  *      Baud      : 115200
  *      Data bits : 8
  *      Parity    : None
  *      Stop bits : 1
  *      Flow ctrl : None
+ *  - The button is disabled while an open is in flight.
  *  - Status bar shows short feedback messages for success/failure.
- *  - Guarded against empty port name and failed open() with error message.
  */
 void MainWindow::on_connButton_clicked()
 {
@@ -27,40 +27,85 @@ void MainWindow::on_connButton_clicked()
         const QString portName = ui->comboBox_port->currentText();
         if (portName.isEmpty()) return;
 
-        // Configure low-level serial parameters before opening.
-        serial.setPortName(portName);
-        serial.setBaudRate(QSerialPort::Baud115200);
-        serial.setDataBits(QSerialPort::Data8);
-        serial.setParity(QSerialPort::NoParity);
-        serial.setStopBits(QSerialPort::OneStop);
-        serial.setFlowControl(QSerialPort::NoFlowControl);
-
-        // Attempt to open the port for read/write; show reason if it fails.
-        if (!serial.open(QIODevice::ReadWrite)) {
-            statusBar()->showMessage(
-                QString("Open failed: %1").arg(serial.errorString()), 3000);
-            return;
-        }
-
-        // Mark as connected and refresh UI/monitor state.
-        connected = true;
-        ui->connButton->setText("Disconnect");
-        statusBar()->showMessage(QString("Connected: %1").arg(portName), 2000);
-
-        // If the serial monitor window is alive, hook it to the active port.
-        if (monitor) monitor->attachPort(&serial);
+        ui->connButton->setEnabled(false);
+        m_link.open(portName, 115200);
     }
     else
     {
-        // Detach monitor first to stop it from reading a closing device.
-        if (monitor) monitor->detachPort();
+        // Detach monitor first so it stops draining a closing link.
+        if (monitor) monitor->detachTransport();
 
-        // Close port if still open; ignore errors here (best-effort shutdown).
-        if (serial.isOpen()) serial.close();
+        // Blocks until the I/O thread has released the port; closed() follows.
+        m_link.close();
+        onLinkClosed(QString());
+    }
+}
 
-        // Mark as disconnected and refresh UI/monitor state.
-        connected = false;
-        ui->connButton->setText("Connect");
-        statusBar()->showMessage("Disconnected", 2000);
+/*
+ * MainWindow::onLinkOpened
+ * ------------------------
+ * Open result from the transport thread.
+ *  - Failure: show the port's error string and re-enable the button.
+ *  - Success: mark connected, start the metrics refresh, and hook the monitor.
+ */
+void MainWindow::onLinkOpened(bool ok, const QString& error)
+{
+    ui->connButton->setEnabled(true);
+
+    if (!ok) {
+        statusBar()->showMessage(QString("Open failed: %1").arg(error), 3000);
+        return;
     }
+
+    connected = true;
+    ui->connButton->setText("Disconnect");
+    statusBar()->showMessage(QString("Connected: %1").arg(ui->comboBox_port->currentText()), 2000);
+
+    m_linkTimer->start(500);
+    refreshLinkStats();
+
+    // If the serial monitor window is alive, hook it to the live link.
+    if (monitor) monitor->attachTransport(&m_link);
+}
+
+/*
+ * MainWindow::onLinkClosed
+ * ------------------------
+ * Reached after a user disconnect (empty @reason, possibly twice) or when the
+ * port is lost (e.g. USB unplugged). Idempotent.
+ */
+void MainWindow::onLinkClosed(const QString& reason)
+{
+    if (!connected) return;
+
+    if (monitor) monitor->detachTransport();
+
+    connected = false;
+    m_linkTimer->stop();
+    refreshLinkStats();
+
+    ui->connButton->setText("Connect");
+    statusBar()->showMessage(reason.isEmpty() ? QString("Disconnected")
+                                              : QString("Port lost: %1").arg(reason), 3000);
+}
+
+/*
+ * MainWindow::refreshLinkStats
+ * ----------------------------
+ * Permanent status bar summary of SerialTransport::metrics():
+ *   TX delivered frames / KiB, backlog, delivery latency avg/max,
+ *   rejected sends (back-pressure), RX KiB and bytes dropped.
+ */
+void MainWindow::refreshLinkStats()
+{
+    const SerialTransport::Metrics m = m_link.metrics();
+    m_linkStats->setText(QString("TX %1 fr %2 KiB  q %3 B  lat %4/%5 ms  rej %6  |  RX %7 KiB  drop %8")
+                             .arg(m.txFrames)
+                             .arg(m.txBytes / 1024)
+                             .arg(m.txBacklog)
+                             .arg(m.txLatAvgUs / 1000.0, 0, 'f', 1)
+                             .arg(m.txLatMaxUs / 1000.0, 0, 'f', 1)
+                             .arg(m.txRejected)
+                             .arg(m.rxBytes / 1024)
+                             .arg(m.rxDropped));
 }
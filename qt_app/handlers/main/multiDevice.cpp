@@ -0,0 +1,31 @@
+#include "../../mainwindow.h"
+#include "../../multidevicewindow.h"
+
+/*
+ * MainWindow::on_multiButton_clicked
+ * ----------------------------------
+ * Open (or bring to front) the multi-device window.
+ *
+ * Behavior:
+ *  - Lazily creates a MultiDeviceWindow as a top-level tool window that
+ *    deletes itself on close.
+ *  - The window pulls the graph through buildActionsPayload() each time a
+ *    run starts, so it always uploads what the editor currently shows, after
+ *    the same timing check as Execute (confirmTiming()).
+ *  - Its sessions use their own transports; the main connection is untouched.
+ */
+void MainWindow::on_multiButton_clicked()
+{
+    if (!multiWin) {
+        multiWin = new MultiDeviceWindow([this] { return buildActionsPayload(); },
+                                         [this] { return confirmTiming("Multi-device run"); },
+                                         this);
+        multiWin->setWindowFlag(Qt::Window, true);
+        multiWin->setWindowTitle("Multi-Device Run");
+        multiWin->setAttribute(Qt::WA_DeleteOnClose);
+    }
+
+    multiWin->show();
+    multiWin->raise();
+    multiWin->activateWindow();
+}
@@ -10,7 +10,7 @@
  *
  * Behavior:
  *  - Lazily constructs the SerialMonitor on first invocation.
- *  - If a serial connection is already open, attaches the port so the monitor
+ *  - If a serial connection is already open, attaches the transport so the monitor
  *    can immediately display incoming/outgoing traffic.
  *  - Connects the monitor’s CSPI request signal to the corresponding slot in
  *    MainWindow (single connection policy).
@@ -26,14 +26,28 @@ void MainWindow::on_serialMonitorButton_clicked()
         monitor->setWindowTitle("Serial Monitor");
         monitor->setAttribute(Qt::WA_DeleteOnClose);
 
-        // If we are already connected, let the monitor tap into the live port.
+        // If we are already connected, let the monitor drain the live link.
         if (connected)
-            monitor->attachPort(&serial);
+            monitor->attachTransport(&m_link);
 
         // Bridge CSPI 'request for data' notifications from the monitor to MainWindow.
         connect(monitor, &SerialMonitor::cspiReqReceived,
                 this,    &MainWindow::onCspiReqReceived,
                 Qt::UniqueConnection);
+        connect(monitor, &SerialMonitor::cspiCreditReceived,
+                this,    &MainWindow::onCspiCreditReceived,
+                Qt::UniqueConnection);
+        connect(monitor, &SerialMonitor::cspiRxBlock,
+                this,    &MainWindow::onCspiRxBlock,
+                Qt::UniqueConnection);
+        connect(monitor, &SerialMonitor::cspiStatsReceived,
+                this,    &MainWindow::onCspiStatsReceived,
+                Qt::UniqueConnection);
+
+        // Resident slot summary replies are shown in the status bar.
+        connect(monitor, &SerialMonitor::slotListReceived,
+                this,    &MainWindow::onSlotListReceived,
+                Qt::UniqueConnection);
     }
 
     // Determine available desktop geometry on the primary screen.
@@ -0,0 +1,14 @@
+#include "../../mainwindow.h"
+#include "../../ui_mainwindow.h"
+#include "../../actionEncoder.h"
+
+/*
+ * MainWindow::on_slotDropButton_clicked
+ * -------------------------------------
+ * Free the selected slot on the device (its RAM is released immediately).
+ */
+void MainWindow::on_slotDropButton_clicked()
+{
+    const int slot = ui->spinBox_slot->value();
+    sendPacket(MSG_ID_SLOT_DROP, QByteArray(1, char(slot)));
+}
@@ -0,0 +1,13 @@
+#include "../../mainwindow.h"
+#include "../../actionEncoder.h"
+
+/*
+ * MainWindow::on_slotListButton_clicked
+ * -------------------------------------
+ * Request the slot summary; the reply is decoded by the SerialMonitor and
+ * delivered to onSlotListReceived().
+ */
+void MainWindow::on_slotListButton_clicked()
+{
+    sendPacket(MSG_ID_SLOT_LIST, QByteArray());
+}
@@ -0,0 +1,15 @@
+#include "../../mainwindow.h"
+#include "../../ui_mainwindow.h"
+#include "../../actionEncoder.h"
+
+/*
+ * MainWindow::on_slotRunButton_clicked
+ * ------------------------------------
+ * Re-trigger the action set resident in the selected slot. The frame carries
+ * only the slot number, so no encoding or device-side parsing is involved.
+ */
+void MainWindow::on_slotRunButton_clicked()
+{
+    const int slot = ui->spinBox_slot->value();
+    sendPacket(MSG_ID_SLOT_EXECUTE, QByteArray(1, char(slot)));
+}
@@ -0,0 +1,39 @@
+#include "../../mainwindow.h"
+#include "../../ui_mainwindow.h"
+#include "../../actionEncoder.h"
+
+/*
+ * MainWindow::on_slotUploadButton_clicked
+ * ---------------------------------------
+ * Upload the current action graph into a resident slot on the device.
+ *
+ * Workflow:
+ *  1) Encode the action set exactly like Execute/Write Flash does, behind
+ *     the selected slot number: [SLOT][ACTIONS BLOB...], framed in place.
+ *  2) Static timing check (confirmTiming()): timing errors need the user's
+ *     confirmation, warnings end up in the status line.
+ *  3) Send as MSG_ID_SLOT_UPLOAD; the device parses it once and keeps it in
+ *     RAM so later runs only need a MSG_ID_SLOT_EXECUTE header frame.
+ */
+void MainWindow::on_slotUploadButton_clicked()
+{
+    ActionIndex index;
+    const int slot = ui->spinBox_slot->value();
+    const QByteArray frame = buildActionsFrame(MSG_ID_SLOT_UPLOAD, slot, &index);
+    if (frame.isEmpty()) {
+        ui->statusbar->showMessage("No actions to upload", 2000);
+        return;
+    }
+    if (frame.size() - PROTO_CORE_SIZE > MAX_PAYLOAD_SIZE) {
+        ui->statusbar->showMessage(QString("Action set too large for a slot (%1 of %2 fit)")
+                                       .arg(recordsFitting(index, MAX_PAYLOAD_SIZE - 1))
+                                       .arg(index.size()), 2500);
+        return;
+    }
+
+    QString note;
+    if (!confirmTiming("Slot upload", &note)) return;
+
+    if (sendFrame(frame, &index, /*blob after slot*/1))
+        ui->statusbar->showMessage(QString("Uploaded to slot %1: %2").arg(slot).arg(note), 5000);
+}
@@ -6,35 +6,52 @@
  * MainWindow::on_wFlashButton_clicked
  * -----------------------------------
  * Build the current action set as a UART protocol payload and send it to the
- * device to be stored in on-chip flash.
+ * device to be stored as a record in the on-chip flash store.
  *
  * Workflow:
- *  1) Build the actions payload (raw action blob) using buildActionsPayload().
- *     - If empty, report and abort.
- *  2) Choose message ID based on the "Boot" checkbox:
- *        - MSG_ID_WRITE_FLASH_BOOT : store and mark as bootable (executed on boot)
+ *  1) Choose message ID based on the "Boot" checkbox:
+ *        - MSG_ID_WRITE_FLASH_BOOT : store and mark as bootable (the newest
+ *                                    bootable record is executed on boot)
  *        - MSG_ID_WRITE_FLASH      : store only (not auto-executed on boot)
- *  3) Frame and transmit with sendPacket(msgId, payload).
+ *  2) Build the frame in place with buildActionsFrame(): the record key from
+ *     spinBox_flashKey, then the actions blob ([key][actions blob]).
+ *     Writing an existing key replaces that record; other keys are kept.
+ *     - If empty, report and abort.
+ *     - If it does not fit, the index tells how many actions would.
+ *  3) Static timing check (confirmTiming()): a stored graph with timing
+ *     errors (e.g. a boot record that would hang) needs confirmation.
+ *  4) Transmit with sendFrame(frame, index, 1).
  *     - On failure, show error; otherwise, show a short success notice.
  */
 void MainWindow::on_wFlashButton_clicked()
 {
-    // 1) Encode current UI action graph into a binary payload for the target
-    QByteArray payload = buildActionsPayload();
-    if (payload.isEmpty()) {
+    // 1) Select message ID depending on whether the user wants a bootable frame
+    const quint8 msgId = ui->flashBootcheckBox->isChecked()
+                             ? MSG_ID_WRITE_FLASH_BOOT
+                             : MSG_ID_WRITE_FLASH;
+
+    // 2) Record key + current UI action graph, encoded straight into the frame
+    ActionIndex index;
+    const QByteArray frame = buildActionsFrame(msgId, ui->spinBox_flashKey->value(), &index);
+    if (frame.isEmpty()) {
         ui->statusbar->showMessage("No actions to write into flash", 2500);
         return;
     }
+    if (frame.size() - PROTO_CORE_SIZE > MAX_PAYLOAD_SIZE) {
+        ui->statusbar->showMessage(QString("Actions too large for one flash record (%1 of %2 fit)")
+                                       .arg(recordsFitting(index, MAX_PAYLOAD_SIZE - 1))
+                                       .arg(index.size()), 3000);
+        return;
+    }
 
-    // 2) Select message ID depending on whether the user wants a bootable frame
-    const quint8 msgId = ui->flashBootcheckBox->isChecked()
-                             ? MSG_ID_WRITE_FLASH_BOOT
-                             : MSG_ID_WRITE_FLASH;
+    // 3) Timing check; errors only go out if the user confirms
+    QString note;
+    if (!confirmTiming("Write flash", &note)) return;
 
-    // 3) Send framed packet over the serial link; report status to the user
-    if (!sendPacket(msgId, payload)) {
+    // 4) Send framed packet over the serial link; report status to the user
+    if (!sendFrame(frame, &index, /*blob after key*/1)) {
         ui->statusbar->showMessage("Flash write failed", 3000);
         return;
     }
-    ui->statusbar->showMessage("Flash frame sent", 2000);
+    ui->statusbar->showMessage("Flash frame sent: " + note, 5000);
 }
@@ -0,0 +1,121 @@
+#include "../../serialmonitor.h"
+#include "../../ui_serialmonitor.h"
+#include "../../serialtransport.h"
+#include <QFileDialog>
+#include <QInputDialog>
+#include <QSignalBlocker>
+#include <QStandardPaths>
+
+/*
+ * SerialMonitor::on_recButton_toggled
+ * -----------------------------------
+ * REC on : start a session capture on the attached transport (Documents).
+ * REC off: finish it (seek index + trailer) and report the record count.
+ * Without a live transport the button snaps back.
+ */
+void SerialMonitor::on_recButton_toggled(bool on)
+{
+    if (on) {
+        if (!m_link) {
+            const QSignalBlocker block(ui->recButton);
+            ui->recButton->setChecked(false);
+            m_log->appendText("REC: not connected");
+            return;
+        }
+        const QString dir  = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+        const QString path = m_link->startRecording(dir);
+        if (path.isEmpty()) {
+            const QSignalBlocker block(ui->recButton);
+            ui->recButton->setChecked(false);
+            m_log->appendText("REC: capture file could not be created");
+            return;
+        }
+        m_recLink = m_link;
+        m_log->appendText(QString("REC -> %1").arg(path));
+    } else if (m_recLink) {
+        const quint64 n = m_recLink->stopRecording();
+        m_recLink = nullptr;
+        m_log->appendText(QString("REC stopped, %1 records").arg(n));
+    }
+}
+
+/*
+ * SerialMonitor::on_replayButton_clicked
+ * --------------------------------------
+ * Start: choose a *.dtcap and a mode.
+ *   - RX → monitor: recorded device chunks go through ingestRx(), i.e. the
+ *     same rendering/parsing (and CSPI/slot signals) as live traffic. Only
+ *     while disconnected: the parser and those signals belong to the live
+ *     link, and a replayed CSPI credit would pump the real device.
+ *   - TX → device : recorded host frames are re-sent through the transport;
+ *     txSpace() resumes a replay the transport pushed back on.
+ * Click again while running to stop.
+ */
+void SerialMonitor::on_replayButton_clicked()
+{
+    if (m_replayer.isRunning()) {
+        m_replayer.stop();
+        ui->replayButton->setText("PLAY");
+        m_log->appendText("PLAY stopped");
+        return;
+    }
+
+    const QString dir  = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+    const QString path = QFileDialog::getOpenFileName(this, "Replay session capture", dir,
+                                                      "Session capture (*.dtcap)");
+    if (path.isEmpty()) return;
+
+    const QStringList modes = {
+        "RX -> monitor (original timing)",
+        "RX -> monitor (as fast as possible)",
+        "TX -> device (original timing)",
+        "TX -> device (as fast as possible)",
+    };
+    bool ok = false;
+    const QString mode = QInputDialog::getItem(this, "Replay", "Mode:", modes, 0, false, &ok);
+    if (!ok) return;
+
+    const int  m     = int(modes.indexOf(mode));
+    const bool toDev = m >= 2;
+    const double speed = (m % 2 == 0) ? 1.0 : 0.0;
+
+    SessionReplayer::Sink sink;
+    if (toDev) {
+        if (!m_link || !m_link->isOpen()) {
+            m_log->appendText("PLAY: not connected");
+            return;
+        }
+        SerialTransport *link = m_link;
+        sink = [link](const QByteArray &frame) { return link->send(frame); };
+        connect(link, &SerialTransport::txSpace, &m_replayer, &SessionReplayer::resume,
+                Qt::UniqueConnection);
+    } else {
+        if (m_link) {
+            m_log->appendText("PLAY: RX replay needs the link disconnected");
+            return;
+        }
+        m_parser.reset();
+        sink = [this](const QByteArray &chunk) { ingestRx(chunk); return true; };
+    }
+
+    disconnect(&m_replayer, nullptr, this, nullptr);
+    connect(&m_replayer, &SessionReplayer::progress, this, [this](quint64 done, quint64 total) {
+        ui->replayButton->setText(QString("%1%").arg(total ? done * 100 / total : 100));
+    });
+    connect(&m_replayer, &SessionReplayer::finished, this, [this](quint64 n, qint64 lateMaxUs) {
+        ui->replayButton->setText("PLAY");
+        m_log->appendText(QString("PLAY done, %1 records, max lag %2 ms")
+                              .arg(n).arg(lateMaxUs / 1000.0, 0, 'f', 1));
+    });
+
+    const bool started = toDev
+        ? m_replayer.start(path, SessionCapture::Frame, SessionCapture::Tx, speed, sink)
+        : m_replayer.start(path, SessionCapture::Chunk, SessionCapture::Rx, speed, sink);
+    if (!started) {
+        m_log->appendText(QString("PLAY: %1").arg(m_replayer.errorString()));
+        return;
+    }
+    m_replayRx = !toDev;
+    ui->replayButton->setText("0%");
+    m_log->appendText(QString("PLAY %1 (%2)").arg(path, mode));
+}
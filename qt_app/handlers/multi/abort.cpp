@@ -0,0 +1,11 @@
+#include "../../multidevicewindow.h"
+
+/*
+ * MultiDeviceWindow::on_abortButton_clicked
+ * -----------------------------------------
+ * Stop the session; finished() brings the window back to idle.
+ */
+void MultiDeviceWindow::on_abortButton_clicked()
+{
+    m_session.abort();
+}
@@ -0,0 +1,27 @@
+#include "../../multidevicewindow.h"
+#include "../../ui_multidevicewindow.h"
+#include <QSerialPortInfo>
+#include <QSet>
+
+/*
+ * MultiDeviceWindow::on_refreshButton_clicked
+ * -------------------------------------------
+ * Rebuild the checkable port list from QSerialPortInfo; ports that were
+ * checked before stay checked.
+ */
+void MultiDeviceWindow::on_refreshButton_clicked()
+{
+    QSet<QString> checked;
+    for (int i = 0; i < ui->portList->count(); ++i) {
+        const QListWidgetItem *it = ui->portList->item(i);
+        if (it->checkState() == Qt::Checked) checked.insert(it->text());
+    }
+
+    ui->portList->clear();
+    for (const QSerialPortInfo &p : QSerialPortInfo::availablePorts()) {
+        auto *it = new QListWidgetItem(p.portName(), ui->portList);
+        it->setToolTip(p.description());
+        it->setFlags(it->flags() | Qt::ItemIsUserCheckable);
+        it->setCheckState(checked.contains(p.portName()) ? Qt::Checked : Qt::Unchecked);
+    }
+}
@@ -0,0 +1,48 @@
+#include "../../multidevicewindow.h"
+#include "../../ui_multidevicewindow.h"
+#include "../../actionEncoder.h"
+
+/*
+ * MultiDeviceWindow::on_startButton_clicked
+ * -----------------------------------------
+ * Collect the checked ports, fetch the current graph from the owner, let the
+ * owner's timing check confirm it and hand both to MultiSession (upload to
+ * the selected slot, aligned start).
+ * One table row per port is created up front; rows fill in as devices move.
+ */
+void MultiDeviceWindow::on_startButton_clicked()
+{
+    QStringList ports;
+    for (int i = 0; i < ui->portList->count(); ++i) {
+        const QListWidgetItem *it = ui->portList->item(i);
+        if (it->checkState() == Qt::Checked) ports << it->text();
+    }
+    if (ports.isEmpty()) {
+        ui->summaryLabel->setText("Check at least one port");
+        return;
+    }
+
+    const QByteArray blob = m_blobSource ? m_blobSource() : QByteArray();
+    if (blob.isEmpty()) {
+        ui->summaryLabel->setText("No actions to run");
+        return;
+    }
+    if (blob.size() + 1 > MAX_PAYLOAD_SIZE) {
+        ui->summaryLabel->setText("Action set too large for a slot");
+        return;
+    }
+    if (m_sendCheck && !m_sendCheck()) {
+        ui->summaryLabel->setText("Cancelled: timing errors");
+        return;
+    }
+
+    ui->table->clearContents();
+    ui->table->setRowCount(int(ports.size()));
+    if (!m_session.start(ports, ui->spinBox_slot->value(), blob)) {
+        ui->summaryLabel->setText("Session could not be started");
+        return;
+    }
+    for (int i = 0; i < m_session.count(); ++i) updateRow(i);
+    ui->summaryLabel->setText(QString("Uploading to %1 devices...").arg(ports.size()));
+    setRunning(true);
+}
@@ -16,6 +16,20 @@ MainWindow::MainWindow(QWidget *parent)
     refreshPorts();
 
     rebuildList();
+
+    // Streamer worker refilled an empty pool: resume sending against credit
+    connect(&m_cspiStream, &CspiStreamer::framesReady,
+            this, &MainWindow::cspiPump, Qt::QueuedConnection);
+
+    // Transport runs on its own thread; its signals arrive queued
+    connect(&m_link, &SerialTransport::opened,  this, &MainWindow::onLinkOpened);
+    connect(&m_link, &SerialTransport::closed,  this, &MainWindow::onLinkClosed);
+    connect(&m_link, &SerialTransport::txSpace, this, &MainWindow::cspiPump);
+
+    m_linkStats = new QLabel(this);
+    statusBar()->addPermanentWidget(m_linkStats);
+    m_linkTimer = new QTimer(this);
+    connect(m_linkTimer, &QTimer::timeout, this, &MainWindow::refreshLinkStats);
 }
 
 MainWindow::~MainWindow()
@@ -2,13 +2,18 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QSerialPort>
 #include <QSerialPortInfo>
+#include <QLabel>
 #include <QTimer>
 #include <QPointer>
 #include "serialmonitor.h"
 #include "cspiwindow.h"
+#include "multidevicewindow.h"
+#include "cspistreamer.h"
+#include "cspicapture.h"
+#include "serialtransport.h"
 #include "actionset.h"
+#include "actionEncoder.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -19,7 +24,8 @@ QT_END_NAMESPACE
  *------------------------------------------------------------------------------
  * Purpose
  *   - Top-level application window that orchestrates:
- *       * Serial connection lifecycle (open/close, write/read).
+ *       * Serial connection lifecycle (open/close through SerialTransport,
+ *         whose I/O thread owns the port).
  *       * Action graph management (add/edit/remove, listing).
  *       * Packet encoding/dispatch for runtime execution and flash ops.
  *       * CSPI workflow (hosting CSPIWindow and streaming chunks on request).
@@ -70,13 +76,29 @@ private slots:
      */
     void refreshPorts();
     /**
-     * @brief Connect/disconnect toggle handler; opens/closes QSerialPort.
+     * @brief Connect/disconnect toggle handler; opens/closes the transport.
      */
     void on_connButton_clicked();
+    /**
+     * @brief Transport finished opening; update UI and attach the monitor.
+     */
+    void onLinkOpened(bool ok, const QString& error);
+    /**
+     * @brief Transport closed (user disconnect or port lost); reset UI state.
+     */
+    void onLinkClosed(const QString& reason);
+    /**
+     * @brief Refresh the status bar link metrics (delivery, latency, drops).
+     */
+    void refreshLinkStats();
     /**
      * @brief Open or focus the SerialMonitor window (optional live trace).
      */
     void on_serialMonitorButton_clicked();
+    /**
+     * @brief Open or focus the multi-device window (same graph on N ports).
+     */
+    void on_multiButton_clicked();
 
     /*--------------------------- Execute / Flash ----------------------------*/
     /**
@@ -96,21 +118,56 @@ private slots:
      */
     void on_resetButton_clicked();
 
+    /*--------------------------- Resident Slots -----------------------------*/
+    /**
+     * @brief Upload the current action set into the selected device slot.
+     */
+    void on_slotUploadButton_clicked();
+    /**
+     * @brief Run the set resident in the selected slot (header-only frame).
+     */
+    void on_slotRunButton_clicked();
+    /**
+     * @brief Free the selected slot on the device.
+     */
+    void on_slotDropButton_clicked();
+    /**
+     * @brief Ask the device for a summary of all occupied slots.
+     */
+    void on_slotListButton_clicked();
+    /**
+     * @brief Show the slot summary reply decoded by the SerialMonitor.
+     */
+    void onSlotListReceived(const QByteArray& payload);
+
     /*--------------------------- CSPI Workflow ------------------------------*/
     /**
      * @brief Show CSPIWindow; connect its signals to start a CSPI session.
      */
     void on_cSPIButton_clicked();
     /**
-     * @brief Receive the ready-to-send CSPI payload from CSPIWindow (header+TX)
-     *        and forward it to the device (e.g., as MSG_ID_CSPI_BEGIN).
+     * @brief Receive a CSPI session from CSPIWindow: send @header as
+     *        MSG_ID_CSPI_BEGIN and stream @txData against device credit.
      */
-    void onCspiPayloadReady(const QByteArray& payload);
+    void onCspiPayloadReady(const QByteArray& header, const QByteArray& txData);
     /**
-     * @brief Handle device “REQ” (data request) by pushing the next 512-byte
-     *        chunk from m_cspiTxData (cyclic if shorter than 512).
+     * @brief Handle a legacy empty “REQ” (data request) by pushing the next
+     *        pre-framed 512-byte chunk from the streamer pool.
      */
     void onCspiReqReceived();
+    /**
+     * @brief Handle a device credit frame: keep DATA frames in flight until the
+     *        advertised byte limit is reached; surface starvation/underflow counts.
+     */
+    void onCspiCreditReceived(quint32 limit, quint32 starved, quint32 underflows);
+    /**
+     * @brief Append a device RX capture block to the session's binary file.
+     */
+    void onCspiRxBlock(quint16 seq, const QByteArray& data);
+    /**
+     * @brief Forward a device stats frame to the CSPI window's panel (if open).
+     */
+    void onCspiStatsReceived(const QByteArray& payload);
     /**
      * @brief Graceful CSPI stop requested by the UI; forward to device.
      */
@@ -130,40 +187,56 @@ private:
 
     /*--------------------------- Port / Serial ------------------------------*/
     QTimer      *portTimer{nullptr};///< Periodic port refresh timer (owned).
-    QSerialPort serial;             ///< Synchronous serial transport.
+    SerialTransport m_link;         ///< Port owner on its own I/O thread.
     bool        connected{false};   ///< Cached connection state for UI.
+    QLabel      *m_linkStats{nullptr}; ///< Permanent status bar metrics label.
+    QTimer      *m_linkTimer{nullptr}; ///< Metrics refresh while connected.
 
     /*--------------------------- Aux Windows --------------------------------*/
     QPointer<SerialMonitor> monitor;///< Optional live monitor (not owned).
     QPointer<CSPIWindow>    cspiWin;///< Optional CSPI config window (not owned).
+    QPointer<MultiDeviceWindow> multiWin; ///< Optional multi-device runner (not owned).
 
     /*--------------------------- I/O helpers --------------------------------*/
     /**
-     * @brief Write entire buffer with per-chunk timeout; returns success/fail.
-     *        Uses QSerialPort::write + waitForBytesWritten to drain OS buffers.
+     * @brief Format a byte array as spaced uppercase hex (e.g., "AA 55 10 ...").
      */
-    bool writeAllWithTimeout(const QByteArray& data, int perChunkTimeoutMs = 200);
+    static QString hexSpaced(const QByteArray& b);
 
     /**
-     * @brief Read one response frame with initial and tail timeouts.
-     *        Useful for small ACK/status replies (optional).
+     * @brief Frame and queue a protocol packet (SOF + ID + LEN + PAYLOAD + CRC16).
+     *        Never blocks; false if disconnected or the TX queue is full.
+     *        @index/@indexBase describe an actions blob inside @payload (for the monitor).
      */
-    QByteArray readOneResponse(int firstByteTimeoutMs = 300, int tailTimeoutMs = 50);
+    bool sendPacket(quint8 msgId, const QByteArray& payload,
+                    const ActionIndex* index = nullptr, int indexBase = 0);
 
     /**
-     * @brief Format a byte array as spaced uppercase hex (e.g., "AA 55 10 ...").
+     * @brief Queue an already framed packet (e.g. from buildActionsFrame()).
+     *        Same checks, queueing and monitor logging as sendPacket().
      */
-    static QString hexSpaced(const QByteArray& b);
+    bool sendFrame(const QByteArray& frame,
+                   const ActionIndex* index = nullptr, int indexBase = 0);
+
+    /**
+     * @brief Encode current ActionSet into a binary payload suitable for device.
+     *        Fills @index with per-record offset/length/kind from the same pass.
+     */
+    QByteArray buildActionsPayload(ActionIndex* index = nullptr);
 
     /**
-     * @brief Frame and send a protocol packet (SOF + ID + LEN + PAYLOAD + CRC16).
+     * @brief Frame @msgId carrying [@prefix] + the current ActionSet blob,
+     *        encoded in place (no intermediate payload). @prefix < 0: none.
+     *        Empty if there are no actions or they do not fit the wire format.
      */
-    bool sendPacket(quint8 msgId, const QByteArray& payload);
+    QByteArray buildActionsFrame(quint8 msgId, int prefix, ActionIndex* index);
 
     /**
-     * @brief Encode current ActionSet into a binary payload suitable for device.
+     * @brief Static timing check of the current graph (analyzeTiming()) before
+     *        it is sent as @what. Errors ask the user to confirm; warnings only
+     *        go to @note (summary + most severe issue). False: declined.
      */
-    QByteArray buildActionsPayload();
+    bool confirmTiming(const QString& what, QString* note = nullptr);
 
     /**
      * @brief Convenience: build, frame and send the execute-actions packet.
@@ -171,9 +244,25 @@ private:
     void sendActions();
 
     /*--------------------------- CSPI streaming state -----------------------*/
-    QByteArray m_cspiTxData;  ///< Full TX pattern/buffer to stream to device.
-    int        m_cspiPos{0};  ///< Current read pointer within m_cspiTxData.
+    CspiStreamer m_cspiStream;      ///< Worker-built pool of framed DATA packets.
     bool       m_cspiActive{false}; ///< Whether a CSPI session is active.
+    quint32    m_cspiSent{0};       ///< DATA bytes sent since BEGIN (credit accounting).
+    quint32    m_cspiCredit{0};     ///< Latest byte limit advertised by the device.
+    quint32    m_cspiStarved{0};    ///< Last reported device starvation count.
+    quint32    m_cspiUnderflows{0}; ///< Last reported device FIFO underflow count.
+    CspiCapture m_cspiCapture;      ///< Binary RX capture file of the current session.
+
+    /**
+     * @brief Close the RX capture file and report its path / lost block count.
+     */
+    void cspiCloseCapture();
+
+    /**
+     * @brief Send pooled DATA frames while the device credit allows.
+     *        Stops at transport back-pressure; txSpace() resumes it.
+     *        No per-frame monitor logging.
+     */
+    void cspiPump();
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,83 @@
+#include "multidevicewindow.h"
+#include "ui_multidevicewindow.h"
+#include <QHeaderView>
+
+MultiDeviceWindow::MultiDeviceWindow(BlobSource blobSource, SendCheck sendCheck, QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::MultiDeviceWindow)
+    , m_blobSource(std::move(blobSource))
+    , m_sendCheck(std::move(sendCheck))
+{
+    ui->setupUi(this);
+    ui->table->setHorizontalHeaderLabels({"Port", "State", "Ack ms", "Done ms", "Trigger µs", "Detail"});
+    ui->table->horizontalHeader()->setStretchLastSection(true);
+    ui->table->verticalHeader()->setVisible(false);
+
+    connect(&m_session, &MultiSession::deviceChanged, this, &MultiDeviceWindow::updateRow);
+    connect(&m_session, &MultiSession::finished, this, &MultiDeviceWindow::onFinished);
+
+    setRunning(false);
+    on_refreshButton_clicked();
+}
+
+MultiDeviceWindow::~MultiDeviceWindow()
+{
+    delete ui;
+}
+
+void MultiDeviceWindow::setRunning(bool running)
+{
+    ui->startButton->setEnabled(!running);
+    ui->abortButton->setEnabled(running);
+    ui->refreshButton->setEnabled(!running);
+    ui->portList->setEnabled(!running);
+    ui->spinBox_slot->setEnabled(!running);
+}
+
+/* Both skews in µs; "-" until at least two devices reported. */
+QString MultiDeviceWindow::skewText() const
+{
+    auto fmt = [](qint64 us) { return us < 0 ? QString("-") : QString::number(us); };
+    return QString("start skew: trigger %1 µs, ack %2 µs")
+        .arg(fmt(m_session.wireSkewUs()), fmt(m_session.ackSkewUs()));
+}
+
+/*
+ * Latencies are relative to the earliest trigger delivery of the session,
+ * so rows are directly comparable with each other.
+ */
+void MultiDeviceWindow::updateRow(int index)
+{
+    const MultiSession::Device &d = m_session.device(index);
+
+    qint64 t0 = -1;
+    for (int i = 0; i < m_session.count(); ++i) {
+        const qint64 w = m_session.device(i).tWireUs;
+        if (w >= 0 && (t0 < 0 || w < t0)) t0 = w;
+    }
+    auto rel = [t0](qint64 t) {
+        return (t < 0 || t0 < 0) ? QString("-") : QString::number((t - t0) / 1000.0, 'f', 2);
+    };
+
+    const QStringList cells = {
+        d.port,
+        MultiSession::stateName(d.state),
+        rel(d.tAckUs),
+        rel(d.tDoneUs),
+        (d.tWireUs < 0 || t0 < 0) ? QString("-") : QString::number(d.tWireUs - t0),
+        d.detail,
+    };
+    for (int c = 0; c < cells.size(); ++c) {
+        QTableWidgetItem *item = ui->table->item(index, c);
+        if (!item) ui->table->setItem(index, c, item = new QTableWidgetItem);
+        item->setText(cells[c]);
+    }
+    ui->summaryLabel->setText(skewText());
+}
+
+void MultiDeviceWindow::onFinished(int passed, int failed)
+{
+    for (int i = 0; i < m_session.count(); ++i) updateRow(i);
+    ui->summaryLabel->setText(QString("%1 passed, %2 failed | %3").arg(passed).arg(failed).arg(skewText()));
+    setRunning(false);
+}
@@ -0,0 +1,82 @@
+#ifndef MULTIDEVICEWINDOW_H
+#define MULTIDEVICEWINDOW_H
+
+#include <QWidget>
+#include <functional>
+#include "multisession.h"
+
+namespace Ui {
+class MultiDeviceWindow;
+}
+
+/*------------------------------------------------------------------------------
+ * MultiDeviceWindow
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - Picks a set of serial ports and runs the editor's current action graph
+ *     on all of them through a MultiSession (one transport per port).
+ *   - One table row per device: state, ack/done latency after the common
+ *     start, trigger delivery offset and the last status/failure line.
+ *   - Summary line with pass/fail counts and the measured start skew.
+ *
+ * Notes
+ *   - The graph is fetched from the owner when Start is pressed, so the
+ *     window always runs what the editor currently shows; the owner's
+ *     timing check runs first and may cancel the start.
+ *   - A port already opened by the main window cannot be opened here; that
+ *     device simply fails with the port error.
+ *----------------------------------------------------------------------------*/
+class MultiDeviceWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    using BlobSource = std::function<QByteArray()>;
+    using SendCheck  = std::function<bool()>;
+
+    /**
+     * @brief @blobSource returns the encoded actions blob to upload.
+     *        @sendCheck runs before each session (timing check of the same
+     *        graph); false cancels the start.
+     */
+    explicit MultiDeviceWindow(BlobSource blobSource, SendCheck sendCheck = {},
+                               QWidget *parent = nullptr);
+    ~MultiDeviceWindow();
+
+private slots:
+    /**
+     * @brief Re-list available serial ports, keeping existing check marks.
+     */
+    void on_refreshButton_clicked();
+
+    /**
+     * @brief Start a session on the checked ports with the selected slot.
+     */
+    void on_startButton_clicked();
+
+    /**
+     * @brief Abort the running session (unfinished devices fail).
+     */
+    void on_abortButton_clicked();
+
+    /**
+     * @brief Refresh the table row of device @index.
+     */
+    void updateRow(int index);
+
+    /**
+     * @brief Session over: summary line, buttons back to idle.
+     */
+    void onFinished(int passed, int failed);
+
+private:
+    void setRunning(bool running);
+    QString skewText() const;
+
+    Ui::MultiDeviceWindow *ui;
+    BlobSource   m_blobSource;
+    SendCheck    m_sendCheck;
+    MultiSession m_session;
+};
+
+#endif // MULTIDEVICEWINDOW_H
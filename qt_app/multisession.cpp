@@ -0,0 +1,270 @@
+#include "multisession.h"
+#include "actionEncoder.h"
+#include "framewriter.h"
+#include <algorithm>
+
+MultiSession::MultiSession(QObject *parent)
+    : QObject(parent)
+{
+    m_tick.setTimerType(Qt::PreciseTimer);
+    connect(&m_tick, &QTimer::timeout, this, &MultiSession::tick);
+}
+
+MultiSession::~MultiSession()
+{
+    m_tick.stop();
+    m_dev.clear();                       // transports close their ports and join
+}
+
+QString MultiSession::stateName(State s)
+{
+    switch (s) {
+    case State::Opening:   return "opening";
+    case State::Uploading: return "uploading";
+    case State::Arming:    return "arming";
+    case State::Armed:     return "armed";
+    case State::Started:   return "started";
+    case State::Running:   return "running";
+    case State::Done:      return "done";
+    case State::Failed:    return "FAILED";
+    }
+    return QString();
+}
+
+/*
+ * Connections carry the device index and the session generation, so a
+ * signal still queued from a previous session's transport is ignored.
+ */
+bool MultiSession::start(const QStringList &ports, int slot, const QByteArray &blob,
+                         int runTimeoutMs, qint32 baud)
+{
+    if (m_running || ports.isEmpty() || blob.isEmpty() || blob.size() + 1 > MAX_PAYLOAD_SIZE)
+        return false;
+
+    m_dev.clear();
+    FrameWriter up(MSG_ID_SLOT_UPLOAD, 1 + blob.size());
+    up.put(quint8(slot));
+    up.append(blob);
+    m_upload       = up.finish();
+    m_exec         = buildPacket(MSG_ID_SLOT_EXECUTE, QByteArray(1, char(slot)));
+    m_runTimeoutMs = runTimeoutMs;
+    m_fired        = false;
+    m_running      = true;
+    const int gen  = ++m_gen;
+
+    for (int i = 0; i < ports.size(); ++i) {
+        auto d = std::make_unique<Device>();
+        d->port     = ports[i];
+        d->tPhaseUs = SerialTransport::nowUs();
+        d->link     = std::make_unique<SerialTransport>();
+
+        SerialTransport *link = d->link.get();
+        connect(link, &SerialTransport::opened, this, [this, i, gen](bool ok, const QString &e) {
+            if (gen == m_gen) onOpened(i, ok, e);
+        });
+        connect(link, &SerialTransport::rxReady, this, [this, i, gen] {
+            if (gen == m_gen) onRx(i);
+        });
+        connect(link, &SerialTransport::closed, this, [this, i, gen](const QString &reason) {
+            if (gen != m_gen || reason.isEmpty()) return;   // m_dev may be a later session's
+            const State s = m_dev[size_t(i)]->state;
+            if (s != State::Done && s != State::Failed)
+                fail(i, reason);
+        });
+
+        m_dev.push_back(std::move(d));
+        link->open(ports[i], baud);
+    }
+
+    m_tick.start(kTickMs);
+    return true;
+}
+
+void MultiSession::abort()
+{
+    if (!m_running) return;
+    for (int i = 0; i < count(); ++i) {
+        const State s = m_dev[size_t(i)]->state;
+        if (s != State::Done && s != State::Failed) fail(i, "aborted");
+    }
+    finish();
+}
+
+void MultiSession::setState(int i, State s, const QString &detail)
+{
+    Device &d = *m_dev[size_t(i)];
+    d.state    = s;
+    d.detail   = detail;
+    d.tPhaseUs = SerialTransport::nowUs();
+    emit deviceChanged(i);
+}
+
+void MultiSession::onOpened(int i, bool ok, const QString &error)
+{
+    Device &d = *m_dev[size_t(i)];
+    if (d.state != State::Opening) return;
+    if (!ok) { fail(i, error); return; }
+
+    if (d.link->send(m_upload)) setState(i, State::Uploading);
+    else                        fail(i, "upload refused by transport");
+}
+
+/* Per-device line assembly; the read timestamp of the chunk dates its lines. */
+void MultiSession::onRx(int i)
+{
+    Device &d = *m_dev[size_t(i)];
+    QByteArray chunk;
+    qint64 t = 0;
+    while (d.link && d.link->takeRx(chunk, &t)) {
+        d.lineBuf += chunk;
+        qsizetype nl;
+        while ((nl = d.lineBuf.indexOf('\n')) >= 0) {
+            const QByteArray line = d.lineBuf.left(nl).trimmed();
+            d.lineBuf.remove(0, nl + 1);
+            if (!line.isEmpty()) onLine(i, line, t);
+        }
+        if (d.lineBuf.size() > kMaxLine) d.lineBuf.clear();
+    }
+}
+
+void MultiSession::onLine(int i, const QByteArray &line, qint64 tUs)
+{
+    Device &d = *m_dev[size_t(i)];
+    switch (d.state) {
+    case State::Uploading:
+        if (line.startsWith("Slot stored")) {
+            // Everything but the last CRC byte: the device parser holds the frame
+            if (d.link->send(m_exec.left(m_exec.size() - 1))) setState(i, State::Arming, QString::fromLatin1(line));
+            else                                               fail(i, "arm refused by transport");
+        } else if (line.startsWith("Slot store error") || line.startsWith("Parse error")) {
+            fail(i, QString::fromLatin1(line));
+        }
+        break;
+
+    case State::Started:
+    case State::Running:
+        if (line.startsWith("Executing")) {
+            d.tAckUs = tUs;
+            setState(i, State::Running);
+        } else if (line.startsWith("Execution Error")) {
+            d.execError = true;
+        } else if (line.startsWith("Execution completed")) {
+            d.tDoneUs = tUs;
+            if (d.execError) fail(i, "Execution Error!!");
+            else             setState(i, State::Done, "completed");
+        } else if (line.startsWith("Slot empty")) {
+            fail(i, QString::fromLatin1(line));
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/*
+ * Trigger bytes are queued in one tight loop before any state/UI update so
+ * nothing but the queue pushes sits between the first and the last device.
+ */
+void MultiSession::fire()
+{
+    m_fired = true;
+    const QByteArray last = m_exec.right(1);
+
+    std::vector<int> armed;
+    for (int i = 0; i < count(); ++i)
+        if (m_dev[size_t(i)]->state == State::Armed) armed.push_back(i);
+
+    std::vector<char> sent(armed.size(), 0);
+    for (size_t k = 0; k < armed.size(); ++k) {
+        Device &d = *m_dev[size_t(armed[k])];
+        d.tFireUs = SerialTransport::nowUs();
+        sent[k]   = d.link->send(last);
+    }
+    for (size_t k = 0; k < armed.size(); ++k) {
+        if (sent[k]) setState(armed[k], State::Started);
+        else         fail(armed[k], "trigger refused by transport");
+    }
+}
+
+/*
+ * Delivery polling, timeouts and the start barrier. Delivered frame counts:
+ * upload = 1, armed prefix = 2, trigger byte = 3.
+ */
+void MultiSession::tick()
+{
+    const qint64 now = SerialTransport::nowUs();
+    bool settled = true, anyArmed = false, allFinal = true;
+
+    for (int i = 0; i < count(); ++i) {
+        Device &d = *m_dev[size_t(i)];
+        const qint64 ageMs = (now - d.tPhaseUs) / 1000;
+
+        switch (d.state) {
+        case State::Opening:
+        case State::Uploading:
+            if (ageMs > kPhaseTimeoutMs) fail(i, QString("timeout while %1").arg(stateName(d.state)));
+            break;
+        case State::Arming: {
+            const SerialTransport::Metrics m = d.link->metrics();
+            if (m.txBacklog == 0 && m.txFrames >= 2) setState(i, State::Armed);
+            else if (ageMs > kPhaseTimeoutMs)        fail(i, "timeout while arming");
+            break;
+        }
+        case State::Started:
+        case State::Running:
+            if (d.tWireUs < 0) {
+                const SerialTransport::Metrics m = d.link->metrics();
+                if (m.txBacklog == 0 && m.txFrames >= 3) {
+                    d.tWireUs = m.txDoneAtUs;
+                    emit deviceChanged(i);
+                }
+            }
+            if ((now - d.tFireUs) / 1000 > m_runTimeoutMs) fail(i, "run timeout");
+            break;
+        default:
+            break;
+        }
+
+        const State s = d.state;
+        anyArmed |= (s == State::Armed);
+        settled  &= (s == State::Armed || s == State::Failed || s >= State::Started);
+        allFinal &= (s == State::Done || s == State::Failed);
+    }
+
+    if (!m_fired && settled && anyArmed) fire();
+    else if (allFinal) finish();
+}
+
+void MultiSession::finish()
+{
+    m_tick.stop();
+
+    int passed = 0, failed = 0;
+    for (auto &d : m_dev) {
+        (d->state == State::Done ? passed : failed)++;
+        d->link.reset();                 // close + join; timing data stays
+    }
+    m_running = false;
+    emit finished(passed, failed);
+}
+
+namespace {
+qint64 spread(const std::vector<std::unique_ptr<MultiSession::Device>> &devs,
+              qint64 MultiSession::Device::*t)
+{
+    qint64 lo = 0, hi = 0;
+    int n = 0;
+    for (const auto &d : devs) {
+        const qint64 v = (*d).*t;
+        if (v < 0) continue;
+        lo = n ? std::min(lo, v) : v;
+        hi = n ? std::max(hi, v) : v;
+        n++;
+    }
+    return n >= 2 ? hi - lo : -1;
+}
+} // namespace
+
+qint64 MultiSession::wireSkewUs() const { return spread(m_dev, &Device::tWireUs); }
+qint64 MultiSession::ackSkewUs()  const { return spread(m_dev, &Device::tAckUs); }
@@ -0,0 +1,123 @@
+#ifndef MULTISESSION_H
+#define MULTISESSION_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QStringList>
+#include <QTimer>
+#include <memory>
+#include <vector>
+#include "serialtransport.h"
+
+/*------------------------------------------------------------------------------
+ * MultiSession
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - Runs one action graph on N devices at once. Every port gets its own
+ *     SerialTransport (own I/O thread) and its own line-assembly state, so a
+ *     slow or dead port only ever delays itself.
+ *
+ * Sequence (per device, all asynchronous)
+ *   Opening   → port opened, MSG_ID_SLOT_UPLOAD [slot][blob] queued
+ *   Uploading → "Slot stored" received; the MSG_ID_SLOT_EXECUTE frame is
+ *               written WITHOUT its last CRC byte (the device parser waits)
+ *   Arming    → that prefix has left the host (backlog 0)
+ *   Armed     ── barrier: once every device is Armed or Failed, the last
+ *               byte goes to all Armed devices back to back ("fire")
+ *   Started   → "Executing..."  → Running → "Execution completed" → Done
+ *   Anything else final ("Slot store error", "Slot empty", "Execution
+ *   Error!!", timeout, port lost) → Failed with the reason.
+ *
+ * Alignment
+ *   - Because only one byte per device is outstanding at the barrier, start
+ *     skew is bounded by the fire loop plus one byte time on the wire
+ *     (~87 µs at 115200), not by whole-frame or upload time.
+ *   - Measured two ways (SerialTransport::nowUs() clock):
+ *       wire skew: spread of the trigger byte's delivery to the drivers;
+ *       ack skew : spread of the "Executing..." read times (device + USB
+ *                  latency included, an upper bound).
+ *
+ * Timeouts
+ *   - kPhaseTimeoutMs per setup phase; the run itself gets runTimeoutMs.
+ *     A device that times out is failed alone; the barrier then releases
+ *     the others.
+ *
+ * Threading
+ *   - GUI thread; transports do the port I/O on their own threads.
+ *----------------------------------------------------------------------------*/
+class MultiSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class State { Opening, Uploading, Arming, Armed, Started, Running, Done, Failed };
+
+    struct Device {
+        QString  port;
+        State    state{State::Opening};
+        QString  detail;              ///< Failure reason / last status line.
+        qint64   tPhaseUs{0};         ///< Entry into the current state.
+        qint64   tFireUs{0};          ///< Trigger byte queued.
+        qint64   tWireUs{-1};         ///< Trigger byte delivered to the driver.
+        qint64   tAckUs{-1};          ///< "Executing..." read.
+        qint64   tDoneUs{-1};         ///< Final line read.
+        bool     execError{false};
+        QByteArray lineBuf;           ///< Partial status line.
+        std::unique_ptr<SerialTransport> link;
+    };
+
+    static constexpr int kPhaseTimeoutMs = 3000;  ///< Open / upload / arm, each.
+    static constexpr int kTickMs         = 1;     ///< Barrier + delivery polling.
+    static constexpr int kMaxLine        = 4096;  ///< Runaway line guard.
+
+    explicit MultiSession(QObject *parent = nullptr);
+    ~MultiSession();
+
+    /**
+     * @brief Open @ports, upload @blob to @slot on each, then start them together.
+     * @return false if already running, no ports or the blob does not fit a slot.
+     */
+    bool start(const QStringList &ports, int slot, const QByteArray &blob,
+               int runTimeoutMs = 30000, qint32 baud = 115200);
+
+    /**
+     * @brief Fail every unfinished device and close all ports.
+     */
+    void abort();
+
+    bool isRunning() const { return m_running; }
+    int  count() const { return int(m_dev.size()); }
+    const Device &device(int i) const { return *m_dev[size_t(i)]; }
+    static QString stateName(State s);
+
+    qint64 wireSkewUs() const;        ///< -1 until two devices have a delivery time.
+    qint64 ackSkewUs() const;         ///< -1 until two devices acknowledged.
+
+signals:
+    /** Device @index changed state or timing. */
+    void deviceChanged(int index);
+
+    /** Every device is Done or Failed; ports are closed. */
+    void finished(int passed, int failed);
+
+private:
+    void onOpened(int i, bool ok, const QString &error);
+    void onRx(int i);
+    void onLine(int i, const QByteArray &line, qint64 tUs);
+    void tick();
+    void fire();
+    void setState(int i, State s, const QString &detail = QString());
+    void fail(int i, const QString &why) { setState(i, State::Failed, why); }
+    void finish();
+
+    std::vector<std::unique_ptr<Device>> m_dev;
+    QTimer     m_tick;
+    QByteArray m_upload;              ///< Framed MSG_ID_SLOT_UPLOAD.
+    QByteArray m_exec;                ///< Framed MSG_ID_SLOT_EXECUTE.
+    int        m_runTimeoutMs{0};
+    bool       m_running{false};
+    bool       m_fired{false};
+    int        m_gen{0};              ///< Session generation (stale queued signals).
+};
+
+#endif // MULTISESSION_H
@@ -0,0 +1,103 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../firmware/source/proto/proto_schema.h"
+
+/*------------------------------------------------------------------------------
+ * Device protocol (host side)
+ *------------------------------------------------------------------------------
+ * C++ expansion of firmware/source/proto/proto_schema.h, the single source of
+ * the wire protocol; the firmware expands the same lists in proto/proto.h.
+ *
+ *   - Constants (SOF0, MAX_PAYLOAD, MAX_SLOTS, ...) and MSG_ID_* as
+ *     `constexpr int`, so they mix with sizes and QString::arg() unchanged.
+ *   - TYPE_* / LVL_* as `constexpr std::uint8_t` (they are written as bytes).
+ *   - One aggregate per record in namespace proto (Delay, CspiStats, ...)
+ *     with its wire size as `kSize`, plus constexpr encode()/decode()
+ *     overloads that do straight-line big-endian stores/loads.
+ *
+ * encode()/decode() never check bounds: the caller provides kSize bytes,
+ * which is a compile-time constant. Both return the end of the record.
+ *----------------------------------------------------------------------------*/
+
+#define PROTO_CPP_CONST(name, value)    inline constexpr int name = (value);
+#define PROTO_CPP_MSG(name, value)      inline constexpr int MSG_ID_##name = (value);
+#define PROTO_CPP_TYPE(name, value)     inline constexpr std::uint8_t TYPE_##name = (value);
+#define PROTO_CPP_LVL(name, value)      inline constexpr std::uint8_t LVL_##name = (value);
+
+PROTO_CONSTANTS(PROTO_CPP_CONST)
+PROTO_MESSAGES(PROTO_CPP_MSG)
+PROTO_ACTION_TYPES(PROTO_CPP_TYPE)
+PROTO_LEVELS(PROTO_CPP_LVL)
+
+namespace proto {
+
+using u8  = std::uint8_t;
+using u16 = std::uint16_t;
+using u32 = std::uint32_t;
+
+namespace detail {
+
+constexpr u8* put(u8* p, u8 v) noexcept { p[0] = v; return p + 1; }
+
+constexpr u8* put(u8* p, u16 v) noexcept
+{
+    p[0] = u8(v >> 8); p[1] = u8(v);
+    return p + 2;
+}
+
+constexpr u8* put(u8* p, u32 v) noexcept
+{
+    p[0] = u8(v >> 24); p[1] = u8(v >> 16); p[2] = u8(v >> 8); p[3] = u8(v);
+    return p + 4;
+}
+
+constexpr const u8* get(const u8* p, u8& v) noexcept { v = p[0]; return p + 1; }
+
+constexpr const u8* get(const u8* p, u16& v) noexcept
+{
+    v = u16((u16(p[0]) << 8) | p[1]);
+    return p + 2;
+}
+
+constexpr const u8* get(const u8* p, u32& v) noexcept
+{
+    v = (u32(p[0]) << 24) | (u32(p[1]) << 16) | (u32(p[2]) << 8) | u32(p[3]);
+    return p + 4;
+}
+
+} // namespace detail
+
+#define PROTO_CPP_MEMBER(t, n)  t n{};
+#define PROTO_CPP_SIZE(t, n)    + sizeof(t)
+#define PROTO_CPP_PUT(t, n)     p = detail::put(p, r.n);
+#define PROTO_CPP_GET(t, n)     p = detail::get(p, r.n);
+
+#define PROTO_CPP_RECORD(lc, UC, Cpp, FIELDS, WIRE)                                 \
+    struct Cpp {                                                                    \
+        FIELDS(PROTO_CPP_MEMBER)                                                    \
+        static constexpr std::size_t kSize = 0 FIELDS(PROTO_CPP_SIZE);              \
+    };                                                                              \
+    static_assert(Cpp::kSize == (WIRE), "proto_schema.h: " #lc " wire size");       \
+    constexpr u8* encode(u8* p, const Cpp& r) noexcept { FIELDS(PROTO_CPP_PUT) return p; } \
+    constexpr const u8* decode(const u8* p, Cpp& r) noexcept { FIELDS(PROTO_CPP_GET) return p; }
+
+PROTO_RECORDS(PROTO_CPP_RECORD)
+
+/**
+ * @brief Decode one record of type @R from @p (kSize bytes must be readable).
+ */
+template <class R>
+constexpr R read(const u8* p) noexcept
+{
+    R r{};
+    decode(p, r);
+    return r;
+}
+
+} // namespace proto
+
+#endif // PROTOCOL_H
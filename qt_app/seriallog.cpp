@@ -0,0 +1,151 @@
+#include "seriallog.h"
+#include <QApplication>
+#include <QDateTime>
+#include <QPainter>
+#include <QTextDocument>
+#include <algorithm>
+
+SerialLogModel::SerialLogModel(QObject *parent, int capacity)
+    : QAbstractListModel(parent)
+    , m_cap(std::max(capacity, 1))
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(kFlushMs);
+    connect(&m_timer, &QTimer::timeout, this, &SerialLogModel::flush);
+}
+
+void SerialLogModel::enqueue(Kind kind, const QByteArray &bytes, const QString &text)
+{
+    Entry e;
+    e.ms    = QDateTime::currentMSecsSinceEpoch();
+    e.kind  = kind;
+    e.bytes = bytes;
+    e.text  = text;
+    m_pending.push_back(std::move(e));
+
+    // A burst larger than the ring only needs its tail
+    if (int(m_pending.size()) > 2 * m_cap)
+        m_pending.erase(m_pending.begin(), m_pending.end() - m_cap);
+
+    if (!m_timer.isActive()) m_timer.start();
+}
+
+/*
+ * Apply the queue: first drop the rows the ring is about to overwrite, then
+ * insert all new rows in one go.
+ */
+void SerialLogModel::flush()
+{
+    if (m_pending.empty()) return;
+
+    auto   src = m_pending.begin();
+    size_t n   = m_pending.size();
+    if (n > size_t(m_cap)) { src += std::ptrdiff_t(n - size_t(m_cap)); n = size_t(m_cap); }
+
+    const int overflow = std::max(0, m_count + int(n) - m_cap);
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        m_first  = (m_first + overflow) % m_cap;
+        m_count -= overflow;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_count, m_count + int(n) - 1);
+    for (; src != m_pending.end(); ++src) {
+        const size_t idx = size_t((m_first + m_count) % m_cap);
+        if (idx == m_ring.size()) m_ring.push_back(std::move(*src));
+        else                      m_ring[idx] = std::move(*src);
+        ++m_count;
+    }
+    endInsertRows();
+
+    m_pending.clear();
+    emit flushed();
+}
+
+void SerialLogModel::clear()
+{
+    beginResetModel();
+    m_ring.clear();
+    m_ring.shrink_to_fit();
+    m_pending.clear();
+    m_first = m_count = 0;
+    endResetModel();
+}
+
+void SerialLogModel::setTimestamps(bool on)
+{
+    if (on == m_timestamps) return;
+    m_timestamps = on;
+    if (m_count > 0) emit dataChanged(index(0), index(m_count - 1), {Qt::DisplayRole});
+}
+
+int SerialLogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+/*
+ * Text is produced on demand, so only rows the view paints (or copies) pay
+ * for hex formatting / UTF-8 decoding.
+ */
+QVariant SerialLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_count) return {};
+    const Entry &e = at(index.row());
+
+    if (role == IsHtmlRole) return e.kind == Html;
+    if (role != Qt::DisplayRole) return {};
+
+    QString line;
+    if (m_timestamps)
+        line = QDateTime::fromMSecsSinceEpoch(e.ms).toString("[HH:mm:ss.zzz] ");
+
+    switch (e.kind) {
+    case Hex:   line += QString::fromLatin1(e.bytes.toHex(' ').toUpper()); break;
+    case Ascii: line += QString::fromUtf8(e.bytes);                         break;
+    case Html:
+    case Text:  line += e.text;                                             break;
+    }
+    return line;
+}
+
+/* ----------------------------- Delegate ------------------------------ */
+
+void SerialLogDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                              const QModelIndex &index) const
+{
+    if (!index.data(SerialLogModel::IsHtmlRole).toBool()) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    QStyleOptionViewItem opt(option);
+    initStyleOption(&opt, index);
+    const QString html = opt.text;
+    opt.text.clear();
+
+    // Background / selection from the style, then the rich text on top
+    QStyle *style = opt.widget ? opt.widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, opt.widget);
+
+    QTextDocument doc;
+    doc.setDocumentMargin(0);
+    doc.setDefaultFont(opt.font);
+    doc.setHtml(html);
+
+    const QRect r = style->subElementRect(QStyle::SE_ItemViewItemText, &opt, opt.widget);
+    painter->save();
+    painter->translate(r.topLeft());
+    painter->setClipRect(r.translated(-r.topLeft()));
+    doc.drawContents(painter);
+    painter->restore();
+}
+
+QSize SerialLogDelegate::sizeHint(const QStyleOptionViewItem &option,
+                                  const QModelIndex &index) const
+{
+    QSize s = QStyledItemDelegate::sizeHint(option, index);
+    s.setHeight(option.fontMetrics.height() + 2);
+    return s;
+}
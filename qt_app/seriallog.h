@@ -0,0 +1,107 @@
+#ifndef SERIALLOG_H
+#define SERIALLOG_H
+
+#include <QAbstractListModel>
+#include <QStyledItemDelegate>
+#include <QByteArray>
+#include <QString>
+#include <QTimer>
+#include <vector>
+
+/*------------------------------------------------------------------------------
+ * SerialLogModel
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - Backing store of the SerialMonitor log: a fixed-capacity ring of
+ *     structured entries shown through a QListView.
+ *
+ * Memory
+ *   - At most `capacity` entries are kept; the oldest are dropped first.
+ *   - RX entries keep the raw bytes; their text (hex dump or decoded line,
+ *     optional timestamp) is built in data() for visible rows only.
+ *   - TX entries keep the plain/HTML line built by logTx().
+ *
+ * Update cadence
+ *   - append*() only queues; a frame timer (kFlushMs) applies the queue as
+ *     one row removal (ring overflow) plus one row insertion, so the view
+ *     relayouts at most once per frame regardless of the incoming rate.
+ *----------------------------------------------------------------------------*/
+class SerialLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Kind : quint8 { Text, Html, Hex, Ascii };
+
+    static constexpr int kCapacity = 1 << 21;   ///< ~2M entries by default.
+    static constexpr int kFlushMs  = 16;        ///< ~60 fps batch interval.
+    static constexpr int IsHtmlRole = Qt::UserRole + 1;
+
+    explicit SerialLogModel(QObject *parent = nullptr, int capacity = kCapacity);
+
+    void appendText (const QString &line)    { enqueue(Text,  {}, line); }
+    void appendHtml (const QString &html)    { enqueue(Html,  {}, html); }
+    void appendHex  (const QByteArray &data) { enqueue(Hex,   data, {}); }
+    void appendAscii(const QByteArray &line) { enqueue(Ascii, line, {}); }
+
+    /**
+     * @brief Drop all entries (queued ones included).
+     */
+    void clear();
+
+    /**
+     * @brief Show or hide the per-entry "[HH:mm:ss.zzz] " prefix.
+     */
+    void setTimestamps(bool on);
+
+    int      rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+
+signals:
+    /**
+     * @brief Queued entries became rows (view may follow the tail).
+     */
+    void flushed();
+
+private:
+    struct Entry {
+        qint64     ms{0};       ///< Arrival time (ms since epoch).
+        Kind       kind{Text};
+        QByteArray bytes;       ///< Hex / Ascii: raw payload.
+        QString    text;        ///< Text / Html: preformatted line.
+    };
+
+    void enqueue(Kind kind, const QByteArray &bytes, const QString &text);
+    void flush();
+    const Entry &at(int row) const { return m_ring[size_t((m_first + row) % m_cap)]; }
+
+    std::vector<Entry> m_ring;       ///< Grows to m_cap, then wraps.
+    int                m_cap;
+    int                m_first{0};   ///< Ring index of row 0.
+    int                m_count{0};   ///< Rows currently visible to the view.
+    std::vector<Entry> m_pending;    ///< Entries waiting for the next flush.
+    QTimer             m_timer;
+    bool               m_timestamps{true};
+};
+
+/*------------------------------------------------------------------------------
+ * SerialLogDelegate
+ *------------------------------------------------------------------------------
+ * Paints Html rows (colored TX frames) through a QTextDocument; everything
+ * else uses the default text path. Row height is one text line so the view
+ * can run with uniformItemSizes.
+ *----------------------------------------------------------------------------*/
+class SerialLogDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    void  paint(QPainter *painter, const QStyleOptionViewItem &option,
+                const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option,
+                   const QModelIndex &index) const override;
+};
+
+#endif // SERIALLOG_H
@@ -1,7 +1,9 @@
 #include "serialmonitor.h"
 #include "ui_serialmonitor.h"
 #include "actionEncoder.h"
-#include <QDateTime>
+#include "serialtransport.h"
+#include <QScrollBar>
+#include <cstring>
 
 /*
  * SerialMonitor
@@ -9,19 +11,24 @@
  * Lightweight serial terminal widget with optional protocol awareness.
  *
  * Responsibilities:
- *  - Attach/detach a QSerialPort and stream incoming bytes into the UI.
+ *  - Attach/detach a SerialTransport and stream incoming bytes into the UI.
  *  - Render either hex-dumped frames or printable ASCII lines with timestamps.
  *  - Incrementally parse custom UART protocol frames (AA 55 ... CRC16).
- *  - Emit cspiReqReceived() when a valid MSG_ID_CSPI_REQ (len=0) is observed.
+ *  - Emit cspiCreditReceived() for MSG_ID_CSPI_REQ credit frames
+ *    (cspiReqReceived() for legacy empty requests).
+ *  - Emit cspiRxBlock() for MSG_ID_CSPI_RX capture blocks.
+ *  - Emit cspiStatsReceived() for MSG_ID_CSPI_STATS counter frames.
  *
  * Rendering:
  *  - Hex view: single line per incoming chunk (uppercase hex, spaced).
  *  - ASCII view: line-buffered; appends only complete lines terminated by '\n'.
+ *  - Lines go to SerialLogModel (fixed-capacity ring, batched per frame);
+ *    text/timestamps are formatted only for rows the view actually paints.
  *
  * Protocol parsing:
- *  - A simple re-sync strategy: search for 0xAA 0x55, verify minimum size,
- *    extract msg/len, wait for full frame, validate CRC16-CCITT, consume
- *    the frame or drop noise and continue.
+ *  - FrameParser: search for 0xAA 0x55 from a read offset, verify minimum
+ *    size, extract msg/len, wait for full frame, validate CRC16-CCITT,
+ *    consume the frame or skip the SOF and continue (no front erases).
  */
 
 SerialMonitor::SerialMonitor(QWidget *parent)
@@ -30,6 +37,21 @@ SerialMonitor::SerialMonitor(QWidget *parent)
 {
     ui->setupUi(this);
 
+    // Bounded, lazily rendered log; the view only paints visible rows
+    m_log = new SerialLogModel(this);
+    m_log->setTimestamps(m_timestamp);
+    ui->logView->setModel(m_log);
+    ui->logView->setItemDelegate(new SerialLogDelegate(ui->logView));
+
+    // Follow the tail only if the user has not scrolled up
+    connect(m_log, &QAbstractItemModel::rowsAboutToBeInserted, this, [this] {
+        const QScrollBar *vbar = ui->logView->verticalScrollBar();
+        m_followTail = !vbar || vbar->value() >= vbar->maximum();
+    });
+    connect(m_log, &SerialLogModel::flushed, this, [this] {
+        if (m_followTail) ui->logView->scrollToBottom();
+    });
+
     // Toggle between Hex and ASCII render modes.
     connect(ui->checkBoxHex, &QCheckBox::toggled,
             this, &SerialMonitor::onHexToggled);
@@ -41,36 +63,46 @@ SerialMonitor::SerialMonitor(QWidget *parent)
 
 SerialMonitor::~SerialMonitor()
 {
-    detachPort();
+    m_replayer.stop();
+    if (m_recLink) m_recLink->stopRecording();
+    detachTransport();
     delete ui;
 }
 
 /**
- * Attach a serial port to the monitor.
- * - Clears any pending bytes in the port input buffer.
- * - Connects readyRead() to our handler for incremental consumption.
+ * Attach the transport to the monitor.
+ * - Stops an RX replay: it shares m_parser and the CSPI/slot signals with
+ *   live traffic and would drive MainWindow against the real device.
+ * - Drops RX queued before the attach (avoid mixing a previous session).
+ * - Connects rxReady() to our handler for incremental consumption.
  */
-void SerialMonitor::attachPort(QSerialPort *port) {
-    if (m_port == port) return;
-    detachPort();
-    m_port = port;
-    if (m_port) {
-        m_port->readAll(); // drop stale data to avoid mixing previous session
-
-        m_conn = connect(m_port, &QSerialPort::readyRead,
+void SerialMonitor::attachTransport(SerialTransport *link) {
+    if (m_link == link) return;
+    detachTransport();
+    m_link = link;
+    if (m_link) {
+        if (m_replayRx && m_replayer.isRunning()) {
+            m_replayer.stop();
+            ui->replayButton->setText("PLAY");
+            m_log->appendText("PLAY stopped: link attached");
+        }
+        m_link->discardRx();
+        m_parser.reset();
+
+        m_conn = connect(m_link, &SerialTransport::rxReady,
                          this,   &SerialMonitor::handleReadyRead);
     }
 }
 
 /**
- * Detach the currently attached serial port (if any).
- * - Disconnects the readyRead() handler and clears the handle.
+ * Detach the current transport (if any).
+ * - Disconnects the rxReady() handler and clears the handle.
  */
-void SerialMonitor::detachPort() {
-    if (m_port) {
+void SerialMonitor::detachTransport() {
+    if (m_link) {
         if (m_conn) QObject::disconnect(m_conn);
         m_conn = QMetaObject::Connection();
-        m_port = nullptr;
+        m_link = nullptr;
     }
 }
 
@@ -83,104 +115,59 @@ void SerialMonitor::showEvent(QShowEvent *e)
     QWidget::showEvent(e);
 }
 
-/* ------------------------- Protocol helpers ------------------------- */
-
-/* One-step CRC16-CCITT update (poly 0x1021, init 0xFFFF). */
-static inline quint16 crc16_step(quint16 crc, quint8 b) {
-    crc ^= (quint16)b << 8;
-    for (int i=0; i<8; ++i)
-        crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
-    return crc;
-}
-
-/* Compute CRC16-CCITT over [msgId, len_hi, len_lo, payload...] */
-static quint16 crc16_calc(quint8 msgId, quint16 len, const quint8* pl) {
-    quint16 crc = 0xFFFF;
-    crc = crc16_step(crc, msgId);
-    crc = crc16_step(crc, (quint8)((len >> 8) & 0xFF));
-    crc = crc16_step(crc, (quint8)(len & 0xFF));
-    for (quint16 i=0; i<len; ++i) crc = crc16_step(crc, pl[i]);
-    return crc;
-}
+/* ------------------------- Protocol dispatch ------------------------- */
 
 /**
  * Incremental protocol frame parser.
  *
- * Buffering strategy:
- *  - Append new chunk to m_protoBuf.
- *  - Loop:
- *      * Find SOF0 (0xAA). If not found -> clear buffer (noise) and return.
- *      * Verify SOF1 (0x55) next; otherwise skip this 0xAA and continue.
- *      * Ensure minimum frame size (7 bytes): SOF(2)+MSG(1)+LEN(2)+CRC(2).
- *      * If full frame not yet available (by LEN), return (wait for more).
- *      * Validate CRC; if OK, handle message (emit signal for CSPI_REQ),
- *        then remove the frame; else drop the first SOF and resync.
+ *  - FrameParser buffers the chunk and scans from a read offset (no per-frame
+ *    erase from the front; see frameparser.h).
+ *  - Each CRC-valid frame is dispatched here; unknown messages are ignored.
  */
 void SerialMonitor::parseProtoFrames(const QByteArray& chunk)
 {
-    m_protoBuf += chunk;
-
-    for (;;) {
-        // Search for SOF
-        int sof = m_protoBuf.indexOf(char(SOF0));
-        if (sof < 0) { m_protoBuf.clear(); return; }
-        if (sof + 1 >= m_protoBuf.size()) return;
-
-        if ((quint8)m_protoBuf[sof] != SOF0 || (quint8)m_protoBuf[sof+1] != SOF1) {
-            // 0xAA was found but not followed by 0x55 -> advance past this 0xAA
-            m_protoBuf.remove(0, sof + 1);
-            continue;
+    m_parser.feed(chunk, [this](quint8 msg, const char* plPtr, quint16 len) {
+        if (msg == MSG_ID_CSPI_REQ && len >= CSPI_CREDIT_SIZE) {
+            const auto c = proto::read<proto::CspiCredit>(reinterpret_cast<const quint8*>(plPtr));
+            emit cspiCreditReceived(c.limit, c.starved, c.underflow);
         }
-
-        // Minimum frame: SOF(2) + msg(1) + len(2) + crc(2) = 7 bytes
-        if (m_protoBuf.size() < sof + 7) return;
-
-        const int base = sof + 2;
-        quint8  msg = (quint8)m_protoBuf[base + 0];
-        quint16 len = ((quint8)m_protoBuf[base + 1] << 8) | (quint8)m_protoBuf[base + 2];
-
-        const int frameLen = 2 + 1 + 2 + len + 2; // SOF + header + payload + CRC
-        if (m_protoBuf.size() < sof + frameLen) return; // incomplete frame -> wait more
-
-        const char* plPtr = m_protoBuf.constData() + base + 3;
-        quint16 rxCrc = ((quint8)m_protoBuf[sof + frameLen - 2] << 8)
-                        | (quint8)m_protoBuf[sof + frameLen - 1];
-
-        quint16 calc = crc16_calc(msg, len, reinterpret_cast<const quint8*>(plPtr));
-
-        if (rxCrc == calc) {
-            // Valid frame: react to known messages
-            if (msg == MSG_ID_CSPI_REQ && len == 0) {
-                emit cspiReqReceived();     // notify UI/app logic about CSPI refill request
-            }
-            // (Extend here to handle/log other message types if needed.)
-
-            // Consume the frame and continue scanning (there might be more)
-            m_protoBuf.remove(sof, frameLen);
-        } else {
-            // CRC mismatch: drop this SOF and attempt resynchronization
-            m_protoBuf.remove(0, sof + 1);
+        else if (msg == MSG_ID_CSPI_REQ && len == 0) {
+            emit cspiReqReceived();     // legacy stop-and-wait refill request
         }
-    }
+        else if (msg == MSG_ID_CSPI_RX && len >= 2) {
+            const quint8* p = reinterpret_cast<const quint8*>(plPtr);
+            emit cspiRxBlock(quint16((p[0] << 8) | p[1]), QByteArray(plPtr + 2, len - 2));
+        }
+        else if (msg == MSG_ID_CSPI_STATS && len >= CSPI_STATS_SIZE) {
+            emit cspiStatsReceived(QByteArray(plPtr, len));
+        }
+        else if (msg == MSG_ID_SLOT_LIST && len >= 1) {
+            emit slotListReceived(QByteArray(plPtr, len));
+        }
+        // (Extend here to handle/log other message types if needed.)
+    });
 }
 
 /* ----------------------- Serial data ingestion ---------------------- */
 
 /**
- * readyRead() handler.
- *  - Drain all currently available bytes.
+ * rxReady() handler.
+ *  - Drain every chunk the transport has queued (rxReady() is coalesced).
  *  - Render as hex or ASCII depending on UI toggle.
  *  - Feed the protocol parser for out-of-band control messages.
  */
 void SerialMonitor::handleReadyRead() {
-    if (!m_port) return;
-
-    QByteArray data = m_port->readAll();
-    while (m_port->bytesAvailable() > 0)
-        data += m_port->readAll();
+    if (!m_link) return;
 
-    if (data.isEmpty()) return;
+    QByteArray data;
+    while (m_link->takeRx(data))
+        ingestRx(data);
+}
 
+/**
+ * One received chunk, from the port or from a replayed capture.
+ */
+void SerialMonitor::ingestRx(const QByteArray &data) {
     if (m_hexView) {
         appendLine(data);
     } else {
@@ -197,50 +184,53 @@ void SerialMonitor::handleReadyRead() {
 void SerialMonitor::onHexToggled(bool on)
 {
     m_hexView = on;
-    if (m_hexView) m_lineBuf.clear();
+    if (m_hexView) { m_lineBuf.clear(); m_lineRd = 0; }
 }
 
 /**
  * Append one line in hex mode.
- *  - Uppercase hex, single space between bytes, optional timestamp prefix.
+ *  - Raw bytes are stored; the model renders uppercase spaced hex (and the
+ *    timestamp prefix) when the row becomes visible.
  */
 void SerialMonitor::appendLine(const QByteArray &data) {
-    QString line;
-    if (m_timestamp) {
-        line += QDateTime::currentDateTime().toString("[HH:mm:ss.zzz] ");
-    }
-    line += QString::fromLatin1(data.toHex(' ').toUpper());
-    ui->textEdit->append(line);
+    m_log->appendHex(data);
 }
 
 /**
  * Append zero or more lines in ASCII mode.
  *  - Accumulate bytes until '\n'; strip optional trailing '\r'.
- *  - Prepend timestamp if enabled.
+ *  - Timestamp is added by the model at render time.
  *  - Only append to UI when RX checkbox is checked.
  */
 void SerialMonitor::appendAsciiLines(const QByteArray &chunk)
 {
+    // Same offset scheme as FrameParser: consume by index, compact rarely
+    if (m_lineRd >= FrameParser::kCompactBytes && m_lineRd * 2 >= m_lineBuf.size()) {
+        m_lineBuf.remove(0, m_lineRd);
+        m_lineRd = 0;
+    }
+    if (m_lineRd == m_lineBuf.size()) { m_lineBuf.resize(0); m_lineRd = 0; }
     m_lineBuf.append(chunk);
 
+    const bool show = ui->rxCheckBox->isChecked();
+    const char *base = m_lineBuf.constData();
     for (;;) {
-        int nl = m_lineBuf.indexOf('\n');
-        if (nl < 0) break;
+        const void *hit = std::memchr(base + m_lineRd, '\n', size_t(m_lineBuf.size() - m_lineRd));
+        if (!hit) break;
+        const qsizetype nl = static_cast<const char*>(hit) - base;
 
-        QByteArray one = m_lineBuf.left(nl);
-        m_lineBuf.remove(0, nl + 1);
+        qsizetype end = nl;
+        if (end > m_lineRd && base[end - 1] == '\r') --end;
 
-        if (!one.isEmpty() && one.back() == '\r')
-            one.chop(1);
-
-        QString line;
-        if (m_timestamp) {
-            line += QDateTime::currentDateTime().toString("[HH:mm:ss.zzz] ");
-        }
-        line += QString::fromUtf8(one);
+        if (show)
+            m_log->appendAscii(QByteArray(base + m_lineRd, end - m_lineRd)); // decoded lazily by the model
+        m_lineRd = nl + 1;
+    }
 
-        if (ui->rxCheckBox->isChecked())
-            ui->textEdit->append(line);
+    // Binary noise without '\n' must not grow the buffer forever
+    if (m_lineBuf.size() - m_lineRd > kMaxLineBytes) {
+        if (show) m_log->appendAscii(m_lineBuf.mid(m_lineRd));
+        m_lineRd = m_lineBuf.size();
     }
 }
 
@@ -249,5 +239,5 @@ void SerialMonitor::appendAsciiLines(const QByteArray &chunk)
  */
 void SerialMonitor::on_clearButton_clicked()
 {
-    ui->textEdit->clear();
+    m_log->clear();
 }
@@ -2,14 +2,15 @@
 #define SERIALMONITOR_H
 
 #include <QWidget>
-#include <QPlainTextEdit>
-#include <QSerialPort>
-#include <QTextEdit>
-#include "actionset.h"
+#include "actionEncoder.h"
+#include "seriallog.h"
+#include "frameparser.h"
+#include "sessionreplayer.h"
 
 namespace Ui {
 class SerialMonitor;
 }
+class SerialTransport;
 
 /*------------------------------------------------------------------------------
  * SerialMonitor
@@ -21,18 +22,26 @@ class SerialMonitor;
  *     CRCs, and (optionally) decoded action graphs and CSPI payloads.
  *
  * Responsibilities
- *   - Attach to a QSerialPort (non-owning) and consume its readyRead() stream.
- *   - Buffer partial reads, parse protocol frames, and append formatted lines.
+ *   - Attach to a SerialTransport (non-owning) and drain its RX queue on
+ *     rxReady().
+ *   - Buffer partial reads, parse protocol frames, and append formatted lines
+ *     to a bounded log model (see SerialLogModel) shown in a virtualized view.
  *   - Emit cspiReqReceived() when a device-side CSPI REQ is detected.
+ *   - Emit cspiRxBlock() for binary CSPI RX capture blocks.
  *   - Allow toggling between Hex view and ASCII line view.
+ *   - REC: session capture on the attached transport (see SerialTransport).
+ *   - PLAY: replay a capture's RX chunks through this monitor (offline
+ *     device simulation, only while no transport is attached) or its TX
+ *     frames to the device.
  *
  * Lifetime / Ownership
  *   - Owns Ui::SerialMonitor* (generated form).
- *   - Does NOT own the QSerialPort; caller must keep it alive while attached.
- *   - Maintains a scoped connection to the port’s readyRead().
+ *   - Does NOT own the transport; caller must keep it alive while attached.
+ *   - Maintains a scoped connection to the transport’s rxReady().
  *
  * Threading
- *   - GUI thread only. QSerialPort notifications come on the same thread.
+ *   - GUI thread only. The port lives on the transport's I/O thread; this
+ *     widget is the single consumer of its RX queue.
  *----------------------------------------------------------------------------*/
 class SerialMonitor : public QWidget {
     Q_OBJECT
@@ -48,27 +57,29 @@ public:
     ~SerialMonitor();
 
     /**
-     * @brief Wire the monitor to an existing serial port.
-     *        Creates a readyRead() connection and begins parsing incoming data.
+     * @brief Wire the monitor to an open transport.
+     *        Drops stale RX, connects rxReady() and begins parsing incoming data.
      *
-     * @param port Non-owning pointer to an open QSerialPort.
+     * @param link Non-owning pointer to the application's SerialTransport.
      */
-    void attachPort(QSerialPort *port);
+    void attachTransport(SerialTransport *link);
 
     /**
-     * @brief Detach from the current serial port and drop signal connections.
+     * @brief Detach from the current transport and drop signal connections.
      */
-    void detachPort();
+    void detachTransport();
 
     /**
      * @brief Log a transmitted packet (host→device).
-     *        Optionally provides an ActionSet to enable decoded coloring
-     *        of action payloads.
+     *        Optionally provides the record index of an actions blob inside
+     *        the payload to enable per-record coloring.
      *
      * @param packet  Full framed packet (SOF..CRC).
-     * @param set     Optional action set used for pretty-printing (may be null).
+     * @param index   Record index from encodeActions() (may be null).
+     * @param base    Payload offset where the indexed blob starts
+     *                (0 for EXECUTE, 1 after a flash key / slot byte).
      */
-    void logTx(const QByteArray &packet, const ActionSet* set);
+    void logTx(const QByteArray &packet, const ActionIndex* index = nullptr, int base = 0);
 
 protected:
     /**
@@ -83,10 +94,37 @@ signals:
      */
     void cspiReqReceived();
 
+    /**
+     * @brief Emitted for a device CSPI credit frame.
+     * @param limit      Total DATA bytes the host may have sent since BEGIN.
+     * @param starved    Bytes the device filled with idle_fill (ring ran dry).
+     * @param underflows SPI TX FIFO underflow events (eDMA path).
+     */
+    void cspiCreditReceived(quint32 limit, quint32 starved, quint32 underflows);
+
+    /**
+     * @brief Emitted for a device CSPI RX capture block.
+     * @param seq  Wrapping block counter (gaps = frames lost in transit).
+     * @param data Captured words (16-bit words little-endian).
+     */
+    void cspiRxBlock(quint16 seq, const QByteArray& data);
+
+    /**
+     * @brief Emitted for a device CSPI statistics frame.
+     * @param payload CSPI_STATS_SIZE bytes (layout: CSPIWindow::showStats()).
+     */
+    void cspiStatsReceived(const QByteArray& payload);
+
+    /**
+     * @brief Emitted when the device answers MSG_ID_SLOT_LIST with its slot summary.
+     * @param payload [used]{[slot][count][len:2][crc:2][runs:4]}...
+     */
+    void slotListReceived(const QByteArray& payload);
+
 private slots:
     /**
-     * @brief Slot connected to QSerialPort::readyRead(). Reads bytes,
-     *        buffers partial frames, and appends parsed/colored output.
+     * @brief Slot connected to SerialTransport::rxReady(). Drains queued
+     *        chunks, buffers partial frames, and appends parsed/colored output.
      */
     void handleReadyRead();
 
@@ -101,6 +139,16 @@ private slots:
      */
     void on_clearButton_clicked();
 
+    /**
+     * @brief Start/stop the transport's session capture.
+     */
+    void on_recButton_toggled(bool on);
+
+    /**
+     * @brief Pick a capture and replay mode, or stop a running replay.
+     */
+    void on_replayButton_clicked();
+
 private:
     /*--------------------------- Formatting helpers ------------------------*/
     /**
@@ -119,10 +167,11 @@ private:
     QString coloredCrc(const QByteArray& packet) const;
 
     /**
-     * @brief Pretty-print an actions payload using IDs/nodes from @actions.
+     * @brief Pretty-print an actions payload, one color per record of @index
+     *        (blob starting at @base); plain hex if the index does not match.
      */
     QString coloredActions(const QByteArray& payload,
-                           const std::vector<Action*>& actions) const;
+                           const ActionIndex& index, int base) const;
 
     /**
      * @brief Pretty-print a CSPI header/payload (human-friendly breakdown).
@@ -145,12 +194,7 @@ private:
     QString coloredBulkEnd() const;
 
     /**
-     * @brief Return action pointers sorted by id ascending (stable view).
-     */
-    std::vector<Action*> idAscending(const ActionSet* set) const;
-
-    /**
-     * @brief Append a fully formatted line to the monitor (hex or rich HTML).
+     * @brief Queue one hex-dump line for a received chunk.
      */
     void appendLine(const QByteArray &data);
 
@@ -159,27 +203,41 @@ private:
      */
     void appendAsciiLines(const QByteArray &chunk);
 
+    /**
+     * @brief Render and parse one received chunk (live or replayed).
+     */
+    void ingestRx(const QByteArray &chunk);
+
     /*--------------------------- UI / Port state ---------------------------*/
     Ui::SerialMonitor *ui = nullptr;          ///< Generated form (owned).
-    QSerialPort *m_port = nullptr;            ///< Attached serial (non-owning).
-    QMetaObject::Connection m_conn;           ///< Scoped connection to readyRead().
+    SerialTransport *m_link = nullptr;        ///< Attached transport (non-owning).
+    QMetaObject::Connection m_conn;           ///< Scoped connection to rxReady().
+    SerialLogModel *m_log = nullptr;          ///< Bounded log ring behind ui->logView (owned).
+    bool m_followTail = true;                 ///< View was at the bottom before the last flush.
 
     /*--------------------------- View / Parse state ------------------------*/
     bool m_hexView = true;                    ///< True → hex; False → ASCII view.
     bool m_timestamp = true;                  ///< Prepend timestamps to lines.
     bool m_dropInitialPending = false;        ///< Drop stale port buffer on attach.
     QByteArray m_lineBuf;                     ///< For ASCII line accumulation.
+    qsizetype  m_lineRd = 0;                  ///< First unconsumed byte in m_lineBuf.
+    static constexpr qsizetype kMaxLineBytes = 4096; ///< Force a line break past this.
 
     /**
      * @brief Convert a byte array to a single line of hex with spacing/grouping.
      */
     QString bytesToHexLine(const QByteArray &data) const;
 
-    QByteArray m_protoBuf;                    ///< RX buffer for protocol frame reassembly.
+    FrameParser m_parser;                     ///< RX protocol frame reassembly (offset based).
+
+    /*--------------------------- Capture / Replay --------------------------*/
+    SerialTransport *m_recLink = nullptr;     ///< Transport recording for us (non-owning).
+    SessionReplayer  m_replayer;              ///< Capture playback (PLAY button).
+    bool             m_replayRx = false;      ///< Running replay feeds ingestRx() (offline only).
 
     /**
-     * @brief Parse framed protocol messages from @chunk (append to m_protoBuf).
-     *        Emits cspiReqReceived() when a CSPI REQ is decoded.
+     * @brief Parse framed protocol messages from @chunk (fed to m_parser).
+     *        Emits cspiCreditReceived()/cspiReqReceived() when a CSPI REQ is decoded.
      */
     void parseProtoFrames(const QByteArray& chunk);
 };
@@ -0,0 +1,342 @@
+#include "serialtransport.h"
+#include <QSerialPort>
+#include <algorithm>
+#include <chrono>
+
+SerialTransport::SerialTransport(QObject *parent)
+    : QObject(parent)
+{
+    m_ctx = new QObject;
+    m_ctx->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_ctx, &QObject::deleteLater);
+    m_thread.setObjectName("SerialTransport");
+    m_thread.start();
+}
+
+SerialTransport::~SerialTransport()
+{
+    close();
+    stopRecording();
+    m_thread.quit();
+    m_thread.wait();
+}
+
+qint64 SerialTransport::nowUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void SerialTransport::raiseMax(std::atomic<qint64> &m, qint64 v)
+{
+    qint64 cur = m.load(std::memory_order_relaxed);
+    while (v > cur && !m.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+}
+
+/* ------------------------------ GUI side ------------------------------ */
+
+/*
+ * Counters are reset here (the I/O thread is idle while the port is closed),
+ * then the port is opened on the I/O thread; opened() reports the result.
+ */
+void SerialTransport::open(const QString &name, qint32 baud)
+{
+    m_txFrames = 0; m_txBytes = 0; m_txRejected = 0; m_txErrors = 0;
+    m_txLatLast = 0; m_txLatSum = 0; m_txLatMax = 0; m_txDoneAt = 0;
+    m_rxChunks = 0; m_rxBytes = 0; m_rxDropped = 0; m_rxLatMax = 0;
+
+    QMetaObject::invokeMethod(m_ctx, [this, name, baud] { doOpen(name, baud); },
+                              Qt::QueuedConnection);
+}
+
+void SerialTransport::close()
+{
+    if (!m_thread.isRunning()) return;
+    QMetaObject::invokeMethod(m_ctx, [this] { doClose(QString()); },
+                              Qt::BlockingQueuedConnection);
+    discardRx();
+}
+
+/*
+ * The I/O thread may have drained the backlog between the caller's check and
+ * the store below; with nothing in flight onWritten() would never run again,
+ * so arming the flag also posts one drain check of its own.
+ */
+void SerialTransport::refuse()
+{
+    m_txRejected.fetch_add(1, std::memory_order_relaxed);
+    if (!m_txBlocked.exchange(true))
+        QMetaObject::invokeMethod(m_ctx, [this] { checkTxSpace(); }, Qt::QueuedConnection);
+}
+
+void SerialTransport::checkTxSpace()
+{
+    if (m_txBacklog.load() <= kTxBudget / 2 && m_txBlocked.exchange(false))
+        emit txSpace();
+}
+
+bool SerialTransport::canSend(qsizetype bytes)
+{
+    if (isOpen() && !m_txq.full() && m_txBacklog.load() + bytes <= kTxBudget)
+        return true;
+    refuse();
+    return false;
+}
+
+/*
+ * Backlog is charged before the push so the I/O thread can never release
+ * more than was charged. The wake-up is posted only when none is pending.
+ */
+bool SerialTransport::send(const QByteArray &frame)
+{
+    const qint64 n = frame.size();
+    if (!canSend(n)) return false;
+
+    m_txBacklog.fetch_add(n);
+    if (!m_txq.push(TxItem{frame, nowUs()})) {
+        m_txBacklog.fetch_sub(n);
+        refuse();
+        return false;
+    }
+
+    if (!m_txWake.exchange(true))
+        QMetaObject::invokeMethod(m_ctx, [this] { pumpTx(); }, Qt::QueuedConnection);
+    return true;
+}
+
+/*
+ * rxReady() is re-armed only after the ring was seen empty; the second pop
+ * closes the race with a chunk queued between the first pop and the re-arm.
+ */
+bool SerialTransport::takeRx(QByteArray &out, qint64 *readAtUs)
+{
+    RxItem it;
+    if (!m_rxq.pop(it)) {
+        m_rxNotify.store(false);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!m_rxq.pop(it)) {
+            if (m_rxHeld.load())
+                QMetaObject::invokeMethod(m_ctx, [this] { flushRxHold(); }, Qt::QueuedConnection);
+            return false;
+        }
+    }
+    raiseMax(m_rxLatMax, nowUs() - it.tReadUs);
+    if (readAtUs) *readAtUs = it.tReadUs;
+    out = std::move(it.data);
+    return true;
+}
+
+void SerialTransport::discardRx()
+{
+    RxItem it;
+    while (m_rxq.pop(it)) {}
+    m_rxNotify.store(false);
+    if (m_rxHeld.load())
+        QMetaObject::invokeMethod(m_ctx, [this] { m_rxHold.clear(); m_rxHeld = false; },
+                                  Qt::QueuedConnection);
+}
+
+SerialTransport::Metrics SerialTransport::metrics() const
+{
+    Metrics m;
+    m.txFrames    = m_txFrames.load(std::memory_order_relaxed);
+    m.txBytes     = m_txBytes.load(std::memory_order_relaxed);
+    m.txRejected  = m_txRejected.load(std::memory_order_relaxed);
+    m.txErrors    = m_txErrors.load(std::memory_order_relaxed);
+    m.txBacklog   = m_txBacklog.load(std::memory_order_relaxed);
+    m.txLatLastUs = m_txLatLast.load(std::memory_order_relaxed);
+    m.txLatAvgUs  = m.txFrames ? m_txLatSum.load(std::memory_order_relaxed) / qint64(m.txFrames) : 0;
+    m.txLatMaxUs  = m_txLatMax.load(std::memory_order_relaxed);
+    m.txDoneAtUs  = m_txDoneAt.load(std::memory_order_relaxed);
+    m.rxChunks    = m_rxChunks.load(std::memory_order_relaxed);
+    m.rxBytes     = m_rxBytes.load(std::memory_order_relaxed);
+    m.rxDropped   = m_rxDropped.load(std::memory_order_relaxed);
+    m.rxLatMaxUs  = m_rxLatMax.load(std::memory_order_relaxed);
+    return m;
+}
+
+QString SerialTransport::startRecording(const QString &dir)
+{
+    QString path;
+    QMetaObject::invokeMethod(m_ctx, [this, dir, &path] {
+        m_rec.close();
+        m_recParser.reset();
+        if (m_rec.open(dir)) path = m_rec.path();
+        m_recording = m_rec.isOpen();
+    }, Qt::BlockingQueuedConnection);
+    return path;
+}
+
+quint64 SerialTransport::stopRecording()
+{
+    quint64 records = 0;
+    if (!m_thread.isRunning()) return records;
+    QMetaObject::invokeMethod(m_ctx, [this, &records] {
+        records = m_rec.records();
+        m_rec.close();
+        m_recording = false;
+    }, Qt::BlockingQueuedConnection);
+    return records;
+}
+
+/* ------------------------------ I/O thread ----------------------------- */
+
+void SerialTransport::doOpen(const QString &name, qint32 baud)
+{
+    if (m_port) doClose(QString());
+
+    // Frames refused-then-queued around a previous close must not leak into this session
+    TxItem stale;
+    while (m_txq.pop(stale)) {}
+    m_txBacklog = 0;
+
+    auto *port = new QSerialPort(m_ctx);
+    port->setPortName(name);
+    port->setBaudRate(baud);
+    port->setDataBits(QSerialPort::Data8);
+    port->setParity(QSerialPort::NoParity);
+    port->setStopBits(QSerialPort::OneStop);
+    port->setFlowControl(QSerialPort::NoFlowControl);
+
+    if (!port->open(QIODevice::ReadWrite)) {
+        const QString err = port->errorString();
+        delete port;
+        emit opened(false, err);
+        return;
+    }
+
+    m_port = port;
+    connect(port, &QSerialPort::readyRead, m_ctx, [this] { onReadable(); });
+    connect(port, &QSerialPort::bytesWritten, m_ctx, [this](qint64 n) { onWritten(n); });
+    connect(port, &QSerialPort::errorOccurred, m_ctx, [this](QSerialPort::SerialPortError e) {
+        if (e == QSerialPort::ResourceError && m_port) doClose(m_port->errorString());
+        else if (e == QSerialPort::WriteError) m_txErrors.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    m_open.store(true, std::memory_order_release);
+    emit opened(true, QString());
+}
+
+/*
+ * Undelivered TX is dropped (it would be stale on the next session); the port
+ * is deleted later because this may run inside one of its own signals.
+ */
+void SerialTransport::doClose(const QString &reason)
+{
+    if (!m_port) return;
+
+    m_open.store(false, std::memory_order_release);
+    m_port->disconnect(m_ctx);
+    m_port->close();
+    m_port->deleteLater();
+    m_port = nullptr;
+
+    TxItem it;
+    while (m_txq.pop(it)) {}
+    m_inflight.clear();
+    m_txBacklog = 0;
+    m_txBlocked = false;
+
+    m_rxHold.clear();
+    m_rxHeld = false;
+
+    emit closed(reason);
+}
+
+/*
+ * Move queued frames into QSerialPort while its buffer is under the high
+ * water mark; bytesWritten() calls back in as the driver drains it.
+ */
+void SerialTransport::pumpTx()
+{
+    m_txWake.store(false);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!m_port) return;
+
+    TxItem it;
+    while (m_port->bytesToWrite() < kPortHighWater && m_txq.pop(it)) {
+        const qint64 n = it.data.size();
+        if (m_port->write(it.data) != n) {
+            m_txErrors.fetch_add(1, std::memory_order_relaxed);
+            m_txBacklog.fetch_sub(n);
+            continue;
+        }
+        m_inflight.push_back(InFlight{n, n, it.tEnqUs});
+        if (m_rec.isOpen())
+            m_rec.append(SessionCapture::Frame, SessionCapture::Tx, it.data.constData(), quint32(n));
+    }
+}
+
+void SerialTransport::onWritten(qint64 n)
+{
+    const qint64 now = nowUs();
+    while (n > 0 && !m_inflight.empty()) {
+        InFlight &f = m_inflight.front();
+        const qint64 take = std::min(n, f.left);
+        f.left -= take;
+        n      -= take;
+        if (f.left > 0) break;
+
+        const qint64 lat = now - f.tEnqUs;
+        m_txLatLast.store(lat, std::memory_order_relaxed);
+        m_txLatSum.fetch_add(lat, std::memory_order_relaxed);
+        raiseMax(m_txLatMax, lat);
+        m_txDoneAt.store(now, std::memory_order_relaxed);
+        m_txFrames.fetch_add(1, std::memory_order_relaxed);
+        m_txBytes.fetch_add(quint64(f.size), std::memory_order_relaxed);
+        m_txBacklog.fetch_sub(f.size);
+        m_inflight.pop_front();
+    }
+
+    checkTxSpace();
+    pumpTx();
+}
+
+bool SerialTransport::queueRx(QByteArray &data, qint64 tUs)
+{
+    RxItem it{std::move(data), tUs};
+    if (!m_rxq.push(std::move(it))) {
+        data = std::move(it.data);
+        return false;
+    }
+    m_rxChunks.fetch_add(1, std::memory_order_relaxed);
+    if (!m_rxNotify.exchange(true)) emit rxReady();
+    return true;
+}
+
+void SerialTransport::flushRxHold()
+{
+    if (m_rxHold.isEmpty() || !queueRx(m_rxHold, m_rxHoldT)) return;
+    m_rxHold = QByteArray();
+    m_rxHeld = false;
+}
+
+/*
+ * Read everything available; older held bytes go first so order is kept.
+ */
+void SerialTransport::onReadable()
+{
+    QByteArray d = m_port->readAll();
+    if (d.isEmpty()) return;
+
+    const qint64 t = nowUs();
+    m_rxBytes.fetch_add(quint64(d.size()), std::memory_order_relaxed);
+
+    if (m_rec.isOpen()) {
+        m_rec.append(SessionCapture::Chunk, SessionCapture::Rx, d.constData(), quint32(d.size()));
+        m_recParser.feed(d, [this](quint8, const char *payload, quint16 len) {
+            m_rec.append(SessionCapture::Frame, SessionCapture::Rx, payload - 5, quint32(len) + 7);
+        });
+    }
+
+    flushRxHold();
+    if (m_rxHold.isEmpty() && queueRx(d, t)) return;
+
+    if (m_rxHold.size() + d.size() > kRxHoldMax) {
+        m_rxDropped.fetch_add(quint64(d.size()), std::memory_order_relaxed);
+        return;
+    }
+    if (m_rxHold.isEmpty()) m_rxHoldT = t;
+    m_rxHold += d;
+    m_rxHeld = true;
+}
@@ -0,0 +1,207 @@
+#ifndef SERIALTRANSPORT_H
+#define SERIALTRANSPORT_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QThread>
+#include <atomic>
+#include <deque>
+#include "spscqueue.h"
+#include "sessioncapture.h"
+#include "frameparser.h"
+
+class QSerialPort;
+
+/*------------------------------------------------------------------------------
+ * SerialTransport
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - Owns the QSerialPort on a dedicated I/O thread so port reads/writes
+ *     never run on (or block) the GUI thread.
+ *   - Exchanges data with the GUI through two lock-free SPSC queues:
+ *       TX: framed packets, GUI → I/O thread (send()).
+ *       RX: raw read chunks, I/O thread → GUI (takeRx()).
+ *
+ * Back-pressure
+ *   - send() refuses a frame (returns false, counted as rejected) once the
+ *     bytes not yet delivered to the driver would exceed kTxBudget, or the TX
+ *     ring is full. Nothing is dropped silently.
+ *   - The I/O thread keeps at most kPortHighWater bytes inside QSerialPort
+ *     ahead of the wire; the rest waits in the ring, so the budget bounds
+ *     end-to-end queueing delay (64 KiB ≈ 5.7 s at 115200 baud).
+ *   - canSend() lets producers (CSPI pump) check before taking a frame; a
+ *     refusal from either call arms txSpace(), emitted once the backlog is
+ *     at or below half the budget (checked right away, then on each write).
+ *   - RX cannot push back on a UART without flow control: when the GUI falls
+ *     behind, chunks are held on the I/O thread (up to kRxHoldMax bytes) and
+ *     re-queued as it catches up; beyond that they are counted as dropped.
+ *
+ * Metrics (metrics(), readable from any thread)
+ *   - Delivered frames/bytes (QSerialPort::bytesWritten confirmed), rejected
+ *     sends, write errors, current backlog.
+ *   - Delivery latency per frame: send() → last byte handed to the driver
+ *     (last / average / max, µs).
+ *   - RX chunks/bytes/dropped and queueing latency (read → takeRx, max µs).
+ *
+ * Recording
+ *   - startRecording() appends every TX frame (as written), every RX chunk
+ *     (as read) and every reassembled RX frame to a *.dtcap session capture
+ *     (see sessioncapture.h). The writer runs on the I/O thread, so the
+ *     timestamps are taken at the port, not when the GUI gets around to it.
+ *   - Recording spans reconnects until stopRecording().
+ *
+ * Threading
+ *   - open()/close()/send()/canSend()/takeRx()/discardRx() from the GUI
+ *     thread (single producer of TX, single consumer of RX).
+ *   - Signals are emitted on the I/O thread; connect them with the default
+ *     (auto → queued) connection.
+ *   - rxReady() is coalesced: drain with takeRx() until it returns false.
+ *----------------------------------------------------------------------------*/
+class SerialTransport : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr std::size_t kTxSlots = 256;      ///< TX ring depth (frames).
+    static constexpr std::size_t kRxSlots = 1024;     ///< RX ring depth (read chunks).
+    static constexpr qint64 kTxBudget      = 64 * 1024;   ///< Max undelivered TX bytes.
+    static constexpr qint64 kPortHighWater = 4 * 1024;    ///< Max bytes inside QSerialPort.
+    static constexpr qint64 kRxHoldMax     = 4 * 1024 * 1024; ///< RX held while the GUI lags.
+
+    struct Metrics {
+        quint64 txFrames{0};      ///< Frames fully handed to the driver.
+        quint64 txBytes{0};       ///< Bytes of those frames.
+        quint64 txRejected{0};    ///< send()/canSend() refusals (back-pressure or closed).
+        quint64 txErrors{0};      ///< Short/failed QSerialPort::write() calls.
+        qint64  txBacklog{0};     ///< Accepted but not yet delivered bytes.
+        qint64  txLatLastUs{0};   ///< Delivery latency of the last frame.
+        qint64  txLatAvgUs{0};    ///< Mean delivery latency since open().
+        qint64  txLatMaxUs{0};    ///< Worst delivery latency since open().
+        qint64  txDoneAtUs{0};    ///< nowUs() when the last frame was fully delivered.
+        quint64 rxChunks{0};      ///< Read chunks queued to the GUI.
+        quint64 rxBytes{0};       ///< Bytes read from the port.
+        quint64 rxDropped{0};     ///< Bytes lost because the GUI fell too far behind.
+        qint64  rxLatMaxUs{0};    ///< Worst read → takeRx() delay since open().
+    };
+
+    explicit SerialTransport(QObject *parent = nullptr);
+    ~SerialTransport();
+
+    /**
+     * @brief Open @name (8N1, no flow control) on the I/O thread.
+     *        Result is reported by opened(); counters are reset.
+     */
+    void open(const QString &name, qint32 baud = 115200);
+
+    /**
+     * @brief Close the port and drop undelivered TX. Blocks until the I/O
+     *        thread has released the port.
+     */
+    void close();
+
+    bool isOpen() const { return m_open.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Whether a frame of @bytes would be accepted right now.
+     *        A false answer is counted and arms txSpace().
+     */
+    bool canSend(qsizetype bytes);
+
+    /**
+     * @brief Queue one framed packet; false = closed or back-pressure.
+     */
+    bool send(const QByteArray &frame);
+
+    /**
+     * @brief Pop the next received chunk; false when none is pending.
+     *        @readAtUs (optional) gets the nowUs() at which it was read.
+     */
+    bool takeRx(QByteArray &out, qint64 *readAtUs = nullptr);
+
+    /**
+     * @brief Drop everything received so far (stale data from before an attach).
+     */
+    void discardRx();
+
+    Metrics metrics() const;
+
+    /**
+     * @brief Start a session capture under @dir (closes a running one first).
+     * @return Capture path, or empty if the file could not be created.
+     */
+    QString startRecording(const QString &dir);
+
+    /**
+     * @brief Finish the capture (writes its seek index).
+     * @return Number of records written.
+     */
+    quint64 stopRecording();
+
+    bool isRecording() const { return m_recording.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Monotonic clock of all timestamps above (µs, steady clock);
+     *        comparable across transports.
+     */
+    static qint64 nowUs();
+
+signals:
+    /** open() finished; @error is the port's error string on failure. */
+    void opened(bool ok, const QString &error);
+
+    /** Port closed by close() (@reason empty) or lost (@reason = port error). */
+    void closed(const QString &reason);
+
+    /** RX data is pending (coalesced). */
+    void rxReady();
+
+    /** A refused send can be retried: backlog fell to kTxBudget / 2. */
+    void txSpace();
+
+private:
+    struct TxItem { QByteArray data; qint64 tEnqUs{0}; };
+    struct RxItem { QByteArray data; qint64 tReadUs{0}; };
+    struct InFlight { qint64 size; qint64 left; qint64 tEnqUs; };
+
+    /* I/O thread */
+    void doOpen(const QString &name, qint32 baud);
+    void doClose(const QString &reason);
+    void pumpTx();
+    void onWritten(qint64 n);
+    void onReadable();
+    bool queueRx(QByteArray &data, qint64 tUs);   ///< Moves @data out only on success.
+    void flushRxHold();
+    void checkTxSpace();                          ///< Emits txSpace() if armed and drained.
+
+    /* Any thread */
+    void refuse();
+    static void raiseMax(std::atomic<qint64> &m, qint64 v);
+
+    QThread      m_thread;
+    QObject     *m_ctx{nullptr};         ///< Lives on m_thread; context for queued calls.
+    QSerialPort *m_port{nullptr};        ///< Created/used/deleted on m_thread only.
+
+    SpscQueue<TxItem, kTxSlots> m_txq;
+    SpscQueue<RxItem, kRxSlots> m_rxq;
+    std::deque<InFlight> m_inflight;     ///< I/O thread: frames written, awaiting bytesWritten.
+    QByteArray           m_rxHold;       ///< I/O thread: RX waiting for ring space.
+    qint64               m_rxHoldT{0};
+    SessionCaptureWriter m_rec;          ///< I/O thread: session capture (if recording).
+    FrameParser          m_recParser;    ///< I/O thread: RX frame boundaries for m_rec.
+    std::atomic_bool     m_recording{false};
+
+    std::atomic_bool  m_open{false};
+    std::atomic_bool  m_txWake{false};   ///< A pumpTx() call is already posted.
+    std::atomic_bool  m_txBlocked{false};///< A refusal happened; emit txSpace() on drain.
+    std::atomic_bool  m_rxNotify{false}; ///< rxReady() posted and not yet drained.
+    std::atomic_bool  m_rxHeld{false};   ///< m_rxHold is non-empty.
+    std::atomic<qint64> m_txBacklog{0};
+
+    std::atomic<quint64> m_txFrames{0}, m_txBytes{0}, m_txRejected{0}, m_txErrors{0};
+    std::atomic<qint64>  m_txLatLast{0}, m_txLatSum{0}, m_txLatMax{0}, m_txDoneAt{0};
+    std::atomic<quint64> m_rxChunks{0}, m_rxBytes{0}, m_rxDropped{0};
+    std::atomic<qint64>  m_rxLatMax{0};
+};
+
+#endif // SERIALTRANSPORT_H
@@ -0,0 +1,249 @@
+#include "sessioncapture.h"
+#include <QDateTime>
+#include <QDir>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+using namespace SessionCapture;
+
+namespace {
+
+constexpr char kMagic[8]   = { 'D', 'T', 'C', 'A', 'P', 0, 0, 1 };
+constexpr char kIdxMagic[4] = { 'D', 'T', 'I', 'X' };
+constexpr char kEndMagic[8] = { 'D', 'T', 'C', 'A', 'P', 'E', 'N', 'D' };
+constexpr quint16 kVersion  = 1;
+constexpr qint64  kFlushNs  = 1000000000;   // at least one flush per second
+
+template <typename T> void put(char *p, T v) { qToLittleEndian<T>(v, p); }
+template <typename T> T get(const uchar *p) { return qFromLittleEndian<T>(p); }
+
+} // namespace
+
+/* ------------------------------- Writer -------------------------------- */
+
+bool SessionCaptureWriter::open(const QString &dir)
+{
+    close();
+
+    const QString name = QString("session_%1.dtcap")
+                             .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    m_file.setFileName(QDir(dir).filePath(name));
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    char hdr[kHeaderSize] = {};
+    std::memcpy(hdr, kMagic, sizeof(kMagic));
+    put<quint16>(hdr + 8,  kVersion);
+    put<quint16>(hdr + 10, quint16(kHeaderSize));
+    put<quint32>(hdr + 12, kIndexEvery);
+    put<qint64> (hdr + 16, QDateTime::currentMSecsSinceEpoch());
+    m_file.write(hdr, sizeof(hdr));
+
+    m_offset  = kHeaderSize;
+    m_records = 0;
+    m_bytes   = 0;
+    m_index.clear();
+    m_clock.start();
+    m_lastFlushNs = 0;
+    return true;
+}
+
+/*
+ * Header + payload go through QFile's buffer; the OS write happens in large
+ * batches. Seek points are remembered in memory and flushed with the data.
+ */
+void SessionCaptureWriter::append(Type type, Dir dir, const char *data, quint32 n)
+{
+    if (!m_file.isOpen()) return;
+
+    const qint64 t = m_clock.nsecsElapsed();
+
+    char hdr[kRecordHdrSize] = {};
+    put<quint32>(hdr, n);
+    hdr[4] = char(type);
+    hdr[5] = char(dir);
+    put<quint64>(hdr + 8, quint64(t));
+    m_file.write(hdr, sizeof(hdr));
+    if (n) m_file.write(data, n);
+
+    const bool seekPoint = (m_records % kIndexEvery) == 0;
+    if (seekPoint) m_index.push_back(IndexEntry{quint64(t), m_offset});
+
+    m_offset += kRecordHdrSize + n;
+    m_records++;
+    m_bytes += n;
+
+    if (seekPoint || t - m_lastFlushNs >= kFlushNs) {
+        m_file.flush();
+        m_lastFlushNs = t;
+    }
+}
+
+void SessionCaptureWriter::close()
+{
+    if (!m_file.isOpen()) return;
+
+    const quint64 indexOffset = m_offset;
+
+    char head[16];
+    std::memcpy(head, kIdxMagic, sizeof(kIdxMagic));
+    put<quint32>(head + 4, quint32(m_index.size()));
+    put<quint64>(head + 8, m_records);
+    m_file.write(head, sizeof(head));
+
+    for (const IndexEntry &e : m_index) {
+        char ent[16];
+        put<quint64>(ent,     e.tNs);
+        put<quint64>(ent + 8, e.offset);
+        m_file.write(ent, sizeof(ent));
+    }
+
+    char trailer[kTrailerSize];
+    put<quint64>(trailer, indexOffset);
+    std::memcpy(trailer + 8, kEndMagic, sizeof(kEndMagic));
+    m_file.write(trailer, sizeof(trailer));
+
+    m_file.close();
+}
+
+/* ------------------------------- Reader -------------------------------- */
+
+bool SessionCaptureReader::open(const QString &path)
+{
+    close();
+    m_error.clear();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_size = quint64(m_file.size());
+    if (m_size < quint64(kHeaderSize)) {
+        m_error = "File too small for a capture header";
+        close();
+        return false;
+    }
+    m_base = m_file.map(0, qint64(m_size));
+    if (!m_base) {
+        m_error = m_file.errorString();
+        close();
+        return false;
+    }
+    if (std::memcmp(m_base, kMagic, sizeof(kMagic)) != 0 || get<quint16>(m_base + 8) != kVersion) {
+        m_error = "Not a session capture (bad magic/version)";
+        close();
+        return false;
+    }
+
+    m_indexEvery  = std::max<quint32>(get<quint32>(m_base + 12), 1);
+    m_startWallMs = get<qint64>(m_base + 16);
+
+    m_indexed = loadIndex();
+    if (!m_indexed) rebuildIndex();
+    return true;
+}
+
+void SessionCaptureReader::close()
+{
+    if (m_base) m_file.unmap(const_cast<uchar *>(m_base));
+    m_base = nullptr;
+    if (m_file.isOpen()) m_file.close();
+    m_size = m_end = m_records = m_lastNs = 0;
+    m_index.clear();
+    m_indexed = false;
+}
+
+/*
+ * Trailer → index block. Any inconsistency means "not cleanly closed" and
+ * falls back to a scan instead of trusting it.
+ */
+bool SessionCaptureReader::loadIndex()
+{
+    if (m_size < quint64(kHeaderSize + 16 + kTrailerSize)) return false;
+
+    const uchar *tr = m_base + m_size - kTrailerSize;
+    if (std::memcmp(tr + 8, kEndMagic, sizeof(kEndMagic)) != 0) return false;
+
+    const quint64 idxOff = get<quint64>(tr);
+    if (idxOff < quint64(kHeaderSize) || idxOff + 16 > m_size - kTrailerSize) return false;
+
+    const uchar *ix = m_base + idxOff;
+    if (std::memcmp(ix, kIdxMagic, sizeof(kIdxMagic)) != 0) return false;
+
+    const quint32 count = get<quint32>(ix + 4);
+    if (idxOff + 16 + quint64(count) * 16 != m_size - kTrailerSize) return false;
+
+    m_records = get<quint64>(ix + 8);
+    m_end     = idxOff;
+    m_index.resize(count);
+    for (quint32 i = 0; i < count; ++i) {
+        m_index[i].tNs    = get<quint64>(ix + 16 + quint64(i) * 16);
+        m_index[i].offset = get<quint64>(ix + 16 + quint64(i) * 16 + 8);
+    }
+
+    // Duration: walk the last index stretch only
+    m_lastNs = 0;
+    quint64 off = m_index.empty() ? begin() : m_index.back().offset;
+    Record r;
+    while (next(off, r)) m_lastNs = r.tNs;
+    return true;
+}
+
+/* One pass over the records; stops at a torn tail (crash mid-write). */
+void SessionCaptureReader::rebuildIndex()
+{
+    m_index.clear();
+    m_records = 0;
+    m_lastNs  = 0;
+
+    quint64 off = begin();
+    while (off + kRecordHdrSize <= m_size) {
+        const quint32 len = get<quint32>(m_base + off);
+        if (off + kRecordHdrSize + len > m_size) break;
+
+        const quint64 t = get<quint64>(m_base + off + 8);
+        if (m_records % m_indexEvery == 0) m_index.push_back(IndexEntry{t, off});
+        m_lastNs = t;
+        m_records++;
+        off += kRecordHdrSize + len;
+    }
+    m_end = off;
+}
+
+quint64 SessionCaptureReader::seek(quint64 tNs) const
+{
+    if (!m_base) return 0;
+
+    // Last seek point strictly before tNs, then walk forward
+    auto it = std::lower_bound(m_index.begin(), m_index.end(), tNs,
+                               [](const IndexEntry &e, quint64 t) { return e.tNs < t; });
+    quint64 off = (it == m_index.begin()) ? begin() : std::prev(it)->offset;
+
+    Record r;
+    quint64 cur = off;
+    while (next(cur, r)) {
+        if (r.tNs >= tNs) return off;
+        off = cur;
+    }
+    return m_end;
+}
+
+bool SessionCaptureReader::next(quint64 &offset, Record &out) const
+{
+    if (!m_base || offset + kRecordHdrSize > m_end) return false;
+
+    const uchar  *p   = m_base + offset;
+    const quint32 len = get<quint32>(p);
+    if (offset + kRecordHdrSize + len > m_end) return false;
+
+    out.len  = len;
+    out.type = p[4];
+    out.dir  = p[5];
+    out.tNs  = get<quint64>(p + 8);
+    out.data = reinterpret_cast<const char *>(p + kRecordHdrSize);
+    offset  += kRecordHdrSize + len;
+    return true;
+}
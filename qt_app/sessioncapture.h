@@ -0,0 +1,165 @@
+#ifndef SESSIONCAPTURE_H
+#define SESSIONCAPTURE_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <vector>
+
+/*------------------------------------------------------------------------------
+ * Session capture (*.dtcap)
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - Append-only binary record of everything that crossed the serial link:
+ *     raw RX chunks, reassembled RX frames and TX frames, each with a
+ *     monotonic nanosecond timestamp and direction. Written while a session
+ *     runs so a failed overnight run can be analyzed (or replayed) later.
+ *
+ * File format (all integers little-endian)
+ *   Header (32 bytes)
+ *     [MAGIC "DTCAP\0\0\1":8][VERSION:2][HDR_SIZE:2][INDEX_EVERY:4]
+ *     [START_WALL_MS:8 (epoch ms at t=0)][RSV:8]
+ *   Records (16-byte header + payload, back to back)
+ *     [LEN:4][TYPE:1][DIR:1][RSV:2][T_NS:8][LEN bytes]
+ *       TYPE: 1 = raw chunk (as read / written), 2 = whole frame (SOF..CRC)
+ *       DIR : 0 = RX (device → host), 1 = TX (host → device)
+ *       T_NS: nanoseconds since the writer opened the file (QElapsedTimer)
+ *   Seek index (written by close())
+ *     ["DTIX":4][COUNT:4][RECORDS:8]{[T_NS:8][OFFSET:8]} × COUNT
+ *     one entry for the first record and every kIndexEvery records after it
+ *   Trailer (16 bytes, last in the file)
+ *     [INDEX_OFFSET:8]["DTCAPEND":8]
+ *
+ * Crash tolerance
+ *   - The writer flushes at every index point and at least once a second.
+ *   - A file without a trailer (crash / power loss) is still readable: the
+ *     reader rebuilds the index with one scan and ignores a torn last record.
+ *----------------------------------------------------------------------------*/
+namespace SessionCapture {
+
+enum Type : quint8 { Chunk = 1, Frame = 2 };
+enum Dir  : quint8 { Rx = 0, Tx = 1 };
+
+constexpr int     kHeaderSize    = 32;
+constexpr int     kRecordHdrSize = 16;
+constexpr int     kTrailerSize   = 16;
+constexpr quint32 kIndexEvery    = 1024;   ///< Records between seek points.
+
+/** One record as seen through the reader's mapping (valid while it is open). */
+struct Record {
+    quint8      type{0};
+    quint8      dir{0};
+    quint64     tNs{0};
+    const char *data{nullptr};
+    quint32     len{0};
+};
+
+struct IndexEntry {
+    quint64 tNs;
+    quint64 offset;
+};
+
+} // namespace SessionCapture
+
+/*------------------------------------------------------------------------------
+ * SessionCaptureWriter
+ *------------------------------------------------------------------------------
+ *   - Streaming writer: records go through QFile's buffer; index entries are
+ *     kept in memory (16 bytes per kIndexEvery records) and written on close().
+ *   - Not thread-safe; SerialTransport drives it from its I/O thread.
+ *----------------------------------------------------------------------------*/
+class SessionCaptureWriter
+{
+public:
+    ~SessionCaptureWriter() { close(); }
+
+    /**
+     * @brief Create `session_<timestamp>.dtcap` under @dir and write the header.
+     * @return false if the file could not be created.
+     */
+    bool open(const QString &dir);
+
+    /**
+     * @brief Append one record timestamped now.
+     */
+    void append(SessionCapture::Type type, SessionCapture::Dir dir, const char *data, quint32 n);
+
+    /**
+     * @brief Write seek index + trailer and close (no-op if not open).
+     */
+    void close();
+
+    bool    isOpen()  const { return m_file.isOpen(); }
+    QString path()    const { return m_file.fileName(); }
+    quint64 records() const { return m_records; }
+    quint64 bytes()   const { return m_bytes; }
+
+private:
+    QFile         m_file;
+    QElapsedTimer m_clock;
+    qint64        m_lastFlushNs{0};
+    quint64       m_offset{0};            ///< File offset of the next record.
+    quint64       m_records{0};
+    quint64       m_bytes{0};             ///< Payload bytes recorded.
+    std::vector<SessionCapture::IndexEntry> m_index;
+};
+
+/*------------------------------------------------------------------------------
+ * SessionCaptureReader
+ *------------------------------------------------------------------------------
+ *   - Memory-maps the whole file; opening a multi-GB capture costs the header
+ *     and trailer reads plus the index block, not a scan.
+ *   - seek(t) is a binary search over the index and at most kIndexEvery
+ *     record hops; next() walks records without copying payloads.
+ *----------------------------------------------------------------------------*/
+class SessionCaptureReader
+{
+public:
+    ~SessionCaptureReader() { close(); }
+
+    /**
+     * @brief Map @path and load (or rebuild) its seek index.
+     * @return false with errorString() set if it is not a capture file.
+     */
+    bool open(const QString &path);
+    void close();
+
+    bool    isOpen()     const { return m_base != nullptr; }
+    bool    wasIndexed() const { return m_indexed; }   ///< False → trailer missing, index rebuilt.
+    quint64 records()    const { return m_records; }
+    quint64 durationNs() const { return m_lastNs; }
+    qint64  startWallMs() const { return m_startWallMs; }
+    QString errorString() const { return m_error; }
+
+    /** Offset of the first record. */
+    quint64 begin() const { return SessionCapture::kHeaderSize; }
+
+    /**
+     * @brief Offset of the first record with T_NS >= @tNs (end offset if none).
+     */
+    quint64 seek(quint64 tNs) const;
+
+    /**
+     * @brief Decode the record at @offset and advance it; false at the end.
+     */
+    bool next(quint64 &offset, SessionCapture::Record &out) const;
+
+private:
+    bool loadIndex();
+    void rebuildIndex();
+
+    QFile         m_file;
+    const uchar  *m_base{nullptr};
+    quint64       m_size{0};
+    quint64       m_end{0};               ///< One past the last complete record.
+    quint64       m_records{0};
+    quint64       m_lastNs{0};
+    qint64        m_startWallMs{0};
+    quint32       m_indexEvery{SessionCapture::kIndexEvery};
+    bool          m_indexed{false};
+    QString       m_error;
+    std::vector<SessionCapture::IndexEntry> m_index;
+};
+
+#endif // SESSIONCAPTURE_H
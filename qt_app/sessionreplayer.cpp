@@ -0,0 +1,100 @@
+#include "sessionreplayer.h"
+#include <algorithm>
+
+SessionReplayer::SessionReplayer(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &SessionReplayer::step);
+}
+
+bool SessionReplayer::start(const QString &path, SessionCapture::Type type,
+                            SessionCapture::Dir dir, double speed, Sink sink)
+{
+    stop();
+    if (!m_reader.open(path)) return false;
+
+    m_type  = type;
+    m_dir   = dir;
+    m_speed = speed;
+    m_sink  = std::move(sink);
+    m_off   = m_reader.begin();
+    m_haveRec = m_haveT0 = false;
+    m_delivered = m_scanned = 0;
+    m_lateMaxUs = 0;
+
+    m_clock.start();
+    m_timer.start(0);
+    return true;
+}
+
+void SessionReplayer::stop()
+{
+    m_timer.stop();
+    m_reader.close();
+    m_sink = nullptr;
+    m_haveRec = false;
+}
+
+void SessionReplayer::resume()
+{
+    if (m_haveRec && isRunning()) {
+        m_timer.stop();
+        step();
+    }
+}
+
+bool SessionReplayer::fetch()
+{
+    SessionCapture::Record r;
+    while (m_reader.next(m_off, r)) {
+        m_scanned++;
+        if (r.type != m_type || r.dir != m_dir) continue;
+        if (!m_haveT0) { m_t0Ns = r.tNs; m_haveT0 = true; }
+        m_rec = r;
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Deliver every record that is due, then sleep until the next one.
+ * Payloads are copied out of the mapping (sinks may queue them).
+ */
+void SessionReplayer::step()
+{
+    if (!isRunning()) return;
+
+    const bool fast = m_speed <= 0.0;
+    for (int n = 0; !fast || n < kBurst; ++n) {
+        if (!m_haveRec && !(m_haveRec = fetch())) {
+            const quint64 total = m_reader.records();
+            const quint64 done  = m_delivered;
+            const qint64  late  = m_lateMaxUs;
+            emit progress(total, total);
+            stop();
+            emit finished(done, late);
+            return;
+        }
+
+        if (!fast) {
+            const qint64 dueNs = qint64(double(m_rec.tNs - m_t0Ns) / m_speed);
+            const qint64 nowNs = m_clock.nsecsElapsed();
+            if (nowNs < dueNs) {
+                m_timer.start(int(std::max<qint64>((dueNs - nowNs) / 1000000, 0)));
+                return;
+            }
+            m_lateMaxUs = std::max(m_lateMaxUs, (nowNs - dueNs) / 1000);
+        }
+
+        if (!m_sink(QByteArray(m_rec.data, qsizetype(m_rec.len)))) {
+            m_timer.start(kRetryMs);
+            return;
+        }
+        if (!isRunning()) return;            // sink stopped us
+        m_haveRec = false;
+        if ((++m_delivered & 0xFF) == 0) emit progress(m_scanned, m_reader.records());
+    }
+    m_timer.start(0);
+}
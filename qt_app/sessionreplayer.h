@@ -0,0 +1,93 @@
+#ifndef SESSIONREPLAYER_H
+#define SESSIONREPLAYER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <functional>
+#include "sessioncapture.h"
+
+/*------------------------------------------------------------------------------
+ * SessionReplayer
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - Plays the records of a *.dtcap capture into a sink, either at their
+ *     original spacing (optionally scaled) or as fast as the sink accepts.
+ *   - Typical sinks: SerialTransport::send() for TX frames (re-drive a device)
+ *     or the monitor's RX path for RX chunks (simulate the device offline).
+ *
+ * Timing
+ *   - Record k is due at (T_NS[k] - T_NS[first]) / speed after start();
+ *     a precise single-shot timer sleeps until the next due record, so a
+ *     long idle gap costs no CPU. speed <= 0 means "as fast as possible".
+ *   - As-fast-as-possible mode yields to the event loop every kBurst records.
+ *
+ * Back-pressure
+ *   - A sink returning false keeps the record; it is retried after
+ *     kRetryMs or on resume() (e.g. connected to SerialTransport::txSpace()).
+ *     Original-timing replays then run late rather than drop data.
+ *
+ * Threading
+ *   - Owner's thread; the sink is called on it.
+ *----------------------------------------------------------------------------*/
+class SessionReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Sink = std::function<bool(const QByteArray &data)>;
+
+    static constexpr int kBurst   = 256;   ///< Records per event-loop turn in fast mode.
+    static constexpr int kRetryMs = 5;     ///< Back-off after a refusing sink.
+
+    explicit SessionReplayer(QObject *parent = nullptr);
+
+    /**
+     * @brief Open @path and start replaying records of @type/@dir into @sink.
+     * @return false with errorString() set if the capture cannot be opened.
+     */
+    bool start(const QString &path, SessionCapture::Type type, SessionCapture::Dir dir,
+               double speed, Sink sink);
+
+    /**
+     * @brief Stop early; finished() is not emitted.
+     */
+    void stop();
+
+    /**
+     * @brief Retry a refused record now (no-op unless waiting on the sink).
+     */
+    void resume();
+
+    bool    isRunning()   const { return m_reader.isOpen(); }
+    QString errorString() const { return m_reader.errorString(); }
+
+signals:
+    /** @done records scanned so far of the capture's @total records (all types). */
+    void progress(quint64 done, quint64 total);
+
+    /** Reached the end; @lateMaxUs = worst lag behind the original timing. */
+    void finished(quint64 delivered, qint64 lateMaxUs);
+
+private:
+    void step();
+    bool fetch();                          ///< Load the next matching record into m_rec.
+
+    SessionCaptureReader   m_reader;
+    SessionCapture::Record m_rec;
+    bool          m_haveRec{false};
+    quint64       m_off{0};
+    quint64       m_t0Ns{0};
+    bool          m_haveT0{false};
+    quint8        m_type{0};
+    quint8        m_dir{0};
+    double        m_speed{1.0};
+    Sink          m_sink;
+    QElapsedTimer m_clock;
+    QTimer        m_timer;
+    quint64       m_delivered{0};
+    quint64       m_scanned{0};
+    qint64        m_lateMaxUs{0};
+};
+
+#endif // SESSIONREPLAYER_H
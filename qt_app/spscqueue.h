@@ -0,0 +1,66 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/*------------------------------------------------------------------------------
+ * SpscQueue<T, N>
+ *------------------------------------------------------------------------------
+ * Purpose
+ *   - Bounded, lock-free single-producer / single-consumer ring.
+ *   - Used between the GUI thread and SerialTransport's I/O thread, one
+ *     queue per direction, so neither side ever takes a lock or blocks.
+ *
+ * Rules
+ *   - Exactly one thread calls push(), exactly one (other) thread calls pop().
+ *   - N must be a power of two; head/tail are free-running counters.
+ *   - A popped slot is reset to T() so large payloads (QByteArray) are
+ *     released by the consumer, not kept alive until the slot is reused.
+ *----------------------------------------------------------------------------*/
+template <typename T, std::size_t N>
+class SpscQueue
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue: N must be a power of two");
+
+public:
+    /** Producer: false if full (item untouched). */
+    bool push(T &&item)
+    {
+        const std::size_t h = m_head.load(std::memory_order_relaxed);
+        if (h - m_tail.load(std::memory_order_acquire) == N) return false;
+        m_buf[h & (N - 1)] = std::move(item);
+        m_head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer: false if empty. */
+    bool pop(T &out)
+    {
+        const std::size_t t = m_tail.load(std::memory_order_relaxed);
+        if (t == m_head.load(std::memory_order_acquire)) return false;
+        out = std::move(m_buf[t & (N - 1)]);
+        m_buf[t & (N - 1)] = T();
+        m_tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Approximate fill level (exact when called from either endpoint while the other is idle). */
+    std::size_t size() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    bool full() const { return size() >= N; }
+    bool empty() const { return size() == 0; }
+    static constexpr std::size_t capacity() { return N; }
+
+private:
+    std::array<T, N> m_buf{};
+    alignas(64) std::atomic<std::size_t> m_head{0};   ///< Written by the producer only.
+    alignas(64) std::atomic<std::size_t> m_tail{0};   ///< Written by the consumer only.
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,262 @@
+/*
+ * test_actiontiming
+ * -----------------
+ * analyzeTiming() on small hand-built graphs, one per issue kind, plus start
+ * windows, tick rounding, critical path and issue ordering. Exit code 0 when
+ * every check holds (ctest: actiontiming).
+ */
+#include "../actionset.h"
+#include "../actiontiming.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+int g_failed = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n",                 \
+                         __FILE__, __LINE__, #cond);                          \
+            ++g_failed;                                                       \
+        }                                                                     \
+    } while (0)
+
+using Kind     = TimingIssue::Kind;
+using Severity = TimingIssue::Severity;
+
+std::unique_ptr<Action> delay(quint32 ms, quint16 us = 0)
+{
+    auto a = std::make_unique<DelayAction>();
+    a->durationMs = ms;
+    a->durationUs = us;
+    return a;
+}
+
+std::unique_ptr<Action> write(int port, int pin, Level target, quint32 ms)
+{
+    auto a = std::make_unique<PinWriteAction>();
+    a->port    = port;
+    a->pin     = pin;
+    a->initial = Level::LOW;
+    a->target  = target;
+    a->final   = Level::LOW;
+    a->durationMs = ms;
+    return a;
+}
+
+std::unique_ptr<Action> trigger(int port, int pin, Level target, quint32 timeoutMs)
+{
+    auto a = std::make_unique<PinTriggerAction>();
+    a->port      = port;
+    a->pin       = pin;
+    a->target    = target;
+    a->timeoutMs = timeoutMs;
+    return a;
+}
+
+const TimingIssue *findIssue(const TimingReport &r, Kind kind)
+{
+    for (const TimingIssue &is : r.issues)
+        if (is.kind == kind) return &is;
+    return nullptr;
+}
+
+bool hasId(const TimingIssue &is, int id)
+{
+    return std::find(is.ids.begin(), is.ids.end(), id) != is.ids.end();
+}
+
+void chainIsClean()
+{
+    ActionSet s;
+    const int w = s.add(write(1, 21, Level::HIGH, 10), {});
+    const int d = s.add(delay(5), {w});
+
+    const TimingReport r = analyzeTiming(s);
+    CHECK(r.issues.empty());
+    CHECK(!r.hasErrors());
+    CHECK(r.makespanMinUs == 15000 && r.makespanMaxUs == 15000);
+    CHECK((r.criticalPath == std::vector<int>{0, w, d}));
+    CHECK((r.order == std::vector<int>{0, w, d}));
+    CHECK(r.nodes.size() == 3);
+
+    const NodeTiming *t = r.find(d);
+    CHECK(t && t->earliestStartUs == 10000 && t->latestStartUs == 10000);
+    CHECK(t && t->minDurationUs == 5000 && t->maxDurationUs == 5000);
+    CHECK(r.find(99) == nullptr);
+    CHECK(!timingSummary(r).isEmpty());
+}
+
+void ticksRoundLikeTheDevice()
+{
+    // execute.c: ticks = ms * 100 + (us + 5) / 10
+    ActionSet s;
+    const int a = s.add(delay(0, 14), {});
+    const int b = s.add(delay(0, 15), {});
+    const int c = s.add(delay(1, 4), {});
+
+    const TimingReport r = analyzeTiming(s);
+    CHECK(r.find(a) && r.find(a)->minDurationUs == 10);
+    CHECK(r.find(b) && r.find(b)->minDurationUs == 20);
+    CHECK(r.find(c) && r.find(c)->minDurationUs == 1000);
+}
+
+void triggerOpensStartWindow()
+{
+    // External trigger (no write drives port D pin 0): fires within 0 and
+    // one tick short of its 50 ms timeout (at the timeout the run errors)
+    ActionSet s;
+    const int t = s.add(trigger(3, 0, Level::HIGH, 50), {});
+    const int d = s.add(delay(10), {t});
+
+    const TimingReport r = analyzeTiming(s);
+    CHECK(r.issues.empty());
+    const NodeTiming *n = r.find(d);
+    CHECK(n && n->earliestStartUs == 0 && n->latestStartUs == 50000 - DEVICE_TICK_US);
+    CHECK(r.makespanMinUs == 10000 && r.makespanMaxUs == 60000 - DEVICE_TICK_US);
+    CHECK((r.criticalPath == std::vector<int>{0, t, d}));
+}
+
+void unreachableIsError()
+{
+    ActionSet s;
+    s.add(delay(1), {});
+    const int u = s.add(delay(3), {});
+    s.unlink(0, u);
+
+    const TimingReport r = analyzeTiming(s);
+    CHECK(r.hasErrors());
+    const TimingIssue *is = findIssue(r, Kind::Unreachable);
+    CHECK(is && is->severity == Severity::Error && is->ids == std::vector<int>{u});
+    CHECK(r.find(u) && !r.find(u)->reached());
+}
+
+void pinReadIsError()
+{
+    ActionSet s;
+    const int p = s.add(std::make_unique<PinReadAction>(), {});
+
+    const TimingReport r = analyzeTiming(s);
+    const TimingIssue *is = findIssue(r, Kind::PinRead);
+    CHECK(is && is->severity == Severity::Error && is->ids == std::vector<int>{p});
+}
+
+void lateWriteTimesTriggerOut()
+{
+    // The only write to C6 starts at 200 ms, the trigger gives up at 100 ms
+    ActionSet s;
+    const int d = s.add(delay(200), {});
+    const int w = s.add(write(2, 6, Level::HIGH, 1), {d});
+    const int t = s.add(trigger(2, 6, Level::HIGH, 100), {});
+
+    const TimingReport r = analyzeTiming(s);
+    const TimingIssue *is = findIssue(r, Kind::TriggerTimeout);
+    CHECK(is && is->severity == Severity::Error);
+    CHECK(is && is->ids.size() == 2 && is->ids[0] == t && is->ids[1] == w);
+    CHECK(is && is->port == 2 && is->pin == 6);
+    CHECK(!timingIssueText(*is).isEmpty());
+}
+
+void writeMayComeAfterTimeout()
+{
+    // The write to C7 starts after an external trigger: 0..50 ms vs. 30 ms
+    ActionSet s;
+    const int ext = s.add(trigger(3, 0, Level::HIGH, 50), {});
+    const int w   = s.add(write(2, 7, Level::HIGH, 1), {ext});
+    const int t   = s.add(trigger(2, 7, Level::HIGH, 30), {});
+
+    const TimingReport r = analyzeTiming(s);
+    CHECK(!r.hasErrors());
+    const TimingIssue *is = findIssue(r, Kind::TriggerRace);
+    CHECK(is && is->severity == Severity::Warning);
+    CHECK(is && is->ids.size() == 2 && is->ids[0] == t && is->ids[1] == w);
+}
+
+void cycleIsWarning()
+{
+    ActionSet s;
+    const int x = s.add(delay(1), {});
+    const int y = s.add(delay(2), {x});
+    s.link(y, x);
+
+    const TimingReport r = analyzeTiming(s);
+    CHECK(!r.hasErrors());
+    const TimingIssue *is = findIssue(r, Kind::Cycle);
+    CHECK(is && is->severity == Severity::Warning && hasId(*is, x) && hasId(*is, y));
+}
+
+void overlappingWritesConflict()
+{
+    // A1 written 0..10 ms and 5..15 ms; a write ordered after the first is fine
+    ActionSet s;
+    const int a = s.add(write(0, 1, Level::HIGH, 10), {});
+    const int d = s.add(delay(5), {});
+    const int b = s.add(write(0, 1, Level::HIGH, 10), {d});
+
+    const TimingReport r = analyzeTiming(s);
+    const TimingIssue *is = findIssue(r, Kind::PinConflict);
+    CHECK(is && is->severity == Severity::Warning && hasId(*is, a) && hasId(*is, b));
+    CHECK(is && is->port == 0 && is->pin == 1);
+
+    ActionSet seq;
+    const int first = seq.add(write(0, 1, Level::HIGH, 10), {});
+    seq.add(write(0, 1, Level::LOW, 10), {first});
+    CHECK(findIssue(analyzeTiming(seq), Kind::PinConflict) == nullptr);
+}
+
+void errorsComeFirst()
+{
+    ActionSet s;
+    const int x = s.add(delay(1), {});
+    const int y = s.add(delay(2), {x});
+    s.link(y, x);                                        // warning
+    s.add(std::make_unique<PinReadAction>(), {});        // error
+
+    const TimingReport r = analyzeTiming(s);
+    CHECK(r.issues.size() >= 2);
+    CHECK(r.hasErrors() && r.issues.front().severity == Severity::Error);
+    CHECK(r.issues.back().severity == Severity::Warning);
+}
+
+void idsSurviveRemove()
+{
+    // Report IDs are editor IDs, not positions: remove a node in the middle
+    ActionSet s;
+    const int a = s.add(delay(1), {});
+    const int b = s.add(delay(2), {a});
+    const int c = s.add(delay(3), {b});
+    s.remove(b);
+
+    const TimingReport r = analyzeTiming(s);
+    CHECK(r.issues.empty());
+    CHECK(r.find(b) == nullptr);
+    CHECK(r.find(c) && r.find(c)->earliestStartUs == 1000);
+    CHECK((r.criticalPath == std::vector<int>{0, a, c}));
+}
+
+} // namespace
+
+int main()
+{
+    chainIsClean();
+    ticksRoundLikeTheDevice();
+    triggerOpensStartWindow();
+    unreachableIsError();
+    pinReadIsError();
+    lateWriteTimesTriggerOut();
+    writeMayComeAfterTimeout();
+    cycleIsWarning();
+    overlappingWritesConflict();
+    errorsComeFirst();
+    idsSurviveRemove();
+
+    if (g_failed) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failed);
+        return 1;
+    }
+    std::puts("actiontiming: all checks passed");
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * test_spscqueue
+ * --------------
+ * SpscQueue rules from spscqueue.h: capacity, refusal without touching the
+ * item, slot release on pop, counter wrap, and a two-thread run checking
+ * FIFO order and that no item is lost or duplicated (ctest: spscqueue).
+ */
+#include "../spscqueue.h"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+int g_failed = 0;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n",                 \
+                         __FILE__, __LINE__, #cond);                          \
+            ++g_failed;                                                       \
+        }                                                                     \
+    } while (0)
+
+void fillAndDrain()
+{
+    SpscQueue<int, 4> q;
+    int v = -1;
+    CHECK(q.empty() && !q.full() && q.capacity() == 4);
+    CHECK(!q.pop(v) && v == -1);
+
+    for (int i = 0; i < 4; ++i) CHECK(q.push(int(i)));
+    CHECK(q.full() && q.size() == 4);
+    CHECK(!q.push(99));
+
+    for (int i = 0; i < 4; ++i) CHECK(q.pop(v) && v == i);
+    CHECK(q.empty() && !q.pop(v));
+}
+
+void refusedItemIsUntouched()
+{
+    SpscQueue<std::string, 2> q;
+    CHECK(q.push(std::string("a")) && q.push(std::string("b")));
+
+    std::string big(1000, 'x');
+    CHECK(!q.push(std::move(big)));
+    CHECK(big.size() == 1000);          // still ours: the caller can retry
+}
+
+void popReleasesSlot()
+{
+    SpscQueue<std::shared_ptr<int>, 2> q;
+    auto p = std::make_shared<int>(7);
+    CHECK(q.push(std::shared_ptr<int>(p)));
+    CHECK(p.use_count() == 2);
+
+    std::shared_ptr<int> out;
+    CHECK(q.pop(out) && *out == 7);
+    out.reset();
+    CHECK(p.use_count() == 1);          // the ring keeps no reference
+}
+
+void countersWrap()
+{
+    // Many times around a small ring: head/tail are free-running
+    SpscQueue<int, 8> q;
+    int v = 0;
+    for (int i = 0; i < 100000; ++i) {
+        CHECK(q.push(int(i)));
+        if (i % 3 == 0) CHECK(q.push(int(-i)) && q.pop(v) && v == i && q.pop(v) && v == -i);
+        else            CHECK(q.pop(v) && v == i);
+    }
+    CHECK(q.empty());
+}
+
+void twoThreads()
+{
+    constexpr int kItems = 1000000;
+    SpscQueue<std::string, 256> q;
+    long long sum = 0;
+    int got = 0, wrong = 0;
+
+    std::thread producer([&q] {
+        for (int i = 0; i < kItems;) {
+            std::string s = std::to_string(i);
+            if (q.push(std::move(s))) ++i;
+            else std::this_thread::yield();
+        }
+    });
+
+    std::string s;
+    while (got < kItems) {
+        if (!q.pop(s)) { std::this_thread::yield(); continue; }
+        wrong += std::stoi(s) != got;
+        sum += got++;
+    }
+    producer.join();
+
+    CHECK(wrong == 0);
+    CHECK(sum == (long long)kItems * (kItems - 1) / 2);
+    CHECK(q.empty());
+}
+
+} // namespace
+
+int main()
+{
+    fillAndDrain();
+    refusedItemIsUntouched();
+    popReleasesSlot();
+    countersWrap();
+    twoThreads();
+
+    if (g_failed) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failed);
+        return 1;
+    }
+    std::puts("spscqueue: all checks passed");
+    return 0;
+}
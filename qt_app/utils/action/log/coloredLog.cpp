@@ -43,38 +43,19 @@ QString SerialMonitor::coloredCrc(const QByteArray& packet) const {
         .arg(hx((unsigned char)packet[n-1]));
 }
 
-std::vector<Action*> SerialMonitor::idAscending(const ActionSet* set) const {
-    std::vector<Action*> v;
-    if (!set) return v;
-    v.reserve(set->nodes().size());
-    for (auto &up : set->nodes()) v.push_back(up.get());
-    std::sort(v.begin(), v.end(), [](const Action* a, const Action* b){
-        return a->id < b->id;
-    });
-    return v;
-}
-
+/*
+ * Records come from the encoder's index (one encode per packet); the payload
+ * must be exactly [prefix][indexed blob] or it is shown as plain hex.
+ */
 QString SerialMonitor::coloredActions(const QByteArray& payload,
-                                      const std::vector<Action*>& actions) const
+                                      const ActionIndex& index, int base) const
 {
-    if (payload.isEmpty() || actions.empty())
+    if (payload.isEmpty() || index.empty())
         return {};
 
-    std::vector<int> sizes; sizes.reserve(actions.size());
-    std::vector<Action*> prefix; prefix.reserve(actions.size());
-
-    int prev = 0;
-    for (size_t i=0; i<actions.size(); ++i) {
-        prefix.push_back(actions[i]);
-        std::vector<std::uint8_t> enc = encodeActionPayload(prefix);
-        const int curr = (int)enc.size();
-        sizes.push_back(curr - prev);
-        prev = curr;
-    }
-    int sum = 0; for (int s : sizes) sum += s;
-    if (sum != payload.size()) {
+    const ActionRecord& last = index.back();
+    if (base < 0 || base + last.offset + last.length != payload.size())
         return bytesToHex(payload);
-    }
 
     static const char* COLORS[] = {
         "#27ae60", "#8e44ad", "#d35400", "#16a085",
@@ -83,17 +64,16 @@ QString SerialMonitor::coloredActions(const QByteArray& payload,
     const int C = (int)(sizeof(COLORS)/sizeof(COLORS[0]));
 
     QString out;
-    out.reserve(payload.size() * 12);
+    out.reserve(payload.size() * 40);
 
-    int off = 0;
-    for (size_t i=0; i<sizes.size(); ++i) {
-        const int len = sizes[i];
-        const QByteArray chunk = payload.mid(off, len);
-        off += len;
+    if (base > 0) out += bytesToHex(payload.left(base)) + " ";
 
-        const QString hex = bytesToHex(chunk);
+    for (size_t i=0; i<index.size(); ++i) {
+        const ActionRecord& r = index[i];
+        const QByteArray chunk = QByteArray::fromRawData(payload.constData() + base + r.offset,
+                                                         r.length);
         out += QString("<span style='color:%1'>%2</span> ")
-                   .arg(COLORS[i % C], hex);
+                   .arg(COLORS[i % C], bytesToHex(chunk));
     }
     return out.trimmed();
 }
@@ -111,9 +91,9 @@ QString SerialMonitor::coloredCSPI(const QByteArray& p) const
         return (int(hi) << 8) | int(lo);
     };
 
-    // [5..6] = txSize (BE)
+    // [5..6] = txSize (BE); header is 13 bytes, or 14 with the flags byte
     const int txSize = be16((unsigned char)p[5], (unsigned char)p[6]);
-    const int headerLen = 13;
+    const int headerLen = (p.size() >= CSPI_HEADER_SIZE + txSize) ? CSPI_HEADER_SIZE : 13;
     if (p.size() < headerLen + txSize)
         return bytesToHex(p);
 
@@ -127,6 +107,7 @@ QString SerialMonitor::coloredCSPI(const QByteArray& p) const
     const QString cTxLen   = "#27ae60"; // tx size (2 byte)
     const QString cThr     = "#d35400"; // threshold (4 byte)
     const QString cPortPin = "#16a085"; // port & pin
+    const QString cFlags   = "#7f8c8d"; // flags
     const QString cTxData  = "#2980b9"; // tx data
 
     auto span = [&](unsigned char b, const QString& col){
@@ -153,6 +134,8 @@ QString SerialMonitor::coloredCSPI(const QByteArray& p) const
     // port & pin
     out += span((unsigned char)p[11], cPortPin) + " ";
     out += span((unsigned char)p[12], cPortPin);
+    if (headerLen > 13)
+        out += " " + span((unsigned char)p[13], cFlags);   // flags
 
     // txData
     if (!txData.isEmpty()) {
@@ -167,7 +150,7 @@ QString SerialMonitor::coloredCSPI(const QByteArray& p) const
 QString SerialMonitor::coloredBulkBeginCSPI(const QByteArray& hdr) const
 {
     // CSPI header: 13B => mode(1), word(1), readSize(2BE), xfer(1), txLen(2BE),
-    //               threshold(4BE), port(1), pin(1)
+    //               threshold(4BE), port(1), pin(1) [+ flags(1)]
     if (hdr.size() < 13) return bytesToHex(hdr);
 
     auto hx = [](unsigned char b){
@@ -181,6 +164,7 @@ QString SerialMonitor::coloredBulkBeginCSPI(const QByteArray& hdr) const
     const QString cTxLen   = "#27ae60"; // txLen (2B)
     const QString cThr     = "#d35400"; // threshold (4B)
     const QString cPortPin = "#16a085"; // port+pin
+    const QString cFlags   = "#7f8c8d"; // flags
 
     auto span = [&](unsigned char b, const QString& col){
         return QString("<span style='color:%1'>%2</span>").arg(col, hx(b));
@@ -214,6 +198,10 @@ QString SerialMonitor::coloredBulkBeginCSPI(const QByteArray& hdr) const
     out += span((unsigned char)hdr[11], cPortPin) + " ";
     out += span((unsigned char)hdr[12], cPortPin);
 
+    // flags (1B, optional)
+    if (hdr.size() >= CSPI_HEADER_SIZE)
+        out += " " + span((unsigned char)hdr[13], cFlags);
+
     return out.trimmed();
 }
 
@@ -1,33 +1,32 @@
 #include "../../../serialmonitor.h"
 #include "../../../ui_serialmonitor.h"
 #include "../../../actionEncoder.h"
-#include <QDateTime>
 
-void SerialMonitor::logTx(const QByteArray &packet, const ActionSet* set)
+/*
+ * TX lines are formatted here (HTML for known frames) and queued in the log
+ * model; the timestamp prefix is added by the model.
+ */
+void SerialMonitor::logTx(const QByteArray &packet, const ActionIndex* index, int base)
 {
-    const QString ts = m_timestamp
-                           ? QDateTime::currentDateTime().toString("[HH:mm:ss.zzz] ")
-                           : QString();
+    if (!ui->txCheckBox->isChecked()) return;
 
     if (packet.size() < 7) {
-        if (ui->txCheckBox->isChecked())
-            ui->textEdit->append(QString("%1TX len=%2 %3").arg(ts).arg(packet.size()).arg(bytesToHex(packet)));
+        m_log->appendText(QString("TX len=%1 %2").arg(packet.size()).arg(bytesToHex(packet)));
         return;
     }
 
     const int total = packet.size();
     const int payloadLen = total - 2 /*SOF*/ - 1 /*msg*/ - 2 /*len*/ - 2 /*crc*/;
     if (payloadLen < 0) {
-        if (ui->txCheckBox->isChecked())
-            ui->textEdit->append(QString("%1TX len=%2 %3").arg(ts).arg(packet.size()).arg(bytesToHex(packet)));
+        m_log->appendText(QString("TX len=%1 %2").arg(packet.size()).arg(bytesToHex(packet)));
         return;
     }
 
     const quint8 msgId = (quint8)packet[2];
     const QByteArray payload = packet.mid(5, payloadLen);
 
-    if (set == nullptr) {
-        QString html = QString("%1TX len=%2 ").arg(ts).arg(packet.size())
+    if (index == nullptr) {
+        QString html = QString("TX len=%1 ").arg(packet.size())
         + coloredHeader(packet) + " ";
 
         if (msgId == MSG_ID_CSPI_BEGIN) {
@@ -43,19 +42,15 @@ void SerialMonitor::logTx(const QByteArray &packet, const ActionSet* set)
             html += bytesToHex(payload) + " ";
         }
         html += coloredCrc(packet);
-        if (ui->txCheckBox->isChecked())
-            ui->textEdit->append(html);
+        m_log->appendHtml(html);
         return;
     }
 
-    const std::vector<Action*> actions = idAscending(set);
-
     const QString html =
-        QString("%1TX len=%2 ").arg(ts).arg(packet.size())
+        QString("TX len=%1 ").arg(packet.size())
         + coloredHeader(packet) + " "
-        + coloredActions(payload, actions) + " "
+        + coloredActions(payload, *index, base) + " "
         + coloredCrc(packet);
 
-    if (ui->txCheckBox->isChecked())
-        ui->textEdit->append(html);
+    m_log->appendHtml(html);
 }
@@ -1,12 +1,15 @@
 #include "../../actionEncoder.h"
-#include <stdexcept>
+#include "../../framewriter.h"
+#include <array>
+#include <algorithm>
 
 /*
  * Encoding utilities for the Qt-side protocol builder.
  * ----------------------------------------------------
  * - Converts high-level Action objects into a compact byte stream understood
  *   by the device firmware.
- * - Provides helpers for big-endian integer appends and small validation.
+ * - Record layouts and big-endian stores come from protocol.h (proto::*);
+ *   this file adds the editor-side mapping, range checks and target lists.
  * - Also builds framed UART packets (SOF + CORE + CRC16).
  */
 
@@ -17,128 +20,124 @@
  */
 std::uint8_t levelToU8(Level l) {
     switch (l) {
-    case Level::LOW:  return 0x00;
-    case Level::HIGH: return 0x01;
-    case Level::UNDEFINED: default: return 0xFF;
+    case Level::LOW:  return LVL_LOW;
+    case Level::HIGH: return LVL_HIGH;
+    case Level::UNDEFINED: default: return LVL_UNDEF;
     }
 }
 
-/* Append a raw 8-bit value. */
-void appendU8(std::vector<std::uint8_t>& out, std::uint8_t v) { out.push_back(v); }
+static bool fitsU8(int v) { return v >= 0 && v <= 255; }
 
-/* Append a 16-bit integer in big-endian order. */
-void appendU16BE(std::vector<std::uint8_t>& out, std::uint16_t v) {
-    out.push_back(static_cast<std::uint8_t>((v >> 8) & 0xFF));
-    out.push_back(static_cast<std::uint8_t>(v & 0xFF));
+/* Fixed record header (TYPE..last timing field) per kind; 0 = not in the blob. */
+static std::size_t headerSize(Kind k) {
+    switch (k) {
+    case Kind::START:       return proto::Start::kSize;
+    case Kind::DELAY:       return proto::Delay::kSize;
+    case Kind::PIN_READ:    return proto::PinRead::kSize;
+    case Kind::PIN_WRITE:   return proto::PinWrite::kSize;
+    case Kind::PIN_TRIGGER: return proto::PinTrigger::kSize;
+    case Kind::CSPI:        break;
+    }
+    return 0;
 }
 
-/* Append a 32-bit integer in big-endian order. */
-void appendU32BE(std::vector<std::uint8_t>& out, std::uint32_t v) {
-    out.push_back(static_cast<std::uint8_t>((v >> 24) & 0xFF));
-    out.push_back(static_cast<std::uint8_t>((v >> 16) & 0xFF));
-    out.push_back(static_cast<std::uint8_t>((v >>  8) & 0xFF));
-    out.push_back(static_cast<std::uint8_t>( v        & 0xFF));
+std::size_t recordSize(const Action& a) {
+    const std::size_t head = headerSize(a.kind);
+    return head ? head + 1 + a.runAfterMe.size() : 0;
 }
 
-/* Validate an Action ID is within protocol range [0..255]; return as u8. */
-std::uint8_t clampIdToU8(int id) {
-    if (id < 0 || id > 255) throw std::runtime_error("Action.id out of 0..255");
-    return static_cast<std::uint8_t>(id);
+static bool pinEncodable(const Action& a) {
+    switch (a.kind) {
+    case Kind::PIN_READ:    return fitsU8(static_cast<const PinReadAction&>(a).pin);
+    case Kind::PIN_WRITE:   return fitsU8(static_cast<const PinWriteAction&>(a).pin);
+    case Kind::PIN_TRIGGER: return fitsU8(static_cast<const PinTriggerAction&>(a).pin);
+    default:                return true;
+    }
 }
 
-/* Append a target list (fan-out/dependencies) as:
- *   [count:u8][id0:u8][id1:u8]...
- */
-void appendTargets(std::vector<std::uint8_t>& out, const std::vector<int>& ids) {
-    if (ids.size() > 255) throw std::runtime_error("TARGET_COUNT > 255");
-    appendU8(out, static_cast<std::uint8_t>(ids.size()));
-    for (int id : ids) {
-        if (id < 0 || id > 255) throw std::runtime_error("Target id out of 0..255");
-        appendU8(out, static_cast<std::uint8_t>(id));
-    }
+/* Editor ids/pins are int; the wire has one byte for each, and one for TCOUNT. */
+bool recordEncodable(const Action& a) {
+    if (!fitsU8(a.id) || a.runAfterMe.size() > 255) return false;
+    for (int t : a.runAfterMe)
+        if (!fitsU8(t)) return false;
+    return pinEncodable(a);
+}
+
+/* Target list (fan-out/dependencies): [count:u8][id0:u8][id1:u8]... */
+static std::uint8_t* packTargets(std::uint8_t* out, const std::vector<int>& ids) {
+    *out++ = static_cast<std::uint8_t>(ids.size());
+    for (int id : ids) *out++ = static_cast<std::uint8_t>(id);
+    return out;
 }
 
 /* START action encoding:
  *   [TYPE=0x01][ID][TCOUNT][TIDS...]
  */
-void packStart(std::vector<std::uint8_t>& out, const StartAction& a) {
-    appendU8(out, TYPE_START);
-    appendU8(out, clampIdToU8(a.id));
-    appendTargets(out, a.runAfterMe);
+std::uint8_t* packStart(std::uint8_t* out, const StartAction& a) {
+    const proto::Start r{TYPE_START, std::uint8_t(a.id)};
+    return packTargets(proto::encode(out, r), a.runAfterMe);
 }
 
 /* DELAY action encoding:
  *   [TYPE=0x02][ID][DUR_MS:4BE][DUR_US:2BE][TCOUNT][TIDS...]
  */
-void packDelay(std::vector<std::uint8_t>& out, const DelayAction& a) {
-    appendU8(out, TYPE_DELAY);
-    appendU8(out, clampIdToU8(a.id));
-    appendU32BE(out, static_cast<std::uint32_t>(a.durationMs));
-    appendU16BE(out, static_cast<std::uint16_t>(a.durationUs));
-    appendTargets(out, a.runAfterMe);
+std::uint8_t* packDelay(std::uint8_t* out, const DelayAction& a) {
+    const proto::Delay r{TYPE_DELAY, std::uint8_t(a.id), a.durationMs, a.durationUs};
+    return packTargets(proto::encode(out, r), a.runAfterMe);
 }
 
 /* PIN_READ action encoding:
  *   [TYPE=0x03][ID][PORT][PIN][INIT][TARGET][FINAL][DUR_MS:4BE][DUR_US:2BE][TCOUNT][TIDS...]
  */
-void packPinRead(std::vector<std::uint8_t>& out, const PinReadAction& a) {
-    if (a.pin < 0 || a.pin > 255) throw std::runtime_error("PinReadAction.pin out of 0..255");
-
-    appendU8(out, TYPE_PIN_READ);
-    appendU8(out, clampIdToU8(a.id));
-    appendU8(out, static_cast<std::uint8_t>(a.port));
-    appendU8(out, static_cast<std::uint8_t>(a.pin));
-    appendU8(out, levelToU8(a.initial));
-    appendU8(out, levelToU8(a.target));
-    appendU8(out, levelToU8(a.final));
-    appendU32BE(out, static_cast<std::uint32_t>(a.durationMs));
-    appendU16BE(out, static_cast<std::uint16_t>(a.durationUs));
-    appendTargets(out, a.runAfterMe);
+std::uint8_t* packPinRead(std::uint8_t* out, const PinReadAction& a) {
+    const proto::PinRead r{TYPE_PIN_READ, std::uint8_t(a.id),
+                           std::uint8_t(a.port), std::uint8_t(a.pin),
+                           levelToU8(a.initial), levelToU8(a.target), levelToU8(a.final),
+                           a.durationMs, a.durationUs};
+    return packTargets(proto::encode(out, r), a.runAfterMe);
 }
 
 /* PIN_WRITE action encoding:
  *   [TYPE=0x04][ID][PORT][PIN][INIT][TARGET][FINAL][DUR_MS:4BE][DUR_US:2BE][TCOUNT][TIDS...]
  */
-void packPinWrite(std::vector<std::uint8_t>& out, const PinWriteAction& a) {
-    if (a.pin < 0 || a.pin > 255) throw std::runtime_error("PinWriteAction.pin out of 0..255");
-
-    appendU8(out, TYPE_PIN_WRITE);
-    appendU8(out, clampIdToU8(a.id));
-    appendU8(out, static_cast<std::uint8_t>(a.port));
-    appendU8(out, static_cast<std::uint8_t>(a.pin));
-    appendU8(out, levelToU8(a.initial));
-    appendU8(out, levelToU8(a.target));
-    appendU8(out, levelToU8(a.final));
-    appendU32BE(out, static_cast<std::uint32_t>(a.durationMs));
-    appendU16BE(out, static_cast<std::uint16_t>(a.durationUs));
-    appendTargets(out, a.runAfterMe);
+std::uint8_t* packPinWrite(std::uint8_t* out, const PinWriteAction& a) {
+    const proto::PinWrite r{TYPE_PIN_WRITE, std::uint8_t(a.id),
+                            std::uint8_t(a.port), std::uint8_t(a.pin),
+                            levelToU8(a.initial), levelToU8(a.target), levelToU8(a.final),
+                            a.durationMs, a.durationUs};
+    return packTargets(proto::encode(out, r), a.runAfterMe);
 }
 
 /* PIN_TRIGGER action encoding:
  *   [TYPE=0x05][ID][PORT][PIN][INIT][TARGET][TIMEOUT_MS:4BE][TIMEOUT_US:2BE][TCOUNT][TIDS...]
  */
-void packPinTrigger(std::vector<std::uint8_t>& out, const PinTriggerAction& a) {
-    if (a.pin < 0 || a.pin > 255) throw std::runtime_error("PinTriggerAction.pin out of 0..255");
-
-    appendU8(out, TYPE_PIN_TRIGGER);
-    appendU8(out, clampIdToU8(a.id));
-    appendU8(out, static_cast<std::uint8_t>(a.port));
-    appendU8(out, static_cast<std::uint8_t>(a.pin));
-    appendU8(out, levelToU8(a.initial));
-    appendU8(out, levelToU8(a.target));
-    appendU32BE(out, static_cast<std::uint32_t>(a.timeoutMs));
-    appendU16BE(out, static_cast<std::uint16_t>(a.timeoutUs));
-    appendTargets(out, a.runAfterMe);
+std::uint8_t* packPinTrigger(std::uint8_t* out, const PinTriggerAction& a) {
+    const proto::PinTrigger r{TYPE_PIN_TRIGGER, std::uint8_t(a.id),
+                              std::uint8_t(a.port), std::uint8_t(a.pin),
+                              levelToU8(a.initial), levelToU8(a.target),
+                              a.timeoutMs, a.timeoutUs};
+    return packTargets(proto::encode(out, r), a.runAfterMe);
 }
 
 /* CRC16-CCITT (poly 0x1021, init 0xFFFF) over a QByteArray. */
 quint16 crc16_ccitt(const QByteArray &data) {
-    quint16 crc = 0xFFFF;
-    for (uchar b : data) {
-        crc ^= quint16(b) << 8;
-        for (int i = 0; i < 8; ++i)
-            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
-    }
+    return crc16_ccitt_update(0xFFFF, data.constData(), data.size());
+}
+
+/* Byte-at-a-time table variant of the bitwise loop (table built once). */
+quint16 crc16_ccitt_update(quint16 crc, const char *p, qsizetype n) {
+    static const auto table = [] {
+        std::array<quint16, 256> t{};
+        for (int v = 0; v < 256; ++v) {
+            quint16 c = quint16(v << 8);
+            for (int i = 0; i < 8; ++i)
+                c = (c & 0x8000) ? quint16((c << 1) ^ 0x1021) : quint16(c << 1);
+            t[v] = c;
+        }
+        return t;
+    }();
+    for (qsizetype i = 0; i < n; ++i)
+        crc = quint16((crc << 8) ^ table[((crc >> 8) ^ quint8(p[i])) & 0xFF]);
     return crc;
 }
 
@@ -148,84 +147,155 @@ quint16 crc16_ccitt(const QByteArray &data) {
  *   CRC16:    over CORE only (big-endian)
  */
 QByteArray buildPacket(quint8 msgId, const QByteArray &payload) {
-    QByteArray core; core.reserve(1 + 2 + payload.size());
-    core.append(char(msgId));
-    const quint16 len = quint16(payload.size());
-    core.append(char((len >> 8) & 0xFF));
-    core.append(char(len & 0xFF));
-    core.append(payload);
-
-    const quint16 crc = crc16_ccitt(core);
-
-    QByteArray pkt; pkt.reserve(2 + core.size() + 2);
-    pkt.append(char(SOF0));
-    pkt.append(char(SOF1));
-    pkt.append(core);
-    pkt.append(char((crc >> 8) & 0xFF));
-    pkt.append(char(crc & 0xFF));
-    return pkt;
-}
-
-/* Serialize a vector of polymorphic Action* into the device wire format.
- * Each Action is dispatched by kind and appended to 'payload' back-to-back.
- * (CSPI is not included here; it has its own encoder.)
+    FrameWriter w(msgId, payload.size());
+    w.append(payload);
+    return w.finish();
+}
+
+/*
+ * Device ids. The firmware indexes its node table by id, so the ids on the
+ * wire must be 0..N-1; ActionSet ids are stable and have gaps after
+ * removals. For a set, the k-th record in wire order gets device id k and
+ * target ids are looked up in the same (ascending) order. Plain action
+ * vectors are encoded with their ids as given.
  */
-std::vector<std::uint8_t> encodeActionPayload(const std::vector<Action*>& actions) {
-    std::vector<std::uint8_t> payload;
-    payload.reserve(actions.size() * 16);
+static int denseId(const std::vector<Action*>& order, int id) {
+    const auto it = std::lower_bound(order.begin(), order.end(), id,
+                                     [](const Action* a, int v) { return a->id < v; });
+    return (it != order.end() && (*it)->id == id) ? int(it - order.begin()) : -1;
+}
 
+/* Pass 1: validate and sum record sizes, so the blob is allocated once.
+ * Returns SIZE_MAX if an action does not fit the wire fields. */
+static std::size_t blobSize(const std::vector<Action*>& actions, std::size_t* records, bool dense) {
+    if (dense && actions.size() > 256) return SIZE_MAX;
+    std::size_t total = 0, n = 0;
+    for (const Action* a : actions) {
+        const std::size_t sz = recordSize(*a);
+        if (!sz) continue;
+        if (dense) {
+            if (a->runAfterMe.size() > 255 || !pinEncodable(*a)) return SIZE_MAX;
+            for (int t : a->runAfterMe)
+                if (denseId(actions, t) < 0) return SIZE_MAX;
+        } else if (!recordEncodable(*a)) {
+            return SIZE_MAX;
+        }
+        total += sz;
+        ++n;
+    }
+    if (records) *records = n;
+    return total;
+}
+
+/* Pass 2: dispatch by kind and write each record at @base. The index falls
+ * out of the write position. (CSPI is not included here; it has its own
+ * encoder.) With @dense the ID and target bytes are rewritten to device ids
+ * right after the record is packed.
+ */
+static void packRecords(std::uint8_t* base, const std::vector<Action*>& actions, ActionIndex* index, bool dense) {
+    std::uint8_t* p = base;
     for (const Action* a : actions) {
+        std::uint8_t* const start = p;
         switch (a->kind) {
-        case Kind::START:       packStart(payload, *static_cast<const StartAction*>(a)); break;
-        case Kind::DELAY:       packDelay(payload, *static_cast<const DelayAction*>(a)); break;
-        case Kind::PIN_READ:    packPinRead(payload, *static_cast<const PinReadAction*>(a)); break;
-        case Kind::PIN_WRITE:   packPinWrite(payload, *static_cast<const PinWriteAction*>(a)); break;
-        case Kind::PIN_TRIGGER: packPinTrigger(payload, *static_cast<const PinTriggerAction*>(a)); break;
+        case Kind::START:       p = packStart(p, *static_cast<const StartAction*>(a)); break;
+        case Kind::DELAY:       p = packDelay(p, *static_cast<const DelayAction*>(a)); break;
+        case Kind::PIN_READ:    p = packPinRead(p, *static_cast<const PinReadAction*>(a)); break;
+        case Kind::PIN_WRITE:   p = packPinWrite(p, *static_cast<const PinWriteAction*>(a)); break;
+        case Kind::PIN_TRIGGER: p = packPinTrigger(p, *static_cast<const PinTriggerAction*>(a)); break;
         case Kind::CSPI:
             /* CSPI actions are sent via a different path (bulk header+data). */
-            break;
+            continue;
         }
+        if (dense) {
+            const std::vector<int>& t = a->runAfterMe;
+            std::uint8_t* tids = p - t.size();
+            start[1] = std::uint8_t(denseId(actions, a->id));
+            for (std::size_t i = 0; i < t.size(); ++i) tids[i] = std::uint8_t(denseId(actions, t[i]));
+        }
+        if (index) index->push_back(ActionRecord{int(start - base), int(p - start), a->kind, start[1]});
     }
-    return payload;
 }
 
-/* Encode the CSPI session header + TX payload for MSG_ID_CSPI_BEGIN.
- * Layout (must match device side parse_cspi_begin + subsequent data stream):
+/* Serialize a vector of polymorphic Action* into the device wire format. */
+static EncodedActions encode(const std::vector<Action*>& actions, bool dense) {
+    EncodedActions enc;
+    std::size_t records = 0;
+    const std::size_t total = blobSize(actions, &records, dense);
+    if (total == SIZE_MAX) return enc;
+
+    enc.bytes.resize(total);
+    enc.index.reserve(records);
+    packRecords(enc.bytes.data(), actions, &enc.index, dense);
+    return enc;
+}
+
+/* Same two passes, with the blob landing inside the frame payload. */
+static bool encodeInto(FrameWriter& w, const std::vector<Action*>& actions, ActionIndex* index, bool dense) {
+    std::size_t records = 0;
+    const std::size_t total = blobSize(actions, &records, dense);
+    if (total == SIZE_MAX) return false;
+
+    if (index) { index->clear(); index->reserve(records); }
+    packRecords(w.grow(qsizetype(total)), actions, index, dense);
+    return true;
+}
+
+EncodedActions encodeActions(const std::vector<Action*>& actions) {
+    return encode(actions, false);
+}
+
+bool encodeActionsInto(FrameWriter& w, const std::vector<Action*>& actions, ActionIndex* index) {
+    return encodeInto(w, actions, index, false);
+}
+
+/* Wire order: ascending id, blob records only. ActionSet keeps its nodes
+ * sorted by id, so this is a filtered copy, not a sort. */
+static std::vector<Action*> wireOrder(const ActionSet& set) {
+    std::vector<Action*> ptrs; ptrs.reserve(set.nodes().size());
+    for (const auto& up : set.nodes())
+        if (recordSize(*up)) ptrs.push_back(up.get());
+    return ptrs;
+}
+
+EncodedActions encodeActionSet(const ActionSet& set) {
+    return encode(wireOrder(set), true);
+}
+
+bool encodeActionSetInto(FrameWriter& w, const ActionSet& set, ActionIndex* index) {
+    return encodeInto(w, wireOrder(set), index, true);
+}
+
+/* Records are in blob order, so the first one past @capacity ends the run. */
+int recordsFitting(const ActionIndex& index, int capacity) {
+    const auto it = std::find_if(index.begin(), index.end(), [capacity](const ActionRecord& r) {
+        return r.offset + r.length > capacity;
+    });
+    return int(it - index.begin());
+}
+
+std::vector<std::uint8_t> encodeActionPayload(const std::vector<Action*>& actions) {
+    return encodeActions(actions).bytes;
+}
+
+/* Encode the CSPI session header for MSG_ID_CSPI_BEGIN.
+ * Layout (must match device side parse_cspi_begin):
  *   [mode:1][wordSize:1][readSize:2][transfer_size:1]
- *   [tx_len:2][threshold:4][port:1][pin:1][tx_bytes...]
+ *   [tx_len:2][threshold:4][port:1][pin:1][flags:1]
+ * The TX words themselves are streamed as DATA frames (CspiStreamer).
  */
-std::vector<std::uint8_t> encodeCSPIPayload(const CSPIAction& a)
+QByteArray encodeCSPIHeader(const CSPIAction& a)
 {
-    // Copy QByteArray into a std::vector<uint8_t> for contiguous access
-    std::vector<uint8_t> txBytes(a.txData.begin(), a.txData.end());
-
-    std::vector<std::uint8_t> payload;
-    payload.reserve(
-        1  /* mode */
-        + 1  /* wordSize */
-        + 2  /* readSize */
-        + 1  /* transfer_size */
-        + 2  /* txData size */
-        + 4  /* threshold (32-bit, high bytes ignored if a.threshold > 32-bit) */
-        + 1  /* port */
-        + 1  /* pin */
-        + txBytes.size()
-        );
-
-    appendU8    (payload, static_cast<std::uint8_t>(a.mode));
-    appendU8    (payload, static_cast<std::uint8_t>(a.wordSize));
-    appendU16BE (payload, static_cast<std::uint16_t>(a.readSize));
-    appendU8    (payload, static_cast<std::uint8_t>(a.transfer_size));
-
-    if (txBytes.size() > 0xFFFF)
-        throw std::runtime_error("txData too large (>65535)");
-    appendU16BE (payload, static_cast<std::uint16_t>(txBytes.size()));
-
-    appendU32BE (payload, static_cast<std::uint32_t>(a.threshold)); // only low 32 bits used on device
-    appendU8    (payload, static_cast<std::uint8_t>(a.port));
-    appendU8    (payload, static_cast<std::uint8_t>(a.pin));
-
-    // Append raw TX stream used by the CSPI producer on the device
-    payload.insert(payload.end(), txBytes.begin(), txBytes.end());
-    return payload;
+    // Informational only: the device streams TX through DATA frames, so large
+    // imported patterns are allowed and tx_len saturates at 0xFFFF
+    const proto::CspiBegin hdr{
+        std::uint8_t(a.mode), std::uint8_t(a.wordSize),
+        std::uint16_t(a.readSize), std::uint8_t(a.transfer_size),
+        std::uint16_t(std::min<qsizetype>(a.txData.size(), 0xFFFF)),
+        std::uint32_t(a.threshold),                 // only low 32 bits used on device
+        std::uint8_t(a.port), std::uint8_t(a.pin),
+        std::uint8_t(a.useDma ? CSPI_FLAG_DMA : 0)};
+
+    QByteArray out(qsizetype(proto::CspiBegin::kSize), Qt::Uninitialized);
+    proto::encode(reinterpret_cast<std::uint8_t*>(out.data()), hdr);
+    return out;
 }
@@ -0,0 +1,12 @@
+#include "../../mainwindow.h"
+
+/*
+ * Device CSPI statistics frame (MSG_ID_CSPI_STATS).
+ *
+ * The window decodes and renders it; frames arriving while it is closed are
+ * simply dropped (the counters are cumulative, the next one catches up).
+ */
+void MainWindow::onCspiStatsReceived(const QByteArray& payload)
+{
+    if (cspiWin) cspiWin->showStats(payload);
+}
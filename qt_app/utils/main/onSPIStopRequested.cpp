@@ -1,5 +1,9 @@
 #include "../../mainwindow.h"
 #include "../../actionEncoder.h"
+#include <QTimer>
+
+// Device flushes its last RX half after END/TERMINATE; keep the file open briefly
+static constexpr int kCaptureTailMs = 500;
 
 void MainWindow::onSPIStopRequested()
 {
@@ -7,6 +11,8 @@ void MainWindow::onSPIStopRequested()
 
     sendPacket(MSG_ID_CSPI_END, QByteArray());
     m_cspiActive = false;
+    m_cspiStream.stop();
+    QTimer::singleShot(kCaptureTailMs, this, [this] { if (!m_cspiActive) cspiCloseCapture(); });
 }
 
 void MainWindow::onSPITerminateRequested()
@@ -15,4 +21,6 @@ void MainWindow::onSPITerminateRequested()
 
     sendPacket(MSG_ID_CSPI_TERMINATE, QByteArray());
     m_cspiActive = false;
+    m_cspiStream.stop();
+    QTimer::singleShot(kCaptureTailMs, this, [this] { if (!m_cspiActive) cspiCloseCapture(); });
 }
@@ -0,0 +1,30 @@
+#include "../../mainwindow.h"
+#include "../../ui_mainwindow.h"
+#include "../../actionEncoder.h"
+
+/*
+ * Show the device's resident slot summary.
+ *
+ * Reply layout (MSG_ID_SLOT_LIST, device → host):
+ *   [USED]{[SLOT][COUNT][LEN:2BE][CRC:2BE][RUNS:4BE]}...   (proto::SlotInfo)
+ *
+ * Rendered as e.g. "Slots: #0 12 actions 140B runs=3 | #2 4 actions 38B runs=0".
+ */
+void MainWindow::onSlotListReceived(const QByteArray& payload)
+{
+    if (payload.isEmpty()) return;
+
+    const auto* p   = reinterpret_cast<const quint8*>(payload.constData());
+    const int  used = p[0];
+    if (used == 0) {
+        ui->statusbar->showMessage("Slots: all empty", 4000);
+        return;
+    }
+
+    QStringList parts;
+    for (int k = 0, off = 1; k < used && off + SLOT_INFO_SIZE <= payload.size(); ++k, off += SLOT_INFO_SIZE) {
+        const auto s = proto::read<proto::SlotInfo>(p + off);
+        parts << QString("#%1 %2 actions %3B runs=%4").arg(s.slot).arg(s.count).arg(s.len).arg(s.runs);
+    }
+    ui->statusbar->showMessage("Slots: " + parts.join(" | "), 6000);
+}
@@ -1,83 +1,50 @@
 #include "../../mainwindow.h"
 #include "../../ui_mainwindow.h"
 #include "../../actionEncoder.h"
-#include <QtSerialPort/QSerialPort>
+#include "../../actiontiming.h"
+#include "../../framewriter.h"
+#include <QMessageBox>
+#include <QStandardPaths>
 #include <algorithm>
 
 /*
- * Write the full `data` buffer to the serial port, waiting for the device
- * to drain its TX FIFO between partial writes.
+ * Frame and queue one protocol packet for the transport thread.
  *
- * - QSerialPort::write() may return before all bytes are queued.
- * - We loop until every byte is accepted by the driver.
- * - After each write (including zero-byte progress), we call
- *   waitForBytesWritten(perChunkTimeoutMs) to block until the OS/hardware
- *   confirms the bytes were handed off, or a timeout occurs.
+ * - Validates that the link is open.
+ * - Builds the packet using the UART protocol (SOF + msg + len + payload + CRC).
+ * - Hands it to SerialTransport::send(); the I/O thread writes it, so the GUI
+ *   never waits on the port. Delivery/latency show up in the link metrics.
+ * - If a SerialMonitor is present, logs the TX packet; actions-carrying
+ *   packets pass their record index (blob starting at @indexBase in the
+ *   payload) so the monitor can color records without re-encoding.
  *
  * Returns:
- *   true  on success (all bytes written and flushed)
- *   false on error or timeout
+ *   true  if the packet was queued
+ *   false if the link is closed or the TX queue is full (back-pressure)
  */
-bool MainWindow::writeAllWithTimeout(const QByteArray& data, int perChunkTimeoutMs)
+bool MainWindow::sendPacket(quint8 msgId, const QByteArray& payload,
+                            const ActionIndex* index, int indexBase)
 {
-    qint64 total = 0;
-    const qint64 len = data.size();
-    const char*  p   = data.constData();
-
-    while (total < len) {
-        // Try to write the remaining bytes
-        const qint64 n = serial.write(p + total, len - total);
-        if (n < 0) return false;                           // QSerialPort error
-        if (n == 0) {
-            // No progress yet; wait for the driver to push pending data out
-            if (!serial.waitForBytesWritten(perChunkTimeoutMs)) return false;
-            continue;
-        }
-
-        total += n;
-
-        // Ensure the just-written bytes are actually pushed out by the driver
-        if (!serial.waitForBytesWritten(perChunkTimeoutMs)) return false;
-    }
-    return true;
+    return sendFrame(buildPacket(msgId, payload), index, indexBase);
 }
 
 /*
- * Frame and send one protocol packet over serial.
- *
- * - Validates that the serial port is open.
- * - Builds the packet using the UART protocol (SOF + msg + len + payload + CRC).
- * - Uses writeAllWithTimeout() to ensure complete transmission.
- * - Flushes the port to minimize latency for small packets.
- * - If a SerialMonitor is present, logs the TX packet (passing the ActionSet
- *   only for MSG_ID_EXECUTE_ACTIONS to enable rich decoding in the monitor UI).
- *
- * Returns:
- *   true  if the packet was sent successfully
- *   false if the port is closed or a write/timeout error occurred
+ * Queue a frame that is already built (buildPacket() or a FrameWriter).
  */
-bool MainWindow::sendPacket(quint8 msgId, const QByteArray& payload)
+bool MainWindow::sendFrame(const QByteArray& pkt, const ActionIndex* index, int indexBase)
 {
-    if (!serial.isOpen()) {
+    if (!m_link.isOpen()) {
         ui->statusbar->showMessage("Serial not connected", 2500);
         return false;
     }
 
-    QByteArray pkt = buildPacket(msgId, payload);
-
-    if (!writeAllWithTimeout(pkt, /*perChunk*/200)) {
-        ui->statusbar->showMessage("Serial write failed or timed out", 3000);
+    if (!m_link.send(pkt)) {
+        ui->statusbar->showMessage("Serial TX queue full, packet not sent", 3000);
         return false;
     }
-    serial.flush();  // Nudge the driver to push immediately
-
-    // Optional: mirror TX in the monitor (with action metadata when relevant)
-    if (monitor) {
-        if (msgId == MSG_ID_EXECUTE_ACTIONS)
-            monitor->logTx(pkt, &actionSet);
-        else
-            monitor->logTx(pkt, nullptr);
-    }
+
+    // Optional: mirror TX in the monitor (with the record index when relevant)
+    if (monitor) monitor->logTx(pkt, index, indexBase);
 
     return true;
 }
@@ -85,48 +52,104 @@ bool MainWindow::sendPacket(quint8 msgId, const QByteArray& payload)
 /*
  * Build the actions payload in the wire format expected by the device.
  *
- * - Gathers all Action nodes from the ActionSet.
- * - Sorts them by their numeric id to produce a stable, deterministic order.
- * - Converts the ordered list to the compact binary payload using
- *   encodeActionPayload().
+ * - encodeActionSet() takes the nodes in ascending id order, assigns the
+ *   dense device ids and encodes them in one pass; the record index is
+ *   handed back in @index (if given) so the monitor and the flash/slot
+ *   writers never re-encode to find record boundaries.
  *
  * Returns:
  *   QByteArray with the payload (could be empty if there are no actions
  *   or the encoder returned nothing).
  */
-QByteArray MainWindow::buildActionsPayload()
+QByteArray MainWindow::buildActionsPayload(ActionIndex* index)
 {
+    if (index) index->clear();
     if (actionSet.nodes().empty())
         return {};
 
-    // Collect and sort action IDs to enforce a deterministic packing order
-    std::vector<int> ids; ids.reserve(actionSet.nodes().size());
-    for (const auto& up : actionSet.nodes()) ids.push_back(up->id);
-    std::sort(ids.begin(), ids.end());
+    // Encode to the device wire format (ascending id; blob + record index in one pass)
+    EncodedActions enc = encodeActionSet(actionSet);
+    if (enc.bytes.empty())
+        return {};
 
-    // Map IDs back to pointers (skip missing/invalid ones)
-    std::vector<Action*> ptrs; ptrs.reserve(ids.size());
-    for (int id : ids)
-        if (auto* a = actionSet.find(id)) ptrs.push_back(a);
+    if (index) *index = std::move(enc.index);
+    return QByteArray(reinterpret_cast<const char*>(enc.bytes.data()),
+                      static_cast<int>(enc.bytes.size()));
+}
 
-    if (ptrs.empty())
+/*
+ * Build an actions-carrying frame in one buffer.
+ *
+ * - FrameWriter reserves a full frame (MAX_PAYLOAD_SIZE) up front; the
+ *   optional prefix byte (slot/key) and the records are written straight
+ *   into it, then LEN/CRC are patched. No blob vector, no payload copy.
+ * - The frame may exceed MAX_PAYLOAD_SIZE; callers check the payload size
+ *   (frame size - PROTO_CORE_SIZE) and report with @index.
+ */
+QByteArray MainWindow::buildActionsFrame(quint8 msgId, int prefix, ActionIndex* index)
+{
+    if (index) index->clear();
+    if (actionSet.nodes().empty())
         return {};
 
-    // Encode to the device wire format
-    std::vector<std::uint8_t> raw = encodeActionPayload(ptrs);
-    if (raw.empty())
+    FrameWriter w(msgId, MAX_PAYLOAD_SIZE);
+    if (prefix >= 0) w.put(quint8(prefix));
+    if (!encodeActionSetInto(w, actionSet, index))
         return {};
+    return w.finish();
+}
+
+/*
+ * Static timing check of the current graph before it leaves the host.
+ *
+ * - Errors mean the device would hang (unreachable action) or stop with an
+ *   error (PIN_READ, trigger that cannot be satisfied): the user is asked
+ *   whether to send anyway, default No.
+ * - Warnings are advisory: nothing is asked, @note gets the summary and the
+ *   most severe issue for the caller's status line.
+ *
+ * Returns:
+ *   true  if the graph may be sent
+ *   false if the user declined
+ */
+bool MainWindow::confirmTiming(const QString& what, QString* note)
+{
+    const TimingReport timing = analyzeTiming(actionSet);
+    if (note) {
+        *note = timingSummary(timing);
+        if (!timing.issues.empty())
+            *note += " | " + timingIssueText(timing.issues.front());
+    }
+    if (!timing.hasErrors())
+        return true;
+
+    QStringList lines;
+    for (const TimingIssue& is : timing.issues) {
+        if (is.severity != TimingIssue::Severity::Error) break;   // errors come first
+        lines << timingIssueText(is);
+    }
+    const auto answer = QMessageBox::warning(
+        this, what,
+        QString("The action graph has timing errors:\n\n%1\n\nSend it anyway?").arg(lines.join('\n')),
+        QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
+    if (answer == QMessageBox::Yes)
+        return true;
 
-    return QByteArray(reinterpret_cast<const char*>(raw.data()),
-                      static_cast<int>(raw.size()));
+    ui->statusbar->showMessage(QString("%1 cancelled: timing errors").arg(what), 3000);
+    return false;
 }
 
 /*
  * Build and send the actions payload immediately.
  *
- * - Validates that there are actions and they can be encoded.
- * - Sends a MSG_ID_EXECUTE_ACTIONS packet to the device.
- * - Shows status messages for UX feedback.
+ * - Validates that there are actions, they can be encoded and the payload
+ *   fits MAX_PAYLOAD_SIZE (the index tells how many actions would).
+ * - Runs the static timing check first (confirmTiming()); a graph with
+ *   errors goes out only if the user confirms.
+ * - Sends a MSG_ID_EXECUTE_ACTIONS frame (built in place) to the device;
+ *   the record index goes along for the monitor's per-record coloring.
+ * - Shows the timing summary (makespan window, issue counts and the most
+ *   severe issue) in the status bar.
  */
 void MainWindow::sendActions()
 {
@@ -135,88 +158,139 @@ void MainWindow::sendActions()
         return;
     }
 
-    // Same ordering pipeline as buildActionsPayload()
-    std::vector<int> ids; ids.reserve(actionSet.nodes().size());
-    for (const auto& up : actionSet.nodes()) ids.push_back(up->id);
-    std::sort(ids.begin(), ids.end());
-
-    std::vector<Action*> ptrs; ptrs.reserve(ids.size());
-    for (int id : ids)
-        if (auto* a = actionSet.find(id)) ptrs.push_back(a);
-
-    if (ptrs.empty()) {
-        ui->statusbar->showMessage("No valid actions found", 2000);
+    ActionIndex index;
+    const QByteArray frame = buildActionsFrame(MSG_ID_EXECUTE_ACTIONS, -1, &index);
+    if (frame.isEmpty()) {
+        ui->statusbar->showMessage("Encoder produced empty payload", 2500);
         return;
     }
-
-    std::vector<std::uint8_t> raw = encodeActionPayload(ptrs);
-    if (raw.empty()) {
-        ui->statusbar->showMessage("Encoder produced empty payload", 2500);
+    if (frame.size() - PROTO_CORE_SIZE > MAX_PAYLOAD_SIZE) {
+        ui->statusbar->showMessage(QString("Actions too large for one frame (%1 of %2 fit)")
+                                       .arg(recordsFitting(index, MAX_PAYLOAD_SIZE))
+                                       .arg(index.size()), 3000);
         return;
     }
 
-    QByteArray payload(reinterpret_cast<const char*>(raw.data()), int(raw.size()));
-    sendPacket(MSG_ID_EXECUTE_ACTIONS, payload);
+    QString note;
+    if (!confirmTiming("Execute", &note) || !sendFrame(frame, &index))
+        return;
+
+    ui->statusbar->showMessage("Sent: " + note, 8000);
 }
 
 /*
- * Make a 512-byte chunk by cycling over `src` starting at index `pos`.
+ * Handle a "CSPI_REQ" event coming from the SerialMonitor (legacy, empty REQ).
  *
- * - If `src` is shorter than 512 bytes, bytes repeat in a wrap-around fashion.
- * - If `src` is empty, returns a zero-filled buffer.
- * - Updates `pos` to the next start index for the following call.
+ * - The device requested more SPI TX bytes.
+ * - If CSPI streaming is active, allow one more 512-byte chunk in flight
+ *   and pump the pre-framed pool.
+ */
+void MainWindow::onCspiReqReceived()
+{
+    if (!m_cspiActive) return;
+    m_cspiCredit = m_cspiSent + CSPI_CHUNK_SIZE;
+    cspiPump();
+}
+
+/*
+ * Handle a CSPI credit frame from the device.
  *
- * This is used to stream continuous SPI data chunks upon device requests.
+ * - `limit` is cumulative (bytes accepted + ring free space), so a stale or
+ *   repeated frame never grants more than the device can hold.
+ * - Whole chunks are sent while they fit under the limit; several DATA frames
+ *   are in flight at once instead of one per UART round trip.
+ * - Starvation/underflow counters are shown when they change.
  */
-static inline QByteArray makeCycledChunk512(const QByteArray& src, int& pos)
+void MainWindow::onCspiCreditReceived(quint32 limit, quint32 starved, quint32 underflows)
 {
-    QByteArray out(512, char(0));
-    if (src.isEmpty()) return out;
-
-    const int n = src.size();
-    char* dst = out.data();
-    for (int i = 0; i < 512; ++i) {
-        dst[i] = src.at(pos);
-        pos = (pos + 1) % n;  // wrap around
+    if (starved != m_cspiStarved || underflows != m_cspiUnderflows) {
+        m_cspiStarved    = starved;
+        m_cspiUnderflows = underflows;
+        ui->statusbar->showMessage(QString("CSPI starved=%1 underflow=%2")
+                                       .arg(starved).arg(underflows), 3000);
     }
-    return out;
+    if (!m_cspiActive) return;
+
+    if (qint32(limit - m_cspiCredit) > 0) m_cspiCredit = limit;
+    cspiPump();
 }
 
 /*
- * Handle a "CSPI_REQ" event coming from the SerialMonitor.
+ * Drain the streamer pool against the current credit.
  *
- * - The device requested more SPI TX bytes.
- * - If CSPI streaming is active, generate a 512-byte chunk (cycled)
- *   and send it as MSG_ID_CSPI_DATA.
+ * - Frames are already SOF/CRC-framed by the worker; this only queues them
+ *   on the transport (no HTML logging per chunk).
+ * - Room is checked before a frame is taken, so a refusal never loses one;
+ *   txSpace() brings us back once the transport backlog drains.
+ * - If the pool runs dry, framesReady() brings us back here.
  */
-void MainWindow::onCspiReqReceived()
+void MainWindow::cspiPump()
 {
-    if (!m_cspiActive) return;
-    const QByteArray chunk = makeCycledChunk512(m_cspiTxData, m_cspiPos);
-    sendPacket(MSG_ID_CSPI_DATA, chunk);
+    constexpr int kFrameLen = 2 + 3 + CSPI_CHUNK_SIZE + 2;  // SOF + MSG/LEN + chunk + CRC
+
+    if (!m_cspiActive || !m_link.isOpen()) return;
+
+    while (qint32(m_cspiCredit - m_cspiSent) >= CSPI_CHUNK_SIZE) {
+        if (!m_link.canSend(kFrameLen)) break;
+        const QByteArray frame = m_cspiStream.take();
+        if (frame.isEmpty()) break;
+        m_link.send(frame);
+        m_cspiSent += CSPI_CHUNK_SIZE;
+    }
 }
 
 /*
  * Begin a new Continuous SPI (CSPI) session.
  *
- * - `payload` is the CSPI header + TX data (as built by encodeCSPIPayload()).
- * - Device expects a separate BEGIN (header only) followed by DATA bursts.
- * - We split the QByteArray:
- *     * header: first 13 bytes (mode/wordSize/readSize/transfer_size/txLen/threshold/port/pin)
- *     * txData: remainder (the generator source used for makeCycledChunk512)
- * - Send MSG_ID_CSPI_BEGIN with just the header.
- * - Mark the CSPI session as active; data will then be fed in response to
- *   onCspiReqReceived() triggers.
+ * - `header` is the MSG_ID_CSPI_BEGIN payload (encodeCSPIHeader()); it goes
+ *   out as one small frame.
+ * - `txData` is the cyclic source handed to m_cspiStream as is (implicitly
+ *   shared, no copy); the streamer frames DATA packets straight from it.
+ * - Mark the CSPI session as active; data will then be fed against the
+ *   device's credit frames (onCspiCreditReceived()).
  */
-void MainWindow::onCspiPayloadReady(const QByteArray& payload)
+void MainWindow::onCspiPayloadReady(const QByteArray& header, const QByteArray& txData)
 {
-    constexpr int kHeaderLen = 13;
-    const QByteArray header = payload.left(kHeaderLen);
-    const QByteArray txData = payload.mid(kHeaderLen);
+    m_cspiStream.start(txData);  // pre-frame DATA packets cycling over txData
+    m_cspiSent   = 0;
+    m_cspiCredit = 0;
+    m_cspiStarved = m_cspiUnderflows = 0;
 
-    m_cspiTxData = txData;  // source buffer we will cycle over
-    m_cspiPos    = 0;
+    // RX capture requested (readSize > 0): blocks go to a binary file
+    const quint16 readSize = header.size() >= CSPI_HEADER_SIZE
+        ? proto::read<proto::CspiBegin>(reinterpret_cast<const quint8*>(header.constData())).rx_size : 0;
+    m_cspiCapture.close();
+    if (readSize > 0) {
+        const QString dir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+        if (!m_cspiCapture.open(dir))
+            ui->statusbar->showMessage("CSPI RX capture file could not be created", 3000);
+    }
 
     sendPacket(MSG_ID_CSPI_BEGIN, header);
     m_cspiActive = true;
 }
+
+/*
+ * Device RX capture block (MSG_ID_CSPI_RX).
+ *
+ * - Written as-is to the session file; no hex/HTML rendering on this path.
+ * - Blocks still arriving after END (the device flushes its last half) are
+ *   kept as long as the file is open.
+ */
+void MainWindow::onCspiRxBlock(quint16 seq, const QByteArray& data)
+{
+    m_cspiCapture.append(seq, data);
+}
+
+/*
+ * Close the capture file and surface where it went and whether blocks were lost.
+ */
+void MainWindow::cspiCloseCapture()
+{
+    if (!m_cspiCapture.isOpen()) return;
+    m_cspiCapture.close();
+    ui->statusbar->showMessage(QString("CSPI RX: %1 blocks, %2 lost -> %3")
+                                   .arg(m_cspiCapture.blocks())
+                                   .arg(m_cspiCapture.lost())
+                                   .arg(m_cspiCapture.path()), 8000);
+}